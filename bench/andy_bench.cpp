@@ -0,0 +1,608 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <andy/lang/api.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/lexer.hpp>
+#include <andy/lang/parser.hpp>
+
+// Benchmarks of the interpreter. The micro suite times one feature at a time, the macro suite runs the
+// scripts of bench/macro from the source file to the result, like the andy executable does.
+//
+// Usage: andy-bench [--suite=micro|macro|all] [--filter=<text>] [--samples=<n>] [--warmup=<n>] [--scale=<n>]
+//                   [--output=<file>] [--compare=<baseline>] [--threshold=<percent>]
+//
+// The result is written as JSON, one benchmark per line. A saved result can be given to --compare, which
+// reports every benchmark whose median moved by more than the threshold and fails if one got slower.
+
+namespace
+{
+    struct benchmark
+    {
+        std::string name;
+        std::string suite;
+        // The number of operations a run executes, the times are also reported per operation
+        size_t operations = 1;
+        // The micro benchmarks which run their operation in a for loop have the cost of the loop subtracted
+        bool in_loop = false;
+        // Prepares a run, not timed
+        std::function<void()> setup;
+        // The timed part
+        std::function<void()> run;
+    };
+
+    struct result
+    {
+        std::string name;
+        std::string suite;
+        size_t operations = 0;
+        size_t samples = 0;
+        size_t warmup = 0;
+        double min = 0;
+        double median = 0;
+        double mean = 0;
+        double max = 0;
+        double stddev = 0;
+        bool in_loop = false;
+        double adjusted_ns_per_op = 0;
+
+        double ns_per_op() const { return median / operations; }
+    };
+
+    struct options
+    {
+        std::string suite = "all";
+        std::string filter;
+        size_t samples = 10;
+        size_t warmup = 2;
+        size_t scale = 1;
+        std::filesystem::path output;
+        std::filesystem::path compare;
+        double threshold = 5;
+    };
+
+    // A program parsed once and executed by a new interpreter on every run
+    struct script
+    {
+        std::string source;
+        std::unique_ptr<andy::lang::lexer> lexer;
+        andy::lang::parser::ast_node root;
+        std::unique_ptr<andy::lang::interpreter> interpreter;
+
+        script(std::string name, std::string __source)
+            : source(std::move(__source))
+        {
+            lexer = std::make_unique<andy::lang::lexer>(name, source);
+
+            andy::lang::parser parser;
+            root = parser.parse_all(*lexer);
+        }
+    };
+
+    std::string generate_corpus(size_t units)
+    {
+        std::string corpus;
+
+        for(size_t i = 0; i < units; i++) {
+            std::string n = std::to_string(i);
+
+            corpus += "// unit " + n + "\n";
+            corpus += "class Shape" + n + " extends Base {\n";
+            corpus += "    var width = 10;\n";
+            corpus += "    function new(width) {\n";
+            corpus += "        super();\n";
+            corpus += "    }\n";
+            corpus += "    function area(height) {\n";
+            corpus += "        if(height > 0) {\n";
+            corpus += "            return width * height;\n";
+            corpus += "        } else {\n";
+            corpus += "            return 0;\n";
+            corpus += "        }\n";
+            corpus += "    }\n";
+            corpus += "}\n";
+            corpus += "function run" + n + "(count) {\n";
+            corpus += "    var values = [1, 2.5, \"three\", null, true];\n";
+            corpus += "    var names = { \"a\": 1, \"b\": 2 };\n";
+            corpus += "    for(var i = 0; i < count; i++) {\n";
+            corpus += "        puts(\"value ${i} of ${count}\\n\");\n";
+            corpus += "    }\n";
+            corpus += "    foreach(var value in values) {\n";
+            corpus += "        puts(value.to_string());\n";
+            corpus += "    }\n";
+            corpus += "    while(count > 0) {\n";
+            corpus += "        count = count - 1;\n";
+            corpus += "    }\n";
+            corpus += "    var shape = new Shape" + n + "(count);\n";
+            corpus += "    return shape.area(2);\n";
+            corpus += "}\n";
+        }
+
+        return corpus;
+    }
+
+    size_t count_nodes(const andy::lang::parser::ast_node& node)
+    {
+        size_t count = 1;
+
+        for(const auto& child : node.childrens()) {
+            count += count_nodes(child);
+        }
+
+        return count;
+    }
+
+    // A micro benchmark of a program which repeats an operation count times
+    benchmark script_benchmark(std::string name, std::string source, size_t count, bool in_loop)
+    {
+        auto program = std::make_shared<script>(name + ".andy", std::move(source));
+
+        benchmark b;
+        b.name       = std::move(name);
+        b.suite      = "micro";
+        b.operations = count;
+        b.in_loop    = in_loop;
+        b.setup      = [program]() {
+            // The builtin classes are created by the constructor, they are not part of the benchmark
+            program->interpreter = std::make_unique<andy::lang::interpreter>();
+        };
+        b.run        = [program]() {
+            program->interpreter->execute_all(program->root);
+        };
+
+        return b;
+    }
+
+    std::string loop(size_t count, std::string_view body)
+    {
+        return "for(var i = 0; i < " + std::to_string(count) + "; i++) {\n    " + std::string(body) + "\n}\n";
+    }
+
+    std::vector<benchmark> micro_benchmarks(size_t scale)
+    {
+        std::vector<benchmark> benchmarks;
+
+        size_t count = 20000 * scale;
+
+        benchmarks.push_back(script_benchmark("loop", loop(count, ""), count, false));
+
+        benchmarks.push_back(script_benchmark("variable_access", "var a = 1;\nvar b = 0;\n" + loop(count, "b = a;"), count, true));
+
+        benchmarks.push_back(script_benchmark("function_call", "function f(n) {\n    return n;\n}\n" + loop(count, "f(i);"), count, true));
+
+        benchmarks.push_back(script_benchmark("method_dispatch", "class Counter {\n    function id(n) {\n        return n;\n    }\n}\nvar counter = new Counter();\n" + loop(count, "counter.id(i);"), count, true));
+
+        // Integer arithmetic whose results fit in 64 bits, the path every counter takes
+        benchmarks.push_back(script_benchmark("integer_add", "var a = 0;\n" + loop(count, "a = a + 3;"), count, true));
+        benchmarks.push_back(script_benchmark("integer_mul", "var a = 0;\n" + loop(count, "a = i * 3;"), count, true));
+        // And a BigInteger, of 129 bits
+        benchmarks.push_back(script_benchmark("big_integer_mul", "var a = 340282366920938463463374607431768211457;\n" + loop(count, "var b = a * a;"), count, true));
+
+        benchmarks.push_back(script_benchmark("allocation", "class Point {\n}\n" + loop(count, "var p = new Point();"), count, true));
+
+        // Every concatenation copies the string, so the count is kept low enough to stay linear
+        size_t concatenations = 2000 * scale;
+        benchmarks.push_back(script_benchmark("string_concat", "var s = \"\";\n" + loop(concatenations, "s = s + \"x\";"), concatenations, true));
+
+        std::string dictionary = "var d = {";
+        for(size_t i = 0; i < 32; i++) {
+            dictionary += (i ? ", " : " ") + std::string("\"key") + std::to_string(i) + "\": " + std::to_string(i);
+        }
+        dictionary += " };\nvar v = 0;\n";
+        benchmarks.push_back(script_benchmark("dictionary_lookup", dictionary + loop(count, "v = d[\"key17\"];"), count, true));
+
+        // Arrays can only be built from a literal
+        std::string array = "var a = [";
+        for(size_t i = 0; i < 1000; i++) {
+            array += (i ? ", " : "") + std::to_string(i);
+        }
+        array += "];\nvar v = 0;\n";
+        size_t passes = count / 1000;
+        benchmarks.push_back(script_benchmark("foreach", array + "for(var j = 0; j < " + std::to_string(passes) + "; j++) {\n    foreach(var e in a) {\n        v = e;\n    }\n}\n", passes * 1000, false));
+
+        // The same function called on every item, in order and on the pool of the parallel methods
+        std::string items = "var a = [";
+        for(size_t i = 0; i < count; i++) {
+            items += (i ? ", " : "") + std::to_string(i % 1000);
+        }
+        items += "];\nfunction f(n) {\n    return n * n;\n}\n";
+        benchmarks.push_back(script_benchmark("sequential_map", items + "foreach(var e in a) {\n    f(e);\n}\n", count, false));
+        benchmarks.push_back(script_benchmark("parallel_map", items + "var b = a.parallel_map(\"f\");\n", count, false));
+
+        // A rule an application evaluates per request, on an engine which already ran it once
+        auto engine = std::make_shared<andy::lang::api::engine>();
+        auto rule = engine->compile_source("function score(n) {\n    return n * 2;\n}\nreturn limit + 1;\n", "rule.andy");
+        engine->run(rule, { { "limit", engine->make(0) } });
+
+        size_t runs = 1000 * scale;
+
+        benchmark embedded_run;
+        embedded_run.name       = "embedded_run";
+        embedded_run.suite      = "micro";
+        embedded_run.operations = runs;
+        embedded_run.run        = [engine, rule, runs]() {
+            for(size_t i = 0; i < runs; i++) {
+                engine->run(rule, { { "limit", engine->make((int)i) } });
+            }
+        };
+        benchmarks.push_back(std::move(embedded_run));
+
+        benchmark embedded_call;
+        embedded_call.name       = "embedded_call";
+        embedded_call.suite      = "micro";
+        embedded_call.operations = runs;
+        embedded_call.run        = [engine, runs]() {
+            for(size_t i = 0; i < runs; i++) {
+                engine->call("score", (int)i);
+            }
+        };
+        benchmarks.push_back(std::move(embedded_call));
+
+        auto corpus = std::make_shared<std::string>(generate_corpus(200 * scale));
+        size_t tokens = andy::lang::lexer("corpus.andy", *corpus).tokens().size();
+
+        benchmark lex;
+        lex.name       = "lex";
+        lex.suite      = "micro";
+        lex.operations = tokens;
+        lex.run        = [corpus]() {
+            andy::lang::lexer lexer("corpus.andy", *corpus);
+        };
+        benchmarks.push_back(std::move(lex));
+
+        auto lexer = std::make_shared<andy::lang::lexer>("corpus.andy", *corpus);
+        size_t nodes = count_nodes(andy::lang::parser().parse_all(*lexer));
+
+        benchmark parse;
+        parse.name       = "parse";
+        parse.suite      = "micro";
+        parse.operations = nodes;
+        parse.setup      = [lexer]() {
+            lexer->reset();
+        };
+        parse.run        = [lexer]() {
+            andy::lang::parser parser;
+            parser.parse_all(*lexer);
+        };
+        benchmarks.push_back(std::move(parse));
+
+        return benchmarks;
+    }
+
+    std::vector<benchmark> macro_benchmarks()
+    {
+        std::vector<benchmark> benchmarks;
+        std::vector<std::filesystem::path> scripts;
+
+        std::filesystem::path directory = std::filesystem::path(ANDYLANG_PROJECT_DIR) / "bench" / "macro";
+
+        if(std::filesystem::is_directory(directory)) {
+            for(const auto& entry : std::filesystem::directory_iterator(directory)) {
+                if(entry.path().extension() == ".andy") {
+                    scripts.push_back(entry.path());
+                }
+            }
+        }
+
+        std::sort(scripts.begin(), scripts.end());
+
+        for(const auto& path : scripts) {
+            benchmark b;
+            b.name  = path.stem().string();
+            b.suite = "macro";
+            b.run   = [path]() {
+                andy::lang::api::evaluate(path);
+            };
+            benchmarks.push_back(std::move(b));
+        }
+
+        return benchmarks;
+    }
+
+    result measure(const benchmark& b, const options& o)
+    {
+        std::vector<double> samples;
+
+        for(size_t i = 0; i < o.warmup + o.samples; i++) {
+            if(b.setup) {
+                b.setup();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            b.run();
+            auto end = std::chrono::steady_clock::now();
+
+            // The first runs fill the caches and the allocator, they are not counted
+            if(i >= o.warmup) {
+                samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            }
+        }
+
+        std::sort(samples.begin(), samples.end());
+
+        result r;
+        r.name       = b.name;
+        r.suite      = b.suite;
+        r.operations = b.operations;
+        r.samples    = samples.size();
+        r.warmup     = o.warmup;
+        r.in_loop    = b.in_loop;
+        r.min        = samples.front();
+        r.max        = samples.back();
+        r.median     = samples.size() % 2 ? samples[samples.size() / 2] : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+
+        for(double sample : samples) {
+            r.mean += sample;
+        }
+
+        r.mean /= samples.size();
+
+        for(double sample : samples) {
+            r.stddev += (sample - r.mean) * (sample - r.mean);
+        }
+
+        r.stddev = std::sqrt(r.stddev / samples.size());
+
+        return r;
+    }
+
+    void write_result(std::ostream& out, const result& r)
+    {
+        out << "\t\t{ \"name\": \"" << r.name << "\", \"suite\": \"" << r.suite << "\"";
+        out << ", \"operations\": " << r.operations;
+        out << ", \"samples\": " << r.samples << ", \"warmup\": " << r.warmup;
+        out << ", \"min_ns\": " << (long long)r.min;
+        out << ", \"median_ns\": " << (long long)r.median;
+        out << ", \"mean_ns\": " << (long long)r.mean;
+        out << ", \"max_ns\": " << (long long)r.max;
+        out << ", \"stddev_ns\": " << (long long)r.stddev;
+        out << ", \"ns_per_op\": " << r.ns_per_op();
+
+        if(r.in_loop) {
+            out << ", \"adjusted_ns_per_op\": " << r.adjusted_ns_per_op;
+        }
+
+        out << ", \"ops_per_second\": " << (long long)(r.operations * 1e9 / r.median);
+        out << " }";
+    }
+
+    std::string string_field(std::string_view line, std::string_view key)
+    {
+        std::string pattern = "\"" + std::string(key) + "\": \"";
+        size_t start = line.find(pattern);
+
+        if(start == std::string_view::npos) {
+            return {};
+        }
+
+        start += pattern.size();
+
+        return std::string(line.substr(start, line.find('"', start) - start));
+    }
+
+    double number_field(std::string_view line, std::string_view key)
+    {
+        std::string pattern = "\"" + std::string(key) + "\": ";
+        size_t start = line.find(pattern);
+
+        if(start == std::string_view::npos) {
+            return 0;
+        }
+
+        return std::stod(std::string(line.substr(start + pattern.size())));
+    }
+
+    // The medians of a result written by write_result, by name
+    std::map<std::string, result> read_baseline(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+
+        if(!file) {
+            throw std::runtime_error("cannot open baseline " + path.string());
+        }
+
+        std::map<std::string, result> baseline;
+        std::string line;
+
+        while(std::getline(file, line)) {
+            std::string name = string_field(line, "name");
+
+            // The comparison of a previous run also has names
+            if(name.empty() || line.find("\"median_ns\"") == std::string::npos) {
+                continue;
+            }
+
+            result r;
+            r.name       = name;
+            r.suite      = string_field(line, "suite");
+            r.median     = number_field(line, "median_ns");
+            r.stddev     = number_field(line, "stddev_ns");
+            r.operations = (size_t)number_field(line, "operations");
+
+            baseline[name] = r;
+        }
+
+        return baseline;
+    }
+
+    // Writes the comparison and returns the number of regressions
+    size_t write_comparison(std::ostream& out, const std::vector<result>& results, const std::map<std::string, result>& baseline, double threshold)
+    {
+        size_t regressions = 0;
+        size_t i = 0;
+
+        out << "\t\"comparison\": [\n";
+
+        for(const auto& r : results) {
+            auto it = baseline.find(r.name);
+
+            if(it == baseline.end() || it->second.median == 0) {
+                continue;
+            }
+
+            // Compare per operation, so a baseline taken with another --scale still compares
+            double before = it->second.median / std::max<size_t>(it->second.operations, 1);
+            double after = r.ns_per_op();
+            double change = (after - before) / before * 100;
+
+            // A change within the noise of both runs is not reported
+            double noise = (it->second.stddev / std::max(it->second.median, 1.0) + r.stddev / r.median) * 100;
+
+            std::string status = "unchanged";
+
+            if(std::abs(change) > threshold && std::abs(change) > noise) {
+                status = change > 0 ? "regression" : "improvement";
+            }
+
+            regressions += status == "regression";
+
+            if(i++) {
+                out << ",\n";
+            }
+
+            out << "\t\t{ \"name\": \"" << r.name << "\", \"baseline_ns_per_op\": " << before << ", \"ns_per_op\": " << after;
+            out << ", \"change_percent\": " << change << ", \"status\": \"" << status << "\" }";
+        }
+
+        out << "\n\t],\n";
+        out << "\t\"regressions\": " << regressions << ",\n";
+
+        return regressions;
+    }
+};
+
+int main(int argc, char** argv)
+{
+    options o;
+
+    for(int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+
+        if(arg.starts_with("--suite=")) {
+            o.suite = arg.substr(8);
+        } else if(arg.starts_with("--filter=")) {
+            o.filter = arg.substr(9);
+        } else if(arg.starts_with("--samples=")) {
+            o.samples = std::stoul(std::string(arg.substr(10)));
+        } else if(arg.starts_with("--warmup=")) {
+            o.warmup = std::stoul(std::string(arg.substr(9)));
+        } else if(arg.starts_with("--scale=")) {
+            o.scale = std::stoul(std::string(arg.substr(8)));
+        } else if(arg.starts_with("--output=")) {
+            o.output = arg.substr(9);
+        } else if(arg.starts_with("--compare=")) {
+            o.compare = arg.substr(10);
+        } else if(arg.starts_with("--threshold=")) {
+            o.threshold = std::stod(std::string(arg.substr(12)));
+        } else {
+            std::cerr << "unknown option " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    if(o.samples == 0 || o.scale == 0) {
+        std::cerr << "--samples and --scale must be at least 1" << std::endl;
+        return 1;
+    }
+
+    if(o.suite != "micro" && o.suite != "macro" && o.suite != "all") {
+        std::cerr << "unknown suite " << o.suite << std::endl;
+        return 1;
+    }
+
+    try {
+        std::map<std::string, result> baseline;
+
+        if(!o.compare.empty()) {
+            baseline = read_baseline(o.compare);
+        }
+
+        std::vector<benchmark> benchmarks;
+
+        if(o.suite != "macro") {
+            benchmarks = micro_benchmarks(o.scale);
+        }
+
+        if(o.suite != "micro") {
+            for(auto& b : macro_benchmarks()) {
+                benchmarks.push_back(std::move(b));
+            }
+        }
+
+        std::vector<result> results;
+        double loop_ns_per_op = 0;
+
+        for(const auto& b : benchmarks) {
+            // The loop is the baseline of the others, it is always measured with them
+            if(!o.filter.empty() && b.name.find(o.filter) == std::string::npos && b.name != "loop") {
+                continue;
+            }
+
+            std::cerr << b.suite << "/" << b.name << "..." << std::flush;
+
+            result r = measure(b, o);
+
+            if(b.name == "loop") {
+                loop_ns_per_op = r.ns_per_op();
+            }
+
+            if(r.in_loop) {
+                r.adjusted_ns_per_op = std::max(r.ns_per_op() - loop_ns_per_op, 0.0);
+            }
+
+            std::cerr << " " << std::fixed << std::setprecision(2) << r.ns_per_op() << " ns/op" << std::endl;
+
+            results.push_back(std::move(r));
+        }
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2);
+
+        out << "{\n";
+        out << "\t\"benchmarks\": [\n";
+
+        for(size_t i = 0; i < results.size(); i++) {
+            write_result(out, results[i]);
+            out << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        out << "\t],\n";
+
+        size_t regressions = 0;
+
+        if(!o.compare.empty()) {
+            regressions = write_comparison(out, results, baseline, o.threshold);
+        }
+
+        out << "\t\"options\": { \"samples\": " << o.samples << ", \"warmup\": " << o.warmup << ", \"scale\": " << o.scale << " }\n";
+        out << "}\n";
+
+        if(o.output.empty()) {
+            std::cout << out.str();
+        } else {
+            std::ofstream file(o.output);
+            file << out.str();
+
+            if(!file) {
+                std::cerr << "cannot write " << o.output.string() << std::endl;
+                return 1;
+            }
+        }
+
+        return regressions ? 2 : 0;
+    } catch(const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -1,8 +1,17 @@
+#pragma once
+
 #include <filesystem>
+#include <map>
+#include <set>
 
 #include <andy/lang/lang.hpp>
 #include <andy/lang/interpreter.hpp>
+#include <andy/lang/preprocessor.hpp>
 #include <andy/lang/config.hpp>
+#include <andy/lang/profiler.hpp>
+#include <andy/lang/call_stats.hpp>
+#include <andy/lang/heap_stats.hpp>
+#include <andy/lang/timings.hpp>
 
 namespace andy
 {
@@ -10,10 +19,44 @@ namespace andy
     {
         namespace api
         {
+            /// @brief Options of how a program is loaded and executed.
+            struct options
+            {
+                /// @brief Discover the include graph first, then read, lex and parse the included files on a thread pool.
+                bool parallel_includes = false;
+                /// @brief The number of threads used by parallel_includes. 0 means one per hardware thread.
+                size_t jobs = 0;
+                /// @brief Load the parsed program from a .andyc file when it matches the sources, and write it otherwise.
+                /// A program which uses #compile is never written, its extensions are built on every run.
+                bool cache = false;
+                /// @brief Where the .andyc files are stored. If empty, they are stored next to the source.
+                std::filesystem::path cache_directory;
+                /// @brief Start from the state of an image instead of an empty interpreter: the functions, classes and
+                /// globals of the program which stored it. See andy::lang::image.
+                std::filesystem::path image;
+                /// @brief After the program is executed, store its functions, classes and globals in an image. Throws
+                /// for a program which uses #compile.
+                std::filesystem::path store_image;
+                /// @brief Where print and puts write. If null, they write to std::cout.
+                std::ostream* output = nullptr;
+                /// @brief Sample the call stack of the program while it runs. The profiler is started before the
+                /// program is executed and stopped after, its samples are kept.
+                andy::lang::profiler* profiler = nullptr;
+                /// @brief Count the calls of every method and the time spent in them.
+                andy::lang::call_stats* call_stats = nullptr;
+                /// @brief Count the objects alive per class and allocation site. It is started before the
+                /// interpreter is created and stopped after it is destroyed, what is alive then was leaked.
+                andy::lang::heap_stats* heap_stats = nullptr;
+                /// @brief Measure each phase of loading and running the program, and of each included file.
+                andy::lang::timings* timings = nullptr;
+                /// @brief The deepest calls can nest before the program throws. 0 keeps the default of the interpreter.
+                size_t max_depth = 0;
+            };
             /// @brief Executes the code in a file and return the result.
             /// @param path The path to the source code.
+            /// @param options How the program is loaded and executed.
             /// @return Returns a shared pointer to the object.
-            std::shared_ptr<andy::lang::object> evaluate(std::filesystem::path path);
+            std::shared_ptr<andy::lang::object> evaluate(std::filesystem::path path, const andy::lang::api::options& options = {});
             /// @brief Creates the object with a value and automatically determines the class.
             /// @tparam T The type of the value.
             /// @param interpreter The interpreter.
@@ -22,9 +65,9 @@ namespace andy
             template<typename T>
             inline std::shared_ptr<andy::lang::object> to_object(andy::lang::interpreter* interpreter, T value)
             {
-                if constexpr(std::is_same_v<T, int>) {
+                if constexpr(std::is_same_v<T, int> || std::is_same_v<T, long> || std::is_same_v<T, long long>) {
                     auto obj = std::make_shared<andy::lang::object>(interpreter->IntegerClass);
-                    obj->set_native<int>(value);
+                    obj->set_native<int64_t>((int64_t)value);
                     return obj;
                 } else if constexpr(std::is_same_v<T, std::string>) {
                     auto obj = std::make_shared<andy::lang::object>(interpreter->StringClass);
@@ -38,8 +81,97 @@ namespace andy
                     auto obj = std::make_shared<andy::lang::object>(interpreter->DoubleClass);
                     obj->set_native<double>(value);
                     return obj;
+                } else if constexpr(std::is_same_v<T, bool>) {
+                    return std::make_shared<andy::lang::object>(value ? interpreter->TrueClass : interpreter->FalseClass);
+                } else if constexpr(std::is_same_v<T, const char*>) {
+                    return to_object(interpreter, std::string(value));
+                } else if constexpr(std::is_same_v<T, std::shared_ptr<andy::lang::object>>) {
+                    return value;
+                } else {
+                    static_assert(!sizeof(T), "to_object: no andy class for this type");
                 }
             }
+            /// @brief A program lexed, preprocessed and parsed once, which an engine can run many times.
+            class program
+            {
+            public:
+                /// @brief Lex, preprocess and parse a program.
+                /// @param __name The file name of the program. Its includes are relative to it.
+                /// @param __source The source code.
+                program(std::string __name, std::string __source);
+                program(const program&) = delete;
+            public:
+                const std::string& name() const { return m_name; }
+                /// @brief The classes declared at the top of the program. An engine declares them once.
+                const andy::lang::parser::ast_node& declarations() const { return m_declarations; }
+                /// @brief Everything else, executed on every run.
+                const andy::lang::parser::ast_node& statements() const { return m_statements; }
+            protected:
+                std::string m_name;
+                std::string m_source;
+                // Own the sources the syntax tree points into
+                andy::lang::lexer m_lexer;
+                andy::lang::preprocessor m_preprocessor;
+                andy::lang::parser::ast_node m_declarations;
+                andy::lang::parser::ast_node m_statements;
+            };
+            /// @brief The global variables a run starts with, by name.
+            using bindings = std::map<std::string, std::shared_ptr<andy::lang::object>>;
+            // An interpreter kept alive to run programs again and again, for applications which embed andy.
+            // The builtin classes are created once, with the engine. A program is compiled once, its classes
+            // are declared the first time it runs and every run starts from empty globals, so a run only
+            // costs its statements. The engine keeps every program it ran alive, their classes point into
+            // them, until it is unloaded. The programs of an engine share its classes: a program cannot
+            // declare a class another loaded program declares.
+            class engine
+            {
+            public:
+                engine();
+                engine(const engine&) = delete;
+            public:
+                /// @brief Compile a source file.
+                std::shared_ptr<andy::lang::api::program> compile(const std::filesystem::path& __path);
+                /// @brief Compile source code. The name is the file name of errors and includes.
+                std::shared_ptr<andy::lang::api::program> compile_source(std::string __source, std::string __name = "<source>");
+                /// @brief Run a program from empty globals. The functions and globals it declares stay until the next run.
+                /// @param __bindings Set as global variables before the program runs.
+                /// @return What the program returned, or null.
+                /// Throws if the program declares a class which already exists.
+                std::shared_ptr<andy::lang::object> run(const std::shared_ptr<andy::lang::api::program>& __program, const andy::lang::api::bindings& __bindings = {});
+                /// @brief Forget a program: its classes are removed and the engine no longer keeps it alive. If it ran
+                /// last, its functions and globals are forgotten too. Objects of its classes must not be used after.
+                /// Running it again declares its classes again.
+                void unload(const std::shared_ptr<andy::lang::api::program>& __program);
+                /// @brief Call a function declared by the last run, converting the arguments with to_object.
+                template<typename... Args>
+                std::shared_ptr<andy::lang::object> call(std::string_view __function, Args... __args)
+                {
+                    return call_function(__function, { to_object(&m_interpreter, std::move(__args))... });
+                }
+                /// @brief Call a function declared by the last run.
+                std::shared_ptr<andy::lang::object> call_function(std::string_view __function, std::vector<std::shared_ptr<andy::lang::object>> __args);
+                /// @brief Convert a value to an object of this engine, see to_object.
+                template<typename T>
+                std::shared_ptr<andy::lang::object> make(T __value)
+                {
+                    return to_object(&m_interpreter, std::move(__value));
+                }
+                andy::lang::interpreter& interpreter() { return m_interpreter; }
+            protected:
+                andy::lang::interpreter m_interpreter;
+                // A program which ran and the classes it declared
+                struct loaded_program
+                {
+                    std::shared_ptr<andy::lang::api::program> program;
+                    std::vector<std::shared_ptr<andy::lang::structure>> classes;
+                };
+
+                std::map<const andy::lang::api::program*, loaded_program> m_programs;
+                // The functions and globals of the interpreter point into the program which ran last
+                const andy::lang::api::program* m_last = nullptr;
+                // The variables of the interpreter are keyed by views, the names of the bindings live here
+                std::set<std::string, std::less<>> m_names;
+            };
         };
     };
 };
\ No newline at end of file
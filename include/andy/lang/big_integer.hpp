@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace andy
+{
+    namespace lang
+    {
+        /// @brief Add two integers, returning false instead when the sum does not fit in 64 bits.
+        inline bool checked_add(int64_t __a, int64_t __b, int64_t& __result)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_add_overflow(__a, __b, &__result);
+#else
+            if((__b > 0 && __a > INT64_MAX - __b) || (__b < 0 && __a < INT64_MIN - __b)) {
+                return false;
+            }
+
+            __result = __a + __b;
+            return true;
+#endif
+        }
+        /// @brief Subtract two integers, returning false instead when the difference does not fit in 64 bits.
+        inline bool checked_sub(int64_t __a, int64_t __b, int64_t& __result)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_sub_overflow(__a, __b, &__result);
+#else
+            if((__b < 0 && __a > INT64_MAX + __b) || (__b > 0 && __a < INT64_MIN + __b)) {
+                return false;
+            }
+
+            __result = __a - __b;
+            return true;
+#endif
+        }
+        /// @brief Multiply two integers, returning false instead when the product does not fit in 64 bits.
+        inline bool checked_mul(int64_t __a, int64_t __b, int64_t& __result)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return !__builtin_mul_overflow(__a, __b, &__result);
+#else
+            if(__a == 0 || __b == 0) {
+                __result = 0;
+                return true;
+            }
+
+            if((__a == -1 && __b == INT64_MIN) || (__b == -1 && __a == INT64_MIN)) {
+                return false;
+            }
+
+            int64_t product = (int64_t)((uint64_t)__a * (uint64_t)__b);
+
+            if(product / __b != __a) {
+                return false;
+            }
+
+            __result = product;
+            return true;
+#endif
+        }
+
+        // An integer of any size. An Integer whose result does not fit in 64 bits becomes a BigInteger holding
+        // one, and a BigInteger whose result fits becomes an Integer again: a big_integer is never used for a
+        // value an int64_t can hold, outside of the computations.
+        //
+        // The magnitude is stored in limbs of 32 bits, the least significant first, without leading zero limbs:
+        // zero has none, and is never negative.
+        class big_integer
+        {
+        public:
+            big_integer() = default;
+            big_integer(int64_t __value);
+        public:
+            /// @brief Operands of at least this many limbs are multiplied with the Karatsuba method, whose cost
+            /// grows as n^1.58 instead of n^2. Below, the schoolbook method is faster.
+            static constexpr size_t karatsuba_threshold = 48;
+
+            /// @brief Parse a decimal integer, with an optional sign. Throws if the text is not one.
+            static big_integer parse(std::string_view __text);
+
+            /// @brief Whether the value fits in an int64_t, which to_int64 returns.
+            bool fits_int64() const;
+            int64_t to_int64() const;
+            /// @brief The nearest double, which loses the least significant digits of a large value.
+            double to_double() const;
+            /// @brief The decimal representation.
+            std::string to_string() const;
+
+            bool is_zero() const { return m_limbs.empty(); }
+            bool is_negative() const { return m_negative; }
+
+            /// @brief Less than 0, 0 or more than 0 as the value is less than, equal to or greater than __other.
+            int compare(const big_integer& __other) const;
+        public:
+            big_integer operator-() const;
+            big_integer operator+(const big_integer& __other) const;
+            big_integer operator-(const big_integer& __other) const;
+            big_integer operator*(const big_integer& __other) const;
+            /// @brief The quotient truncated toward zero, like the one of two Integers. Throws on a division by zero.
+            big_integer operator/(const big_integer& __other) const;
+            /// @brief The remainder, which has the sign of the dividend, like the one of two Integers.
+            big_integer operator%(const big_integer& __other) const;
+
+            bool operator==(const big_integer& __other) const { return m_negative == __other.m_negative && m_limbs == __other.m_limbs; }
+            bool operator!=(const big_integer& __other) const { return !(*this == __other); }
+            bool operator<(const big_integer& __other) const { return compare(__other) < 0; }
+            bool operator>(const big_integer& __other) const { return compare(__other) > 0; }
+        protected:
+            using limbs = std::vector<uint32_t>;
+
+            limbs m_limbs;
+            bool m_negative = false;
+
+            big_integer(limbs __limbs, bool __negative);
+
+            // The operations on magnitudes, which ignore the signs
+            static int compare_magnitudes(const limbs& __a, const limbs& __b);
+            static limbs add_magnitudes(const limbs& __a, const limbs& __b);
+            // __a must not be less than __b
+            static limbs sub_magnitudes(const limbs& __a, const limbs& __b);
+            static limbs multiply_magnitudes(const limbs& __a, const limbs& __b);
+            static void divide_magnitudes(const limbs& __a, const limbs& __b, limbs* __quotient, limbs* __remainder);
+            static void trim(limbs& __value);
+        };
+    };
+};
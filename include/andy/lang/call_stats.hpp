@@ -0,0 +1,101 @@
+#pragma once
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace andy
+{
+    namespace lang
+    {
+        class method;
+        class structure;
+        // Counts the calls of every method and the time spent in them. interpreter::call enters and leaves
+        // the method of each call, whether it comes from an andy function call or from native code.
+        //
+        // The hook is compiled only with ANDY_CALL_STATS (the ENABLE_CALL_STATS option of CMake), without
+        // it interpreter::call has no trace of the counters.
+        class call_stats
+        {
+        public:
+            /// @brief The counters of one method.
+            struct entry
+            {
+                /// @brief The class of the method, empty for a global function.
+                std::string cls;
+                std::string method;
+                /// @brief The method is implemented in C++.
+                bool native = false;
+                size_t calls = 0;
+                /// @brief The time from the call to the return. Recursive calls are counted once.
+                std::chrono::nanoseconds inclusive{0};
+                /// @brief The inclusive time without the time of the methods it called.
+                std::chrono::nanoseconds exclusive{0};
+            };
+        public:
+            call_stats() = default;
+            call_stats(const call_stats&) = delete;
+        public:
+            /// @brief A method is called. Used by interpreter::call.
+            void enter(const andy::lang::method& __method, const andy::lang::structure* __cls);
+            /// @brief The last method entered returns.
+            void leave();
+        public:
+            /// @brief The counters of the methods called, the longest exclusive time first. Methods with
+            /// the same class and name are merged.
+            std::vector<entry> entries() const;
+            /// @brief Write a table of the entries, followed by the time spent in native and andy methods.
+            void write_report(std::ostream& __out) const;
+            /// @brief Write the entries as JSON.
+            void write_json(std::ostream& __out) const;
+        public:
+            /// @brief Calls enter and leave around a call. Does nothing without counters.
+            class scope
+            {
+            public:
+                scope(andy::lang::call_stats* __stats, const andy::lang::method& __method, const andy::lang::structure* __cls)
+                    : m_stats(__stats)
+                {
+                    if(m_stats) {
+                        m_stats->enter(__method, __cls);
+                    }
+                }
+                scope(const scope&) = delete;
+                ~scope()
+                {
+                    if(m_stats) {
+                        m_stats->leave();
+                    }
+                }
+            protected:
+                andy::lang::call_stats* m_stats;
+            };
+        protected:
+            struct key
+            {
+                const void* method;
+                const andy::lang::structure* cls;
+
+                bool operator==(const key& other) const { return method == other.method && cls == other.cls; }
+            };
+            struct key_hash
+            {
+                size_t operator()(const key& k) const { return std::hash<const void*>()(k.method) * 31 + std::hash<const void*>()(k.cls); }
+            };
+            struct frame
+            {
+                size_t slot;
+                std::chrono::steady_clock::time_point start;
+                std::chrono::nanoseconds children;
+            };
+        protected:
+            std::vector<entry> m_entries;
+            /// @brief The number of calls of each entry which have not returned, to count recursion once.
+            std::vector<size_t> m_active;
+            std::unordered_map<key, size_t, key_hash> m_slots;
+            std::vector<frame> m_stack;
+        };
+    };
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A bounded queue between exactly one producer thread and one consumer thread. Pushing and popping
+        // only use atomics, no lock. When the queue is full the producer waits, when it is empty the consumer
+        // waits, both on an atomic counter the other side bumps (a futex on Linux), so an idle side does not
+        // spin. Closing wakes both sides: the producer stops, the consumer drains what is left.
+        template<typename T>
+        class channel
+        {
+        public:
+            /// @brief Create a channel.
+            /// @param __capacity How many values can wait in the channel before push waits.
+            explicit channel(size_t __capacity)
+                : m_slots(__capacity ? __capacity : 1)
+            {
+            }
+            channel(const channel&) = delete;
+        public:
+            /// @brief Add a value at the end of the channel, waiting while it is full. Only the producer thread calls it.
+            /// @return False if the channel is closed, the value is dropped.
+            bool push(T __value)
+            {
+                uint64_t tail = m_tail.load(std::memory_order_relaxed);
+
+                while(true) {
+                    // Read the counter before the state, a pop after it changes the counter and wait returns
+                    uint32_t signal = m_to_producer.load(std::memory_order_acquire);
+
+                    if(m_closed.load(std::memory_order_acquire)) {
+                        return false;
+                    }
+
+                    if(tail - m_head.load(std::memory_order_acquire) < m_slots.size()) {
+                        break;
+                    }
+
+                    m_to_producer.wait(signal, std::memory_order_acquire);
+                }
+
+                m_slots[tail % m_slots.size()] = std::move(__value);
+                m_tail.store(tail + 1, std::memory_order_release);
+
+                m_to_consumer.fetch_add(1, std::memory_order_release);
+                m_to_consumer.notify_one();
+
+                return true;
+            }
+            /// @brief Remove the value at the front of the channel, waiting while it is empty. Only the consumer thread calls it.
+            /// @return The value, or nothing if the channel is closed and empty.
+            std::optional<T> pop()
+            {
+                uint64_t head = m_head.load(std::memory_order_relaxed);
+
+                while(true) {
+                    uint32_t signal = m_to_consumer.load(std::memory_order_acquire);
+
+                    if(m_tail.load(std::memory_order_acquire) != head) {
+                        break;
+                    }
+
+                    if(m_closed.load(std::memory_order_acquire)) {
+                        return std::nullopt;
+                    }
+
+                    m_to_consumer.wait(signal, std::memory_order_acquire);
+                }
+
+                T value = std::move(m_slots[head % m_slots.size()]);
+                m_head.store(head + 1, std::memory_order_release);
+
+                m_to_producer.fetch_add(1, std::memory_order_release);
+                m_to_producer.notify_one();
+
+                return value;
+            }
+            /// @brief Stop the channel. Any thread can call it.
+            void close()
+            {
+                m_closed.store(true, std::memory_order_release);
+
+                m_to_consumer.fetch_add(1, std::memory_order_release);
+                m_to_consumer.notify_all();
+                m_to_producer.fetch_add(1, std::memory_order_release);
+                m_to_producer.notify_all();
+            }
+            bool closed() const { return m_closed.load(std::memory_order_acquire); }
+            size_t capacity() const { return m_slots.size(); }
+        protected:
+            std::vector<T> m_slots;
+            // The number of values popped and pushed so far, on their own cache lines
+            alignas(64) std::atomic<uint64_t> m_head = 0;
+            alignas(64) std::atomic<uint64_t> m_tail = 0;
+            alignas(64) std::atomic<uint32_t> m_to_consumer = 0;
+            alignas(64) std::atomic<uint32_t> m_to_producer = 0;
+            std::atomic<bool> m_closed = false;
+        };
+    };
+};
@@ -33,6 +33,10 @@ namespace andy {
 
             var(*object_to_var)(std::shared_ptr<const andy::lang::object> obj) = nullptr;
 
+            /// @brief The declaration of a class of a program, null for the builtin classes. Another interpreter can
+            /// declare the same class from it.
+            const andy::lang::parser::ast_node* declaration = nullptr;
+
             // std::shared_ptr<andy::lang::object> call(const andy::lang::method& method, const var& params= null);
             // std::shared_ptr<andy::lang::object> call(const std::string& method, const var& params = null)
             // {
@@ -40,6 +44,9 @@ namespace andy {
             // }
         public:
             static void create_structures(andy::lang::interpreter* interpreter);
+            /// @brief Create and load a builtin class which is not created with the interpreter, like File.
+            /// @return The class, or nullptr if no such builtin class exists or it was already created.
+            static std::shared_ptr<andy::lang::structure> create_lazy_structure(andy::lang::interpreter* interpreter, std::string_view name);
         };
     };
 };
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A function which can suspend itself and be resumed later where it stopped. It runs on a stack of its own,
+        // so the interpreter frames it is in the middle of stay where they are while it is suspended: nothing is
+        // copied when it suspends or resumes. Generators and fibers are built on it.
+        //
+        // A coroutine belongs to the thread which created it. An exception thrown by the function is rethrown by
+        // resume. A coroutine destroyed while it is suspended is unwound first, so the objects on its stack are freed.
+        class coroutine
+        {
+        public:
+            /// @brief The stack of a coroutine. Its memory is reserved, not committed: the pages which are not used cost nothing.
+            static constexpr size_t default_stack_size = 1024 * 1024;
+
+            coroutine(std::function<void()> __function, size_t __stack_size = default_stack_size);
+            ~coroutine();
+
+            coroutine(const coroutine&) = delete;
+            coroutine& operator=(const coroutine&) = delete;
+        public:
+            /// @brief Run the function until it suspends or returns.
+            void resume();
+            /// @brief Go back to where the running coroutine was resumed. Must be called from inside a coroutine.
+            static void suspend();
+            /// @brief The coroutine running on this thread, null outside of a coroutine.
+            static coroutine* current();
+            /// @brief Whether the function has returned.
+            bool done() const { return m_done; }
+            /// @brief Whether less than __needed bytes are left on the stack the thread runs on, be it the one of the
+            /// thread, of a coroutine or a segment.
+            static bool stack_low(size_t __needed);
+            /// @brief Call a function on a stack segment of its own, freed when the function returns. It is not a
+            /// coroutine: a coroutine the function runs in suspends with the segment. Recursion continues on a new
+            /// segment when the stack is low, instead of overflowing it.
+            static void on_new_stack(size_t __size, const std::function<void()>& __function);
+        private:
+            struct context;
+            // Thrown by suspend inside a coroutine which is destroyed, it unwinds the stack of the coroutine.
+            struct cancelled {};
+
+            static void entry();
+
+            std::function<void()> m_function;
+            context* m_context = nullptr;
+            coroutine* m_resumer = nullptr;
+            std::exception_ptr m_exception;
+            bool m_started = false;
+            bool m_done = false;
+            bool m_cancelled = false;
+            // The lowest address of the stack the coroutine runs on, which is a segment while it runs on one
+            const char* m_stack_limit = nullptr;
+        };
+    };
+};
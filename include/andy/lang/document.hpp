@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <andy/lang/lexer.hpp>
+#include <andy/lang/parser.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A source file kept in memory by an editor session. An edit re-lexes only the damaged region and
+        // re-parses only the top-level declarations it touches. The tokens and declarations before and after
+        // the damage are kept, only their positions are moved.
+        class document
+        {
+        public:
+            /// @brief A top-level statement of the file and the tokens it was parsed from.
+            struct declaration
+            {
+                size_t first_token;
+                size_t token_count;
+                andy::lang::parser::ast_node node;
+            };
+            /// @brief What the last update did and how long it took.
+            struct update_stats
+            {
+                size_t lexed_tokens = 0;
+                size_t parsed_declarations = 0;
+                size_t reused_declarations = 0;
+                bool includes_reloaded = false;
+                std::chrono::nanoseconds lex_time = std::chrono::nanoseconds(0);
+                std::chrono::nanoseconds parse_time = std::chrono::nanoseconds(0);
+            };
+        public:
+            /// @brief Open a document. The whole source is lexed and parsed.
+            /// @param __file_name The path of the file. Relative includes are resolved from it.
+            /// @param __source The current content of the file, which may not be saved yet.
+            document(std::string __file_name, std::string __source);
+            document(const document&) = delete;
+            ~document() = default;
+        public:
+            /// @brief Replace a range of the source.
+            /// @param __offset The byte offset where the edit starts.
+            /// @param __removed The number of bytes removed.
+            /// @param __inserted The text inserted at __offset.
+            /// @return What was re-lexed and re-parsed.
+            const update_stats& edit(size_t __offset, size_t __removed, std::string_view __inserted);
+        public:
+            std::string_view file_name() const { return m_file_name; }
+            std::string_view source() const { return m_source; }
+            /// @brief The tokens of the file, without the included files.
+            const andy::lang::lexer& lexer() const { return m_lexer; }
+            /// @brief The tokens of the included files.
+            const andy::lang::lexer& included() const { return m_included; }
+            /// @brief The syntax tree of the included files.
+            const andy::lang::parser::ast_node& included_root() const { return m_included_root; }
+            /// @brief The top-level declarations, in order. Parsing stops at the first syntax error.
+            const std::vector<declaration>& declarations() const { return m_declarations; }
+            /// @brief The lexer, preprocessor or syntax error, empty if there is none.
+            const std::string& error() const { return m_lexer_failed || m_includes_error.empty() ? m_error : m_includes_error; }
+            const update_stats& stats() const { return m_stats; }
+        protected:
+            /// @brief Lex and parse everything again.
+            void reload();
+            /// @brief Run the preprocessor over the file and keep the tokens and declarations of the included files.
+            void load_includes();
+            /// @brief Parse declarations from a token until the end of the file or until a declaration of __reusable starts.
+            /// @param __first_token The token to start from.
+            /// @param __damage_end Declarations are not reused before this token.
+            /// @param __reusable Declarations parsed before the edit. Their tokens are already shifted by __token_delta.
+            /// @return The parsed declarations followed by the reused ones.
+            std::vector<declaration> parse(size_t __first_token, size_t __damage_end, std::vector<declaration> __reusable, ptrdiff_t __token_delta);
+        protected:
+            std::string m_file_name;
+            std::string m_source;
+            andy::lang::lexer m_lexer;
+            andy::lang::lexer m_included;
+            andy::lang::parser::ast_node m_included_root;
+            std::vector<declaration> m_declarations;
+            std::string m_error;
+            std::string m_includes_error;
+            bool m_lexer_failed = false;
+            update_stats m_stats;
+        };
+    };
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace andy
+{
+    namespace lang
+    {
+        // The asynchronous I/O of an interpreter: file reads and writes, child processes, timers and local
+        // TCP and UNIX sockets. An operation starts when it is created and completes while the loop runs, which
+        // it does when the program waits for an operation. Many operations are then in flight at once, the
+        // loop blocks only when none of them can progress.
+        //
+        // The loop is an epoll set on Linux. Sockets and pipes are non-blocking and watched by it, timers
+        // are kept sorted and bound the wait, and a child process is watched through a pidfd. Regular files
+        // cannot be watched, they are always ready, so they are read and written by a few threads of the loop,
+        // which wake it up with an eventfd when they are done. Every other part of an operation runs on the
+        // thread of the interpreter. The loop is not available on other platforms.
+        class event_loop
+        {
+        public:
+            // A socket, closed when the last reference to it goes away. The operations on a socket keep it alive.
+            class socket
+            {
+            public:
+                explicit socket(int __fd, int __port = 0, std::filesystem::path __unix_path = {});
+                socket(const socket&) = delete;
+                ~socket();
+            public:
+                int fd() const { return m_fd; }
+                /// @brief The port a TCP socket listens on.
+                int port() const { return m_port; }
+                /// @brief Shut the socket down: the operations in flight on it complete, with an empty string or an
+                /// error. It is closed when the last reference goes away.
+                void shutdown();
+            protected:
+                int m_fd;
+                int m_port;
+                // A UNIX socket which listens removes its file when closed
+                std::filesystem::path m_unix_path;
+            };
+            struct operation
+            {
+                enum class kind
+                {
+                    read_file,
+                    write_file,
+                    process,
+                    timer,
+                    accept,
+                    connect,
+                    receive,
+                    send,
+                };
+
+                kind type;
+                bool done = false;
+                /// @brief Why the operation failed. Empty if it succeeded.
+                std::string error;
+                /// @brief What was read: the file, the output of the process or the bytes received.
+                std::string data;
+                /// @brief The bytes written or sent, or the exit code of the process.
+                int64_t value = 0;
+                /// @brief The connection accepted or connected.
+                std::shared_ptr<andy::lang::event_loop::socket> connection;
+                /// @brief Called on the thread of the interpreter when the operation completes.
+                std::function<void()> on_done;
+
+                operation(kind __type) : type(__type) {}
+            protected:
+                friend class event_loop;
+                // The socket the operation is on
+                std::shared_ptr<andy::lang::event_loop::socket> m_socket;
+                // What is left to write
+                std::string m_pending;
+                size_t m_offset = 0;
+                int m_fd = -1;
+                int m_input_fd = -1;
+                int m_exit_fd = -1;
+                int m_pid = -1;
+                // The parts of a process which are not finished: its output, its input and its exit
+                int m_open_parts = 0;
+            };
+            using handle = std::shared_ptr<andy::lang::event_loop::operation>;
+        public:
+            event_loop();
+            event_loop(const event_loop&) = delete;
+            ~event_loop();
+        public:
+            handle read_file(std::filesystem::path __path);
+            handle write_file(std::filesystem::path __path, std::string __content);
+            /// @brief Run a command with /bin/sh, write the input to it and read its output.
+            handle run_process(const std::string& __command, std::string __input, const std::filesystem::path& __working_directory);
+            handle timer(std::chrono::milliseconds __delay);
+            /// @brief Accept a connection on a listening socket.
+            handle accept(std::shared_ptr<andy::lang::event_loop::socket> __listener);
+            /// @brief Connect to a TCP port of 127.0.0.1.
+            handle connect_tcp(int __port);
+            /// @brief Connect to a UNIX socket.
+            handle connect_unix(const std::filesystem::path& __path);
+            /// @brief Receive what is available on a connection, or an empty string once it is closed.
+            handle receive(std::shared_ptr<andy::lang::event_loop::socket> __socket);
+            /// @brief Send all of the data on a connection.
+            handle send(std::shared_ptr<andy::lang::event_loop::socket> __socket, std::string __data);
+            /// @brief Listen on a TCP port of 127.0.0.1. Port 0 picks a free port.
+            static std::shared_ptr<andy::lang::event_loop::socket> listen_tcp(int __port);
+            static std::shared_ptr<andy::lang::event_loop::socket> listen_unix(const std::filesystem::path& __path);
+        public:
+            /// @brief Run the loop until the operation is done.
+            void wait(const handle& __operation);
+            /// @brief Run the loop until no operation is in flight.
+            void run();
+            /// @brief Complete what is ready without blocking.
+            void poll();
+            /// @brief Wait for events, up to the next timer if it blocks, and handle them.
+            void run_once(bool __block);
+            /// @brief The number of operations in flight.
+            size_t pending() const { return m_pending; }
+        protected:
+            struct watch
+            {
+                handle reader;
+                handle writer;
+                uint32_t events = 0;
+            };
+        protected:
+            void watch_reader(int __fd, handle __operation);
+            void watch_writer(int __fd, handle __operation);
+            void unwatch_reader(int __fd);
+            void unwatch_writer(int __fd);
+            void update(int __fd);
+            void on_readable(int __fd, handle __operation);
+            void on_writable(int __fd, handle __operation);
+            void finish_part(const handle& __operation);
+            void complete(const handle& __operation, std::string __error = {});
+            handle start_connect(int __fd, const void* __address, size_t __length);
+            void close_descriptors(andy::lang::event_loop::operation& __operation);
+            // Run a job on the file threads, the operation completes on the loop thread after it
+            void submit(handle __operation, std::function<void(andy::lang::event_loop::operation&)> __job);
+            void file_thread();
+        protected:
+            int m_epoll = -1;
+            int m_wakeup = -1;
+            size_t m_pending = 0;
+            std::unordered_map<int, watch> m_watches;
+            std::multimap<std::chrono::steady_clock::time_point, handle> m_timers;
+            // The file threads: jobs go in, finished operations come out
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            std::deque<std::pair<handle, std::function<void(andy::lang::event_loop::operation&)>>> m_jobs;
+            std::vector<handle> m_finished;
+            std::vector<std::thread> m_file_threads;
+            size_t m_busy_threads = 0;
+            bool m_stopping = false;
+        };
+    };
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <andy/lang/coroutine.hpp>
+#include <andy/lang/interpreter.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        // The state of a call to a function which yields. Calling such a function does not run it, it creates
+        // a Generator object. Each value asked to the generator runs the function until its next yield, in a
+        // coroutine: the interpreter frames of the function stay on the stack of the coroutine while it is suspended.
+        //
+        // The interpreter contexts of the function live here between the values. Resuming swaps them with the
+        // ones of the interpreter, so the caller does not see them and they are never copied.
+        class generator
+        {
+        public:
+            /// @brief Create the Generator object of a call. Called by interpreter::call instead of running the function.
+            /// @param __context The context of the call, with the parameters of the function.
+            static std::shared_ptr<andy::lang::object> create(andy::lang::interpreter* __interpreter, std::shared_ptr<andy::lang::object> __self, const andy::lang::method& __method, andy::lang::interpreter_context&& __context);
+
+            generator(andy::lang::interpreter* __interpreter, std::shared_ptr<andy::lang::object> __self, const andy::lang::parser::ast_node* __block, andy::lang::interpreter_context __context);
+            generator(const generator&) = delete;
+        public:
+            /// @brief Run the function until its next yield.
+            /// @return The value it yields, nothing once the function returned.
+            std::optional<std::shared_ptr<andy::lang::object>> next();
+            /// @brief Whether the function returned. It runs until its next yield to know it.
+            bool done();
+            /// @brief Hand a value to what asked for it and wait to be asked for the next one. Called by the yield statement.
+            void yield(std::shared_ptr<andy::lang::object> __value);
+        protected:
+            // Swap the contexts of the function with the ones of the interpreter, which are kept here meanwhile
+            void swap_contexts();
+        protected:
+            andy::lang::interpreter* m_interpreter;
+            std::shared_ptr<andy::lang::object> m_self;
+            const andy::lang::parser::ast_node* m_block;
+            andy::lang::interpreter_context m_context;
+            std::deque<andy::lang::interpreter_context> m_stack;
+            andy::lang::generator* m_resumer = nullptr;
+            // A value yielded but not asked for yet, when done had to run the function to find it
+            std::optional<std::shared_ptr<andy::lang::object>> m_value;
+            andy::lang::coroutine m_coroutine;
+        };
+    };
+};
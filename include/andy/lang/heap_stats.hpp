@@ -0,0 +1,110 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <andy/lang/lexer.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        class object;
+        class structure;
+        // Counts the objects alive, per class and per allocation site, while it is started. The objects
+        // report themselves: the constructor and destructor of andy::lang::object find the heap_stats of
+        // their thread through current(), and an object keeps the tag of its site and its bytes, so
+        // nothing is looked up per object. The interpreter moves the allocation site as it executes,
+        // every statement and every node_to_object, so an object is attributed to the source which
+        // created it, including objects instantiated by native methods.
+        //
+        // The bytes of an object are its own size, its native value when it does not fit in the object
+        // and its instance variables. Memory owned by the native value, like the characters of a long
+        // string, is not counted.
+        class heap_stats
+        {
+        public:
+            /// @brief The objects of a class, or of a class at an allocation site.
+            struct entry
+            {
+                std::string cls;
+                /// @brief "file:line" of the allocation, empty for the counters of a class.
+                std::string site;
+                size_t objects = 0;
+                size_t bytes = 0;
+                size_t allocated_objects = 0;
+                size_t allocated_bytes = 0;
+            };
+            /// @brief The estimated size of an instance variable, the node of the map which holds it.
+            static constexpr size_t instance_variable_bytes = 64;
+        public:
+            heap_stats();
+            heap_stats(const heap_stats&) = delete;
+            ~heap_stats();
+        public:
+            /// @brief Count the objects created from now on, on this thread.
+            void start();
+            /// @brief Stop counting. Objects destroyed after are still counted as alive.
+            void stop();
+            /// @brief The heap_stats started on this thread, if any.
+            static heap_stats* current() { return s_current; }
+        public:
+            /// @brief The objects created from now on are allocated at __token. Tokens without a file are ignored.
+            void at(const andy::lang::lexer::token& __token)
+            {
+                if(!__token.m_file_name.empty()) {
+                    m_position = &__token;
+                }
+            }
+            /// @brief An object of __cls is constructed at the current site, with the size of an object.
+            /// @return The tag of the site, which the object passes to grew and freed. Never 0.
+            uint32_t allocated(const andy::lang::structure* __cls);
+            /// @brief An object holds __bytes more.
+            void grew(uint32_t __tag, size_t __bytes);
+            /// @brief An object which holds __bytes is destroyed. Objects of another heap_stats are ignored.
+            void freed(uint32_t __tag, size_t __bytes);
+        public:
+            size_t live_objects() const { return m_live_objects; }
+            size_t live_bytes() const { return m_live_bytes; }
+            size_t peak_bytes() const { return m_peak_bytes; }
+            /// @brief The counters of every class, the most bytes alive first.
+            std::vector<entry> classes() const;
+            /// @brief The counters of every allocation site, the most bytes allocated first.
+            std::vector<entry> sites() const;
+            /// @brief Write the classes and the top allocation sites as tables.
+            void write_report(std::ostream& __out) const;
+            /// @brief Write the totals, the classes and the allocation sites as JSON.
+            void write_snapshot(std::ostream& __out) const;
+        protected:
+            /// @brief The site of a tag, or -1 if the tag is not of this heap_stats.
+            size_t site_of_tag(uint32_t __tag) const;
+            uint32_t site_of(uint32_t __cls);
+        protected:
+            static thread_local heap_stats* s_current;
+
+            bool m_running = false;
+            const andy::lang::lexer::token* m_position = nullptr;
+
+            /// @brief The high byte of the tags, tells the objects of two heap_stats apart.
+            uint32_t m_generation;
+            std::vector<entry> m_classes;
+            std::unordered_map<const andy::lang::structure*, uint32_t> m_class_ids;
+            std::vector<entry> m_sites;
+            std::vector<uint32_t> m_site_classes;
+            /// @brief The site of a token, several tokens of a line share it.
+            std::map<std::pair<const andy::lang::lexer::token*, uint32_t>, uint32_t> m_site_ids;
+            std::map<std::pair<std::string, uint32_t>, uint32_t> m_site_names;
+            /// @brief The last site found, a statement often allocates several objects of a class.
+            const andy::lang::lexer::token* m_last_position = nullptr;
+            const andy::lang::structure* m_last_cls = nullptr;
+            uint32_t m_last_site = 0;
+
+            size_t m_live_objects = 0;
+            size_t m_live_bytes = 0;
+            size_t m_peak_bytes = 0;
+        };
+    };
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+#include <vector>
+
+#include <andy/lang/module_cache.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        class interpreter;
+        // The state of a program after it ran, stored so another process starts from it instead of running
+        // the program again. An image is a module cache of the boot program which also holds its global
+        // variables: the objects they reference are stored as a graph, so shared objects and cycles survive.
+        //
+        // Restoring an image declares the functions and classes of the boot program from its mapped syntax
+        // tree and rebuilds its globals, no statement of the boot program is executed. The builtin classes
+        // are still created by the interpreter, their native methods cannot be stored. Only null, booleans,
+        // numbers, strings, arrays, dictionaries, classes and instances of the classes of the program can
+        // be stored. The image is invalid once a source of the boot program changes.
+        class image
+        {
+        public:
+            /// @brief Construct an image.
+            /// @param __path The path of the image file.
+            image(std::filesystem::path __path);
+            image(const image&) = delete;
+        public:
+            /// @brief Store the globals of an interpreter which executed a program.
+            /// @param __root The program, as executed.
+            /// @param __dependencies The root file followed by every included file.
+            /// @param __interpreter The interpreter, after the program returned.
+            /// @throw std::runtime_error If a global references an object which cannot be stored, or the image cannot be written.
+            void store(const andy::lang::parser::ast_node& __root, const std::vector<andy::lang::module_cache::dependency>& __dependencies, andy::lang::interpreter& __interpreter);
+            /// @brief Map the image. The image must outlive the interpreters it is restored into.
+            /// @return Whether the image exists, was written by this interpreter version and matches all sources.
+            bool load();
+            /// @brief Declare the functions and classes of the boot program and set its globals.
+            void restore(andy::lang::interpreter& __interpreter) const;
+        protected:
+            andy::lang::module_cache m_cache;
+            andy::lang::parser::ast_node m_root;
+        };
+    };
+};
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <deque>
+#include <optional>
 #include <vector>
 #include <memory>
+#include <iostream>
 
 #include <uva/var.hpp>
 #include <andy/lang/parser.hpp>
@@ -14,19 +17,36 @@ namespace andy
     namespace lang
     {
         class extension;
-        // The context of the interpreter execution. It is relative to a block.
+        class profiler;
+        class call_stats;
+        class heap_stats;
+        class timings;
+        class worker;
+        class event_loop;
+        class generator;
+        class fiber;
+        class scheduler;
+        // The context of the interpreter execution. It is relative to a block. One is kept for each call in
+        // progress, so it holds only what a call needs.
         struct interpreter_context
         {
-            std::shared_ptr<andy::lang::structure> cls;
-            std::shared_ptr<andy::lang::object> self;
             std::map<std::string_view, std::shared_ptr<andy::lang::object>> variables;
             std::map<std::string_view, andy::lang::method> functions;
 
             bool has_returned = false;
             std::shared_ptr<andy::lang::object> return_value;
+            // Whether a call returned by the block replaces the call in progress instead of nesting. Only the
+            // block of a function itself can, not a loop in it, nor a generator or a constructor.
+            bool tail_calls = false;
         };
         // This class is responsible of storing all resources needed by an andylang program.
         // It will store all classes, objects, methods, variables, call stack, etc.
+        //
+        // An interpreter must only be used by one thread at a time, but interpreters are independent: each thread
+        // can run its own. They share no mutable state, the working directory of a program is per interpreter
+        // and so is its output. Objects must not be passed from an interpreter to another, values are copied
+        // between them instead, see andy::lang::worker. Only one profiler can run in a process,
+        // and the standard input and the console are those of the process.
         class interpreter
         {
         public:
@@ -37,23 +57,67 @@ namespace andy
             ~interpreter() = default;
         public:
             std::filesystem::path input_file_path;
+            /// @brief The directory the relative paths of the program are resolved against. Path.set_current changes
+            /// it instead of the working directory of the process, which every thread shares.
+            std::filesystem::path working_directory = std::filesystem::current_path();
+            /// @brief A path of the program, made absolute against working_directory.
+            std::filesystem::path resolve(const std::filesystem::path& path) const
+            {
+                return path.is_absolute() ? path : working_directory / path;
+            }
+            /// @brief Where print and puts write. Embedders can capture the output of a program by replacing it.
+            std::ostream* output = &std::cout;
+            /// @brief Samples the call stack while it is set, see andy::lang::profiler.
+            andy::lang::profiler* profiler = nullptr;
+            /// @brief Counts the calls while it is set, see andy::lang::call_stats. Ignored without ANDY_CALL_STATS.
+            andy::lang::call_stats* call_stats = nullptr;
+            /// @brief Attributes the objects created to the source which is executed, see andy::lang::heap_stats.
+            andy::lang::heap_stats* heap_stats = nullptr;
+            /// @brief Measures the loading of extensions while it is set, see andy::lang::timings.
+            andy::lang::timings* timings = nullptr;
+            /// @brief The worker this interpreter runs, which Worker.receive and Worker.send talk to. Null outside a worker.
+            andy::lang::worker* worker = nullptr;
+            /// @brief The event loop of the asynchronous I/O of the program, created on first use.
+            andy::lang::event_loop& loop();
+            /// @brief The generator whose function is running, which the yield statement hands its values to. Null outside a generator.
+            andy::lang::generator* generator = nullptr;
+            /// @brief The scheduler of the fibers of the program, created on first use.
+            andy::lang::scheduler& fibers();
+            /// @brief The deepest calls can nest. A deeper recursion throws instead of exhausting the memory.
+            size_t max_depth = 1'000'000;
+            /// @brief The stack a call needs left before it calls again. With less, the call runs on a new segment.
+            static constexpr size_t stack_reserve = 64 * 1024;
+            /// @brief The segments deep recursions continue on. Only the pages which are used are committed.
+            static constexpr size_t stack_segment_size = 8 * 1024 * 1024;
         public:
             /// @brief Load a class into the vm. The class is kept alive by the vm untill it is destroyed.
             /// @param cls The class to be loaded. It is kept alive by the vm untill it is destroyed. It is globally accessible.
             void load(std::shared_ptr<andy::lang::structure> cls);
+            /// @brief The classes loaded, in the order they were.
+            const std::vector<std::shared_ptr<andy::lang::structure>>& loaded_classes() const { return classes; }
+            /// @brief Remove a class loaded by load. Its objects must not be used after, its methods can point into a syntax
+            /// tree which is destroyed.
+            void unload(const std::shared_ptr<andy::lang::structure>& cls);
 
             /// @brief Exeuctes a syntax tree into the interpreter. Note that if the code has while loops with no exit condition, this method will never return.
             /// @param cls The syntax tree to exeuctes. All its childs (not recursively) will be executed.
-            std::shared_ptr<andy::lang::object> execute(andy::lang::parser::ast_node source_code, std::shared_ptr<andy::lang::object>& object);
+            std::shared_ptr<andy::lang::object> execute(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
+
+            /// @brief Executes a call expression. It is kept apart from execute, so that a recursion of andy calls
+            /// only keeps the stack frames of the cases it goes through.
+            /// @param tail Whether the call is returned by the function in progress. A function written in andy is
+            /// then left for the function in progress to run in its place, see tail_call.
+            std::shared_ptr<andy::lang::object> execute_call(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object, bool tail = false);
 
             /// @brief Exeuctes a class declaration into the interpreter.
             /// @param source_code The class declaration.
-            std::shared_ptr<andy::lang::structure> execute_classdecl(andy::lang::parser::ast_node source_code);
+            std::shared_ptr<andy::lang::structure> execute_classdecl(const andy::lang::parser::ast_node& source_code);
 
             std::shared_ptr<andy::lang::object> execute_all(std::vector<andy::lang::parser::ast_node>::const_iterator begin, std::vector<andy::lang::parser::ast_node>::const_iterator end, std::shared_ptr<andy::lang::object>& object);
-            std::shared_ptr<andy::lang::object> execute_all(andy::lang::parser::ast_node source_code, std::shared_ptr<andy::lang::object>& object);
+            std::shared_ptr<andy::lang::object> execute_all(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
 
-            std::shared_ptr<andy::lang::object> execute_all(andy::lang::parser::ast_node source_code)
+            /// @brief Execute a program. The syntax tree must outlive the interpreter, the declared methods point into it.
+            std::shared_ptr<andy::lang::object> execute_all(const andy::lang::parser::ast_node& source_code)
             {
                 std::shared_ptr<andy::lang::object> tmp;
                 return execute_all(source_code, tmp);
@@ -73,14 +137,17 @@ namespace andy
             /// @brief The global integer class.
             std::shared_ptr<andy::lang::structure> IntegerClass;
 
+            /// @brief The global big integer class, of the integers which do not fit in 64 bits.
+            std::shared_ptr<andy::lang::structure> BigIntegerClass;
+
             /// @brief The global double class.
             std::shared_ptr<andy::lang::structure> DoubleClass;
 
             /// @brief The global float class.
             std::shared_ptr<andy::lang::structure> FloatClass;
 
-            /// @brief The global file class.
-            std::shared_ptr<andy::lang::structure> FileClass;
+            /// @brief The global file class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& FileClass() { return lazy_class(m_file_class, "File"); }
 
             /// @brief The global array class.
             std::shared_ptr<andy::lang::structure> ArrayClass;
@@ -91,14 +158,35 @@ namespace andy
             /// @brief The global dictionary class.
             std::shared_ptr<andy::lang::structure> DictionaryClass;
 
-            /// @brief The global system class.
-            std::shared_ptr<andy::lang::structure> SystemClass;
+            /// @brief The global system class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& SystemClass() { return lazy_class(m_system_class, "System"); }
+
+            /// @brief The global path class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& PathClass() { return lazy_class(m_path_class, "Path"); }
+
+            /// @brief The global andy config class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& AndyConfigClass() { return lazy_class(m_andy_config_class, "AndyConfig"); }
 
-            /// @brief The global path class.
-            std::shared_ptr<andy::lang::structure> PathClass;
+            /// @brief The global worker class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& WorkerClass() { return lazy_class(m_worker_class, "Worker"); }
 
-            /// @brief The global andy config class.
-            std::shared_ptr<andy::lang::structure> AndyConfigClass;
+            /// @brief The global async class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& AsyncClass() { return lazy_class(m_async_class, "Async"); }
+
+            /// @brief The global task class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& TaskClass() { return lazy_class(m_task_class, "Task"); }
+
+            /// @brief The global socket class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& SocketClass() { return lazy_class(m_socket_class, "Socket"); }
+
+            /// @brief The global generator class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& GeneratorClass() { return lazy_class(m_generator_class, "Generator"); }
+
+            /// @brief The global fiber class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& FiberClass() { return lazy_class(m_fiber_class, "Fiber"); }
+
+            /// @brief The global channel class, created the first time it is used.
+            const std::shared_ptr<andy::lang::structure>& ChannelClass() { return lazy_class(m_channel_class, "Channel"); }
 
             /// @brief The global class class.
             std::shared_ptr<andy::lang::structure> ClassClass;
@@ -111,6 +199,7 @@ namespace andy
                 std::map<std::string, std::shared_ptr<andy::lang::object>> named_params = {}
             );
 
+            /// @brief Find a class by its name. The builtin classes which are created lazily are created here.
             std::shared_ptr<andy::lang::structure> find_class(const std::string_view& name) {
                 for(auto& cls : classes) {
                     if(cls->name == name) {
@@ -118,7 +207,20 @@ namespace andy
                     }
                 }
 
-                return nullptr;
+                return andy::lang::structure::create_lazy_structure(this, name);
+            }
+            /// @brief The variables of the current context. Between the statements of a program, they are its globals.
+            std::map<std::string_view, std::shared_ptr<andy::lang::object>>& variables() { return current_context.variables; }
+            /// @brief The functions of the current context. Between the statements of a program, they are its global functions.
+            std::map<std::string_view, andy::lang::method>& functions() { return current_context.functions; }
+            /// @brief The functions of the context which called the method being executed. A native method runs in a
+            /// context of its own, the functions a program can call from where it called the method are these.
+            std::map<std::string_view, andy::lang::method>& caller_functions() { return stack.empty() ? current_context.functions : stack.back().functions; }
+            /// @brief Forget the global variables and functions and what the last program returned. The classes stay.
+            void reset_globals()
+            {
+                current_context = interpreter_context();
+                stack.clear();
             }
             const std::shared_ptr<andy::lang::object> try_object_from_declname(const andy::lang::parser::ast_node& node, std::shared_ptr<andy::lang::structure> cls = nullptr, std::shared_ptr<andy::lang::object> object = nullptr);
             const std::shared_ptr<andy::lang::object> node_to_object(const andy::lang::parser::ast_node& node, std::shared_ptr<andy::lang::structure> cls = nullptr, std::shared_ptr<andy::lang::object> object = nullptr);
@@ -128,17 +230,62 @@ namespace andy
 
             void start_extensions();
         protected:
+            // Generators and fibers swap the contexts of their functions with these while they run
+            friend class andy::lang::generator;
+            friend class andy::lang::fiber;
+
             /// @brief The global context stack.
             interpreter_context global_context;
 
             /// @brief The current context.
             interpreter_context current_context;
 
-            /// @brief The call stack.
-            std::vector<interpreter_context> stack;
+            /// @brief The call stack. A deque, which grows without moving the contexts of the calls in progress.
+            std::deque<interpreter_context> stack;
+
+            // A call in tail position, which the call in progress runs in its place once its block returned
+            struct pending_call
+            {
+                std::shared_ptr<andy::lang::structure> cls;
+                std::shared_ptr<andy::lang::object> object;
+                const andy::lang::method* method = nullptr;
+                std::vector<std::shared_ptr<andy::lang::object>> positional_params;
+                std::map<std::string, std::shared_ptr<andy::lang::object>> named_params;
+            };
+
+            /// @brief The call left by a return in tail position, empty the rest of the time.
+            std::optional<pending_call> tail_call;
 
             std::vector<andy::lang::extension*> extensions;
 
+            // The statements which need more locals than the others are executed apart from execute, whose frame
+            // every nested block and call keeps on the stack
+            void execute_fn_decl(const andy::lang::parser::ast_node& source_code);
+            std::shared_ptr<andy::lang::object> execute_foreach(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
+            std::shared_ptr<andy::lang::object> execute_for(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
+            std::shared_ptr<andy::lang::object> execute_while(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
+            std::shared_ptr<andy::lang::object> execute_conditional(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
+            std::shared_ptr<andy::lang::object> execute_vardecl(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object);
+            void execute_yield(const andy::lang::parser::ast_node& source_code);
+            // Evaluate the parameters of a call expression
+            void evaluate_params(const andy::lang::parser::ast_node& source_code, std::vector<std::shared_ptr<andy::lang::object>>& positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>>& named_params);
+            // The values node_to_object creates itself: literals, and arrays, dictionaries and interpolated strings
+            const std::shared_ptr<andy::lang::object> literal_to_object(const andy::lang::parser::ast_node& node);
+            const std::shared_ptr<andy::lang::object> composite_to_object(const andy::lang::parser::ast_node& node);
+            // Find what a call expression calls. Returns the value of the expression when it does not call a method,
+            // which leaves method_to_call null: an assignment or a default constructor.
+            std::shared_ptr<andy::lang::object> resolve_call(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object, andy::lang::method*& method_to_call, std::shared_ptr<andy::lang::structure>& class_to_call, std::shared_ptr<andy::lang::object>& object_to_call);
+            // The calls on a name and the call of the constructor of the base class are resolved apart: resolve_call
+            // stays on the stack while a call on the value of another call runs, they do not
+            std::shared_ptr<andy::lang::object> resolve_named_call(const andy::lang::parser::ast_node& source_code, const andy::lang::parser::ast_node& object_node, std::shared_ptr<andy::lang::object>& object, andy::lang::method*& method_to_call, std::shared_ptr<andy::lang::structure>& class_to_call, std::shared_ptr<andy::lang::object>& object_to_call);
+            void resolve_super(std::shared_ptr<andy::lang::object>& object, andy::lang::method*& method_to_call, std::shared_ptr<andy::lang::structure>& class_to_call, std::shared_ptr<andy::lang::object>& object_to_call);
+
+            // Run a method in the current context, which call pushed for it
+            std::shared_ptr<andy::lang::object> invoke(std::shared_ptr<andy::lang::structure>& cls, std::shared_ptr<andy::lang::object>& object, const andy::lang::method& method, std::vector<std::shared_ptr<andy::lang::object>>& positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>>& named_params);
+
+            // Throw if the parameters do not match the ones of the method, and add the named ones it defaults
+            void check_params(const andy::lang::method& method, const std::vector<std::shared_ptr<andy::lang::object>>& positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>>& named_params);
+
             void push_context(bool inherit = false) {
                 stack.push_back(std::move(current_context));
                 current_context = interpreter_context();
@@ -159,8 +306,35 @@ namespace andy
         protected:
             /// @brief Initialize the interpreter. This method will create the global classes and objects. It also load extensions.
             void init();
+            /// @brief Create a lazy builtin class if it does not exist yet, as find_class does when a script names it.
+            const std::shared_ptr<andy::lang::structure>& lazy_class(std::shared_ptr<andy::lang::structure>& cls, std::string_view name)
+            {
+                if(!cls) {
+                    andy::lang::structure::create_lazy_structure(this, name);
+                }
+
+                return cls;
+            }
         private:
+            // create_lazy_structure sets the lazy classes
+            friend class andy::lang::structure;
+
             std::vector<std::shared_ptr<andy::lang::structure>> classes;
+            // The builtin classes few programs use, null until they are first used
+            std::shared_ptr<andy::lang::structure> m_file_class;
+            std::shared_ptr<andy::lang::structure> m_system_class;
+            std::shared_ptr<andy::lang::structure> m_path_class;
+            std::shared_ptr<andy::lang::structure> m_andy_config_class;
+            std::shared_ptr<andy::lang::structure> m_worker_class;
+            std::shared_ptr<andy::lang::structure> m_async_class;
+            std::shared_ptr<andy::lang::structure> m_task_class;
+            std::shared_ptr<andy::lang::structure> m_socket_class;
+            std::shared_ptr<andy::lang::structure> m_generator_class;
+            std::shared_ptr<andy::lang::structure> m_fiber_class;
+            std::shared_ptr<andy::lang::structure> m_channel_class;
+            std::shared_ptr<andy::lang::event_loop> m_event_loop;
+            // Destroyed before the event loop, the operations its fibers wait for point to it
+            std::shared_ptr<andy::lang::scheduler> m_scheduler;
         };
     }  
 }; // namespace andy
\ No newline at end of file
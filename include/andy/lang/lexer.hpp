@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <map>
@@ -7,6 +8,7 @@
 #include <string>
 #include <stdexcept>
 #include <filesystem>
+#include <functional>
 
 namespace andy
 {
@@ -59,8 +61,30 @@ namespace andy
                 operator_greater_equal,
                 operator_increment,
                 operator_decrement,
+                operator_assign,
+                operator_question,
                 operator_max
             };
+            enum keyword_type {
+                keyword_none,
+                keyword_break,
+                keyword_class,
+                keyword_else,
+                keyword_for,
+                keyword_foreach,
+                keyword_function,
+                keyword_if,
+                keyword_namespace,
+                keyword_new,
+                keyword_return,
+                keyword_static,
+                keyword_var,
+                keyword_while,
+                keyword_yield,
+                // Lexed as an identifier, it is a keyword only after the name of a class
+                keyword_extends,
+                keyword_max
+            };
             struct token_position {
                 size_t line = 0;
                 size_t column = 0;
@@ -69,14 +93,16 @@ namespace andy
             class token {
             protected:
                 std::string_view m_content;
-                token_type m_type;
-                operator_type m_operator;
+                token_type m_type = token_type::token_undefined;
+                operator_type m_operator = operator_type::operator_max;
+                keyword_type m_keyword = keyword_type::keyword_none;
+                bool m_interpolated = false;
             public:
-                token_kind m_kind;
+                token_kind m_kind = token_kind::token_null;
             public:
                 struct {
                     union {
-                        int integer_literal;
+                        int64_t integer_literal;
                         double double_literal;
                         float float_literal;
                         bool boolean_literal;
@@ -90,7 +116,7 @@ namespace andy
                 token(token_position start, token_position end, std::string_view content, token_type type, token_kind kind = token_kind::token_null);
                 token(token&& other) = default;
                 token(const token&) = default;
-                token() = default;
+                token() : integer_literal(0) {}
                 ~token() = default;
             public:
             public:
@@ -101,6 +127,12 @@ namespace andy
                 std::string_view human_start_position() const;
 
                 void merge(const token& other);
+                /// @brief Point the content of the token into an edited copy of its source.
+                /// @param __old_source The source before the edit.
+                /// @param __new_source The source after the edit.
+                /// @param __edit_end The offset where the edit ends in the old source. Content after it moves by __delta.
+                /// @param __delta The size of the inserted text minus the size of the removed text.
+                void relocate(std::string_view __old_source, std::string_view __new_source, size_t __edit_end, ptrdiff_t __delta);
             public:
                 /// @brief Return the content of the token.
                 std::string_view content() const;
@@ -110,6 +142,13 @@ namespace andy
                 token_kind kind() const { return m_kind; }
                 /// @brief Return the operator type of the token.
                 operator_type op() const { return m_operator; }
+                /// @brief Return the keyword of the token, classified once by the lexer.
+                keyword_type keyword() const { return m_keyword; }
+                /// @brief Set the keyword of the token.
+                void set_keyword(keyword_type __keyword) { m_keyword = __keyword; }
+                /// @brief Return true if the token was lexed inside an interpolated string, after its first part.
+                bool interpolated() const { return m_interpolated; }
+                void set_interpolated(bool __interpolated) { m_interpolated = __interpolated; }
                 /// @brief Return the human type of the token.
                 std::string_view human_type() const;
             public:
@@ -121,18 +160,27 @@ namespace andy
         protected:
             std::string_view m_file_name;
             std::string_view m_source;
-            std::map<std::string, std::string, std::less<>> m_includes;
+            // A file can be included more than once, and the tokens of every copy point to their own source
+            std::multimap<std::string, std::string, std::less<>> m_includes;
             std::string_view m_current;
             std::string_view m_buffer;
             std::vector<andy::lang::lexer::token> m_tokens;
 
             token_position m_start;
+            // How many interpolated strings are being read
+            size_t m_interpolation_depth = 0;
 
             // iterating
             size_t iterator = 0;
         public:
             std::string_view path() const { return m_file_name; }
-            void include(std::string __file_name, std::string __source);
+            /// @brief Keep the source of an included file, which the tokens of the file point to.
+            /// @return The stored name and source, to lex the file from. A moved short string would not keep its address.
+            const std::pair<const std::string, std::string>& include(std::string __file_name, std::string __source);
+            /// @brief Take the sources included by another lexer. The nodes are moved, so tokens still point to valid memory.
+            void include(andy::lang::lexer& __other);
+            /// @brief Return the included files and their sources.
+            const std::multimap<std::string, std::string, std::less<>>& includes() const { return m_includes; }
             /// @brief Return the source code where the token is located.
             /// @param token The token.
             std::string_view source(const andy::lang::lexer::token& token) const;
@@ -175,6 +223,14 @@ namespace andy
                 /// @param __file_name The name of the file.
                 /// @param __source The source code.
                 void tokenize(std::string_view __file_name, std::string_view __source);
+                /// @brief Tokenize the source code from a position until a token for which __stop returns true. That token,
+                /// and the rest of the interpolated string it starts, is not kept. Used to re-lex only the damaged region
+                /// of an edited source.
+                /// @param __file_name The name of the file.
+                /// @param __source The whole source code.
+                /// @param __start The position to start from. It must be the start of a token.
+                /// @param __stop Called with each token which is not interpolated, including the end of file.
+                void tokenize(std::string_view __file_name, std::string_view __source, token_position __start, const std::function<bool(const andy::lang::lexer::token&)>& __stop);
             public:
                 void extract_and_push_string(token_position start);
         // iterating
@@ -210,6 +266,11 @@ namespace andy
             /// @brief The tokens.
             /// @return The tokens.
             const std::vector<andy::lang::lexer::token>& tokens() const { return m_tokens; }
+            std::vector<andy::lang::lexer::token>& tokens() { return m_tokens; }
+            /// @brief The index of the next token.
+            size_t position() const { return iterator; }
+            /// @brief Move the iterator. The next call to next_token will return the token at __position.
+            void seek(size_t __position) { iterator = __position; }
         protected:
         public:
             //extern std::vector<std::pair<std::string_view, andy::lang::lexer::cursor_type>> cursor_type_from_string_map;
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A read-only view of a whole file. The file is mapped into memory where the platform allows it and
+        // read into a buffer otherwise, so the caches built on top of it do not need to know the difference.
+        class mapped_file
+        {
+        public:
+            mapped_file() = default;
+            mapped_file(const mapped_file&) = delete;
+            ~mapped_file();
+        public:
+            /// @brief Map a file, closing the previous one.
+            /// @return False if the file does not exist, is empty or cannot be mapped.
+            bool open(const std::filesystem::path& __path);
+            void close();
+        public:
+            const char* data() const { return m_data; }
+            size_t size() const { return m_size; }
+            bool is_open() const { return m_data != nullptr; }
+        protected:
+            const char* m_data = nullptr;
+            size_t m_size = 0;
+#ifdef _WIN32
+            void* m_file = nullptr;
+            void* m_mapping = nullptr;
+#elif defined(__wasm__)
+            std::string m_buffer;
+#endif
+        };
+    };
+};
@@ -36,7 +36,10 @@ namespace andy {
         public:
             std::string name;
             std::string block;
-            andy::lang::parser::ast_node block_ast;
+            /// @brief The declaration of the method. It points into the syntax tree of the program, which outlives the interpreter.
+            const andy::lang::parser::ast_node* block_ast = nullptr;
+            /// @brief Whether the body yields. Calling such a method creates a generator instead of running it.
+            bool is_generator = false;
             method_storage_type storage_type;
             std::vector<fn_parameter> positional_params;
             std::vector<fn_parameter> named_params;
@@ -44,8 +47,8 @@ namespace andy {
 
             method() = default;
 
-            method(const std::string& __name, method_storage_type __storage_type, std::vector<std::string> __params, andy::lang::parser::ast_node __block)
-                : name(__name), block_ast(std::move(__block)), storage_type(__storage_type) {
+            method(const std::string& __name, method_storage_type __storage_type, std::vector<std::string> __params, const andy::lang::parser::ast_node* __block)
+                : name(__name), block_ast(__block), is_generator(__block && yields(*__block)), storage_type(__storage_type) {
                 init_params(__params);
             };
 
@@ -83,6 +86,8 @@ namespace andy {
 
             protected:
                 void init_params(std::vector<std::string> __params);
+                // Whether a node has a yield statement, not counting the functions and classes declared in it
+                static bool yields(const andy::lang::parser::ast_node& __node);
         };
     }
 }
\ No newline at end of file
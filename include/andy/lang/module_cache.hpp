@@ -0,0 +1,64 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include <andy/lang/parser.hpp>
+#include <andy/lang/mapped_file.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A parsed program serialized to disk (.andyc). The file is keyed on the content hash of the source
+        // and of every included file, plus the interpreter version. A valid file is mapped into memory and
+        // the tokens of the loaded syntax tree point directly into the mapping, so loading does not lex,
+        // preprocess or parse anything. A cache can also carry an opaque state, which andy::lang::image uses to
+        // store the objects of a program next to its syntax tree.
+        class module_cache
+        {
+        public:
+            /// @brief A file the program was built from.
+            struct dependency
+            {
+                std::string_view file_name;
+                std::string_view source;
+            };
+        public:
+            /// @brief Construct a module cache.
+            /// @param __cache_path The path of the .andyc file.
+            module_cache(std::filesystem::path __cache_path);
+            module_cache(const module_cache&) = delete;
+            ~module_cache();
+        public:
+            /// @brief The path of the cache of a source file.
+            /// @param __source_path The root source file.
+            /// @param __cache_directory Where to store the cache. If empty, the cache is stored next to the source.
+            static std::filesystem::path cache_path_for(const std::filesystem::path& __source_path, const std::filesystem::path& __cache_directory = {});
+            /// @brief FNV-1a hash used to key the cache.
+            static uint64_t hash(std::string_view __data);
+        public:
+            /// @brief Map the cache and rebuild the syntax tree if the cache is valid. The cache must outlive the tree.
+            /// @param __root The root node, set only when the cache is valid.
+            /// @return Whether the cache exists, was written by this interpreter version and matches all sources.
+            bool load(andy::lang::parser::ast_node& __root);
+            /// @brief Serialize a syntax tree. The file is written to a temporary path and renamed, so concurrent
+            /// runs never see a partial file. Failing to write the cache is not an error.
+            /// @param __root The root node.
+            /// @param __dependencies The root file followed by every included file.
+            /// @param __state Stored as is after the syntax tree, see state.
+            /// @return Whether the cache was written.
+            bool store(const andy::lang::parser::ast_node& __root, const std::vector<andy::lang::module_cache::dependency>& __dependencies, std::string_view __state = {});
+            /// @brief The state stored with the syntax tree, empty if none or if the cache is not loaded. It points into the mapping.
+            std::string_view state() const;
+        protected:
+            void read_node(andy::lang::parser::ast_node& __node, size_t& __index) const;
+        protected:
+            std::filesystem::path m_path;
+            andy::lang::mapped_file m_file;
+        };
+    };
+};
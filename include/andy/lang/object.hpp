@@ -42,23 +42,39 @@ namespace andy
             void (*native_destructor)(object* obj) = nullptr;
             // The object move ptr.
             void (*native_move)(object* obj, object&& other) = nullptr;
+            // The allocation site and the bytes of the object, when it is counted by andy::lang::heap_stats.
+            uint32_t heap_tag = 0;
+            uint32_t heap_bytes = 0;
             
             void initialize(andy::lang::interpreter* interpreter, std::vector<std::shared_ptr<andy::lang::object>> params = {});
         public:
             object& operator=(object&& other)
             {
+                if(this == &other) {
+                    return *this;
+                }
+
                 cls = other.cls;
                 base_instance = other.base_instance;
                 derived_instance = other.derived_instance;
                 instance_variables = std::move(other.instance_variables);
 
-                if(other.native_ptr) {
-                    native_ptr = other.native_ptr;
-                    native_destructor = other.native_destructor;
-                } else if(native_move) {
-                    native_move(this, std::move(other));
-                } else {
-                    std::memcpy(native, other.native, max_native_size);
+                // The value replaced can be of another type, an Integer assigned a BigInteger for instance, so it
+                // is destroyed and the value is moved as the type of the other object
+                if(native_destructor) {
+                    native_destructor(this);
+                }
+
+                native_ptr = other.native_ptr;
+                native_destructor = other.native_destructor;
+                native_move = other.native_move;
+
+                if(!native_ptr) {
+                    if(native_move) {
+                        native_move(this, std::move(other));
+                    } else {
+                        std::memcpy(native, other.native, max_native_size);
+                    }
                 }
                 other.native_destructor = nullptr;
 
@@ -116,6 +132,10 @@ namespace andy
             void set_native(T value) {
                 if(native_destructor) {
                     native_destructor(this);
+                    // An Integer becoming a BigInteger and back changes the type of its value
+                    native_destructor = nullptr;
+                    native_move = nullptr;
+                    native_ptr = nullptr;
                 }
 
                 bool should_destroy = false;
@@ -133,6 +153,7 @@ namespace andy
                 } else {
                     this->native_ptr = new T(std::move(value));
                     should_destroy = true;
+                    count_native_bytes(sizeof(T));
                 }
                 set_destructor<T>(this);
             }
@@ -141,6 +162,7 @@ namespace andy
             void set_native_ptr(T* ptr) {
                 this->native_ptr = (void*)ptr;
                 set_destructor<T>(this);
+                count_native_bytes(sizeof(T));
             }
 
             template<typename T>
@@ -176,6 +198,8 @@ namespace andy
             }
 
             void log_native_destructor();
+            /// @brief The object holds bytes out of itself, its native value or its instance variables. See andy::lang::heap_stats.
+            void count_native_bytes(size_t bytes);
         public:
             bool is_present() const;
 
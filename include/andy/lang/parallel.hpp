@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace andy
+{
+    namespace lang
+    {
+        class interpreter;
+        class object;
+        class method;
+        class thread_pool;
+        // The data parallel methods of Array: parallel_map, parallel_each and parallel_reduce.
+        //
+        // The items are split in chunks which run on a work-stealing pool shared by every interpreter of the
+        // process. Objects must not cross interpreters, so every thread of the pool calls the function in its
+        // own clone: an interpreter with the builtin classes, into which the classes and the global functions of
+        // the program are declared again, without the class variables the program set since. The items are
+        // copied into the clone as messages (see andy::lang::message) and the results are copied back, in the
+        // order of the items. What the function prints is buffered per chunk and written in order too.
+        //
+        // The chunks are sized from the number of items and of threads only, never from timings, so a program
+        // splits the same way on every run. Arrays too small to be worth it, and calls made from a clone, run
+        // sequentially in the calling interpreter.
+        namespace parallel
+        {
+            /// @brief The least number of items of a chunk. Below two chunks, the items are not split.
+            constexpr size_t min_chunk = 256;
+            /// @brief The pool the chunks run on, created on first use with one thread per hardware thread.
+            andy::lang::thread_pool& pool();
+            /// @brief How many chunks the items are split in: a few per thread, so stealing can balance uneven
+            /// chunks, but none smaller than min_chunk. 1 means the items are not split.
+            size_t chunk_count(size_t __items, size_t __threads);
+            /// @brief Call a function with every item.
+            /// @return The results, in the order of the items.
+            std::vector<std::shared_ptr<andy::lang::object>> map(andy::lang::interpreter* __interpreter, const std::vector<std::shared_ptr<andy::lang::object>>& __items, const andy::lang::method& __function);
+            /// @brief Call a function with every item, for what it does.
+            void each(andy::lang::interpreter* __interpreter, const std::vector<std::shared_ptr<andy::lang::object>>& __items, const andy::lang::method& __function);
+            /// @brief Fold the items with a function of (accumulator, item). Every chunk is folded from its first item,
+            /// then the chunks are folded in order from __initial, so the function must be associative.
+            std::shared_ptr<andy::lang::object> reduce(andy::lang::interpreter* __interpreter, const std::vector<std::shared_ptr<andy::lang::object>>& __items, const andy::lang::method& __function, std::shared_ptr<andy::lang::object> __initial);
+        };
+    };
+};
@@ -32,6 +32,7 @@ namespace andy
 
                 ast_node_fn_decl,
                 ast_node_fn_return,
+                ast_node_fn_yield,
                 ast_node_fn_call,
                 ast_node_fn_params,
                 ast_node_fn_object,
@@ -72,10 +73,35 @@ namespace andy
                     : m_token(__token), m_type(__type) {
                     
                 }
+            public:
+                /// @brief The number of child types which have a fixed slot.
+                static constexpr size_t slot_count = 12;
+                /// @brief Return the slot of a child type, or -1 if children of this type are searched.
+                static constexpr int slot_of(ast_node_type __type)
+                {
+                    switch(__type) {
+                        case ast_node_type::ast_node_declname:       return 0;
+                        case ast_node_type::ast_node_decltype:       return 1;
+                        case ast_node_type::ast_node_valuedecl:      return 2;
+                        case ast_node_type::ast_node_condition:      return 3;
+                        case ast_node_type::ast_node_context:        return 4;
+                        case ast_node_type::ast_node_fn_object:      return 5;
+                        case ast_node_type::ast_node_fn_params:      return 6;
+                        case ast_node_type::ast_node_else:           return 7;
+                        case ast_node_type::ast_node_classdecl_base: return 8;
+                        case ast_node_type::ast_node_declstatic:     return 9;
+                        case ast_node_type::ast_node_vardecl:        return 10;
+                        case ast_node_type::ast_node_fn_call:        return 11;
+                        default:                                     return -1;
+                    }
+                }
             protected:
                 andy::lang::lexer::token m_token;
                 ast_node_type m_type;
                 std::vector<ast_node> m_children;
+                // The index + 1 of the first child of each well-known type, 0 if there is none. Evaluation looks
+                // up these children on every execution, so the lookup must not scan the children.
+                uint32_t m_slots[slot_count] = { 0 };
             public:
                 bool is_undefined() const {
                     return m_type == ast_node_type::ast_node_undefined;
@@ -83,7 +109,27 @@ namespace andy
             // Setters
             public:
                 void add_child(ast_node child) {
+                    int slot = slot_of(child.type());
+
                     m_children.push_back(std::move(child));
+
+                    if(slot >= 0 && !m_slots[slot]) {
+                        m_slots[slot] = (uint32_t)m_children.size();
+                    }
+                }
+                /// @brief Recompute the child slots. Must be called after the children are modified through childrens().
+                void reindex() {
+                    for(auto& slot : m_slots) {
+                        slot = 0;
+                    }
+
+                    for(size_t i = m_children.size(); i-- > 0;) {
+                        int slot = slot_of(m_children[i].type());
+
+                        if(slot >= 0) {
+                            m_slots[slot] = (uint32_t)(i + 1);
+                        }
+                    }
                 }
                 void set_type(ast_node_type __type)
                 {
@@ -116,6 +162,10 @@ namespace andy
                 }
 
                 const ast_node* child_from_type(const andy::lang::parser::ast_node_type& __type) const {
+                    if(int slot = slot_of(__type); slot >= 0) {
+                        return m_slots[slot] ? &m_children[m_slots[slot] - 1] : nullptr;
+                    }
+
                     for(auto& child : m_children) {
                         if(child.type() == __type) {
                             return &child;
@@ -126,13 +176,7 @@ namespace andy
                 }
 
                 ast_node* child_from_type(const andy::lang::parser::ast_node_type& __type) {
-                    for(auto& child : m_children) {
-                        if(child.type() == __type) {
-                            return &child;
-                        }
-                    }
-
-                    return nullptr;
+                    return const_cast<ast_node*>(static_cast<const ast_node*>(this)->child_from_type(__type));
                 }
 
                 const andy::lang::lexer::token* child_token_from_type(const andy::lang::parser::ast_node_type& __type) const {
@@ -179,7 +223,9 @@ namespace andy
             }
         public:
             andy::lang::parser::ast_node parse_node(andy::lang::lexer& lexer);
-            andy::lang::parser::ast_node parse_all(andy::lang::lexer& lexer);
+            /// @brief Parse every node of a lexer into a unit node.
+            /// @param __starts If set, receives the token position each top-level node starts at.
+            andy::lang::parser::ast_node parse_all(andy::lang::lexer& lexer, std::vector<size_t>* __starts = nullptr);
 
         // Commons extract functions used by parsers
         protected:
@@ -216,6 +262,7 @@ namespace andy
             andy::lang::parser::ast_node parse_keyword_var(andy::lang::lexer& lexer);
             andy::lang::parser::ast_node parse_keyword_function(andy::lang::lexer& lexer);
             andy::lang::parser::ast_node parse_keyword_return(andy::lang::lexer& lexer);
+            andy::lang::parser::ast_node parse_keyword_yield(andy::lang::lexer& lexer);
             andy::lang::parser::ast_node parse_keyword_if(andy::lang::lexer& lexer);
             andy::lang::parser::ast_node parse_keyword_namespace(andy::lang::lexer& lexer);
             andy::lang::parser::ast_node parse_keyword_for(andy::lang::lexer& lexer);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A lookup table from a fixed set of strings to values, built at compile time. The seed of the hash
+        // function is searched until every key lands in its own slot, so a lookup is one hash and one compare.
+        template<typename T, size_t Size>
+        class perfect_hash_table
+        {
+        public:
+            static_assert((Size & (Size - 1)) == 0, "perfect_hash_table: Size must be a power of two");
+
+            template<size_t N>
+            constexpr perfect_hash_table(const std::array<std::pair<std::string_view, T>, N>& __entries, T __missing)
+                : m_missing(__missing)
+            {
+                static_assert(N <= Size, "perfect_hash_table: too many entries");
+
+                for(uint32_t seed = 1; seed < 100000; seed++) {
+                    if(try_seed(__entries, seed)) {
+                        m_seed = seed;
+                        return;
+                    }
+                }
+
+                // Not a constant expression, so a table without a perfect seed fails to compile
+                throw "perfect_hash_table: no perfect seed found, increase Size";
+            }
+        public:
+            static constexpr uint32_t hash(std::string_view __key, uint32_t __seed)
+            {
+                uint32_t result = __seed * 2166136261u;
+
+                for(const char& c : __key) {
+                    result ^= (uint8_t)c;
+                    result *= 16777619u;
+                }
+
+                return result ^ (result >> 15);
+            }
+            /// @brief Return the value of a key, or the missing value if the key is not in the table.
+            constexpr T find(std::string_view __key) const
+            {
+                const auto& slot = m_slots[hash(__key, m_seed) & (Size - 1)];
+
+                if(slot.first == __key && slot.first.size()) {
+                    return slot.second;
+                }
+
+                return m_missing;
+            }
+            constexpr bool contains(std::string_view __key) const
+            {
+                const auto& slot = m_slots[hash(__key, m_seed) & (Size - 1)];
+
+                return slot.first == __key && slot.first.size();
+            }
+        protected:
+            template<size_t N>
+            constexpr bool try_seed(const std::array<std::pair<std::string_view, T>, N>& __entries, uint32_t __seed)
+            {
+                for(auto& slot : m_slots) {
+                    slot = { std::string_view(), m_missing };
+                }
+
+                for(const auto& entry : __entries) {
+                    auto& slot = m_slots[hash(entry.first, __seed) & (Size - 1)];
+
+                    if(slot.first.size()) {
+                        return false;
+                    }
+
+                    slot = entry;
+                }
+
+                return true;
+            }
+        protected:
+            std::array<std::pair<std::string_view, T>, Size> m_slots = {};
+            T m_missing;
+            uint32_t m_seed = 0;
+        };
+    };
+};
@@ -1,28 +1,109 @@
 #pragma once
 
 #include <andy/lang/lexer.hpp>
+#include <andy/lang/parser.hpp>
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <string_view>
 #include <functional>
 #include <filesystem>
 #include <regex>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <future>
 
 namespace andy
 {
     namespace lang
     {
+        class include_cache;
+        class timings;
         class preprocessor
         {
         public:
             preprocessor();
             ~preprocessor();
+        public:
+            /// @brief A source file of the include graph. It owns the source code its tokens point to.
+            struct unit
+            {
+                std::string file_name;
+                std::string source;
+                andy::lang::lexer lexer;
+                /// @brief The files included by this unit, in the order they are spliced.
+                std::vector<std::string> include_files;
+                /// @brief The #include directive which included each of the includes. Used for error messages.
+                std::vector<andy::lang::lexer::token> include_tokens;
+                /// @brief The token position each #include directive was at, once the directives are removed.
+                std::vector<size_t> include_positions;
+                /// @brief The top-level node of the unit each include is merged before, the number of nodes for the end.
+                std::vector<size_t> include_nodes;
+                /// @brief The parsed unit, without its includes.
+                andy::lang::parser::ast_node root;
+                /// @brief The error thrown while parsing the unit, rethrown when the unit is merged.
+                std::exception_ptr error;
+            };
+        public:
+            /// @brief Measures the reading, lexing and parsing of each included file while it is set.
+            andy::lang::timings* timings = nullptr;
         public:
             void process(const std::filesystem::path& __file_name, andy::lang::lexer& __lexer);
+            /// @brief Discover the whole include graph first, then lex and parse every included file on a thread pool.
+            /// The result is the same program process() followed by parser::parse_all would produce.
+            /// @param __file_name The root file.
+            /// @param __lexer The lexer of the root file. Its directives are removed.
+            /// @param __jobs The number of threads. 0 means one per hardware thread.
+            /// @param __cache Where the included files are taken from and stored, shared with other preprocessors.
+            /// @return The root node of the program with the included files merged in the original order.
+            andy::lang::parser::ast_node process_parallel(const std::filesystem::path& __file_name, andy::lang::lexer& __lexer, size_t __jobs = 0, include_cache* __cache = nullptr);
+            /// @brief The files loaded by process_parallel. They must outlive the returned syntax tree.
+            const std::vector<std::shared_ptr<unit>>& units() const { return m_units; }
+            /// @brief The extension directories #compile built. A program which compiles one must not be cached, loading
+            /// it would skip the build.
+            const std::vector<std::filesystem::path>& compiled() const { return m_compiled; }
         public:
             void process_include(const std::filesystem::path& __file_name, andy::lang::lexer& __lexer);
             void process_compile(const std::filesystem::path& __file_name, andy::lang::lexer& __lexer);
+        protected:
+            /// @brief Remove the directives of a lexer, running #compile and resolving #include to the files it matches,
+            /// which are added to the includes of the unit.
+            void extract_includes(unit& __unit, andy::lang::lexer& __lexer);
+            /// @brief Parse a unit and find the node each of its includes is merged before. Errors are stored in the unit.
+            void parse_unit(unit& __unit, andy::lang::lexer& __lexer);
+            /// @brief Read, lex, resolve the directives and parse an included file. Errors are stored in the unit.
+            void load_unit(unit& __unit);
+            void merge_unit(size_t index, andy::lang::parser::ast_node& root, std::vector<bool>& visiting, std::vector<size_t>& uses);
+        protected:
+            std::vector<std::shared_ptr<unit>> m_units;
+            /// @brief The units included by each unit, indexes of m_units.
+            std::vector<std::vector<size_t>> m_graph;
+            // Written by process_compile with the compile lock held, the included files can be loaded on other threads
+            std::vector<std::filesystem::path> m_compiled;
+            include_cache* m_cache = nullptr;
+        };
+        // The included files of many root files, like the files of a workspace. Each file is read, lexed and
+        // parsed once, by the first preprocessor which needs it. The others wait for it and share the unit.
+        class include_cache
+        {
+        public:
+            /// @brief Return the unit of a file, loading it on the calling thread if it is the first request.
+            /// @param __key The canonical path of the file.
+            /// @param __file_name The path the file is loaded from.
+            /// @param __loader Fills the unit. It must not throw and must not load other units of the cache.
+            std::shared_ptr<preprocessor::unit> load(std::string_view __key, std::string __file_name, const std::function<void(preprocessor::unit&)>& __loader);
+            /// @brief Return the files an #include pattern matches, listing the directory only the first time.
+            /// @param __directory The directory of the including file.
+            /// @param __pattern The pattern of the directive.
+            std::vector<std::string> match(const std::filesystem::path& __directory, std::string_view __pattern);
+            /// @brief The number of files loaded.
+            size_t size() const;
+        protected:
+            mutable std::mutex m_mutex;
+            std::map<std::string, std::shared_future<std::shared_ptr<preprocessor::unit>>, std::less<>> m_units;
+            std::map<std::pair<std::string, std::string>, std::vector<std::string>> m_matches;
         };
     };
-};
\ No newline at end of file
+};
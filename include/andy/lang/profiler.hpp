@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <andy/lang/lexer.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        class method;
+        class structure;
+        // A sampling profiler of the andy call stack. The interpreter keeps a shadow stack of the methods it
+        // calls and of the token each one is executing. A timer only counts ticks: the stack is read by the
+        // interpreter itself, at the next statement, call or return after a tick, so nothing is read while
+        // it changes. A sample is weighted by the ticks it stands for.
+        //
+        // The timer is a SIGPROF interval timer, so the process stays single threaded and shared_ptr keeps
+        // its non atomic reference counts. Windows uses a thread and wasm reads the clock. Only one profiler
+        // runs at a time.
+        //
+        // A frame is named "Class.method (file:line)", with the line the method is executing, so a stack
+        // spread across included files keeps the file of every frame.
+        class profiler
+        {
+        public:
+            /// @brief Construct a stopped profiler.
+            /// @param __interval The processor time between two samples.
+            profiler(std::chrono::microseconds __interval = std::chrono::microseconds(1000));
+            profiler(const profiler&) = delete;
+            ~profiler();
+        public:
+            /// @brief Start the timer. The bottom frame of every stack is named __name.
+            void start(std::string __name);
+            /// @brief Stop the timer. The samples are kept.
+            void stop();
+        public:
+            /// @brief A method is called. Used by interpreter::call.
+            void enter(const andy::lang::method& __method, const andy::lang::structure* __cls)
+            {
+                safepoint();
+                m_stack.push_back({ &__method, __cls, nullptr });
+            }
+            /// @brief The last method entered returns.
+            void leave()
+            {
+                safepoint();
+                m_stack.pop_back();
+            }
+            /// @brief The current frame executes the statement which starts at __token.
+            void at(const andy::lang::lexer::token& __token)
+            {
+                // Nodes built by the parser have no position, the frame stays at the last one which has
+                if(!__token.m_file_name.empty()) {
+                    m_stack.back().position = &__token;
+                }
+                safepoint();
+            }
+        public:
+            /// @brief The number of samples taken.
+            size_t samples() const { return m_samples.size(); }
+            /// @brief Write the samples in the folded stack format of flamegraph.pl: "frame;frame;frame weight".
+            void write_folded(std::ostream& __out) const;
+            /// @brief Write the samples as Chrome trace events, for chrome://tracing and Perfetto.
+            void write_chrome_trace(std::ostream& __out) const;
+        public:
+            /// @brief Calls enter and leave around a call. Does nothing without a profiler.
+            class scope
+            {
+            public:
+                scope(andy::lang::profiler* __profiler, const andy::lang::method& __method, const andy::lang::structure* __cls)
+                    : m_profiler(__profiler)
+                {
+                    if(m_profiler) {
+                        m_profiler->enter(__method, __cls);
+                    }
+                }
+                scope(const scope&) = delete;
+                ~scope()
+                {
+                    if(m_profiler) {
+                        m_profiler->leave();
+                    }
+                }
+            protected:
+                andy::lang::profiler* m_profiler;
+            };
+        protected:
+            struct frame
+            {
+                const andy::lang::method* method;
+                const andy::lang::structure* cls;
+                const andy::lang::lexer::token* position;
+            };
+            struct sample
+            {
+                std::chrono::microseconds time;
+                size_t weight;
+                std::vector<uint32_t> frames;
+            };
+        protected:
+            void safepoint()
+            {
+#ifdef __wasm__
+                // There is no timer thread, the clock is read once in a while
+                if(++m_polls % 1024 == 0) {
+                    poll();
+                }
+#endif
+                if(m_ticks.load(std::memory_order_relaxed)) {
+                    take_sample();
+                }
+            }
+            void take_sample();
+            void poll();
+#ifdef __UVA_WIN__
+            void timer_loop();
+#endif
+            /// @brief The id of a frame name, names are kept once.
+            uint32_t intern(std::string __name);
+        protected:
+            std::chrono::microseconds m_interval;
+            std::chrono::steady_clock::time_point m_start;
+            std::vector<frame> m_stack;
+            std::string m_name;
+            std::vector<sample> m_samples;
+            std::vector<std::string> m_names;
+            std::unordered_map<std::string, uint32_t> m_ids;
+            std::atomic<size_t> m_ticks = 0;
+            bool m_running = false;
+#if defined(__wasm__)
+            size_t m_polls = 0;
+            std::chrono::steady_clock::time_point m_last_poll;
+#elif defined(__UVA_WIN__)
+            std::atomic<bool> m_timer_running = false;
+            std::thread m_timer;
+#endif
+        };
+    };
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <andy/lang/coroutine.hpp>
+#include <andy/lang/event_loop.hpp>
+#include <andy/lang/interpreter.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        class scheduler;
+        // A function running concurrently with the rest of the program, in the same interpreter and on the same
+        // thread. It has a coroutine for its interpreter frames and contexts of its own, which are swapped with
+        // the ones of the interpreter while it runs. A fiber costs its contexts and the part of its stack it uses.
+        class fiber : public std::enable_shared_from_this<fiber>
+        {
+        public:
+            fiber(andy::lang::interpreter* __interpreter, andy::lang::method __method, std::vector<std::shared_ptr<andy::lang::object>> __params, size_t __stack_size);
+            fiber(const fiber&) = delete;
+        public:
+            /// @brief Whether the function returned or threw.
+            bool done() const { return m_coroutine.done(); }
+            /// @brief What the function returned. Throws what it threw.
+            std::shared_ptr<andy::lang::object> result() const;
+        protected:
+            friend class scheduler;
+            // Run the function until it waits or returns
+            void resume();
+        protected:
+            andy::lang::interpreter* m_interpreter;
+            andy::lang::method m_method;
+            std::vector<std::shared_ptr<andy::lang::object>> m_params;
+            andy::lang::interpreter_context m_context;
+            std::deque<andy::lang::interpreter_context> m_stack;
+            andy::lang::generator* m_generator = nullptr;
+            std::shared_ptr<andy::lang::object> m_result;
+            std::exception_ptr m_error;
+            // The fibers waiting for this one to finish. Only the scheduler keeps the fibers which wait alive.
+            std::vector<std::weak_ptr<andy::lang::fiber>> m_joiners;
+            bool m_ready = false;
+            andy::lang::coroutine m_coroutine;
+        };
+        // Runs the fibers of an interpreter cooperatively. A fiber runs until it waits: for another fiber, a
+        // channel, an operation of the event loop or its next turn after Fiber.yield. The program runs the fibers
+        // which are ready whenever it waits itself, and runs the event loop when none of them is ready.
+        //
+        // Only what waits through the scheduler lets the other fibers run. A fiber which waits from inside a
+        // generator, whose coroutine is not the one of the fiber, runs the others until it can continue instead.
+        class scheduler
+        {
+        public:
+            // Values passed between fibers. Sending waits while the channel is full, receiving while it is empty.
+            class channel
+            {
+            public:
+                channel(andy::lang::scheduler* __scheduler, size_t __capacity);
+            public:
+                /// @brief Send a value, waiting while the channel is full.
+                /// @return False if the channel is closed.
+                bool send(std::shared_ptr<andy::lang::object> __value);
+                /// @brief Receive a value, waiting for it.
+                /// @return Nothing once the channel is closed and empty.
+                std::optional<std::shared_ptr<andy::lang::object>> receive();
+                /// @brief Close the channel, the fibers waiting on it continue.
+                void close();
+            protected:
+                andy::lang::scheduler* m_scheduler;
+                size_t m_capacity;
+                bool m_closed = false;
+                std::deque<std::shared_ptr<andy::lang::object>> m_values;
+                std::deque<std::weak_ptr<andy::lang::fiber>> m_senders;
+                std::deque<std::weak_ptr<andy::lang::fiber>> m_receivers;
+            };
+        public:
+            /// @brief The stack reserved for each fiber. Only the pages a fiber touches are committed.
+            static constexpr size_t stack_size = 256 * 1024;
+
+            scheduler(andy::lang::interpreter* __interpreter);
+            scheduler(const scheduler&) = delete;
+        public:
+            /// @brief Create a fiber calling a function. It runs once the program waits.
+            std::shared_ptr<andy::lang::fiber> spawn(andy::lang::method __method, std::vector<std::shared_ptr<andy::lang::object>> __params);
+            /// @brief Wait for a fiber to finish.
+            /// @return What its function returned. Throws what it threw.
+            std::shared_ptr<andy::lang::object> join(const std::shared_ptr<andy::lang::fiber>& __fiber);
+            /// @brief Let the other fibers which are ready run.
+            void yield();
+            /// @brief Wait for an operation of the event loop.
+            void wait(const andy::lang::event_loop::handle& __operation);
+            /// @brief Wait for every fiber to finish.
+            void run();
+            /// @brief The fibers which did not finish.
+            size_t count() const { return m_fibers.size(); }
+        protected:
+            // The fiber which is running and can be suspended, null outside of one
+            andy::lang::fiber* running() const;
+            // Wait until ready returns true. A fiber is queued by enqueue and suspended until it is woken up
+            void block(const std::function<bool()>& __ready, const std::function<void(std::shared_ptr<andy::lang::fiber>)>& __enqueue);
+            // Run the fibers and the event loop until ready returns true
+            void run_until(const std::function<bool()>& __ready);
+            // Run each fiber which is ready once
+            void run_ready();
+            void wake(const std::weak_ptr<andy::lang::fiber>& __fiber);
+        protected:
+            andy::lang::interpreter* m_interpreter;
+            // Set once an operation is waited for
+            andy::lang::event_loop* m_loop = nullptr;
+            andy::lang::fiber* m_running = nullptr;
+            std::deque<std::shared_ptr<andy::lang::fiber>> m_ready;
+            std::unordered_map<andy::lang::fiber*, std::shared_ptr<andy::lang::fiber>> m_fibers;
+        };
+    };
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+#include <andy/lang/lexer.hpp>
+#include <andy/lang/parser.hpp>
+#include <andy/lang/mapped_file.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        // The declarations and identifier uses of a set of files, kept on disk between runs. The stored index
+        // is mapped into memory and looked up in place: names are sorted, so a query is a binary search over
+        // the mapping. Files updated since the index was loaded are kept in memory and hide their stored
+        // records, store() writes both back to a single file.
+        //
+        // References are resolved by name only. A method is referenced by any identifier with its name.
+        class symbol_index
+        {
+        public:
+            enum symbol_kind : uint32_t {
+                symbol_class,
+                symbol_function,
+                symbol_method,
+                symbol_variable,
+                symbol_parameter,
+            };
+            struct location
+            {
+                std::string file_name;
+                size_t line = 0;
+                size_t column = 0;
+                size_t offset = 0;
+                size_t length = 0;
+            };
+            /// @brief A declaration.
+            struct symbol
+            {
+                std::string name;
+                symbol_kind kind;
+                /// @brief The class or function the symbol is declared in, empty at the top level.
+                std::string container;
+                location where;
+            };
+            /// @brief A use of a name which is not its declaration.
+            struct reference
+            {
+                std::string name;
+                location where;
+            };
+        public:
+            /// @brief Construct an empty index.
+            /// @param __index_path Where the index is loaded from and stored.
+            symbol_index(std::filesystem::path __index_path);
+            symbol_index(const symbol_index&) = delete;
+            ~symbol_index() = default;
+        public:
+            /// @brief Map the stored index. The files updated before are kept.
+            /// @return Whether the index exists and was written by this version.
+            bool load();
+            /// @brief Write the whole index. The file is written to a temporary path and renamed.
+            /// @return Whether the index was written.
+            bool store();
+        public:
+            /// @brief Whether the index has a file with this content hash, so updating it would not change anything.
+            bool is_current(std::string_view __file_name, uint64_t __hash) const;
+            /// @brief Index a file from its tokens and syntax tree. Safe to call from many threads.
+            /// @param __file_name The file. Tokens and declarations of other files are ignored.
+            /// @param __hash The content hash of the file, see module_cache::hash.
+            /// @param __tokens The tokens of the file.
+            /// @param __declarations The top-level declarations of the file.
+            void update(std::string_view __file_name, uint64_t __hash, const std::vector<andy::lang::lexer::token>& __tokens, const std::vector<const andy::lang::parser::ast_node*>& __declarations);
+            /// @brief Read, lex and parse a file and index it, unless the index is current.
+            /// @return Whether the file was indexed again.
+            bool update(const std::filesystem::path& __file_name);
+            /// @brief Forget a file.
+            void remove(std::string_view __file_name);
+        public:
+            /// @brief The declarations of a name.
+            std::vector<symbol> definitions(std::string_view __name) const;
+            /// @brief The uses of a name.
+            std::vector<reference> references(std::string_view __name) const;
+            /// @brief The symbols no file references. Parameters, and methods the interpreter calls by itself, are not reported.
+            std::vector<symbol> unused() const;
+            /// @brief The indexed files.
+            std::vector<std::string> files() const;
+        protected:
+            struct file_entry
+            {
+                uint64_t hash = 0;
+                bool removed = false;
+                std::vector<symbol> symbols;
+                std::vector<reference> references;
+            };
+        protected:
+            /// @brief Build the symbols and references of a file.
+            static file_entry extract(std::string_view __file_name, const std::vector<andy::lang::lexer::token>& __tokens, const std::vector<const andy::lang::parser::ast_node*>& __declarations);
+            /// @brief Replace the records of a file. The lock must be held.
+            void replace(std::string_view __file_name, file_entry __entry);
+            /// @brief The number of references to a name in the stored files which are not hidden. The lock must be held.
+            size_t stored_reference_count(std::string_view __name) const;
+        protected:
+            std::filesystem::path m_path;
+            andy::lang::mapped_file m_file;
+            /// @brief The stored files, by name.
+            std::map<std::string, uint32_t, std::less<>> m_stored_files;
+            /// @brief Whether the stored records of each stored file are replaced by m_files.
+            std::vector<bool> m_hidden;
+            /// @brief The files updated or removed since the index was loaded.
+            std::map<std::string, file_entry, std::less<>> m_files;
+            mutable std::mutex m_mutex;
+        };
+    };
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+namespace andy
+{
+    namespace lang
+    {
+        // A fixed set of worker threads used by the loading pipeline and the analyzer. Work is submitted
+        // in batches with parallel_for, which blocks until the whole batch is done.
+        //
+        // Every thread has its own queue. A batch is split in contiguous slices, one per queue. A thread works
+        // through its own queue from the front and, when it runs out of work, steals from the back of the other
+        // queues, so uneven work is balanced without a shared queue every task has to go through.
+        class thread_pool
+        {
+        public:
+            /// @brief Construct a thread pool.
+            /// @param __threads The number of workers. 0 means one worker per hardware thread.
+            thread_pool(size_t __threads = 0);
+            ~thread_pool();
+        public:
+            /// @brief The number of threads which execute work, including the calling thread.
+            size_t size() const { return m_workers.size() + 1; }
+            /// @brief Call fn(i) for every i in [0, count). The calling thread also executes work. If any call throws,
+            /// the exception of the lowest index is rethrown after the whole batch has finished.
+            /// @param count The number of calls.
+            /// @param fn The function to call. It must be safe to call it concurrently. It may call parallel_for.
+            void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+        protected:
+            struct queue
+            {
+                std::mutex mutex;
+                std::deque<std::function<void()>> tasks;
+            };
+        protected:
+            void worker_loop(size_t __index);
+            /// @brief Run a task of the queue __index, or steal one from another queue.
+            /// @return False if every queue was empty.
+            bool run_one(size_t __index);
+            /// @brief The queue of the calling thread. Threads which are not workers of this pool share the first one.
+            size_t current_queue() const;
+        protected:
+            std::vector<std::thread> m_workers;
+            std::vector<std::unique_ptr<queue>> m_queues;
+            // The number of tasks in all queues, so idle workers know when to sleep
+            std::atomic<size_t> m_pending = 0;
+            std::mutex m_mutex;
+            std::condition_variable m_condition;
+            bool m_stopping = false;
+        };
+    };
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace andy
+{
+    namespace lang
+    {
+        // The time spent in each phase of loading and running a program: reading, lexing, preprocessing and
+        // parsing the files, creating the structures of the interpreter, executing and starting the
+        // extensions. A phase of a single file, like the lexing of an included file, names its file.
+        //
+        // Phases are measured in wall time, processor time and allocations. The allocations are only counted
+        // if the program forwards its operator new to count_allocation, as the andy executable does, and
+        // only those of the thread which runs the phase. The processor time of a file is the time of its
+        // thread, the others are for the whole process.
+        class timings
+        {
+        public:
+            struct phase
+            {
+                std::string name;
+                /// @brief The file of the phase, empty for the phases of the whole program.
+                std::string file;
+                std::chrono::nanoseconds wall{0};
+                std::chrono::nanoseconds cpu{0};
+                size_t allocations = 0;
+                size_t allocated_bytes = 0;
+            };
+        public:
+            timings();
+            timings(const timings&) = delete;
+            ~timings();
+        public:
+            /// @brief Add a phase. Phases can be added from any thread.
+            void record(phase __phase);
+            /// @brief The phases, in the order they ended.
+            std::vector<phase> phases() const;
+            /// @brief Write the phases of the program, then the phases of each file, as tables.
+            void write_report(std::ostream& __out) const;
+            /// @brief Write the phases as JSON.
+            void write_json(std::ostream& __out) const;
+        public:
+            /// @brief Count an allocation while a timings object exists. Called by operator new.
+            static void count_allocation(size_t __bytes)
+            {
+                if(s_counting.load(std::memory_order_relaxed)) {
+                    t_allocations++;
+                    t_allocated_bytes += __bytes;
+                }
+            }
+        public:
+            /// @brief Measures a phase from its construction to end or its destruction. Does nothing without timings.
+            class scope
+            {
+            public:
+                scope(andy::lang::timings* __timings, std::string __name, std::string __file = {});
+                scope(const scope&) = delete;
+                ~scope() { end(); }
+            public:
+                /// @brief End the phase before the scope ends.
+                void end();
+            protected:
+                andy::lang::timings* m_timings;
+                phase m_phase;
+                std::chrono::steady_clock::time_point m_wall;
+                std::chrono::nanoseconds m_cpu;
+                size_t m_allocations;
+                size_t m_allocated_bytes;
+            };
+        protected:
+            mutable std::mutex m_mutex;
+            std::vector<phase> m_phases;
+        protected:
+            static inline std::atomic<size_t> s_counting = 0;
+            static inline thread_local size_t t_allocations = 0;
+            static inline thread_local size_t t_allocated_bytes = 0;
+        };
+    };
+};
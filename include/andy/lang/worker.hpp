@@ -0,0 +1,83 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <andy/lang/channel.hpp>
+#include <andy/lang/big_integer.hpp>
+
+namespace andy
+{
+    namespace lang
+    {
+        class interpreter;
+        class object;
+        // A value on its way from an interpreter to another. Objects must not cross interpreters, so the
+        // sender copies the value out of its objects and the receiver creates its own objects from the copy.
+        // Only null, booleans, numbers, strings, arrays and dictionaries of them can be sent.
+        struct message
+        {
+            using array = std::vector<andy::lang::message>;
+            using dictionary = std::vector<std::pair<andy::lang::message, andy::lang::message>>;
+
+            std::variant<std::monostate, bool, int64_t, andy::lang::big_integer, float, double, std::string, array, dictionary> value;
+
+            /// @brief Copy a value out of an interpreter.
+            /// @param __transfer Move the strings out of the objects instead of copying them, they are left empty.
+            static andy::lang::message from(andy::lang::interpreter* __interpreter, const std::shared_ptr<andy::lang::object>& __object, bool __transfer = false);
+            /// @brief Create the objects of the value in an interpreter.
+            std::shared_ptr<andy::lang::object> to_object(andy::lang::interpreter* __interpreter) &&;
+        };
+        // A script running on its own thread, in its own interpreter, created by new Worker(path). The
+        // interpreter which created it and the worker talk through two bounded channels: what the creator
+        // sends the worker receives, and the other way around. The creator drops the worker by joining
+        // it or when its object is destroyed, which closes the channels so a worker waiting on them ends.
+        class worker
+        {
+        public:
+            /// @brief How many messages wait in a channel before send waits.
+            static constexpr size_t channel_capacity = 64;
+            /// @brief Start running a script.
+            /// @param __path The script, relative to the working directory of the creator.
+            /// @param __creator The interpreter which creates the worker. The worker starts in its working directory
+            /// and writes to its output, which is buffered until join unless it is std::cout.
+            worker(std::filesystem::path __path, andy::lang::interpreter* __creator);
+            worker(const worker&) = delete;
+            ~worker();
+        public:
+            /// @brief Send a message to the worker, waiting while its inbox is full. Called by the creator.
+            /// @return False if the worker finished.
+            bool send(andy::lang::message __message);
+            /// @brief Receive a message from the worker, waiting for it. Called by the creator.
+            /// @return Nothing if the worker finished without sending more.
+            std::optional<andy::lang::message> receive();
+            /// @brief Wait for the worker to finish. Throws the error the worker ended with.
+            /// @return What the script returned.
+            andy::lang::message join();
+            const std::filesystem::path& path() const { return m_path; }
+            /// @brief What the creator sends. The worker pops it.
+            andy::lang::channel<andy::lang::message>& inbox() { return m_inbox; }
+            /// @brief What the worker sends. The creator pops it.
+            andy::lang::channel<andy::lang::message>& outbox() { return m_outbox; }
+        protected:
+            void run(std::filesystem::path __working_directory);
+        protected:
+            std::filesystem::path m_path;
+            andy::lang::channel<andy::lang::message> m_inbox;
+            andy::lang::channel<andy::lang::message> m_outbox;
+            std::ostream* m_creator_output;
+            std::ostringstream m_output;
+            // Written by the worker thread before it closes the outbox, read by the creator after join
+            andy::lang::message m_result;
+            std::string m_error;
+            std::thread m_thread;
+        };
+    };
+};
@@ -1,5 +1,11 @@
 #include <filesystem>
 #include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
 
 #include <uva/console.hpp>
 #include <uva/file.hpp>
@@ -9,8 +15,10 @@
 #include <andy/lang/interpreter.hpp>
 #include <andy/lang/extension.hpp>
 #include <andy/lang/preprocessor.hpp>
-
-size_t num_linter_warnings = 0;
+#include <andy/lang/document.hpp>
+#include <andy/lang/thread_pool.hpp>
+#include <andy/lang/symbol_index.hpp>
+#include <andy/lang/module_cache.hpp>
 
 void write_path(std::string_view path)
 {
@@ -26,27 +34,457 @@ void write_path(std::string_view path)
 #endif
 }
 
-void write_linter_warning(std::string_view type, std::string_view message, std::string_view file_name, andy::lang::lexer::token_position start, size_t length)
+void write_linter_warning(std::ostream& out, size_t& num_warnings, std::string_view type, std::string_view message, std::string_view file_name, andy::lang::lexer::token_position start, size_t length)
+{
+    if(num_warnings) {
+        out << ",\n";
+    }
+    out << "\t\t{\n\t\t\t\"type\": \"";
+    out << type;
+    out << "\",\n\t\t\t\"message\": \"";
+    for(const auto& c : message) {
+        // Error messages can quote the source
+        switch(c) {
+            case '\"':
+            case '\\':
+                out << '\\' << c;
+            break;
+            case '\n':
+                out << "\\n";
+            break;
+            default:
+                out << c;
+            break;
+        }
+    }
+    out << "\",\n\t\t\t\"location\": {\n\t\t\t\t\"file\": \"";
+    out << file_name;
+    out << "\",\n\t\t\t\t\"line\": ";
+    out << start.line;
+    out << ",\n\t\t\t\t\"column\": ";
+    out << start.column;
+    out << ",\n\t\t\t\t\"offset\": ";
+    out << start.offset;
+    out << ",\n\t\t\t\t\"length\": ";
+    out << length;
+    out << "\n\t\t\t}\n\t\t}";
+    ++num_warnings;
+}
+
+long long microseconds(std::chrono::nanoseconds duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+std::string_view source_of(const andy::lang::document& document, const andy::lang::lexer::token& token)
+{
+    if(token.m_file_name == document.file_name()) {
+        return document.source();
+    }
+
+    return document.included().source(token);
+}
+
+void write_symbol_location(const andy::lang::symbol_index::location& where)
+{
+    std::cout << "{\n\t\t\t\"file\": \"";
+    write_path(where.file_name);
+    std::cout << "\",\n\t\t\t\"line\": " << where.line;
+    std::cout << ",\n\t\t\t\"column\": " << where.column;
+    std::cout << ",\n\t\t\t\"offset\": " << where.offset;
+    std::cout << ",\n\t\t\t\"length\": " << where.length;
+    std::cout << "\n\t\t}";
+}
+
+std::string_view symbol_kind_name(andy::lang::symbol_index::symbol_kind kind)
+{
+    switch(kind) {
+        case andy::lang::symbol_index::symbol_class:
+            return "class";
+        case andy::lang::symbol_index::symbol_function:
+            return "function";
+        case andy::lang::symbol_index::symbol_method:
+            return "method";
+        case andy::lang::symbol_index::symbol_variable:
+            return "variable";
+        case andy::lang::symbol_index::symbol_parameter:
+            return "parameter";
+    }
+
+    return "unknown";
+}
+
+// The unused symbols of the index, as linter warnings
+void write_unused_symbols(std::ostream& out, size_t& num_warnings, const andy::lang::symbol_index& index)
+{
+    for(const auto& symbol : index.unused()) {
+        std::string message = std::string(symbol_kind_name(symbol.kind)) + " '" + symbol.name + "' is never used";
+        andy::lang::lexer::token_position start = { symbol.where.line, symbol.where.column, symbol.where.offset };
+
+        write_linter_warning(out, num_warnings, "unused-symbol", message, symbol.where.file_name, start, symbol.where.length);
+    }
+}
+
+// Answer a query of the symbol index. Returns false if the request is not a query.
+bool answer_symbol_query(std::string_view request, const andy::lang::symbol_index& index)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    if(request.starts_with("@definition ")) {
+        std::cout << "{\n\t\"definitions\": [";
+
+        size_t i = 0;
+
+        for(const auto& symbol : index.definitions(request.substr(12))) {
+            std::cout << (i++ ? ",\n\t\t" : "\n\t\t");
+            std::cout << "{\n\t\t\t\"name\": \"" << symbol.name << "\",\n\t\t\t\"kind\": \"" << symbol_kind_name(symbol.kind);
+            std::cout << "\",\n\t\t\t\"container\": \"" << symbol.container << "\",\n\t\t\t\"location\": ";
+            write_symbol_location(symbol.where);
+            std::cout << "\n\t\t}";
+        }
+    } else if(request.starts_with("@references ")) {
+        std::cout << "{\n\t\"references\": [";
+
+        size_t i = 0;
+
+        for(const auto& reference : index.references(request.substr(12))) {
+            std::cout << (i++ ? ",\n\t\t" : "\n\t\t");
+            write_symbol_location(reference.where);
+        }
+    } else if(request == "@unused") {
+        std::cout << "{\n\t\"linter\": [\n";
+
+        size_t num_warnings = 0;
+        write_unused_symbols(std::cout, num_warnings, index);
+    } else {
+        return false;
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "\n\t],\n";
+    std::cout << "\t\"elapsed\": \"" << microseconds(end - start) << "us\"\n";
+    std::cout << "}";
+    std::cout.flush();
+
+    return true;
+}
+
+void write_token(const andy::lang::lexer::token& token, size_t& token_i)
 {
-    if(num_linter_warnings) {
+    if(token_i) {
         std::cout << ",\n";
     }
-    std::cout << "\t\t{\n\t\t\t\"type\": \"";
-    std::cout << type;
-    std::cout << "\",\n\t\t\t\"message\": \"";
-    std::cout << message;
-    std::cout << "\",\n\t\t\t\"location\": {\n\t\t\t\t\"file\": \"";
-    std::cout << file_name;
+
+    token_i++;
+
+    std::cout << "\t\t{\n\t\t\t\"location\": {\n\t\t\t\t\"file\": \"";
+    write_path(token.m_file_name);
     std::cout << "\",\n\t\t\t\t\"line\": ";
-    std::cout << start.line;
+    std::cout << token.start.line;
     std::cout << ",\n\t\t\t\t\"column\": ";
-    std::cout << start.column;
+    std::cout << token.start.column;
     std::cout << ",\n\t\t\t\t\"offset\": ";
-    std::cout << start.offset;
+    std::cout << token.start.offset;
     std::cout << ",\n\t\t\t\t\"length\": ";
-    std::cout << length;
-    std::cout << "\n\t\t\t}\n\t\t}";
-    ++num_linter_warnings;
+    std::cout << token.end.offset - token.start.offset;
+    std::cout << "\n\t\t\t}";
+    std::cout << ",\n\t\t\t\"type\": \"";
+    std::cout << token.human_type();
+    std::cout << "\"\n";
+    std::cout << "\t\t}";
+}
+
+void lint_token(std::ostream& out, size_t& num_warnings, std::string_view source, const andy::lang::lexer::token& token)
+{
+    size_t offset = token.start.offset;
+    size_t end_offset = token.end.offset;
+    int has_whitespace = 0;
+    const char* end_it = source.data() + end_offset;
+
+    // Check if the token is before a \n
+    while(end_it != source.data()) {
+        if(*end_it == '\n' || *end_it == 0) {
+            break;
+        } else if(isspace(*end_it)) {
+            has_whitespace++;
+        } else {
+            break;
+        }
+        end_it++;
+    }
+
+    if(has_whitespace && (*end_it == '\n' || *end_it == 0)) {
+        write_linter_warning(out, num_warnings, "trailing-whitespace", "Trailing whitespace", token.m_file_name, token.end, has_whitespace);
+    }
+
+    switch(token.type()) {
+        case andy::lang::lexer::token_type::token_literal:
+            switch(token.kind()) {
+                case andy::lang::lexer::token_kind::token_string:
+                    char c = source[offset];
+
+                    switch(c)
+                    {
+                        case '\"':
+                            if(token.content().find("${") == std::string::npos) {
+                                write_linter_warning(out, num_warnings, "string-default-single-quotes", "String literal without interpolation should use single quotes", token.m_file_name, token.start, token.content().size() + 2 /* 2 for the quotes */);
+                            }
+                        break;
+                    }
+                break;
+            }
+        break;
+    }
+}
+
+void write_declaration(const andy::lang::document& document, const andy::lang::parser::ast_node& node, size_t& node_i)
+{
+    if(node.type() != andy::lang::parser::ast_node_type::ast_node_classdecl) {
+        return;
+    }
+
+    if(node_i) {
+        std::cout << ",";
+    }
+
+    node_i++;
+
+    std::cout << "\n";
+
+    const andy::lang::parser::ast_node* decname_node = node.child_from_type(andy::lang::parser::ast_node_type::ast_node_declname);
+    const andy::lang::lexer::token& decname_token = decname_node->token();
+
+    std::cout << "\t\t{\n\t\t\t\"type\": \"class\",\n\t\t\t\"name\": \"";
+    std::cout << decname_token.content();
+    std::cout << "\",\n\t\t\t\"location\": {\n\t\t\t\t\"file\": \"";
+    write_path(decname_token.m_file_name);
+    std::cout << "\",\n";
+    std::cout << "\t\t\t\t\"line\": ";
+    std::cout << decname_token.start.line;
+    std::cout << ",\n\t\t\t\t\"column\": ";
+    std::cout << decname_token.start.column;
+    std::cout << ",\n\t\t\t\t\"offset\": ";
+    std::cout << decname_token.start.offset;
+    std::cout << "\n\t\t\t}";
+    std::cout << ",\n\t\t\t\"references\": [";
+
+    size_t token_i = 0;
+
+    for(const andy::lang::lexer* l : { &document.included(), &document.lexer() }) {
+        for(const auto& token : l->tokens()) {
+            if(token.type() == andy::lang::lexer::token_type::token_identifier) {
+                if(token.content() == decname_token.content()) {
+                    if(token_i) {
+                        std::cout << ",";
+                    }
+
+                    token_i++;
+
+                    std::cout << "\n\t\t\t\t{\n\t\t\t\t\t\"file\": \"";
+                    write_path(token.m_file_name);
+                    std::cout << "\",\n\t\t\t\t\t\"line\": ";
+                    std::cout << token.start.line;
+                    std::cout << ",\n\t\t\t\t\t\"column\": ";
+                    std::cout << token.start.column;
+                    std::cout << ",\n\t\t\t\t\t\"offset\": ";
+                    std::cout << token.start.offset;
+                    std::cout << "\n\t\t\t\t}";
+                }
+            }
+        }
+    }
+
+    std::cout << "\n\t\t\t]";
+    std::cout << "\n\t\t}";
+}
+
+// Apply the new content of a document as a single edit, the range between the common prefix and suffix
+void update_document(andy::lang::document& document, std::string_view source)
+{
+    std::string_view old_source = document.source();
+
+    size_t prefix = 0;
+
+    while(prefix < old_source.size() && prefix < source.size() && old_source[prefix] == source[prefix]) {
+        prefix++;
+    }
+
+    size_t suffix = 0;
+
+    while(suffix < old_source.size() - prefix && suffix < source.size() - prefix
+        && old_source[old_source.size() - suffix - 1] == source[source.size() - suffix - 1]) {
+        suffix++;
+    }
+
+    document.edit(prefix, old_source.size() - prefix - suffix, source.substr(prefix, source.size() - prefix - suffix));
+}
+
+// Lint many files at once. The files are spread on a thread pool and the included files are loaded once for all
+// of them. The result of each file is written as soon as it is done, so the order of the files is not fixed.
+// With an index, the files whose content did not change since it was stored are not parsed again.
+int run_workspace(const std::vector<std::string_view>& paths, size_t jobs, andy::lang::symbol_index* index)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::filesystem::path> files;
+
+    for(const auto& path : paths) {
+        std::filesystem::path absolute = std::filesystem::absolute(path).lexically_normal();
+
+        if(std::filesystem::is_directory(absolute)) {
+            for(const auto& entry : std::filesystem::recursive_directory_iterator(absolute)) {
+                if(entry.is_regular_file() && entry.path().extension() == ".andy") {
+                    files.push_back(entry.path());
+                }
+            }
+        } else if(std::filesystem::is_regular_file(absolute)) {
+            files.push_back(absolute);
+        } else {
+            std::cerr << "input file '" << absolute.string() << "' does not exist" << std::endl;
+            return 1;
+        }
+    }
+
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    andy::lang::thread_pool pool(jobs);
+    andy::lang::include_cache includes;
+
+    std::mutex output_mutex;
+    size_t num_files = 0;
+    size_t num_warnings_total = 0;
+    std::atomic<size_t> num_indexed = 0;
+
+    std::cout << "{\n";
+    std::cout << "\t\"files\": [";
+
+    pool.parallel_for(files.size(), [&](size_t i) {
+        std::string file_name = files[i].string();
+        std::ostringstream out;
+        size_t num_warnings = 0;
+
+        auto file_start = std::chrono::high_resolution_clock::now();
+
+        std::string source;
+
+        try {
+            source = uva::file::read_all_text<char>(files[i]);
+        } catch(const std::exception& e) {
+            write_linter_warning(out, num_warnings, "error", e.what(), file_name, {}, 0);
+        }
+
+        auto read = std::chrono::high_resolution_clock::now();
+
+        andy::lang::lexer l;
+        bool lexed = true;
+
+        try {
+            l.tokenize(file_name, source);
+        } catch(const std::exception& e) {
+            lexed = false;
+            write_linter_warning(out, num_warnings, "error", e.what(), file_name, {}, 0);
+        }
+
+        auto lex_end = std::chrono::high_resolution_clock::now();
+
+        // Only the tokens of the file, the included files are linted by their own entry
+        for(const auto& token : l.tokens()) {
+            lint_token(out, num_warnings, source, token);
+        }
+
+        auto lint_end = std::chrono::high_resolution_clock::now();
+
+        if(lexed) {
+            // The pool is already busy with the other files
+            andy::lang::preprocessor preprocessor;
+            andy::lang::parser::ast_node root;
+
+            try {
+                root = preprocessor.process_parallel(files[i], l, 1, &includes);
+            } catch(const std::exception& e) {
+                write_linter_warning(out, num_warnings, "error", e.what(), file_name, {}, 0);
+            }
+
+            uint64_t hash = andy::lang::module_cache::hash(source);
+
+            if(index && !index->is_current(file_name, hash)) {
+                // The declarations of the included files are indexed from their own entry
+                std::vector<const andy::lang::parser::ast_node*> declarations;
+
+                for(const auto& child : root.childrens()) {
+                    declarations.push_back(&child);
+                }
+
+                index->update(file_name, hash, l.tokens(), declarations);
+                num_indexed++;
+            }
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+
+        std::unique_lock<std::mutex> lock(output_mutex);
+
+        if(num_files) {
+            std::cout << ",";
+        }
+
+        num_files++;
+        num_warnings_total += num_warnings;
+
+        std::cout << "\n\t{\n\t\t\"file\": \"";
+        write_path(file_name);
+        std::cout << "\",\n\t\t\"linter\": [\n";
+        std::cout << out.str();
+        std::cout << "\n\t\t],\n\t\t\"timings\": {\n";
+        std::cout << "\t\t\t\"read\": " << microseconds(read - file_start) << ",\n";
+        std::cout << "\t\t\t\"lex\": " << microseconds(lex_end - read) << ",\n";
+        std::cout << "\t\t\t\"lint\": " << microseconds(lint_end - lex_end) << ",\n";
+        std::cout << "\t\t\t\"parse\": " << microseconds(end - lint_end) << ",\n";
+        std::cout << "\t\t\t\"total\": " << microseconds(end - file_start) << "\n";
+        std::cout << "\t\t}\n\t}";
+        std::cout.flush();
+    });
+
+    std::cout << "\n\t],\n";
+
+    if(index) {
+        // The files which were removed from the workspace are not in the index anymore
+        for(const auto& indexed : index->files()) {
+            if(!std::binary_search(files.begin(), files.end(), std::filesystem::path(indexed))) {
+                index->remove(indexed);
+            }
+        }
+
+        std::cout << "\t\"unused\": [\n";
+
+        size_t num_unused = 0;
+        write_unused_symbols(std::cout, num_unused, *index);
+        num_warnings_total += num_unused;
+
+        std::cout << "\n\t],\n";
+
+        if(!index->store()) {
+            std::cerr << "could not write the symbol index" << std::endl;
+        }
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+
+    std::cout << "\t\"summary\": {\n";
+    std::cout << "\t\t\"files\": " << num_files << ",\n";
+    std::cout << "\t\t\"included_files\": " << includes.size() << ",\n";
+    if(index) {
+        std::cout << "\t\t\"indexed_files\": " << num_indexed << ",\n";
+    }
+    std::cout << "\t\t\"warnings\": " << num_warnings_total << ",\n";
+    std::cout << "\t\t\"threads\": " << pool.size() << "\n";
+    std::cout << "\t},\n";
+    std::cout << "\t\"elapsed\": \"" << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms\"\n";
+    std::cout << "}" << std::endl;
+
+    return 0;
 }
 
 int main(int argc, char** argv) {
@@ -54,6 +492,9 @@ int main(int argc, char** argv) {
     args.reserve(argc);
 
     bool is_server = false;
+    bool is_workspace = false;
+    size_t jobs = 0;
+    std::string index_path;
 
     for(int i = 1; i < argc; i++) {
         std::string_view arg = argv[i];
@@ -61,12 +502,38 @@ int main(int argc, char** argv) {
         if(arg.starts_with("--")) {
             if(arg == "--server") {
                 is_server = true;
+            } else if(arg == "--workspace") {
+                is_workspace = true;
+            } else if(arg.starts_with("--jobs=")) {
+                jobs = std::stoul(std::string(arg.substr(7)));
+            } else if(arg.starts_with("--index=")) {
+                index_path = arg.substr(8);
             }
         } else {
             args.push_back(arg);
         }
     }
 
+    // Without --index=<file> the server still indexes its documents, the index is only kept in memory
+    std::unique_ptr<andy::lang::symbol_index> index;
+
+    if(!index_path.empty() || is_server) {
+        index = std::make_unique<andy::lang::symbol_index>(index_path);
+
+        if(!index_path.empty()) {
+            index->load();
+        }
+    }
+
+    if(is_workspace) {
+        if(args.empty()) {
+            std::cerr << "andy-analyzer --workspace [--jobs=N] [--index=<file>] <directory-or-file>..." << std::endl;
+            return 1;
+        }
+
+        return run_workspace(args, jobs, index.get());
+    }
+
     if(is_server) {
         if(args.size() > 0) {
             std::cerr << "andy-analyzer --server takes no arguments. Write <input-file>\\n<temp-file>\\n to stdin" << std::endl;
@@ -74,7 +541,7 @@ int main(int argc, char** argv) {
         }
     } else {
         if(args.size() < 1) {
-            std::cerr << "andy-analyzer <input-file> [temp-file] or andy-analyzer --server" << std::endl;
+            std::cerr << "andy-analyzer <input-file> [temp-file], andy-analyzer --server or andy-analyzer --workspace <directory-or-file>..." << std::endl;
             return 1;
         }
     }
@@ -92,47 +559,122 @@ int main(int argc, char** argv) {
         }
     }
 
+    // The documents opened by the server. Requests for an open document only lex and parse what changed.
+    std::map<std::string, std::unique_ptr<andy::lang::document>, std::less<>> documents;
+
     bool run = true;
 
     while(run) {
-        num_linter_warnings = 0;
+        size_t num_linter_warnings = 0;
         std::filesystem::path uva_executable_path = argv[0];
 
+        // The server protocol is:
+        //  <input-file>\n<temp-file>\n                       open or update a document from the content of temp-file
+        //  @edit <input-file>\n<offset> <removed> <size>\n<text>  replace <removed> bytes at <offset> by the <size> bytes of text
+        //  @close <input-file>\n                              forget a document, nothing is written
+        //  @definition <name>\n                              the declarations of a name in the indexed files
+        //  @references <name>\n                              the uses of a name in the indexed files
+        //  @unused\n                                         the symbols which are never used
+        bool is_edit = false;
+        size_t edit_offset = 0;
+        size_t edit_removed = 0;
+        std::string edit_text;
+
+        auto start = std::chrono::high_resolution_clock::now();
+
         if(is_server) {
-            std::getline(std::cin, arg0);
-            std::getline(std::cin, arg1);
+            if(!std::getline(std::cin, arg0)) {
+                break;
+            }
+
+            if(arg0.starts_with("@close ")) {
+                documents.erase(std::filesystem::absolute(arg0.substr(7)).string());
+
+                if(!index_path.empty()) {
+                    index->store();
+                }
+
+                continue;
+            }
+
+            if(answer_symbol_query(arg0, *index)) {
+                continue;
+            }
+
+            if(arg0.starts_with("@edit ")) {
+                is_edit = true;
+                arg0 = arg0.substr(6);
+
+                size_t edit_size = 0;
+                std::cin >> edit_offset >> edit_removed >> edit_size;
+                std::cin.ignore(1);
+
+                edit_text.resize(edit_size);
+                std::cin.read(edit_text.data(), edit_size);
+
+                start = std::chrono::high_resolution_clock::now();
+            } else {
+                std::getline(std::cin, arg1);
+            }
         } else {
             run = false;
         }
 
         std::filesystem::path file_path = std::filesystem::absolute(arg0);
-        std::filesystem::path temp_file_path = std::filesystem::absolute(arg1);
+        std::string file_path_str = file_path.string();
 
-        auto start = std::chrono::high_resolution_clock::now();
+        auto document_it = documents.find(file_path_str);
+        andy::lang::document* document = document_it != documents.end() ? document_it->second.get() : nullptr;
 
-        if(!std::filesystem::exists(file_path)) {
-            std::cerr << "input file '" << file_path.string() << "' does not exist" << std::endl;
-            exit(1);
+        if(is_edit) {
+            if(!document) {
+                std::cerr << "document '" << file_path_str << "' is not open" << std::endl;
+                exit(1);
+            }
+        } else {
+            std::filesystem::path temp_file_path = std::filesystem::absolute(arg1);
+
+            if(!std::filesystem::exists(file_path)) {
+                std::cerr << "input file '" << file_path.string() << "' does not exist" << std::endl;
+                exit(1);
+            }
+
+            if(!std::filesystem::is_regular_file(file_path)) {
+                std::cerr << "input file '" << file_path.string() << "' is not a regular file" << std::endl;
+                exit(1);
+            }
+
+            edit_text = uva::file::read_all_text<char>(temp_file_path);
         }
 
-        if(!std::filesystem::is_regular_file(file_path)) {
-            std::cerr << "input file '" << file_path.string() << "' is not a regular file" << std::endl;
+        auto read = std::chrono::high_resolution_clock::now();
+
+        try {
+            if(is_edit) {
+                document->edit(edit_offset, edit_removed, edit_text);
+            } else if(document) {
+                update_document(*document, edit_text);
+            } else {
+                auto created = std::make_unique<andy::lang::document>(file_path_str, std::move(edit_text));
+                document = created.get();
+                documents.emplace(file_path_str, std::move(created));
+            }
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
             exit(1);
         }
 
-        std::string source = uva::file::read_all_text<char>(temp_file_path);
+        const andy::lang::document::update_stats& stats = document->stats();
 
-        andy::lang::lexer l;
-        std::string file_path_str = file_path.string();
+        if(index) {
+            std::vector<const andy::lang::parser::ast_node*> declarations;
 
-        try {
-            l.tokenize(file_path_str, source);
-        } catch (const std::exception& e) {
-            (void)e;
+            for(const auto& declaration : document->declarations()) {
+                declarations.push_back(&declaration.node);
+            }
+
+            index->update(file_path_str, andy::lang::module_cache::hash(document->source()), document->lexer().tokens(), declarations);
         }
-        
-        andy::lang::preprocessor preprocessor;
-        preprocessor.process(file_path, l);
 
         // Note we are writing directly to the cout instead of saving and encoding the output
 
@@ -140,160 +682,75 @@ int main(int argc, char** argv) {
 
         std::cout << "\t\"tokens\": [\n";
 
-        for(size_t i = 0; i < l.tokens().size(); i++) {
-            const auto& token = l.tokens()[i];
+        size_t token_i = 0;
 
-            if(i) {
-                std::cout << ",\n";
+        for(const auto& token : document->included().tokens()) {
+            // The end of file is written once, after the tokens of the document
+            if(!token.is_eof()) {
+                write_token(token, token_i);
             }
+        }
 
-            std::cout << "\t\t{\n\t\t\t\"location\": {\n\t\t\t\t\"file\": \"";
-            write_path(token.m_file_name);
-            std::cout << "\",\n\t\t\t\t\"line\": ";
-            std::cout << token.start.line;
-            std::cout << ",\n\t\t\t\t\"column\": ";
-            std::cout << token.start.column;
-            std::cout << ",\n\t\t\t\t\"offset\": ";
-            std::cout << token.start.offset;
-            std::cout << ",\n\t\t\t\t\"length\": ";
-            std::cout << token.end.offset - token.start.offset;
-            std::cout << "\n\t\t\t}";
-            std::cout << ",\n\t\t\t\"type\": \"";
-            std::cout << token.human_type();
-            std::cout << "\"\n";
-            std::cout << "\t\t}";
+        for(const auto& token : document->lexer().tokens()) {
+            write_token(token, token_i);
         }
 
         std::cout << "\n\t],\n";
 
         std::cout << "\t\"linter\": [\n";
 
-        // Token level linting
-        for(size_t i = 0; i < l.tokens().size(); i++) {
-            const auto& token = l.tokens()[i];
-
-            size_t offset = token.start.offset;
-            size_t end_offset = token.end.offset;
-            std::string_view source = l.source(token);
-            int has_whitespace = 0;
-            const char* end_it = source.data() + end_offset;
-
-            // Check if the token is before a \n
-            while(end_it != source.data()) {
-                if(*end_it == '\n' || *end_it == 0) {
-                    break;
-                } else if(isspace(*end_it)) {
-                    has_whitespace++;
-                } else {
-                    break;
-                }
-                end_it++;
-            }
+        auto lint_start = std::chrono::high_resolution_clock::now();
 
-            if(has_whitespace && (*end_it == '\n' || *end_it == 0)) {
-                write_linter_warning("trailing-whitespace", "Trailing whitespace", token.m_file_name, token.end, has_whitespace);
-            }
-
-            switch(token.type()) {
-                case andy::lang::lexer::token_type::token_literal:
-                    switch(token.kind()) {
-                        case andy::lang::lexer::token_kind::token_string:
-                            char c = source[offset];
-
-                            switch(c)
-                            {
-                                case '\"':
-                                    if(token.content().find("${") == std::string::npos) {
-                                        write_linter_warning("string-default-single-quotes", "String literal without interpolation should use single quotes", token.m_file_name, token.start, token.content().size() + 2 /* 2 for the quotes */);
-                                    }
-                                break;
-                            }
-                        break;
-                    }
-                break;
+        // Token level linting
+        for(const andy::lang::lexer* l : { &document->included(), &document->lexer() }) {
+            for(const auto& token : l->tokens()) {
+                lint_token(std::cout, num_linter_warnings, source_of(*document, token), token);
             }
         }
 
+        auto lint_end = std::chrono::high_resolution_clock::now();
+
         std::cout << "\n\t],\n";
 
         std::cout << "\t\"declarations\": [";
 
-        andy::lang::parser p;
-        andy::lang::parser::ast_node root_node;
-        
-        try {
-            root_node = p.parse_all(l);
-        } catch (const std::exception& e) {
-            (void)e;
-        }
-
         size_t node_i = 0;
 
-        for(const auto& node : root_node.childrens()) {
-            
-            if(node.type() == andy::lang::parser::ast_node_type::ast_node_classdecl) {
-                if(node_i) {
-                    std::cout << ",";
-                }
-
-                node_i++;
-
-                std::cout << "\n";
-
-                const andy::lang::parser::ast_node* decname_node = node.child_from_type(andy::lang::parser::ast_node_type::ast_node_declname);
-                const andy::lang::lexer::token& decname_token = decname_node->token();
-
-                std::cout << "\t\t{\n\t\t\t\"type\": \"class\",\n\t\t\t\"name\": \"";
-                std::cout << decname_token.content();
-                std::cout << "\",\n\t\t\t\"location\": {\n\t\t\t\t\"file\": \"";
-                write_path(decname_token.m_file_name);
-                std::cout << "\",\n";
-                std::cout << "\t\t\t\t\"line\": ";
-                std::cout << decname_token.start.line;
-                std::cout << ",\n\t\t\t\t\"column\": ";
-                std::cout << decname_token.start.column;
-                std::cout << ",\n\t\t\t\t\"offset\": ";
-                std::cout << decname_token.start.offset;
-                std::cout << "\n\t\t\t}";
-                std::cout << ",\n\t\t\t\"references\": [";
-
-                size_t token_i = 0;
-
-                for(const auto& token : l.tokens()) {
-                    if(token.type() == andy::lang::lexer::token_type::token_identifier) {
-                        if(token.content() == decname_token.content()) {
-                            if(token_i) {
-                                std::cout << ",";
-                            }
-
-                            token_i++;
-
-                            std::cout << "\n\t\t\t\t{\n\t\t\t\t\t\"file\": \"";
-                            write_path(token.m_file_name);
-                            std::cout << "\",\n\t\t\t\t\t\"line\": ";
-                            std::cout << token.start.line;
-                            std::cout << ",\n\t\t\t\t\t\"column\": ";
-                            std::cout << token.start.column;
-                            std::cout << ",\n\t\t\t\t\t\"offset\": ";
-                            std::cout << token.start.offset;
-                            std::cout << "\n\t\t\t\t}";
-                        }
-                    }
-                }
+        for(const auto& node : document->included_root().childrens()) {
+            write_declaration(*document, node, node_i);
+        }
 
-                std::cout << "\n\t\t\t]";
-                std::cout << "\n\t\t}";
-            }
+        for(const auto& declaration : document->declarations()) {
+            write_declaration(*document, declaration.node, node_i);
         }
 
         std::cout << "\n\t],\n";
 
         auto end = std::chrono::high_resolution_clock::now();
 
+        std::cout << "\t\"timings\": {\n";
+        std::cout << "\t\t\"read\": " << microseconds(read - start) << ",\n";
+        std::cout << "\t\t\"lex\": " << microseconds(stats.lex_time) << ",\n";
+        std::cout << "\t\t\"parse\": " << microseconds(stats.parse_time) << ",\n";
+        std::cout << "\t\t\"lint\": " << microseconds(lint_end - lint_start) << ",\n";
+        std::cout << "\t\t\"total\": " << microseconds(end - start) << "\n";
+        std::cout << "\t},\n";
+
+        std::cout << "\t\"incremental\": {\n";
+        std::cout << "\t\t\"lexed_tokens\": " << stats.lexed_tokens << ",\n";
+        std::cout << "\t\t\"parsed_declarations\": " << stats.parsed_declarations << ",\n";
+        std::cout << "\t\t\"reused_declarations\": " << stats.reused_declarations << ",\n";
+        std::cout << "\t\t\"includes_reloaded\": " << (stats.includes_reloaded ? "true" : "false") << "\n";
+        std::cout << "\t},\n";
+
         std::cout << "\t\"elapsed\": \"" << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << "ms\"\n";
 
         std::cout << "}";
     }
 
+    if(is_server && !index_path.empty()) {
+        index->store();
+    }
+
     return 0;
-}
\ No newline at end of file
+}
@@ -1,10 +1,145 @@
 #include <iostream>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <cstdlib>
 
 #include <andy/lang/api.hpp>
 
 #include <uva/console.hpp>
 
+// A .json profile is a Chrome trace, any other is in the folded stack format
+static void write_profile(const andy::lang::profiler& profiler, const std::filesystem::path& path)
+{
+    std::ofstream file(path, std::ios::binary);
+
+    if(!file) {
+        throw std::runtime_error("cannot write the profile to " + path.string());
+    }
+
+    if(path.extension() == ".json") {
+        profiler.write_chrome_trace(file);
+    } else {
+        profiler.write_folded(file);
+    }
+}
+
+// Without a file the report is printed to the standard error, after the output of the program
+static void write_call_stats(const andy::lang::call_stats& stats, const std::filesystem::path& path)
+{
+    if(path.empty()) {
+        stats.write_report(std::cerr);
+        return;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+
+    if(path.extension() == ".json") {
+        stats.write_json(file);
+    } else {
+        stats.write_report(file);
+    }
+}
+
+static void write_heap_stats(const andy::lang::heap_stats& stats, const std::filesystem::path& path)
+{
+    if(path.empty()) {
+        stats.write_report(std::cerr);
+        return;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    stats.write_snapshot(file);
+}
+
+static void write_timings(const andy::lang::timings& timings, const std::filesystem::path& path)
+{
+    if(path.empty()) {
+        timings.write_report(std::cerr);
+        return;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+
+    if(path.extension() == ".json") {
+        timings.write_json(file);
+    } else {
+        timings.write_report(file);
+    }
+}
+
+// The allocations of --timings. Every allocation of the process goes through count_allocation, which is one
+// relaxed load when --timings is not given. The array and nothrow forms call these, so all of them are counted.
+namespace
+{
+    // Out of line: inlined where a new expression is deleted, free is reported by -Wmismatched-new-delete
+#ifdef __GNUC__
+    [[gnu::noinline]]
+#endif
+    void release(void* ptr, [[maybe_unused]] bool aligned) noexcept
+    {
+#ifdef __UVA_WIN__
+        if(aligned) {
+            _aligned_free(ptr);
+            return;
+        }
+#endif
+        std::free(ptr);
+    }
+};
+
+void* operator new(std::size_t size)
+{
+    andy::lang::timings::count_allocation(size);
+
+    if(void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    andy::lang::timings::count_allocation(size);
+
+    size_t align = static_cast<size_t>(alignment);
+
+#ifdef __UVA_WIN__
+    void* ptr = _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc takes a multiple of the alignment
+    void* ptr = std::aligned_alloc(align, size ? (size + align - 1) / align * align : align);
+#endif
+
+    if(ptr) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    release(ptr, false);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    release(ptr, false);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    release(ptr, true);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    release(ptr, true);
+}
+
 #ifdef __UVA_DEBUG__
     #define try if(true)
     #define catch(e) if(false)
@@ -18,42 +153,127 @@ int main(int argc, char** argv) {
         //vm_instance = std::make_shared<andy::lang::vm>();
 
         std::filesystem::path file_path;
+        andy::lang::api::options options;
+        std::filesystem::path profile_path;
+        std::chrono::microseconds profile_interval(1000);
+        bool stats = false;
+        std::filesystem::path stats_path;
+        bool heap_stats = false;
+        std::filesystem::path heap_stats_path;
+        bool timings = false;
+        std::filesystem::path timings_path;
 
-        if(argc > 1) {
-            std::string_view arg = argv[1];
-
-            if(arg.starts_with("--")) {
-                if(arg == "--help") {
-                    std::cout << "Usage: " << argv[0] << " [file]" << std::endl;
-                    std::cout << std::endl;
-                    std::cout << "Options: " << std::endl;
-                    uva::console::print_warning("  --help");
-                    std::cout << "     Display this information" << std::endl;
-                    uva::console::print_warning("  --version");
-                    std::cout << "  Display the version of the andy language" << std::endl;
-                    return 0;
-                } else if(arg == "--version") {
-                    std::cout << ANDYLANG_VERSION << std::endl;
-                    return 0;
-                } else {
-                    arg.remove_prefix(2);
-                    file_path = andy::lang::config::src_dir() / "utility" / arg;
-                    file_path.replace_extension(".andy");
-
-                    if(!std::filesystem::exists(file_path)) {
-                        throw std::runtime_error("utility does not exist");
-                    }
-
-                    if(!std::filesystem::is_regular_file(file_path)) {
-                        throw std::runtime_error("utility is not a regular file");
-                    }
+        int arg_index = 1;
+
+        for(; arg_index < argc; arg_index++) {
+            std::string_view arg = argv[arg_index];
+
+            if(!arg.starts_with("--")) {
+                break;
+            }
+
+            if(arg == "--help") {
+                std::cout << "Usage: " << argv[0] << " [options] [file]" << std::endl;
+                std::cout << std::endl;
+                std::cout << "Options: " << std::endl;
+                uva::console::print_warning("  --help");
+                std::cout << "               Display this information" << std::endl;
+                uva::console::print_warning("  --version");
+                std::cout << "            Display the version of the andy language" << std::endl;
+                uva::console::print_warning("  --parallel-includes");
+                std::cout << "  Read, lex and parse the included files in parallel" << std::endl;
+                uva::console::print_warning("  --jobs=<n>");
+                std::cout << "           Number of threads used by --parallel-includes" << std::endl;
+                uva::console::print_warning("  --cache");
+                std::cout << "              Load the parsed program from a .andyc file next to the source" << std::endl;
+                uva::console::print_warning("  --cache-dir=<dir>");
+                std::cout << "    Store the .andyc files in a directory (implies --cache)" << std::endl;
+                uva::console::print_warning("  --image=<file>");
+                std::cout << "       Start from the functions, classes and globals stored in an image by --store-image" << std::endl;
+                uva::console::print_warning("  --store-image=<file>");
+                std::cout << " Store the functions, classes and globals of the program in an image after it runs" << std::endl;
+                uva::console::print_warning("  --profile[=<file>]");
+                std::cout << "   Sample the call stack into a folded stack file, or a Chrome trace if it ends with .json (default andy.folded)" << std::endl;
+                uva::console::print_warning("  --profile-interval=<us>");
+                std::cout << " Microseconds between two samples of --profile (default 1000)" << std::endl;
+                uva::console::print_warning("  --stats[=<file>]");
+                std::cout << "     Count the calls of every method and print them at exit, or write them to a file (JSON if it ends with .json)" << std::endl;
+                uva::console::print_warning("  --heap-stats[=<file>]");
+                std::cout << " Count the objects alive per class and allocation site and print them at exit, or write a JSON snapshot to a file" << std::endl;
+                uva::console::print_warning("  --timings[=<file>]");
+                std::cout << "   Measure the time and allocations of each phase and print them at exit, or write them to a file (JSON if it ends with .json)" << std::endl;
+                uva::console::print_warning("  --max-depth=<n>");
+                std::cout << "      Throw when calls nest deeper than this (default 1000000)" << std::endl;
+                return 0;
+            } else if(arg == "--version") {
+                std::cout << ANDYLANG_VERSION << std::endl;
+                return 0;
+            } else if(arg == "--parallel-includes") {
+                options.parallel_includes = true;
+            } else if(arg.starts_with("--jobs=")) {
+                arg.remove_prefix(7);
+                options.jobs = std::stoul(std::string(arg));
+            } else if(arg == "--cache") {
+                options.cache = true;
+            } else if(arg.starts_with("--cache-dir=")) {
+                arg.remove_prefix(12);
+                options.cache = true;
+                options.cache_directory = std::filesystem::absolute(arg);
+            } else if(arg.starts_with("--image=")) {
+                arg.remove_prefix(8);
+                options.image = std::filesystem::absolute(arg);
+            } else if(arg.starts_with("--store-image=")) {
+                arg.remove_prefix(14);
+                options.store_image = std::filesystem::absolute(arg);
+            } else if(arg == "--profile") {
+                profile_path = std::filesystem::absolute("andy.folded");
+            } else if(arg.starts_with("--profile=")) {
+                arg.remove_prefix(10);
+                profile_path = std::filesystem::absolute(arg);
+            } else if(arg.starts_with("--profile-interval=")) {
+                arg.remove_prefix(19);
+                profile_interval = std::chrono::microseconds(std::stoul(std::string(arg)));
+            } else if(arg == "--stats") {
+                stats = true;
+            } else if(arg.starts_with("--stats=")) {
+                arg.remove_prefix(8);
+                stats = true;
+                stats_path = std::filesystem::absolute(arg);
+            } else if(arg == "--heap-stats") {
+                heap_stats = true;
+            } else if(arg.starts_with("--heap-stats=")) {
+                arg.remove_prefix(13);
+                heap_stats = true;
+                heap_stats_path = std::filesystem::absolute(arg);
+            } else if(arg == "--timings") {
+                timings = true;
+            } else if(arg.starts_with("--timings=")) {
+                arg.remove_prefix(10);
+                timings = true;
+                timings_path = std::filesystem::absolute(arg);
+            } else if(arg.starts_with("--max-depth=")) {
+                arg.remove_prefix(12);
+                options.max_depth = std::stoul(std::string(arg));
+            } else {
+                arg.remove_prefix(2);
+                file_path = andy::lang::config::src_dir() / "utility" / arg;
+                file_path.replace_extension(".andy");
+
+                if(!std::filesystem::exists(file_path)) {
+                    throw std::runtime_error("utility does not exist");
+                }
+
+                if(!std::filesystem::is_regular_file(file_path)) {
+                    throw std::runtime_error("utility is not a regular file");
                 }
+
+                break;
             }
         }
 
         if(file_path.empty()) {
-            if(argc > 1) {
-                file_path = std::filesystem::absolute(argv[1]);
+            if(arg_index < argc) {
+                file_path = std::filesystem::absolute(argv[arg_index]);
             } else {
                 file_path = std::filesystem::absolute("application.andy");
             }
@@ -67,7 +287,93 @@ int main(int argc, char** argv) {
             }
         }
 
-        std::shared_ptr<andy::lang::object> ret = andy::lang::api::evaluate(file_path);
+        std::unique_ptr<andy::lang::profiler> profiler;
+
+        if(!profile_path.empty()) {
+            profiler = std::make_unique<andy::lang::profiler>(profile_interval);
+            options.profiler = profiler.get();
+        }
+
+        std::unique_ptr<andy::lang::timings> phases;
+
+        if(timings) {
+            phases = std::make_unique<andy::lang::timings>();
+            options.timings = phases.get();
+        }
+
+        struct report_timings
+        {
+            const andy::lang::timings* timings;
+            const std::filesystem::path& path;
+
+            ~report_timings()
+            {
+                if(timings) {
+                    write_timings(*timings, path);
+                }
+            }
+        } timings_report{ phases.get(), timings_path };
+
+        std::unique_ptr<andy::lang::heap_stats> heap;
+
+        if(heap_stats) {
+            heap = std::make_unique<andy::lang::heap_stats>();
+            options.heap_stats = heap.get();
+        }
+
+        std::unique_ptr<andy::lang::call_stats> call_stats;
+
+        if(stats) {
+#ifdef ANDY_CALL_STATS
+            call_stats = std::make_unique<andy::lang::call_stats>();
+            options.call_stats = call_stats.get();
+#else
+            throw std::runtime_error("andy was built without ENABLE_CALL_STATS");
+#endif
+        }
+
+        // The counters are reported when the program exits, even if it failed
+        struct report_call_stats
+        {
+            const andy::lang::call_stats* stats;
+            const std::filesystem::path& path;
+
+            ~report_call_stats()
+            {
+                if(stats) {
+                    write_call_stats(*stats, path);
+                }
+            }
+        } call_stats_report{ call_stats.get(), stats_path };
+
+        struct report_heap_stats
+        {
+            const andy::lang::heap_stats* stats;
+            const std::filesystem::path& path;
+
+            ~report_heap_stats()
+            {
+                if(stats) {
+                    write_heap_stats(*stats, path);
+                }
+            }
+        } heap_stats_report{ heap.get(), heap_stats_path };
+
+        std::shared_ptr<andy::lang::object> ret;
+
+        if(profiler) {
+            // The profile of a program which failed is still written, it is often the one wanted
+            try {
+                ret = andy::lang::api::evaluate(file_path, options);
+            } catch(const std::exception&) {
+                write_profile(*profiler, profile_path);
+                throw;
+            }
+
+            write_profile(*profiler, profile_path);
+        } else {
+            ret = andy::lang::api::evaluate(file_path, options);
+        }
 
         if(!ret) {
             return 0;
@@ -75,7 +381,7 @@ int main(int argc, char** argv) {
 
         if(ret) {
             // TODO: Treat the return value
-            int ret_value = ret->as<int>();
+            int ret_value = (int)ret->as<int64_t>();
             return ret_value;
         }
         
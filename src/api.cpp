@@ -2,6 +2,8 @@
 #include <andy/lang/preprocessor.hpp>
 #include <andy/lang/lexer.hpp>
 #include <andy/lang/parser.hpp>
+#include <andy/lang/module_cache.hpp>
+#include <andy/lang/image.hpp>
 
 #include <uva/file.hpp>
 
@@ -11,28 +13,288 @@ namespace andy
     {
         namespace api
         {
-            std::shared_ptr<andy::lang::object> evaluate(std::filesystem::path path)
+            std::shared_ptr<andy::lang::object> evaluate(std::filesystem::path path, const andy::lang::api::options& options)
             {
-                std::string source = uva::file::read_all_text<char>(path);
+                // Must outlive the syntax tree, the loaded tokens point into the mapped file
+                std::unique_ptr<andy::lang::module_cache> cache;
+                andy::lang::parser::ast_node root_node;
 
+                // Storing an image needs the sources of the program, which a loaded cache does not keep
+                if(options.cache && options.store_image.empty()) {
+                    cache = std::make_unique<andy::lang::module_cache>(andy::lang::module_cache::cache_path_for(path, options.cache_directory));
+                }
+
+                std::string source;
                 std::string path_str = path.string();
 
-                andy::lang::lexer l(path_str, source);
+                andy::lang::lexer l;
         
+                // Must outlive the syntax tree, it owns the included sources
                 andy::lang::preprocessor preprocessor;
-                preprocessor.process(path_str, l);
-        
-                andy::lang::parser p;
-                andy::lang::parser::ast_node root_node = p.parse_all(l);
+                preprocessor.timings = options.timings;
+
+                bool cached = false;
+                std::vector<andy::lang::module_cache::dependency> dependencies;
+
+                if(cache) {
+                    andy::lang::timings::scope load_phase(options.timings, "load cache");
+                    cached = cache->load(root_node);
+                }
+
+                if(!cached) {
+                    andy::lang::timings::scope read_phase(options.timings, "read");
+                    source = uva::file::read_all_text<char>(path);
+                    read_phase.end();
+
+                    andy::lang::timings::scope lex_phase(options.timings, "lex");
+                    l.tokenize(path_str, source);
+                    lex_phase.end();
+
+                    dependencies.push_back({ path_str, source });
+
+                    if(options.parallel_includes) {
+                        andy::lang::timings::scope process_phase(options.timings, "preprocess and parse");
+                        root_node = preprocessor.process_parallel(path_str, l, options.jobs);
+                        process_phase.end();
+
+                        // The first unit is the root file
+                        for(size_t i = 1; i < preprocessor.units().size(); i++) {
+                            dependencies.push_back({ preprocessor.units()[i]->file_name, preprocessor.units()[i]->source });
+                        }
+                    } else {
+                        andy::lang::timings::scope process_phase(options.timings, "preprocess");
+                        preprocessor.process(path_str, l);
+                        process_phase.end();
+
+                        andy::lang::timings::scope parse_phase(options.timings, "parse");
+                        andy::lang::parser p;
+                        root_node = p.parse_all(l);
+                        parse_phase.end();
+
+                        for(const auto& [file_name, file_source] : l.includes()) {
+                            dependencies.push_back({ file_name, file_source });
+                        }
+                    }
+
+                    // A loaded cache or image does not run #compile, its extension would be stale or not built at all
+                    if(!options.store_image.empty() && preprocessor.compiled().size()) {
+                        throw std::runtime_error("cannot store an image of a program which uses #compile");
+                    }
+
+                    if(cache && preprocessor.compiled().empty()) {
+                        andy::lang::timings::scope store_phase(options.timings, "store cache");
+                        cache->store(root_node, dependencies);
+                    }
+                }
         
+                // Must outlive the interpreter, the restored methods and objects point into it
+                std::unique_ptr<andy::lang::image> image;
+
+                if(!options.image.empty()) {
+                    andy::lang::timings::scope image_phase(options.timings, "load image");
+                    image = std::make_unique<andy::lang::image>(options.image);
+
+                    if(!image->load()) {
+                        throw std::runtime_error("image " + options.image.string() + " does not exist or is out of date");
+                    }
+                }
+
+                // Stops the heap statistics once the interpreter is destroyed, what it did not free was leaked
+                struct stop_heap_stats
+                {
+                    andy::lang::heap_stats* stats;
+
+                    ~stop_heap_stats()
+                    {
+                        if(stats) {
+                            stats->stop();
+                        }
+                    }
+                } heap_stats_guard{ options.heap_stats };
+
+                andy::lang::timings::scope structures_phase(options.timings, "create structures");
                 andy::lang::interpreter interpreter;
+                structures_phase.end();
+
                 interpreter.input_file_path = path;
-                std::shared_ptr<andy::lang::object> ret = interpreter.execute_all(root_node);
+                interpreter.timings = options.timings;
+
+                if(options.output) {
+                    interpreter.output = options.output;
+                }
+
+                interpreter.call_stats = options.call_stats;
+
+                if(options.max_depth) {
+                    interpreter.max_depth = options.max_depth;
+                }
+
+                // The objects of the interpreter itself are not counted
+                if(options.heap_stats) {
+                    interpreter.heap_stats = options.heap_stats;
+                    options.heap_stats->start();
+                }
+
+                if(image) {
+                    andy::lang::timings::scope restore_phase(options.timings, "restore image");
+                    image->restore(interpreter);
+                }
+
+                std::shared_ptr<andy::lang::object> ret;
+
+                andy::lang::timings::scope execute_phase(options.timings, "execute");
+
+                if(options.profiler) {
+                    interpreter.profiler = options.profiler;
+                    options.profiler->start(path.filename().string());
+
+                    try {
+                        ret = interpreter.execute_all(root_node);
+                    } catch(...) {
+                        options.profiler->stop();
+                        interpreter.profiler = nullptr;
+                        throw;
+                    }
+
+                    options.profiler->stop();
+                    interpreter.profiler = nullptr;
+                } else {
+                    ret = interpreter.execute_all(root_node);
+                }
         
+                execute_phase.end();
+
+                if(!options.store_image.empty()) {
+                    andy::lang::timings::scope store_phase(options.timings, "store image");
+                    andy::lang::image(options.store_image).store(root_node, dependencies, interpreter);
+                }
+
+                andy::lang::timings::scope extensions_phase(options.timings, "start extensions");
                 interpreter.start_extensions();
+                extensions_phase.end();
         
                 return ret;
             }
+
+            program::program(std::string __name, std::string __source)
+                : m_name(std::move(__name)), m_source(std::move(__source))
+            {
+                m_lexer.tokenize(m_name, m_source);
+                m_preprocessor.process(m_name, m_lexer);
+
+                andy::lang::parser p;
+                andy::lang::parser::ast_node root = p.parse_all(m_lexer);
+
+                m_declarations = andy::lang::parser::ast_node(root.type());
+                m_statements   = andy::lang::parser::ast_node(root.type());
+
+                for(auto& node : root.childrens()) {
+                    if(node.type() == andy::lang::parser::ast_node_type::ast_node_classdecl) {
+                        m_declarations.childrens().push_back(std::move(node));
+                    } else {
+                        m_statements.childrens().push_back(std::move(node));
+                    }
+                }
+
+                m_declarations.reindex();
+                m_statements.reindex();
+            }
+
+            engine::engine()
+            {
+            }
+
+            std::shared_ptr<andy::lang::api::program> engine::compile(const std::filesystem::path& __path)
+            {
+                return std::make_shared<andy::lang::api::program>(__path.string(), uva::file::read_all_text<char>(__path));
+            }
+
+            std::shared_ptr<andy::lang::api::program> engine::compile_source(std::string __source, std::string __name)
+            {
+                return std::make_shared<andy::lang::api::program>(std::move(__name), std::move(__source));
+            }
+
+            std::shared_ptr<andy::lang::object> engine::run(const std::shared_ptr<andy::lang::api::program>& __program, const andy::lang::api::bindings& __bindings)
+            {
+                if(!m_programs.contains(__program.get())) {
+                    std::set<std::string_view> names;
+
+                    for(const auto& declaration : __program->declarations().childrens()) {
+                        std::string_view name = declaration.decname();
+
+                        if(!names.insert(name).second || m_interpreter.find_class(name)) {
+                            throw std::runtime_error(declaration.token().error_message_at_current_position("class " + std::string(name) + " is already declared"));
+                        }
+                    }
+
+                    loaded_program loaded{ __program, {} };
+
+                    try {
+                        m_interpreter.execute_all(__program->declarations());
+                    } catch(...) {
+                        // The classes declared before the error would clash with the next run
+                        for(const auto& declaration : __program->declarations().childrens()) {
+                            if(auto cls = m_interpreter.find_class(declaration.decname())) {
+                                m_interpreter.unload(cls);
+                            }
+                        }
+
+                        throw;
+                    }
+
+                    for(const auto& declaration : __program->declarations().childrens()) {
+                        loaded.classes.push_back(m_interpreter.find_class(declaration.decname()));
+                    }
+
+                    m_programs.emplace(__program.get(), std::move(loaded));
+                }
+
+                m_interpreter.reset_globals();
+                m_last = __program.get();
+
+                for(const auto& [name, value] : __bindings) {
+                    auto it = m_names.find(name);
+
+                    if(it == m_names.end()) {
+                        it = m_names.insert(name).first;
+                    }
+
+                    m_interpreter.variables()[*it] = value;
+                }
+
+                return m_interpreter.execute_all(__program->statements());
+            }
+
+            void engine::unload(const std::shared_ptr<andy::lang::api::program>& __program)
+            {
+                auto it = m_programs.find(__program.get());
+
+                if(it == m_programs.end()) {
+                    return;
+                }
+
+                if(m_last == __program.get()) {
+                    m_interpreter.reset_globals();
+                    m_last = nullptr;
+                }
+
+                for(const auto& cls : it->second.classes) {
+                    m_interpreter.unload(cls);
+                }
+
+                m_programs.erase(it);
+            }
+
+            std::shared_ptr<andy::lang::object> engine::call_function(std::string_view __function, std::vector<std::shared_ptr<andy::lang::object>> __args)
+            {
+                auto it = m_interpreter.functions().find(__function);
+
+                if(it == m_interpreter.functions().end()) {
+                    throw std::runtime_error("function " + std::string(__function) + " not found");
+                }
+
+                return m_interpreter.call(nullptr, nullptr, it->second, std::move(__args));
+            }
         };
     };
 };
\ No newline at end of file
@@ -0,0 +1,508 @@
+#include <andy/lang/big_integer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    using limbs = std::vector<uint32_t>;
+
+    constexpr uint64_t limb_base = uint64_t(1) << 32;
+    // The largest power of 10 a limb holds, which decimal conversions work by
+    constexpr uint32_t decimal_chunk = 1000000000;
+    constexpr size_t decimal_chunk_digits = 9;
+
+    // __value = __value * __factor + __addend
+    void multiply_add(limbs& __value, uint32_t __factor, uint32_t __addend)
+    {
+        uint64_t carry = __addend;
+
+        for(uint32_t& limb : __value) {
+            uint64_t current = (uint64_t)limb * __factor + carry;
+            limb = (uint32_t)current;
+            carry = current >> 32;
+        }
+
+        if(carry) {
+            __value.push_back((uint32_t)carry);
+        }
+    }
+
+    // __value = __value / __divisor, returning the remainder
+    uint32_t divide_small(limbs& __value, uint32_t __divisor)
+    {
+        uint64_t remainder = 0;
+
+        for(size_t i = __value.size(); i-- > 0;) {
+            uint64_t current = (remainder << 32) | __value[i];
+            __value[i] = (uint32_t)(current / __divisor);
+            remainder = current % __divisor;
+        }
+
+        while(!__value.empty() && __value.back() == 0) {
+            __value.pop_back();
+        }
+
+        return (uint32_t)remainder;
+    }
+
+    // Add __value shifted by __offset limbs to __result, which is large enough to hold the sum
+    void add_at(limbs& __result, const limbs& __value, size_t __offset)
+    {
+        uint64_t carry = 0;
+        size_t i = 0;
+
+        for(; i < __value.size(); i++) {
+            uint64_t sum = (uint64_t)__result[__offset + i] + __value[i] + carry;
+            __result[__offset + i] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+
+        for(size_t j = __offset + i; carry; j++) {
+            uint64_t sum = (uint64_t)__result[j] + carry;
+            __result[j] = (uint32_t)sum;
+            carry = sum >> 32;
+        }
+    }
+
+    limbs slice(const limbs& __value, size_t __begin, size_t __end)
+    {
+        __end = std::min(__end, __value.size());
+
+        if(__begin >= __end) {
+            return {};
+        }
+
+        limbs part(__value.begin() + __begin, __value.begin() + __end);
+
+        while(!part.empty() && part.back() == 0) {
+            part.pop_back();
+        }
+
+        return part;
+    }
+
+    unsigned leading_zeros(uint32_t __value)
+    {
+        unsigned count = 0;
+
+        while(!(__value & 0x80000000u)) {
+            __value <<= 1;
+            count++;
+        }
+
+        return count;
+    }
+};
+
+andy::lang::big_integer::big_integer(int64_t __value)
+    : m_negative(__value < 0)
+{
+    uint64_t magnitude = m_negative ? 0 - (uint64_t)__value : (uint64_t)__value;
+
+    while(magnitude) {
+        m_limbs.push_back((uint32_t)magnitude);
+        magnitude >>= 32;
+    }
+}
+
+andy::lang::big_integer::big_integer(limbs __limbs, bool __negative)
+    : m_limbs(std::move(__limbs))
+{
+    trim(m_limbs);
+    m_negative = __negative && !m_limbs.empty();
+}
+
+andy::lang::big_integer andy::lang::big_integer::parse(std::string_view __text)
+{
+    bool negative = false;
+
+    if(!__text.empty() && (__text.front() == '-' || __text.front() == '+')) {
+        negative = __text.front() == '-';
+        __text.remove_prefix(1);
+    }
+
+    if(__text.empty() || !std::all_of(__text.begin(), __text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw std::runtime_error("'" + std::string(__text) + "' is not an integer");
+    }
+
+    limbs value;
+    value.reserve(__text.size() / decimal_chunk_digits + 1);
+
+    // The first chunk takes the digits left over, so the others have exactly decimal_chunk_digits
+    size_t first = __text.size() % decimal_chunk_digits;
+
+    if(first == 0) {
+        first = decimal_chunk_digits;
+    }
+
+    for(size_t begin = 0, length = first; begin < __text.size(); begin += length, length = decimal_chunk_digits) {
+        uint32_t chunk = 0;
+        uint32_t factor = 1;
+
+        for(size_t i = begin; i < begin + length; i++) {
+            chunk = chunk * 10 + (uint32_t)(__text[i] - '0');
+            factor *= 10;
+        }
+
+        multiply_add(value, factor, chunk);
+    }
+
+    return big_integer(std::move(value), negative);
+}
+
+bool andy::lang::big_integer::fits_int64() const
+{
+    if(m_limbs.size() > 2) {
+        return false;
+    }
+
+    uint64_t magnitude = 0;
+
+    for(size_t i = m_limbs.size(); i-- > 0;) {
+        magnitude = (magnitude << 32) | m_limbs[i];
+    }
+
+    // The magnitude of INT64_MIN is one more than INT64_MAX
+    return magnitude <= (uint64_t)INT64_MAX + (m_negative ? 1 : 0);
+}
+
+int64_t andy::lang::big_integer::to_int64() const
+{
+    uint64_t magnitude = 0;
+
+    for(size_t i = std::min<size_t>(m_limbs.size(), 2); i-- > 0;) {
+        magnitude = (magnitude << 32) | m_limbs[i];
+    }
+
+    return m_negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+}
+
+double andy::lang::big_integer::to_double() const
+{
+    double value = 0;
+
+    for(size_t i = m_limbs.size(); i-- > 0;) {
+        value = value * (double)limb_base + m_limbs[i];
+    }
+
+    return m_negative ? -value : value;
+}
+
+std::string andy::lang::big_integer::to_string() const
+{
+    if(m_limbs.empty()) {
+        return "0";
+    }
+
+    limbs value = m_limbs;
+    std::vector<uint32_t> chunks;
+
+    while(!value.empty()) {
+        chunks.push_back(divide_small(value, decimal_chunk));
+    }
+
+    std::string text;
+    text.reserve(chunks.size() * decimal_chunk_digits + 1);
+
+    if(m_negative) {
+        text.push_back('-');
+    }
+
+    text += std::to_string(chunks.back());
+
+    for(size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string chunk = std::to_string(chunks[i]);
+        text.append(decimal_chunk_digits - chunk.size(), '0');
+        text += chunk;
+    }
+
+    return text;
+}
+
+int andy::lang::big_integer::compare(const big_integer& __other) const
+{
+    if(m_negative != __other.m_negative) {
+        return m_negative ? -1 : 1;
+    }
+
+    int magnitudes = compare_magnitudes(m_limbs, __other.m_limbs);
+
+    return m_negative ? -magnitudes : magnitudes;
+}
+
+andy::lang::big_integer andy::lang::big_integer::operator-() const
+{
+    return big_integer(m_limbs, !m_negative);
+}
+
+andy::lang::big_integer andy::lang::big_integer::operator+(const big_integer& __other) const
+{
+    if(m_negative == __other.m_negative) {
+        return big_integer(add_magnitudes(m_limbs, __other.m_limbs), m_negative);
+    }
+
+    // The sign is the one of the operand with the larger magnitude
+    if(compare_magnitudes(m_limbs, __other.m_limbs) >= 0) {
+        return big_integer(sub_magnitudes(m_limbs, __other.m_limbs), m_negative);
+    }
+
+    return big_integer(sub_magnitudes(__other.m_limbs, m_limbs), __other.m_negative);
+}
+
+andy::lang::big_integer andy::lang::big_integer::operator-(const big_integer& __other) const
+{
+    return *this + -__other;
+}
+
+andy::lang::big_integer andy::lang::big_integer::operator*(const big_integer& __other) const
+{
+    return big_integer(multiply_magnitudes(m_limbs, __other.m_limbs), m_negative != __other.m_negative);
+}
+
+andy::lang::big_integer andy::lang::big_integer::operator/(const big_integer& __other) const
+{
+    if(__other.is_zero()) {
+        throw std::runtime_error("division by zero");
+    }
+
+    limbs quotient;
+    divide_magnitudes(m_limbs, __other.m_limbs, &quotient, nullptr);
+
+    return big_integer(std::move(quotient), m_negative != __other.m_negative);
+}
+
+andy::lang::big_integer andy::lang::big_integer::operator%(const big_integer& __other) const
+{
+    if(__other.is_zero()) {
+        throw std::runtime_error("division by zero");
+    }
+
+    limbs remainder;
+    divide_magnitudes(m_limbs, __other.m_limbs, nullptr, &remainder);
+
+    return big_integer(std::move(remainder), m_negative);
+}
+
+int andy::lang::big_integer::compare_magnitudes(const limbs& __a, const limbs& __b)
+{
+    if(__a.size() != __b.size()) {
+        return __a.size() < __b.size() ? -1 : 1;
+    }
+
+    for(size_t i = __a.size(); i-- > 0;) {
+        if(__a[i] != __b[i]) {
+            return __a[i] < __b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+andy::lang::big_integer::limbs andy::lang::big_integer::add_magnitudes(const limbs& __a, const limbs& __b)
+{
+    const limbs& longer = __a.size() >= __b.size() ? __a : __b;
+    const limbs& shorter = __a.size() >= __b.size() ? __b : __a;
+
+    limbs sum(longer.size() + 1, 0);
+    std::copy(longer.begin(), longer.end(), sum.begin());
+    add_at(sum, shorter, 0);
+    trim(sum);
+
+    return sum;
+}
+
+andy::lang::big_integer::limbs andy::lang::big_integer::sub_magnitudes(const limbs& __a, const limbs& __b)
+{
+    limbs difference(__a.size());
+    int64_t borrow = 0;
+
+    for(size_t i = 0; i < __a.size(); i++) {
+        int64_t current = (int64_t)__a[i] - borrow - (i < __b.size() ? (int64_t)__b[i] : 0);
+        borrow = current < 0 ? 1 : 0;
+        difference[i] = (uint32_t)(current + (borrow ? (int64_t)limb_base : 0));
+    }
+
+    trim(difference);
+
+    return difference;
+}
+
+andy::lang::big_integer::limbs andy::lang::big_integer::multiply_magnitudes(const limbs& __a, const limbs& __b)
+{
+    if(__a.size() < __b.size()) {
+        return multiply_magnitudes(__b, __a);
+    }
+
+    if(__b.empty()) {
+        return {};
+    }
+
+    limbs product(__a.size() + __b.size(), 0);
+
+    if(__b.size() < karatsuba_threshold) {
+        // Schoolbook
+        for(size_t i = 0; i < __b.size(); i++) {
+            uint64_t carry = 0;
+
+            for(size_t j = 0; j < __a.size(); j++) {
+                uint64_t current = (uint64_t)__b[i] * __a[j] + product[i + j] + carry;
+                product[i + j] = (uint32_t)current;
+                carry = current >> 32;
+            }
+
+            product[i + __a.size()] = (uint32_t)carry;
+        }
+
+        trim(product);
+
+        return product;
+    }
+
+    size_t half = __a.size() / 2;
+
+    limbs a_low = slice(__a, 0, half);
+    limbs a_high = slice(__a, half, __a.size());
+
+    if(__b.size() <= half) {
+        // __b has no high half: each half of __a is multiplied by the whole of it
+        add_at(product, multiply_magnitudes(a_low, __b), 0);
+        add_at(product, multiply_magnitudes(a_high, __b), half);
+        trim(product);
+
+        return product;
+    }
+
+    limbs b_low = slice(__b, 0, half);
+    limbs b_high = slice(__b, half, __b.size());
+
+    // (a_high * B + a_low) * (b_high * B + b_low) takes three products instead of four, the middle term is
+    // (a_low + a_high) * (b_low + b_high) - low - high
+    limbs low = multiply_magnitudes(a_low, b_low);
+    limbs high = multiply_magnitudes(a_high, b_high);
+    limbs middle = multiply_magnitudes(add_magnitudes(a_low, a_high), add_magnitudes(b_low, b_high));
+    middle = sub_magnitudes(sub_magnitudes(middle, low), high);
+
+    add_at(product, low, 0);
+    add_at(product, middle, half);
+    add_at(product, high, 2 * half);
+    trim(product);
+
+    return product;
+}
+
+void andy::lang::big_integer::divide_magnitudes(const limbs& __a, const limbs& __b, limbs* __quotient, limbs* __remainder)
+{
+    if(compare_magnitudes(__a, __b) < 0) {
+        if(__quotient) {
+            __quotient->clear();
+        }
+        if(__remainder) {
+            *__remainder = __a;
+        }
+        return;
+    }
+
+    if(__b.size() == 1) {
+        limbs quotient = __a;
+        uint32_t remainder = divide_small(quotient, __b[0]);
+
+        if(__quotient) {
+            *__quotient = std::move(quotient);
+        }
+        if(__remainder) {
+            *__remainder = remainder ? limbs{ remainder } : limbs{};
+        }
+        return;
+    }
+
+    // Knuth's algorithm D. The divisor is shifted until its top bit is set, so the quotient limbs estimated from
+    // the top limbs are at most 2 too large
+    size_t n = __b.size();
+    size_t m = __a.size();
+    unsigned shift = leading_zeros(__b.back());
+
+    limbs divisor(n);
+    limbs dividend(m + 1);
+
+    for(size_t i = n; i-- > 0;) {
+        divisor[i] = (uint32_t)(((uint64_t)__b[i] << shift) | (i ? (uint64_t)__b[i - 1] >> (32 - shift) : 0));
+    }
+
+    dividend[m] = (uint32_t)((uint64_t)__a[m - 1] >> (32 - shift));
+
+    for(size_t i = m; i-- > 0;) {
+        dividend[i] = (uint32_t)(((uint64_t)__a[i] << shift) | (i ? (uint64_t)__a[i - 1] >> (32 - shift) : 0));
+    }
+
+    limbs quotient(m - n + 1, 0);
+
+    for(size_t j = m - n + 1; j-- > 0;) {
+        uint64_t top = ((uint64_t)dividend[j + n] << 32) | dividend[j + n - 1];
+        uint64_t estimate = top / divisor[n - 1];
+        uint64_t rest = top % divisor[n - 1];
+
+        while(estimate >= limb_base || estimate * divisor[n - 2] > ((rest << 32) | dividend[j + n - 2])) {
+            estimate--;
+            rest += divisor[n - 1];
+
+            if(rest >= limb_base) {
+                break;
+            }
+        }
+
+        // Subtract estimate * divisor from the dividend
+        int64_t borrow = 0;
+        int64_t current = 0;
+
+        for(size_t i = 0; i < n; i++) {
+            uint64_t product = estimate * divisor[i];
+            current = (int64_t)dividend[i + j] - borrow - (int64_t)(product & 0xFFFFFFFF);
+            dividend[i + j] = (uint32_t)current;
+            borrow = (int64_t)(product >> 32) - (current >> 32);
+        }
+
+        current = (int64_t)dividend[j + n] - borrow;
+        dividend[j + n] = (uint32_t)current;
+
+        quotient[j] = (uint32_t)estimate;
+
+        if(current < 0) {
+            // The estimate was one too large, the divisor is added back
+            quotient[j]--;
+
+            uint64_t carry = 0;
+
+            for(size_t i = 0; i < n; i++) {
+                uint64_t sum = (uint64_t)dividend[i + j] + divisor[i] + carry;
+                dividend[i + j] = (uint32_t)sum;
+                carry = sum >> 32;
+            }
+
+            dividend[j + n] += (uint32_t)carry;
+        }
+    }
+
+    if(__quotient) {
+        trim(quotient);
+        *__quotient = std::move(quotient);
+    }
+
+    if(__remainder) {
+        limbs remainder(n);
+
+        for(size_t i = 0; i < n; i++) {
+            remainder[i] = (uint32_t)(((uint64_t)dividend[i] >> shift) | ((uint64_t)dividend[i + 1] << (32 - shift)));
+        }
+
+        trim(remainder);
+        *__remainder = std::move(remainder);
+    }
+}
+
+void andy::lang::big_integer::trim(limbs& __value)
+{
+    while(!__value.empty() && __value.back() == 0) {
+        __value.pop_back();
+    }
+}
@@ -0,0 +1,141 @@
+#include <andy/lang/call_stats.hpp>
+#include <andy/lang/method.hpp>
+#include <andy/lang/class.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <map>
+#include <tuple>
+
+namespace
+{
+    double to_milliseconds(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+};
+
+void andy::lang::call_stats::enter(const andy::lang::method& __method, const andy::lang::structure* __cls)
+{
+    // The functions of a context are copied with it, but they all point to the same declaration
+    key k{ __method.block_ast ? (const void*)__method.block_ast : (const void*)&__method, __cls };
+
+    auto [it, inserted] = m_slots.try_emplace(k, m_entries.size());
+
+    if(inserted) {
+        entry e;
+        e.cls    = __cls ? __cls->name : std::string();
+        e.method = __method.name;
+        e.native = __method.block_ast == nullptr;
+
+        m_entries.push_back(std::move(e));
+        m_active.push_back(0);
+    }
+
+    size_t slot = it->second;
+
+    m_entries[slot].calls++;
+    m_active[slot]++;
+
+    m_stack.push_back({ slot, std::chrono::steady_clock::now(), std::chrono::nanoseconds(0) });
+}
+
+void andy::lang::call_stats::leave()
+{
+    frame f = m_stack.back();
+    m_stack.pop_back();
+
+    std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - f.start;
+    entry& e = m_entries[f.slot];
+
+    if(--m_active[f.slot] == 0) {
+        e.inclusive += elapsed;
+    }
+
+    e.exclusive += elapsed - f.children;
+
+    if(!m_stack.empty()) {
+        m_stack.back().children += elapsed;
+    }
+}
+
+std::vector<andy::lang::call_stats::entry> andy::lang::call_stats::entries() const
+{
+    std::map<std::tuple<std::string_view, std::string_view, bool>, entry> merged;
+
+    for(const entry& e : m_entries) {
+        entry& m = merged[{ e.cls, e.method, e.native }];
+
+        if(!m.calls) {
+            m.cls    = e.cls;
+            m.method = e.method;
+            m.native = e.native;
+        }
+
+        m.calls     += e.calls;
+        m.inclusive += e.inclusive;
+        m.exclusive += e.exclusive;
+    }
+
+    std::vector<entry> result;
+    result.reserve(merged.size());
+
+    for(auto& [k, e] : merged) {
+        result.push_back(std::move(e));
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const entry& a, const entry& b) {
+        return a.exclusive > b.exclusive;
+    });
+
+    return result;
+}
+
+void andy::lang::call_stats::write_report(std::ostream& __out) const
+{
+    std::vector<entry> all = entries();
+
+    std::chrono::nanoseconds native(0);
+    std::chrono::nanoseconds andy_defined(0);
+
+    __out << std::setw(12) << "calls" << std::setw(16) << "inclusive ms" << std::setw(16) << "exclusive ms" << "  kind    method" << std::endl;
+    __out << std::fixed << std::setprecision(3);
+
+    for(const entry& e : all) {
+        __out << std::setw(12) << e.calls;
+        __out << std::setw(16) << to_milliseconds(e.inclusive);
+        __out << std::setw(16) << to_milliseconds(e.exclusive);
+        __out << "  " << (e.native ? "native  " : "andy    ");
+
+        if(!e.cls.empty()) {
+            __out << e.cls << '.';
+        }
+
+        __out << e.method << std::endl;
+
+        (e.native ? native : andy_defined) += e.exclusive;
+    }
+
+    __out << std::endl;
+    __out << "native methods: " << to_milliseconds(native) << " ms" << std::endl;
+    __out << "andy methods:   " << to_milliseconds(andy_defined) << " ms" << std::endl;
+}
+
+void andy::lang::call_stats::write_json(std::ostream& __out) const
+{
+    std::vector<entry> all = entries();
+
+    __out << "[\n";
+
+    for(size_t i = 0; i < all.size(); i++) {
+        const entry& e = all[i];
+
+        // Class and method names are identifiers or operators, none of them needs to be escaped
+        __out << "\t{ \"class\": \"" << e.cls << "\", \"method\": \"" << e.method << "\", ";
+        __out << "\"native\": " << (e.native ? "true" : "false") << ", \"calls\": " << e.calls << ", ";
+        __out << "\"inclusive_ns\": " << e.inclusive.count() << ", \"exclusive_ns\": " << e.exclusive.count() << " }";
+        __out << (i + 1 < all.size() ? ",\n" : "\n");
+    }
+
+    __out << "]\n";
+}
@@ -4,8 +4,9 @@
 
 #include "classes/false_class.cpp"
 #include "classes/true_class.cpp"
-#include "classes/string_class.cpp"
 #include "classes/integer_class.cpp"
+#include "classes/big_integer_class.cpp"
+#include "classes/string_class.cpp"
 #include "classes/double_class.cpp"
 #include "classes/float_class.cpp"
 #include "classes/file_class.cpp"
@@ -17,6 +18,13 @@
 #include "classes/path_class.cpp"
 #include "classes/andy_config_class.cpp"
 #include "classes/class_class.cpp"
+#include "classes/worker_class.cpp"
+#include "classes/task_class.cpp"
+#include "classes/socket_class.cpp"
+#include "classes/async_class.cpp"
+#include "classes/generator_class.cpp"
+#include "classes/fiber_class.cpp"
+#include "classes/channel_class.cpp"
 
 void andy::lang::structure::create_structures(andy::lang::interpreter* interpreter)
 {
@@ -24,19 +32,65 @@ void andy::lang::structure::create_structures(andy::lang::interpreter* interpret
     interpreter->load(interpreter->TrueClass        = create_true_class        (interpreter) );
     interpreter->load(interpreter->StringClass      = create_string_class      (interpreter) );
     interpreter->load(interpreter->IntegerClass     = create_integer_class     (interpreter) );
+    interpreter->load(interpreter->BigIntegerClass  = create_big_integer_class (interpreter) );
     interpreter->load(interpreter->DoubleClass      = create_double_class      (interpreter) );
     interpreter->load(interpreter->FloatClass       = create_float_class       (interpreter) );
-    interpreter->load(interpreter->FileClass        = create_file_class        (interpreter) );
     interpreter->load(interpreter->StdClass         = create_std_class         (interpreter) );
     interpreter->load(interpreter->ArrayClass       = create_array_class       (interpreter) );
     interpreter->load(interpreter->NullClass        = create_null_class        (interpreter) );
     interpreter->load(interpreter->DictionaryClass  = create_dictionary_class  (interpreter) );
-    interpreter->load(interpreter->SystemClass      = create_system_class      (interpreter) );
-    interpreter->load(interpreter->PathClass        = create_path_class        (interpreter) );
-    interpreter->load(interpreter->AndyConfigClass  = create_andy_config_class (interpreter) );
     interpreter->load(interpreter->ClassClass       = create_class_class       (interpreter) );
 }
 
+namespace
+{
+    // The builtin classes few programs use. They are created when they are first referenced, by find_class or by
+    // their accessor in the interpreter.
+    struct lazy_structure
+    {
+        std::string_view name;
+        std::shared_ptr<andy::lang::structure> andy::lang::interpreter::* member;
+        std::shared_ptr<andy::lang::structure> (*create)(andy::lang::interpreter* interpreter);
+    };
+};
+
+std::shared_ptr<andy::lang::structure> andy::lang::structure::create_lazy_structure(andy::lang::interpreter* interpreter, std::string_view name)
+{
+    // The members are private to the interpreter, which makes structure a friend
+    static constexpr lazy_structure lazy_structures[] = {
+        { "File",       &andy::lang::interpreter::m_file_class,        create_file_class        },
+        { "System",     &andy::lang::interpreter::m_system_class,      create_system_class      },
+        { "Path",       &andy::lang::interpreter::m_path_class,        create_path_class        },
+        { "AndyConfig", &andy::lang::interpreter::m_andy_config_class, create_andy_config_class },
+        { "Worker",     &andy::lang::interpreter::m_worker_class,      create_worker_class      },
+        { "Async",      &andy::lang::interpreter::m_async_class,       create_async_class       },
+        { "Task",       &andy::lang::interpreter::m_task_class,        create_task_class        },
+        { "Socket",     &andy::lang::interpreter::m_socket_class,      create_socket_class      },
+        { "Generator",  &andy::lang::interpreter::m_generator_class,   create_generator_class   },
+        { "Fiber",      &andy::lang::interpreter::m_fiber_class,       create_fiber_class       },
+        { "Channel",    &andy::lang::interpreter::m_channel_class,     create_channel_class     },
+    };
+
+    for(const lazy_structure& lazy : lazy_structures) {
+        if(lazy.name != name) {
+            continue;
+        }
+
+        std::shared_ptr<andy::lang::structure>& cls = interpreter->*lazy.member;
+
+        if(cls) {
+            return nullptr;
+        }
+
+        cls = lazy.create(interpreter);
+        interpreter->load(cls);
+
+        return cls;
+    }
+
+    return nullptr;
+}
+
 andy::lang::structure::structure(const std::string& __name, std::vector<andy::lang::method> __methods)
     : name(__name)
 {
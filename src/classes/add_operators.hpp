@@ -2,6 +2,7 @@
 #include <andy/lang/class.hpp>
 #include <andy/lang/method.hpp>
 #include <andy/lang/object.hpp>
+#include <andy/lang/big_integer.hpp>
 
 namespace andy
 {
@@ -16,9 +17,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->DoubleClass, value + other->as<double>());
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return andy::lang::object::instantiate(interpreter, cls, value + other->as<int>());
+                    return andy::lang::object::instantiate(interpreter, cls, value + other->as<int64_t>());
                 } else if(other->cls == interpreter->FloatClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->FloatClass, value + other->as<float>());
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return andy::lang::object::instantiate(interpreter, cls, value + (T)other->as<andy::lang::big_integer>().to_double());
                 }
 
                 throw std::runtime_error("undefined operator+(" + object->cls->name + ", " + other->cls->name + ")");
@@ -29,9 +32,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->DoubleClass, value - other->as<double>());
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return andy::lang::object::instantiate(interpreter, cls, value - other->as<int>());
+                    return andy::lang::object::instantiate(interpreter, cls, value - other->as<int64_t>());
                 } else if(other->cls == interpreter->FloatClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->FloatClass, value - other->as<float>());
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return andy::lang::object::instantiate(interpreter, cls, value - (T)other->as<andy::lang::big_integer>().to_double());
                 }
 
                 throw std::runtime_error("undefined operator-(" + object->cls->name + ", " + other->cls->name + ")");
@@ -42,9 +47,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->DoubleClass, value * other->as<double>());
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return andy::lang::object::instantiate(interpreter, cls, value * other->as<int>());
+                    return andy::lang::object::instantiate(interpreter, cls, value * other->as<int64_t>());
                 } else if(other->cls == interpreter->FloatClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->FloatClass, value * other->as<float>());
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return andy::lang::object::instantiate(interpreter, cls, value * (T)other->as<andy::lang::big_integer>().to_double());
                 }
 
                 throw std::runtime_error("undefined operator*(" + object->cls->name + ", " + other->cls->name + ")");
@@ -55,9 +62,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->DoubleClass, value / other->as<double>());
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return andy::lang::object::instantiate(interpreter, cls, value / other->as<int>());
+                    return andy::lang::object::instantiate(interpreter, cls, value / other->as<int64_t>());
                 } else if(other->cls == interpreter->FloatClass) {
                     return andy::lang::object::instantiate(interpreter, interpreter->FloatClass, value / other->as<float>());
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return andy::lang::object::instantiate(interpreter, cls, value / (T)other->as<andy::lang::big_integer>().to_double());
                 }
 
                 throw std::runtime_error("undefined operator/(" + object->cls->name + ", " + other->cls->name + ")");
@@ -67,7 +76,7 @@ namespace andy
                     T& value = object->as<T>();
                     std::shared_ptr<andy::lang::object> other = params[0];
                     if(other->cls == interpreter->IntegerClass) {
-                        return andy::lang::object::instantiate(interpreter, cls, value % other->as<int>());
+                        return andy::lang::object::instantiate(interpreter, cls, value % other->as<int64_t>());
                     }
 
                     throw std::runtime_error("undefined operator%(" + object->cls->name + ", " + other->cls->name + ")");
@@ -85,9 +94,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return value != other->as<double>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return value != other->as<int>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                    return value != other->as<int64_t>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->FloatClass) {
                     return value != other->as<float>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return value != other->as<andy::lang::big_integer>().to_double() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 }
 
                 throw std::runtime_error("undefined operator!=(" + object->cls->name + ", " + other->cls->name + ")");
@@ -98,9 +109,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return value == other->as<double>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return value == other->as<int>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                    return value == other->as<int64_t>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->FloatClass) {
                     return value == other->as<float>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return value == other->as<andy::lang::big_integer>().to_double() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 }
 
                 throw std::runtime_error("undefined operator==(" + object->cls->name + ", " + other->cls->name + ")");
@@ -111,9 +124,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return value < other->as<double>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return value < other->as<int>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                    return value < other->as<int64_t>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->FloatClass) {
                     return value < other->as<float>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return value < other->as<andy::lang::big_integer>().to_double() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 }
 
                 throw std::runtime_error("undefined operator<(" + object->cls->name + ", " + other->cls->name + ")");
@@ -124,9 +139,11 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     return value > other->as<double>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->IntegerClass) {
-                    return value > other->as<int>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                    return value > other->as<int64_t>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 } else if(other->cls == interpreter->FloatClass) {
                     return value > other->as<float>() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
+                } else if(other->cls == interpreter->BigIntegerClass) {
+                    return value > other->as<andy::lang::big_integer>().to_double() ? std::make_shared<andy::lang::object>(interpreter->TrueClass) : std::make_shared<andy::lang::object>(interpreter->FalseClass);
                 }
 
                 throw std::runtime_error("undefined operator>(" + object->cls->name + ", " + other->cls->name + ")");
@@ -137,7 +154,7 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     value += other->as<double>();
                 } else if(other->cls == interpreter->IntegerClass) {
-                    value += other->as<int>();
+                    value += other->as<int64_t>();
                 } else if(other->cls == interpreter->FloatClass) {
                     value += other->as<float>();
                 } else {
@@ -152,7 +169,7 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     value -= other->as<double>();
                 } else if(other->cls == interpreter->IntegerClass) {
-                    value -= other->as<int>();
+                    value -= other->as<int64_t>();
                 } else if(other->cls == interpreter->FloatClass) {
                     value -= other->as<float>();
                 } else {
@@ -167,7 +184,7 @@ namespace andy
                 if(other->cls == interpreter->DoubleClass) {
                     value *= other->as<double>();
                 } else if(other->cls == interpreter->IntegerClass) {
-                    value *= other->as<int>();
+                    value *= other->as<int64_t>();
                 } else if(other->cls == interpreter->FloatClass) {
                     value *= other->as<float>();
                 } else {
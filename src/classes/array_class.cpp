@@ -1,6 +1,25 @@
 #include <andy/lang/lang.hpp>
 
 #include <andy/lang/interpreter.hpp>
+#include <andy/lang/parallel.hpp>
+
+// The function a parallel method calls, a global function of the program named by a string
+static andy::lang::method array_callback(andy::lang::interpreter* interpreter, std::string_view method_name, const std::shared_ptr<andy::lang::object>& name)
+{
+    if(name->cls != interpreter->StringClass) {
+        throw std::runtime_error("Array." + std::string(method_name) + ": expected the name of a function");
+    }
+
+    const std::string& function_name = name->as<std::string>();
+
+    auto it = interpreter->caller_functions().find(function_name);
+
+    if(it == interpreter->caller_functions().end()) {
+        throw std::runtime_error("Array." + std::string(method_name) + ": function " + function_name + " not found");
+    }
+
+    return it->second;
+}
 
 std::shared_ptr<andy::lang::structure> create_array_class(andy::lang::interpreter* interpreter)
 {
@@ -67,7 +86,7 @@ std::shared_ptr<andy::lang::structure> create_array_class(andy::lang::interprete
         {"size", andy::lang::method("size",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::vector<std::shared_ptr<andy::lang::object>>& items = object->as<std::vector<std::shared_ptr<andy::lang::object>>>();
 
-            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, items.size());
+            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, (int64_t)items.size());
         })},
 
         {"pop_front!", andy::lang::method("pop_front!",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
@@ -83,10 +102,33 @@ std::shared_ptr<andy::lang::structure> create_array_class(andy::lang::interprete
         {"[]", andy::lang::method("[]",andy::lang::method_storage_type::instance_method, {"index"} , [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::vector<std::shared_ptr<andy::lang::object>>& items = object->as<std::vector<std::shared_ptr<andy::lang::object>>>();
 
-            auto index = params[0]->as<int>();
+            auto index = params[0]->as<int64_t>();
 
             return items[index];
         })},
+
+        {"parallel_map", andy::lang::method("parallel_map",andy::lang::method_storage_type::instance_method, {"function"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            std::vector<std::shared_ptr<andy::lang::object>>& items = object->as<std::vector<std::shared_ptr<andy::lang::object>>>();
+            andy::lang::method function = array_callback(interpreter, "parallel_map", params[0]);
+
+            return andy::lang::object::create(interpreter, interpreter->ArrayClass, andy::lang::parallel::map(interpreter, items, function));
+        })},
+
+        {"parallel_each", andy::lang::method("parallel_each",andy::lang::method_storage_type::instance_method, {"function"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            std::vector<std::shared_ptr<andy::lang::object>>& items = object->as<std::vector<std::shared_ptr<andy::lang::object>>>();
+            andy::lang::method function = array_callback(interpreter, "parallel_each", params[0]);
+
+            andy::lang::parallel::each(interpreter, items, function);
+
+            return nullptr;
+        })},
+
+        {"parallel_reduce", andy::lang::method("parallel_reduce",andy::lang::method_storage_type::instance_method, {"function", "initial"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            std::vector<std::shared_ptr<andy::lang::object>>& items = object->as<std::vector<std::shared_ptr<andy::lang::object>>>();
+            andy::lang::method function = array_callback(interpreter, "parallel_reduce", params[0]);
+
+            return andy::lang::parallel::reduce(interpreter, items, function, params[1]);
+        })},
     };
     
     return ArrayClass;
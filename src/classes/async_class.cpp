@@ -0,0 +1,58 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/event_loop.hpp>
+
+// A path of the program, relative to its working directory
+static std::filesystem::path async_path(andy::lang::interpreter* interpreter, const std::shared_ptr<andy::lang::object>& path_object)
+{
+    if(path_object->cls == interpreter->StringClass) {
+        return interpreter->resolve(path_object->as<std::string>());
+    } else if(path_object->cls == interpreter->PathClass()) {
+        return interpreter->resolve(path_object->as<std::filesystem::path>());
+    }
+
+    throw std::runtime_error("invalid path");
+}
+
+std::shared_ptr<andy::lang::structure> create_async_class(andy::lang::interpreter* interpreter)
+{
+    auto AsyncClass = std::make_shared<andy::lang::structure>("Async");
+
+    AsyncClass->class_methods = {
+        { "read", andy::lang::method("read",andy::lang::method_storage_type::class_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().read_file(async_path(interpreter, params[0])));
+        })},
+        { "write", andy::lang::method("write",andy::lang::method_storage_type::class_method, {"path", "content"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().write_file(async_path(interpreter, params[0]), params[1]->as<std::string>()));
+        })},
+        { "system", andy::lang::method("system",andy::lang::method_storage_type::class_method, {"command"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().run_process(params[0]->as<std::string>(), {}, interpreter->working_directory));
+        })},
+        { "process", andy::lang::method("process",andy::lang::method_storage_type::class_method, {"command", "input"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().run_process(params[0]->as<std::string>(), params[1]->as<std::string>(), interpreter->working_directory));
+        })},
+        { "sleep", andy::lang::method("sleep",andy::lang::method_storage_type::class_method, {"milliseconds"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().timer(std::chrono::milliseconds(params[0]->as<int64_t>())));
+        })},
+        { "listen", andy::lang::method("listen",andy::lang::method_storage_type::class_method, {"port"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_socket(interpreter, andy::lang::event_loop::listen_tcp((int)params[0]->as<int64_t>()));
+        })},
+        { "listen_unix", andy::lang::method("listen_unix",andy::lang::method_storage_type::class_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_socket(interpreter, andy::lang::event_loop::listen_unix(async_path(interpreter, params[0])));
+        })},
+        { "connect", andy::lang::method("connect",andy::lang::method_storage_type::class_method, {"port"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().connect_tcp((int)params[0]->as<int64_t>()));
+        })},
+        { "connect_unix", andy::lang::method("connect_unix",andy::lang::method_storage_type::class_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().connect_unix(async_path(interpreter, params[0])));
+        })},
+        // Waiting for one task runs the loop, which progresses all of them. run waits for all of them.
+        { "run", andy::lang::method("run",andy::lang::method_storage_type::class_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            interpreter->loop().run();
+
+            return nullptr;
+        })},
+    };
+
+    return AsyncClass;
+}
@@ -0,0 +1,116 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/big_integer.hpp>
+
+#include <functional>
+
+// An operator of BigInteger. Its result becomes an Integer when it fits in 64 bits again.
+template<typename Big, typename Real>
+static andy::lang::method big_integer_operator(andy::lang::interpreter* interpreter, const std::string& name, Big big, Real real)
+{
+    return andy::lang::method(name, andy::lang::method_storage_type::instance_method, {"other"}, [interpreter, name, big, real](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+        const andy::lang::big_integer& value = object->as<andy::lang::big_integer>();
+        const std::shared_ptr<andy::lang::object>& other = params[0];
+
+        if(other->cls == interpreter->IntegerClass || other->cls == interpreter->BigIntegerClass) {
+            return integer_to_object(interpreter, big(value, integer_value(interpreter, *other)));
+        }
+
+        if constexpr(!std::is_same_v<Real, std::nullptr_t>) {
+            if(other->cls == interpreter->DoubleClass) {
+                return andy::lang::object::instantiate(interpreter, interpreter->DoubleClass, real(value.to_double(), other->as<double>()));
+            } else if(other->cls == interpreter->FloatClass) {
+                return andy::lang::object::instantiate(interpreter, interpreter->FloatClass, real((float)value.to_double(), other->as<float>()));
+            }
+        }
+
+        throw std::runtime_error("undefined operator" + name + "(" + object->cls->name + ", " + other->cls->name + ")");
+    });
+}
+
+// An assignment operator of BigInteger, which stays one only while its value does not fit in 64 bits
+template<typename Big>
+static andy::lang::method big_integer_assignment(andy::lang::interpreter* interpreter, const std::string& name, Big big)
+{
+    return andy::lang::method(name, andy::lang::method_storage_type::instance_method, {"other"}, [interpreter, name, big](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+        const std::shared_ptr<andy::lang::object>& other = params[0];
+
+        if(other->cls != interpreter->IntegerClass && other->cls != interpreter->BigIntegerClass) {
+            throw std::runtime_error("undefined operator" + name + "(" + object->cls->name + ", " + other->cls->name + ")");
+        }
+
+        assign_integer(interpreter, *object, big(object->as<andy::lang::big_integer>(), integer_value(interpreter, *other)));
+
+        return std::shared_ptr<andy::lang::object>(nullptr);
+    });
+}
+
+// A comparison of BigInteger, with any number
+template<typename Compare>
+static andy::lang::method big_integer_comparison(andy::lang::interpreter* interpreter, const std::string& name, Compare compare)
+{
+    return andy::lang::method(name, andy::lang::method_storage_type::instance_method, {"other"}, [interpreter, name, compare](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+        const andy::lang::big_integer& value = object->as<andy::lang::big_integer>();
+        const std::shared_ptr<andy::lang::object>& other = params[0];
+        bool result;
+
+        if(other->cls == interpreter->IntegerClass || other->cls == interpreter->BigIntegerClass) {
+            result = compare(value, integer_value(interpreter, *other));
+        } else if(other->cls == interpreter->DoubleClass) {
+            result = compare(value.to_double(), other->as<double>());
+        } else if(other->cls == interpreter->FloatClass) {
+            result = compare(value.to_double(), (double)other->as<float>());
+        } else {
+            throw std::runtime_error("undefined operator" + name + "(" + object->cls->name + ", " + other->cls->name + ")");
+        }
+
+        return std::make_shared<andy::lang::object>(result ? interpreter->TrueClass : interpreter->FalseClass);
+    });
+}
+
+std::shared_ptr<andy::lang::structure> create_big_integer_class(andy::lang::interpreter* interpreter)
+{
+    std::shared_ptr<andy::lang::structure> BigIntegerClass = std::make_shared<andy::lang::structure>("BigInteger");
+    BigIntegerClass->object_to_var = [](std::shared_ptr<const andy::lang::object> obj) {
+        // var has no integer larger than 64 bits, the digits are kept instead
+        return var(obj->as<andy::lang::big_integer>().to_string());
+    };
+
+    BigIntegerClass->instance_methods = {
+        // A BigInteger is never 0, which is an Integer
+        {"present?", andy::lang::method("present?", andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return std::make_shared<andy::lang::object>(interpreter->TrueClass);
+        })},
+        {"to_string", andy::lang::method("to_string", andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return andy::lang::object::instantiate(interpreter, interpreter->StringClass, object->as<andy::lang::big_integer>().to_string());
+        })},
+        {"++", andy::lang::method("++", andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            assign_integer(interpreter, *object, object->as<andy::lang::big_integer>() + andy::lang::big_integer(1));
+
+            return std::shared_ptr<andy::lang::object>(nullptr);
+        })}
+    };
+
+    auto add = [](const auto& a, const auto& b) { return a + b; };
+    auto sub = [](const auto& a, const auto& b) { return a - b; };
+    auto mul = [](const auto& a, const auto& b) { return a * b; };
+    auto div = [](const auto& a, const auto& b) { return a / b; };
+    auto rem = [](const auto& a, const auto& b) { return a % b; };
+
+    BigIntegerClass->instance_methods["+"] = big_integer_operator(interpreter, "+", add, add);
+    BigIntegerClass->instance_methods["-"] = big_integer_operator(interpreter, "-", sub, sub);
+    BigIntegerClass->instance_methods["*"] = big_integer_operator(interpreter, "*", mul, mul);
+    BigIntegerClass->instance_methods["/"] = big_integer_operator(interpreter, "/", div, div);
+    BigIntegerClass->instance_methods["%"] = big_integer_operator(interpreter, "%", rem, nullptr);
+
+    BigIntegerClass->instance_methods["+="] = big_integer_assignment(interpreter, "+=", add);
+    BigIntegerClass->instance_methods["-="] = big_integer_assignment(interpreter, "-=", sub);
+    BigIntegerClass->instance_methods["*="] = big_integer_assignment(interpreter, "*=", mul);
+
+    BigIntegerClass->instance_methods["=="] = big_integer_comparison(interpreter, "==", std::equal_to<>());
+    BigIntegerClass->instance_methods["!="] = big_integer_comparison(interpreter, "!=", std::not_equal_to<>());
+    BigIntegerClass->instance_methods["<"] = big_integer_comparison(interpreter, "<", std::less<>());
+    BigIntegerClass->instance_methods[">"] = big_integer_comparison(interpreter, ">", std::greater<>());
+
+    return BigIntegerClass;
+}
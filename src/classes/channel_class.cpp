@@ -0,0 +1,44 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/scheduler.hpp>
+
+std::shared_ptr<andy::lang::structure> create_channel_class(andy::lang::interpreter* interpreter)
+{
+    auto ChannelClass = std::make_shared<andy::lang::structure>("Channel");
+
+    // A channel between the fibers of the program. Waiting on it lets the other fibers run.
+    ChannelClass->instance_methods = {
+        {"new", andy::lang::method("new",andy::lang::method_storage_type::instance_method, {"capacity"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            int64_t capacity = params[0]->as<int64_t>();
+
+            if(capacity < 1) {
+                throw std::runtime_error("Channel: the capacity must be at least 1");
+            }
+
+            object->set_native<std::shared_ptr<andy::lang::scheduler::channel>>(std::make_shared<andy::lang::scheduler::channel>(&interpreter->fibers(), (size_t)capacity));
+
+            return nullptr;
+        })},
+        {"send", andy::lang::method("send",andy::lang::method_storage_type::instance_method, {"value"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            bool sent = object->as<std::shared_ptr<andy::lang::scheduler::channel>>()->send(params[0]);
+
+            return std::make_shared<andy::lang::object>(sent ? interpreter->TrueClass : interpreter->FalseClass);
+        })},
+        {"receive", andy::lang::method("receive",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            std::optional<std::shared_ptr<andy::lang::object>> value = object->as<std::shared_ptr<andy::lang::scheduler::channel>>()->receive();
+
+            if(!value) {
+                return std::make_shared<andy::lang::object>(interpreter->NullClass);
+            }
+
+            return *value;
+        })},
+        {"close", andy::lang::method("close",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            object->as<std::shared_ptr<andy::lang::scheduler::channel>>()->close();
+
+            return nullptr;
+        })},
+    };
+
+    return ChannelClass;
+}
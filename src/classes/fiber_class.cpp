@@ -0,0 +1,39 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/scheduler.hpp>
+
+// Fibers are created by spawn, see the standard class
+std::shared_ptr<andy::lang::structure> create_fiber_class(andy::lang::interpreter* interpreter)
+{
+    auto FiberClass = std::make_shared<andy::lang::structure>("Fiber");
+
+    FiberClass->instance_methods = {
+        {"join", andy::lang::method("join",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return interpreter->fibers().join(object->as<std::shared_ptr<andy::lang::fiber>>());
+        })},
+        {"done?", andy::lang::method("done?",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            bool done = object->as<std::shared_ptr<andy::lang::fiber>>()->done();
+
+            return std::make_shared<andy::lang::object>(done ? interpreter->TrueClass : interpreter->FalseClass);
+        })},
+    };
+
+    FiberClass->class_methods = {
+        // yield is a keyword, a fiber lets the others run with Fiber.pass()
+        { "pass", andy::lang::method("pass",andy::lang::method_storage_type::class_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            interpreter->fibers().yield();
+
+            return nullptr;
+        })},
+        { "run", andy::lang::method("run",andy::lang::method_storage_type::class_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            interpreter->fibers().run();
+
+            return nullptr;
+        })},
+        { "count", andy::lang::method("count",andy::lang::method_storage_type::class_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return andy::lang::object::create(interpreter, interpreter->IntegerClass, (int64_t)interpreter->fibers().count());
+        })},
+    };
+
+    return FiberClass;
+}
@@ -16,16 +16,16 @@ std::shared_ptr<andy::lang::structure> create_file_class(andy::lang::interpreter
             std::shared_ptr<andy::lang::object> path_object = params[0];
             if(path_object->cls == interpreter->StringClass) {
                 path = path_object->as<std::string>();
-            } else if(path_object->cls == interpreter->PathClass) {
+            } else if(path_object->cls == interpreter->PathClass()) {
                 path = path_object->as<std::filesystem::path>();
             } else {
                 throw std::runtime_error("invalid path");
             }
-            return andy::lang::object::instantiate(interpreter, interpreter->StringClass, std::move(uva::file::read_all_text<char>(path)));
+            return andy::lang::object::instantiate(interpreter, interpreter->StringClass, std::move(uva::file::read_all_text<char>(interpreter->resolve(path))));
         })},
         { "read_all_lines", andy::lang::method("read_all_lines",andy::lang::method_storage_type::class_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             const std::string& input_path = params[0]->as<std::string>();
-            std::filesystem::path path = std::filesystem::absolute(input_path);
+            std::filesystem::path path = interpreter->resolve(input_path);
 
             if(!std::filesystem::exists(path)) {
                 throw std::runtime_error("file '" + path.string() + "' does not exist");
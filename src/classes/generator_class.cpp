@@ -0,0 +1,39 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/generator.hpp>
+
+std::shared_ptr<andy::lang::structure> create_generator_class(andy::lang::interpreter* interpreter)
+{
+    auto GeneratorClass = std::make_shared<andy::lang::structure>("Generator");
+
+    // Generators are created by calling a function which yields, foreach asks them for their values one at a time
+    GeneratorClass->instance_methods = {
+        {"next", andy::lang::method("next",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            std::optional<std::shared_ptr<andy::lang::object>> value = object->as<std::shared_ptr<andy::lang::generator>>()->next();
+
+            if(!value) {
+                return std::make_shared<andy::lang::object>(interpreter->NullClass);
+            }
+
+            return *value;
+        })},
+        {"done?", andy::lang::method("done?",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            bool done = object->as<std::shared_ptr<andy::lang::generator>>()->done();
+
+            return std::make_shared<andy::lang::object>(done ? interpreter->TrueClass : interpreter->FalseClass);
+        })},
+        {"to_array", andy::lang::method("to_array",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            auto& generator = object->as<std::shared_ptr<andy::lang::generator>>();
+
+            std::vector<std::shared_ptr<andy::lang::object>> values;
+
+            while(auto value = generator->next()) {
+                values.push_back(std::move(*value));
+            }
+
+            return andy::lang::object::create(interpreter, interpreter->ArrayClass, std::move(values));
+        })},
+    };
+
+    return GeneratorClass;
+}
@@ -1,19 +1,191 @@
 #include <andy/lang/lang.hpp>
 #include <andy/lang/interpreter.hpp>
+#include <andy/lang/big_integer.hpp>
 
-#include "add_operators.hpp"
+#include <charconv>
+#include <functional>
+
+// The Integer holding a value, or the BigInteger holding it when it does not fit in 64 bits
+static std::shared_ptr<andy::lang::object> integer_to_object(andy::lang::interpreter* interpreter, andy::lang::big_integer value)
+{
+    if(value.fits_int64()) {
+        return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, value.to_int64());
+    }
+
+    return andy::lang::object::instantiate(interpreter, interpreter->BigIntegerClass, std::move(value));
+}
+
+// Store a value in an Integer or a BigInteger, which becomes the other one when the value needs it
+static void assign_integer(andy::lang::interpreter* interpreter, andy::lang::object& object, andy::lang::big_integer value)
+{
+    if(value.fits_int64()) {
+        object.cls = interpreter->IntegerClass;
+        object.set_native<int64_t>(value.to_int64());
+    } else {
+        object.cls = interpreter->BigIntegerClass;
+        object.set_native<andy::lang::big_integer>(std::move(value));
+    }
+}
+
+// The value of an Integer or a BigInteger
+static andy::lang::big_integer integer_value(andy::lang::interpreter* interpreter, const andy::lang::object& object)
+{
+    if(object.cls == interpreter->IntegerClass) {
+        return andy::lang::big_integer(object.as<int64_t>());
+    }
+
+    return object.as<andy::lang::big_integer>();
+}
+
+// The Integer or the BigInteger a string of digits is, null when the string is something else
+static std::shared_ptr<andy::lang::object> parse_integer(andy::lang::interpreter* interpreter, const std::string& text)
+{
+    if(text.empty() || !isdigit(text[0])) {
+        return nullptr;
+    }
+
+    int64_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+    if(end != text.data() + text.size()) {
+        return nullptr;
+    }
+
+    if(error == std::errc::result_out_of_range) {
+        return andy::lang::object::instantiate(interpreter, interpreter->BigIntegerClass, andy::lang::big_integer::parse(text));
+    }
+
+    return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, value);
+}
+
+// An operator of Integer. With another Integer, the result is computed in 64 bits, and in a big_integer when
+// checked reports it does not fit. Real is nullptr for the operators Double and Float do not have.
+template<typename Checked, typename Big, typename Real>
+static andy::lang::method integer_operator(andy::lang::interpreter* interpreter, const std::string& name, Checked checked, Big big, Real real)
+{
+    return andy::lang::method(name, andy::lang::method_storage_type::instance_method, {"other"}, [interpreter, name, checked, big, real](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+        int64_t value = object->as<int64_t>();
+        const std::shared_ptr<andy::lang::object>& other = params[0];
+
+        if(other->cls == interpreter->IntegerClass) {
+            int64_t result;
+
+            if(checked(value, other->as<int64_t>(), result)) {
+                return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, result);
+            }
+
+            return integer_to_object(interpreter, big(andy::lang::big_integer(value), andy::lang::big_integer(other->as<int64_t>())));
+        } else if(other->cls == interpreter->BigIntegerClass) {
+            return integer_to_object(interpreter, big(andy::lang::big_integer(value), other->as<andy::lang::big_integer>()));
+        }
+
+        if constexpr(!std::is_same_v<Real, std::nullptr_t>) {
+            if(other->cls == interpreter->DoubleClass) {
+                return andy::lang::object::instantiate(interpreter, interpreter->DoubleClass, real((double)value, other->as<double>()));
+            } else if(other->cls == interpreter->FloatClass) {
+                return andy::lang::object::instantiate(interpreter, interpreter->FloatClass, real((float)value, other->as<float>()));
+            }
+        }
+
+        throw std::runtime_error("undefined operator" + name + "(" + object->cls->name + ", " + other->cls->name + ")");
+    });
+}
+
+// An assignment operator of Integer, like integer_operator but storing the result in the Integer itself
+template<typename Checked, typename Big, typename Real>
+static andy::lang::method integer_assignment(andy::lang::interpreter* interpreter, const std::string& name, Checked checked, Big big, Real real)
+{
+    return andy::lang::method(name, andy::lang::method_storage_type::instance_method, {"other"}, [interpreter, name, checked, big, real](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+        int64_t& value = object->as<int64_t>();
+        const std::shared_ptr<andy::lang::object>& other = params[0];
+
+        if(other->cls == interpreter->IntegerClass) {
+            int64_t result;
+
+            if(checked(value, other->as<int64_t>(), result)) {
+                value = result;
+            } else {
+                assign_integer(interpreter, *object, big(andy::lang::big_integer(value), andy::lang::big_integer(other->as<int64_t>())));
+            }
+        } else if(other->cls == interpreter->BigIntegerClass) {
+            assign_integer(interpreter, *object, big(andy::lang::big_integer(value), other->as<andy::lang::big_integer>()));
+        } else if(other->cls == interpreter->DoubleClass) {
+            value = (int64_t)real((double)value, other->as<double>());
+        } else if(other->cls == interpreter->FloatClass) {
+            value = (int64_t)real((float)value, other->as<float>());
+        } else {
+            throw std::runtime_error("undefined operator" + name + "(" + object->cls->name + ", " + other->cls->name + ")");
+        }
+
+        return std::shared_ptr<andy::lang::object>(nullptr);
+    });
+}
+
+// A comparison of Integer, with any number
+template<typename Compare>
+static andy::lang::method integer_comparison(andy::lang::interpreter* interpreter, const std::string& name, Compare compare)
+{
+    return andy::lang::method(name, andy::lang::method_storage_type::instance_method, {"other"}, [interpreter, name, compare](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+        int64_t value = object->as<int64_t>();
+        const std::shared_ptr<andy::lang::object>& other = params[0];
+        bool result;
+
+        if(other->cls == interpreter->IntegerClass) {
+            result = compare(value, other->as<int64_t>());
+        } else if(other->cls == interpreter->BigIntegerClass) {
+            result = compare(andy::lang::big_integer(value), other->as<andy::lang::big_integer>());
+        } else if(other->cls == interpreter->DoubleClass) {
+            result = compare((double)value, other->as<double>());
+        } else if(other->cls == interpreter->FloatClass) {
+            result = compare((float)value, other->as<float>());
+        } else {
+            throw std::runtime_error("undefined operator" + name + "(" + object->cls->name + ", " + other->cls->name + ")");
+        }
+
+        return std::make_shared<andy::lang::object>(result ? interpreter->TrueClass : interpreter->FalseClass);
+    });
+}
+
+static bool checked_divide(int64_t a, int64_t b, int64_t& result)
+{
+    if(b == 0) {
+        throw std::runtime_error("division by zero");
+    }
+
+    // The only quotient which does not fit
+    if(a == INT64_MIN && b == -1) {
+        return false;
+    }
+
+    result = a / b;
+    return true;
+}
+
+static bool checked_remainder(int64_t a, int64_t b, int64_t& result)
+{
+    if(b == 0) {
+        throw std::runtime_error("division by zero");
+    }
+
+    if(a == INT64_MIN && b == -1) {
+        return false;
+    }
+
+    result = a % b;
+    return true;
+}
 
 std::shared_ptr<andy::lang::structure> create_integer_class(andy::lang::interpreter* interpreter)
 {
     std::shared_ptr<andy::lang::structure> IntegerClass = std::make_shared<andy::lang::structure>("Integer");
     IntegerClass->object_to_var = [](std::shared_ptr<const andy::lang::object> obj) {
-        return var(obj->as<int>());
+        return var(obj->as<int64_t>());
     };
 
     IntegerClass->instance_methods = {
         {"present?", andy::lang::method("present?", andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
-            int i = object->as<int>();
-            
+            int64_t i = object->as<int64_t>();
+
             if(i == 0) {
                 return std::make_shared<andy::lang::object>(interpreter->FalseClass);
             }
@@ -21,13 +193,43 @@ std::shared_ptr<andy::lang::structure> create_integer_class(andy::lang::interpre
             return std::make_shared<andy::lang::object>(interpreter->TrueClass);
         })},
         {"to_string", andy::lang::method("to_string", andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
-            int value = object->as<int>();
+            int64_t value = object->as<int64_t>();
 
             return andy::lang::object::instantiate(interpreter, interpreter->StringClass, std::move(std::to_string(value)));
+        })},
+        {"++", andy::lang::method("++", andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            int64_t& value = object->as<int64_t>();
+
+            if(value == INT64_MAX) {
+                assign_integer(interpreter, *object, andy::lang::big_integer(value) + andy::lang::big_integer(1));
+            } else {
+                value++;
+            }
+
+            return std::shared_ptr<andy::lang::object>(nullptr);
         })}
     };
 
-    andy::lang::add_operators<int>(IntegerClass, interpreter);
+    auto add = [](const auto& a, const auto& b) { return a + b; };
+    auto sub = [](const auto& a, const auto& b) { return a - b; };
+    auto mul = [](const auto& a, const auto& b) { return a * b; };
+    auto div = [](const auto& a, const auto& b) { return a / b; };
+    auto rem = [](const auto& a, const auto& b) { return a % b; };
+
+    IntegerClass->instance_methods["+"] = integer_operator(interpreter, "+", andy::lang::checked_add, add, add);
+    IntegerClass->instance_methods["-"] = integer_operator(interpreter, "-", andy::lang::checked_sub, sub, sub);
+    IntegerClass->instance_methods["*"] = integer_operator(interpreter, "*", andy::lang::checked_mul, mul, mul);
+    IntegerClass->instance_methods["/"] = integer_operator(interpreter, "/", checked_divide, div, div);
+    IntegerClass->instance_methods["%"] = integer_operator(interpreter, "%", checked_remainder, rem, nullptr);
+
+    IntegerClass->instance_methods["+="] = integer_assignment(interpreter, "+=", andy::lang::checked_add, add, add);
+    IntegerClass->instance_methods["-="] = integer_assignment(interpreter, "-=", andy::lang::checked_sub, sub, sub);
+    IntegerClass->instance_methods["*="] = integer_assignment(interpreter, "*=", andy::lang::checked_mul, mul, mul);
+
+    IntegerClass->instance_methods["=="] = integer_comparison(interpreter, "==", std::equal_to<>());
+    IntegerClass->instance_methods["!="] = integer_comparison(interpreter, "!=", std::not_equal_to<>());
+    IntegerClass->instance_methods["<"] = integer_comparison(interpreter, "<", std::less<>());
+    IntegerClass->instance_methods[">"] = integer_comparison(interpreter, ">", std::greater<>());
 
     return IntegerClass;
-}
\ No newline at end of file
+}
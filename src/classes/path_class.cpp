@@ -21,7 +21,7 @@ std::shared_ptr<andy::lang::structure> create_path_class(andy::lang::interpreter
         {"exists?", andy::lang::method("exists?",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::filesystem::path& path = object->as<std::filesystem::path>();
 
-            if(std::filesystem::exists(path)) {
+            if(std::filesystem::exists(interpreter->resolve(path))) {
                 return std::make_shared<andy::lang::object>(interpreter->TrueClass);
             }
 
@@ -36,7 +36,7 @@ std::shared_ptr<andy::lang::structure> create_path_class(andy::lang::interpreter
         {"/", andy::lang::method("/",andy::lang::method_storage_type::instance_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::filesystem::path path = object->as<std::filesystem::path>() / params[0]->as<std::string>();
             
-            return andy::lang::object::create(interpreter, interpreter->PathClass, std::move(path));
+            return andy::lang::object::create(interpreter, interpreter->PathClass(), std::move(path));
         })},
     };
     
@@ -47,13 +47,19 @@ std::shared_ptr<andy::lang::structure> create_path_class(andy::lang::interpreter
 
             if(path_object->cls == interpreter->StringClass) {
                 path = path_object->as<std::string>();
-            } else if(path_object->cls == interpreter->PathClass) {
+            } else if(path_object->cls == interpreter->PathClass()) {
                 path = path_object->as<std::filesystem::path>();
             } else {
                 throw std::runtime_error("invalid path");
             }
 
-            std::filesystem::current_path(path);
+            path = interpreter->resolve(path);
+
+            if(!std::filesystem::is_directory(path)) {
+                throw std::runtime_error("'" + path.string() + "' is not a directory");
+            }
+
+            interpreter->working_directory = path.lexically_normal();
 
             return nullptr;
         })}
@@ -0,0 +1,30 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/event_loop.hpp>
+
+std::shared_ptr<andy::lang::structure> create_socket_class(andy::lang::interpreter* interpreter)
+{
+    auto SocketClass = std::make_shared<andy::lang::structure>("Socket");
+
+    SocketClass->instance_methods = {
+        {"port", andy::lang::method("port",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return andy::lang::object::create(interpreter, interpreter->IntegerClass, (int64_t)object->as<std::shared_ptr<andy::lang::event_loop::socket>>()->port());
+        })},
+        {"accept", andy::lang::method("accept",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().accept(object->as<std::shared_ptr<andy::lang::event_loop::socket>>()));
+        })},
+        {"read", andy::lang::method("read",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().receive(object->as<std::shared_ptr<andy::lang::event_loop::socket>>()));
+        })},
+        {"write", andy::lang::method("write",andy::lang::method_storage_type::instance_method, {"data"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return create_task(interpreter, interpreter->loop().send(object->as<std::shared_ptr<andy::lang::event_loop::socket>>(), params[0]->as<std::string>()));
+        })},
+        {"close", andy::lang::method("close",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            object->as<std::shared_ptr<andy::lang::event_loop::socket>>()->shutdown();
+
+            return nullptr;
+        })},
+    };
+
+    return SocketClass;
+}
@@ -1,8 +1,13 @@
 #include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <stdexcept>
 
 #include <andy/lang/lang.hpp>
 #include <andy/lang/interpreter.hpp>
 #include <andy/lang/extension.hpp>
+#include <andy/lang/heap_stats.hpp>
+#include <andy/lang/scheduler.hpp>
 
 std::shared_ptr<andy::lang::structure> create_std_class(andy::lang::interpreter* interpreter)
 {
@@ -12,10 +17,10 @@ std::shared_ptr<andy::lang::structure> create_std_class(andy::lang::interpreter*
         { "print", andy::lang::method("print",andy::lang::method_storage_type::class_method, {"message"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::shared_ptr<andy::lang::object> obj = params[0];
             if(obj->cls == interpreter->StringClass) {
-                std::cout << obj->as<std::string>();
+                *interpreter->output << obj->as<std::string>();
             } else {
                 std::string s = obj->cls->instance_methods["to_string"].call(obj)->as<std::string>();
-                std::cout << s;
+                *interpreter->output << s;
             }
 
             return nullptr;
@@ -24,10 +29,10 @@ std::shared_ptr<andy::lang::structure> create_std_class(andy::lang::interpreter*
         { "puts", andy::lang::method("puts",andy::lang::method_storage_type::class_method, {"message"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::shared_ptr<andy::lang::object> obj = params[0];
             if(obj->cls == interpreter->StringClass) {
-                std::cout << obj->as<std::string>() << std::endl;
+                *interpreter->output << obj->as<std::string>() << std::endl;
             } else {
                 std::string s = obj->cls->instance_methods["to_string"].call(obj)->as<std::string>();
-                std::cout << s << std::endl;
+                *interpreter->output << s << std::endl;
             }
 
             return nullptr;
@@ -41,10 +46,97 @@ std::shared_ptr<andy::lang::structure> create_std_class(andy::lang::interpreter*
         })},
 
         { "system", andy::lang::method("system",andy::lang::method_storage_type::class_method, {"command"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
-            std::shared_ptr<andy::lang::object> command = params[0]->cls->instance_methods["to_string"].call(params[0]);
-            int code = ((std::system(command->as<std::string>().c_str())) & 0xff00) >> 8;
+            std::shared_ptr<andy::lang::object> command_object = params[0]->cls->instance_methods["to_string"].call(params[0]);
+            std::string command = command_object->as<std::string>();
 
-            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, code);
+            // The command runs in the working directory of the interpreter, not in the one of the process
+            if(interpreter->working_directory != std::filesystem::current_path()) {
+#ifdef __UVA_WIN__
+                command = "cd /d \"" + interpreter->working_directory.string() + "\" && " + command;
+#else
+                command = "cd \"" + interpreter->working_directory.string() + "\" && " + command;
+#endif
+            }
+
+            int status;
+
+            if(interpreter->output == &std::cout) {
+                std::cout.flush();
+                status = std::system(command.c_str());
+            } else {
+                // The output is captured, the output of the command must go to the same place
+#ifdef __UVA_WIN__
+                FILE* pipe = _popen(command.c_str(), "r");
+#else
+                FILE* pipe = popen(command.c_str(), "r");
+#endif
+                if(!pipe) {
+                    throw std::runtime_error("failed to run command");
+                }
+
+                char buffer[4096];
+                size_t read;
+
+                while((read = fread(buffer, 1, sizeof(buffer), pipe)) > 0) {
+                    interpreter->output->write(buffer, read);
+                }
+
+#ifdef __UVA_WIN__
+                status = _pclose(pipe);
+#else
+                status = pclose(pipe);
+#endif
+            }
+
+            int code = (status & 0xff00) >> 8;
+
+            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, (int64_t)code);
+        })},
+
+        { "heap_snapshot", andy::lang::method("heap_snapshot",andy::lang::method_storage_type::class_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            // Without andy --heap-stats there is nothing to write
+            if(!interpreter->heap_stats) {
+                return std::make_shared<andy::lang::object>(interpreter->FalseClass);
+            }
+
+            std::ofstream file(interpreter->resolve(params[0]->as<std::string>()), std::ios::binary);
+
+            if(!file) {
+                throw std::runtime_error("cannot write the heap snapshot to " + params[0]->as<std::string>());
+            }
+
+            interpreter->heap_stats->write_snapshot(file);
+
+            return std::make_shared<andy::lang::object>(interpreter->TrueClass);
+        })},
+
+        // A global function of the program, named by a string, runs in a new fiber. It gets the argument if it has a parameter.
+        { "spawn", andy::lang::method("spawn",andy::lang::method_storage_type::class_method, {"function", "argument"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            if(params[0]->cls != interpreter->StringClass) {
+                throw std::runtime_error("spawn: expected the name of a function");
+            }
+
+            auto it = interpreter->caller_functions().find(params[0]->as<std::string>());
+
+            if(it == interpreter->caller_functions().end()) {
+                throw std::runtime_error("spawn: function " + params[0]->as<std::string>() + " not found");
+            }
+
+            std::vector<std::shared_ptr<andy::lang::object>> arguments;
+
+            if(it->second.positional_params.size()) {
+                arguments.push_back(params[1]);
+            }
+
+            return andy::lang::object::create(interpreter, interpreter->FiberClass(), interpreter->fibers().spawn(it->second, std::move(arguments)));
+        })},
+
+        { "join", andy::lang::method("join",andy::lang::method_storage_type::class_method, {"fiber"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            if(params[0]->cls != interpreter->FiberClass()) {
+                throw std::runtime_error("join: expected a fiber");
+            }
+
+            return interpreter->fibers().join(params[0]->as<std::shared_ptr<andy::lang::fiber>>());
         })},
 
         { "import", andy::lang::method("import",andy::lang::method_storage_type::class_method, {"module"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
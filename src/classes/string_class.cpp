@@ -27,13 +27,13 @@ std::shared_ptr<andy::lang::structure> create_string_class(andy::lang::interpret
         {"find", andy::lang::method("find", andy::lang::method_storage_type::instance_method, {"what"}, [interpreter, StringClass](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             const std::string& value = object->as<std::string>();
             size_t pos = value.find(params[0]->as<std::string>());
-            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, (int32_t)pos);
+            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, (int64_t)pos);
         })},
 
         {"substring", andy::lang::method("substring", andy::lang::method_storage_type::instance_method, {"start", "size"}, [interpreter, StringClass](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             const std::string& value = object->as<std::string>();
-            size_t start = params[0]->as<int32_t>();
-            size_t size = params[1]->as<int32_t>();
+            size_t start = params[0]->as<int64_t>();
+            size_t size = params[1]->as<int64_t>();
 
             return andy::lang::object::instantiate(interpreter, StringClass, value.substr(start, size));
         })},
@@ -68,25 +68,16 @@ std::shared_ptr<andy::lang::structure> create_string_class(andy::lang::interpret
                 return object;
             }
 
-            if(!isdigit(value[0])) {
-                object->cls = interpreter->NullClass;
-                object->set_native(0);
+            std::shared_ptr<andy::lang::object> result = parse_integer(interpreter, value);
 
-                return object;
-            }
-
-            size_t pos = 0;
-            int result = std::stoi(value, &pos);
-
-            if(pos != value.size()) {
+            if(!result) {
                 object->cls = interpreter->NullClass;
                 object->set_native(0);
 
                 return object;
             }
 
-            object->cls = interpreter->IntegerClass;
-            object->set_native(result);
+            *object = std::move(*result);
 
             return object;
         })},
@@ -96,20 +87,17 @@ std::shared_ptr<andy::lang::structure> create_string_class(andy::lang::interpret
 
             if(value.empty()) return std::make_shared<andy::lang::object>(interpreter->NullClass);
 
-            if(!isdigit(value[0])) return std::make_shared<andy::lang::object>(interpreter->NullClass);
-
-            size_t pos = 0;
-            int result = std::stoi(value, &pos);
+            std::shared_ptr<andy::lang::object> result = parse_integer(interpreter, value);
 
-            if(pos != value.size()) return std::make_shared<andy::lang::object>(interpreter->NullClass);
+            if(!result) return std::make_shared<andy::lang::object>(interpreter->NullClass);
 
-            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, result);
+            return result;
         })},
 
         {"erase!", andy::lang::method("erase!", andy::lang::method_storage_type::instance_method, {"start", "size"}, [interpreter, StringClass](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             std::string& value = object->as<std::string>();
-            size_t start = params[0]->as<int32_t>();
-            size_t size = params[1]->as<int32_t>();
+            size_t start = params[0]->as<int64_t>();
+            size_t size = params[1]->as<int64_t>();
 
             value.erase(start, size);
 
@@ -160,7 +148,7 @@ std::shared_ptr<andy::lang::structure> create_string_class(andy::lang::interpret
 
         {"size", andy::lang::method("size", andy::lang::method_storage_type::instance_method, [interpreter, StringClass](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
             const std::string& value = object->as<std::string>();
-            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, (int32_t)value.size());
+            return andy::lang::object::instantiate(interpreter, interpreter->IntegerClass, (int64_t)value.size());
         })},
 
         {"empty?", andy::lang::method("empty?", andy::lang::method_storage_type::instance_method, [interpreter, StringClass](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
@@ -0,0 +1,77 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/event_loop.hpp>
+#include <andy/lang/scheduler.hpp>
+
+static std::shared_ptr<andy::lang::object> create_task(andy::lang::interpreter* interpreter, andy::lang::event_loop::handle operation)
+{
+    return andy::lang::object::create(interpreter, interpreter->TaskClass(), std::move(operation));
+}
+
+static std::shared_ptr<andy::lang::object> create_socket(andy::lang::interpreter* interpreter, std::shared_ptr<andy::lang::event_loop::socket> socket)
+{
+    return andy::lang::object::create(interpreter, interpreter->SocketClass(), std::move(socket));
+}
+
+// What a finished operation resulted in
+static std::shared_ptr<andy::lang::object> task_result(andy::lang::interpreter* interpreter, const andy::lang::event_loop::handle& operation)
+{
+    using kind = andy::lang::event_loop::operation::kind;
+
+    if(!operation->error.empty()) {
+        throw std::runtime_error(operation->error);
+    }
+
+    switch(operation->type) {
+        case kind::read_file:
+        case kind::process:
+        case kind::receive:
+            return andy::lang::object::create(interpreter, interpreter->StringClass, operation->data);
+        case kind::write_file:
+        case kind::send:
+            return andy::lang::object::create(interpreter, interpreter->IntegerClass, (int64_t)operation->value);
+        case kind::accept:
+        case kind::connect:
+            return create_socket(interpreter, operation->connection);
+        default:
+            return std::make_shared<andy::lang::object>(interpreter->NullClass);
+    }
+}
+
+std::shared_ptr<andy::lang::structure> create_task_class(andy::lang::interpreter* interpreter)
+{
+    auto TaskClass = std::make_shared<andy::lang::structure>("Task");
+
+    // A fiber waiting for a task lets the other fibers run meanwhile
+    TaskClass->instance_methods = {
+        {"wait", andy::lang::method("wait",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            auto& operation = object->as<andy::lang::event_loop::handle>();
+
+            interpreter->fibers().wait(operation);
+
+            return task_result(interpreter, operation);
+        })},
+        {"done?", andy::lang::method("done?",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            auto& operation = object->as<andy::lang::event_loop::handle>();
+
+            if(!operation->done) {
+                interpreter->loop().poll();
+            }
+
+            return std::make_shared<andy::lang::object>(operation->done ? interpreter->TrueClass : interpreter->FalseClass);
+        })},
+        {"exit_code", andy::lang::method("exit_code",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            auto& operation = object->as<andy::lang::event_loop::handle>();
+
+            if(operation->type != andy::lang::event_loop::operation::kind::process) {
+                throw std::runtime_error("Task.exit_code: the task is not a process");
+            }
+
+            interpreter->fibers().wait(operation);
+
+            return andy::lang::object::create(interpreter, interpreter->IntegerClass, (int64_t)operation->value);
+        })},
+    };
+
+    return TaskClass;
+}
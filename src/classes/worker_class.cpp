@@ -0,0 +1,80 @@
+#include <andy/lang/lang.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/worker.hpp>
+
+std::shared_ptr<andy::lang::structure> create_worker_class(andy::lang::interpreter* interpreter)
+{
+    auto WorkerClass = std::make_shared<andy::lang::structure>("Worker");
+
+    // The side of the creator: new Worker(path) starts the script, send and receive talk to it
+    WorkerClass->instance_methods = {
+        {"new", andy::lang::method("new",andy::lang::method_storage_type::instance_method, {"path"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            object->set_native<std::shared_ptr<andy::lang::worker>>(std::make_shared<andy::lang::worker>(params[0]->as<std::string>(), interpreter));
+
+            return nullptr;
+        })},
+        {"send", andy::lang::method("send",andy::lang::method_storage_type::instance_method, {"value"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            bool sent = object->as<std::shared_ptr<andy::lang::worker>>()->send(andy::lang::message::from(interpreter, params[0]));
+
+            return std::make_shared<andy::lang::object>(sent ? interpreter->TrueClass : interpreter->FalseClass);
+        })},
+        {"transfer", andy::lang::method("transfer",andy::lang::method_storage_type::instance_method, {"value"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            bool sent = object->as<std::shared_ptr<andy::lang::worker>>()->send(andy::lang::message::from(interpreter, params[0], true));
+
+            return std::make_shared<andy::lang::object>(sent ? interpreter->TrueClass : interpreter->FalseClass);
+        })},
+        {"receive", andy::lang::method("receive",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            std::optional<andy::lang::message> message = object->as<std::shared_ptr<andy::lang::worker>>()->receive();
+
+            if(!message) {
+                return std::make_shared<andy::lang::object>(interpreter->NullClass);
+            }
+
+            return std::move(*message).to_object(interpreter);
+        })},
+        {"join", andy::lang::method("join",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            return object->as<std::shared_ptr<andy::lang::worker>>()->join().to_object(interpreter);
+        })},
+    };
+
+    // The side of the worker: Worker.receive and Worker.send talk to its creator
+    WorkerClass->class_methods = {
+        {"receive", andy::lang::method("receive",andy::lang::method_storage_type::instance_method, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            if(!interpreter->worker) {
+                throw std::runtime_error("Worker.receive: not called in a worker");
+            }
+
+            std::optional<andy::lang::message> message = interpreter->worker->inbox().pop();
+
+            if(!message) {
+                return std::make_shared<andy::lang::object>(interpreter->NullClass);
+            }
+
+            return std::move(*message).to_object(interpreter);
+        })},
+        {"send", andy::lang::method("send",andy::lang::method_storage_type::instance_method, {"value"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            if(!interpreter->worker) {
+                throw std::runtime_error("Worker.send: not called in a worker");
+            }
+
+            if(!interpreter->worker->outbox().push(andy::lang::message::from(interpreter, params[0]))) {
+                throw std::runtime_error("Worker.send: the worker was dropped by its creator");
+            }
+
+            return nullptr;
+        })},
+        {"transfer", andy::lang::method("transfer",andy::lang::method_storage_type::instance_method, {"value"}, [interpreter](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
+            if(!interpreter->worker) {
+                throw std::runtime_error("Worker.transfer: not called in a worker");
+            }
+
+            if(!interpreter->worker->outbox().push(andy::lang::message::from(interpreter, params[0], true))) {
+                throw std::runtime_error("Worker.transfer: the worker was dropped by its creator");
+            }
+
+            return nullptr;
+        })},
+    };
+
+    return WorkerClass;
+}
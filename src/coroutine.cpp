@@ -0,0 +1,568 @@
+#include <andy/lang/coroutine.hpp>
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __UVA_WIN__
+#include <windows.h>
+#elif !defined(__wasm__)
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+// The sanitizers must be told when the stack changes, or they report the frames of the other stack as errors
+#if defined(__SANITIZE_ADDRESS__)
+#define ANDY_ASAN_FIBERS 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ANDY_ASAN_FIBERS 1
+#endif
+#endif
+
+#if defined(__SANITIZE_THREAD__)
+#define ANDY_TSAN_FIBERS 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define ANDY_TSAN_FIBERS 1
+#endif
+#endif
+
+#if defined(ANDY_ASAN_FIBERS) && !defined(__UVA_WIN__)
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+#if defined(ANDY_TSAN_FIBERS) && !defined(__UVA_WIN__)
+#include <sanitizer/tsan_interface.h>
+#endif
+
+namespace
+{
+    thread_local andy::lang::coroutine* running = nullptr;
+};
+
+#ifdef __UVA_WIN__
+
+struct andy::lang::coroutine::context
+{
+    void* fiber = nullptr;
+    // Where the coroutine suspended: its fiber, or the fiber of a segment it runs on
+    void* suspended = nullptr;
+    void* resumer = nullptr;
+};
+
+namespace
+{
+    struct segment
+    {
+        const std::function<void()>* function;
+        std::exception_ptr error;
+        void* caller;
+    };
+};
+
+andy::lang::coroutine::coroutine(std::function<void()> __function, size_t __stack_size)
+    : m_function(std::move(__function)), m_context(new context())
+{
+    m_context->fiber = CreateFiber(__stack_size, [](void*) { entry(); }, nullptr);
+
+    if(!m_context->fiber) {
+        delete m_context;
+        throw std::runtime_error("coroutine: could not create a fiber");
+    }
+
+    m_context->suspended = m_context->fiber;
+}
+
+andy::lang::coroutine::~coroutine()
+{
+    if(m_started && !m_done) {
+        m_cancelled = true;
+
+        while(!m_done) {
+            try {
+                resume();
+            } catch(...) {
+            }
+        }
+    }
+
+    DeleteFiber(m_context->fiber);
+    delete m_context;
+}
+
+void andy::lang::coroutine::resume()
+{
+    if(m_done) {
+        throw std::runtime_error("coroutine: resumed after it has returned");
+    }
+
+    if(!IsThreadAFiber()) {
+        ConvertThreadToFiber(nullptr);
+    }
+
+    m_started = true;
+    m_resumer = std::exchange(running, this);
+    m_context->resumer = GetCurrentFiber();
+
+    SwitchToFiber(m_context->suspended);
+
+    running = m_resumer;
+
+    if(m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void andy::lang::coroutine::suspend()
+{
+    coroutine* self = running;
+
+    if(!self) {
+        throw std::runtime_error("coroutine: suspended outside of a coroutine");
+    }
+
+    self->m_context->suspended = GetCurrentFiber();
+    SwitchToFiber(self->m_context->resumer);
+
+    if(self->m_cancelled) {
+        throw cancelled();
+    }
+}
+
+void andy::lang::coroutine::entry()
+{
+    coroutine* self = running;
+
+    try {
+        self->m_function();
+    } catch(const cancelled&) {
+    } catch(...) {
+        self->m_exception = std::current_exception();
+    }
+
+    self->m_done = true;
+
+    SwitchToFiber(self->m_context->resumer);
+}
+
+bool andy::lang::coroutine::stack_low(size_t __needed)
+{
+    ULONG_PTR low;
+    ULONG_PTR high;
+    GetCurrentThreadStackLimits(&low, &high);
+
+    return (ULONG_PTR)&low - low < __needed;
+}
+
+void andy::lang::coroutine::on_new_stack(size_t __size, const std::function<void()>& __function)
+{
+    if(!IsThreadAFiber()) {
+        ConvertThreadToFiber(nullptr);
+    }
+
+    segment current{ &__function, nullptr, GetCurrentFiber() };
+
+    void* fiber = CreateFiber(__size, [](void* parameter) {
+        auto* current = (segment*)parameter;
+
+        try {
+            (*current->function)();
+        } catch(...) {
+            current->error = std::current_exception();
+        }
+
+        SwitchToFiber(current->caller);
+    }, &current);
+
+    if(!fiber) {
+        throw std::runtime_error("coroutine: could not create a stack segment");
+    }
+
+    SwitchToFiber(fiber);
+    DeleteFiber(fiber);
+
+    if(current.error) {
+        std::rethrow_exception(current.error);
+    }
+}
+
+#elif defined(__wasm__)
+
+// WebAssembly gives no way to switch stacks, so there are no coroutines and recursion stays on the one stack
+struct andy::lang::coroutine::context
+{
+};
+
+namespace
+{
+    [[noreturn]] void unsupported()
+    {
+        throw std::runtime_error("generators and fibers are not supported on WebAssembly");
+    }
+};
+
+andy::lang::coroutine::coroutine(std::function<void()> __function, size_t __stack_size)
+    : m_function(std::move(__function))
+{
+    unsupported();
+}
+
+andy::lang::coroutine::~coroutine()
+{
+    delete m_context;
+}
+
+void andy::lang::coroutine::resume()
+{
+    unsupported();
+}
+
+void andy::lang::coroutine::suspend()
+{
+    unsupported();
+}
+
+void andy::lang::coroutine::entry()
+{
+}
+
+bool andy::lang::coroutine::stack_low(size_t __needed)
+{
+    return false;
+}
+
+void andy::lang::coroutine::on_new_stack(size_t __size, const std::function<void()>& __function)
+{
+    __function();
+}
+
+#else
+
+struct andy::lang::coroutine::context
+{
+    ucontext_t self;
+    ucontext_t resumer;
+    void* stack = nullptr;
+    size_t size = 0;
+#ifdef ANDY_ASAN_FIBERS
+    void* fake_stack = nullptr;
+    const void* resumer_bottom = nullptr;
+    size_t resumer_size = 0;
+#endif
+#ifdef ANDY_TSAN_FIBERS
+    void* fiber = nullptr;
+    void* resumer_fiber = nullptr;
+#endif
+
+    // Called on the stack of the resumer
+    void switch_in()
+    {
+#ifdef ANDY_ASAN_FIBERS
+        void* resumer_fake_stack = nullptr;
+        __sanitizer_start_switch_fiber(&resumer_fake_stack, stack, size);
+#endif
+#ifdef ANDY_TSAN_FIBERS
+        resumer_fiber = __tsan_get_current_fiber();
+        __tsan_switch_to_fiber(fiber, 0);
+#endif
+        swapcontext(&resumer, &self);
+#ifdef ANDY_ASAN_FIBERS
+        __sanitizer_finish_switch_fiber(resumer_fake_stack, nullptr, nullptr);
+#endif
+    }
+
+    // Called on the stack of the coroutine when it is switched to
+    void switched_in()
+    {
+#ifdef ANDY_ASAN_FIBERS
+        __sanitizer_finish_switch_fiber(fake_stack, &resumer_bottom, &resumer_size);
+#endif
+    }
+
+    // Called on the stack of the coroutine
+    void switch_out([[maybe_unused]] bool finished)
+    {
+#ifdef ANDY_ASAN_FIBERS
+        __sanitizer_start_switch_fiber(finished ? nullptr : &fake_stack, resumer_bottom, resumer_size);
+#endif
+#ifdef ANDY_TSAN_FIBERS
+        __tsan_switch_to_fiber(resumer_fiber, 0);
+#endif
+        swapcontext(&self, &resumer);
+        switched_in();
+    }
+};
+
+namespace
+{
+    // The lowest address of the stack the thread runs on. Null until it is looked up for the stack of the thread.
+    thread_local const char* stack_limit = nullptr;
+
+    // The default stack_guard_gap of Linux
+    constexpr size_t main_stack_gap = 1024 * 1024;
+
+    const char* thread_stack_limit()
+    {
+#if defined(__linux__)
+        pthread_attr_t attributes;
+
+        if(pthread_getattr_np(pthread_self(), &attributes) != 0) {
+            return nullptr;
+        }
+
+        void* address = nullptr;
+        size_t size = 0;
+        size_t guard = 0;
+        pthread_attr_getstack(&attributes, &address, &size);
+        pthread_attr_getguardsize(&attributes, &guard);
+        pthread_attr_destroy(&attributes);
+
+        // The stack of the main thread grows on demand, and the kernel keeps a gap between it and the mapping
+        // under it, which the attributes do not count
+        if(getpid() == (pid_t)syscall(SYS_gettid)) {
+            guard += main_stack_gap;
+        }
+
+        return (const char*)address + guard;
+#elif defined(__APPLE__)
+        return (const char*)pthread_get_stackaddr_np(pthread_self()) - pthread_get_stacksize_np(pthread_self());
+#else
+        return nullptr;
+#endif
+    }
+
+    const char* current_stack_limit()
+    {
+        if(!stack_limit) {
+            stack_limit = thread_stack_limit();
+        }
+
+        return stack_limit;
+    }
+
+    // Reserve a stack, with one more page below it which faults instead of overwriting the memory under it
+    void* allocate_stack(size_t& __size)
+    {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+        __size = (__size + page - 1) / page * page + page;
+
+        void* stack = mmap(nullptr, __size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+
+        if(stack == MAP_FAILED) {
+            throw std::runtime_error("coroutine: could not allocate a stack");
+        }
+
+        mprotect(stack, page, PROT_NONE);
+
+        return stack;
+    }
+
+    struct segment
+    {
+        ucontext_t self;
+        ucontext_t caller;
+        const std::function<void()>* function;
+        std::exception_ptr error;
+#ifdef ANDY_ASAN_FIBERS
+        const void* caller_bottom = nullptr;
+        size_t caller_size = 0;
+#endif
+#ifdef ANDY_TSAN_FIBERS
+        void* fiber = nullptr;
+        void* caller_fiber = nullptr;
+#endif
+    };
+
+    thread_local segment* starting_segment = nullptr;
+
+    void segment_entry()
+    {
+        segment* current = starting_segment;
+
+#ifdef ANDY_ASAN_FIBERS
+        __sanitizer_finish_switch_fiber(nullptr, &current->caller_bottom, &current->caller_size);
+#endif
+
+        try {
+            (*current->function)();
+        } catch(...) {
+            current->error = std::current_exception();
+        }
+
+#ifdef ANDY_ASAN_FIBERS
+        __sanitizer_start_switch_fiber(nullptr, current->caller_bottom, current->caller_size);
+#endif
+#ifdef ANDY_TSAN_FIBERS
+        __tsan_switch_to_fiber(current->caller_fiber, 0);
+#endif
+        swapcontext(&current->self, &current->caller);
+    }
+};
+
+andy::lang::coroutine::coroutine(std::function<void()> __function, size_t __stack_size)
+    : m_function(std::move(__function)), m_context(new context())
+{
+    m_context->size = __stack_size;
+
+    try {
+        m_context->stack = allocate_stack(m_context->size);
+    } catch(...) {
+        delete m_context;
+        throw;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    m_stack_limit = (const char*)m_context->stack + page;
+
+    getcontext(&m_context->self);
+    m_context->self.uc_stack.ss_sp = (char*)m_context->stack + page;
+    m_context->self.uc_stack.ss_size = m_context->size - page;
+    m_context->self.uc_link = nullptr;
+    makecontext(&m_context->self, entry, 0);
+
+#ifdef ANDY_TSAN_FIBERS
+    m_context->fiber = __tsan_create_fiber(0);
+#endif
+}
+
+andy::lang::coroutine::~coroutine()
+{
+    if(m_started && !m_done) {
+        m_cancelled = true;
+
+        while(!m_done) {
+            try {
+                resume();
+            } catch(...) {
+            }
+        }
+    }
+
+#ifdef ANDY_TSAN_FIBERS
+    __tsan_destroy_fiber(m_context->fiber);
+#endif
+
+    munmap(m_context->stack, m_context->size);
+    delete m_context;
+}
+
+void andy::lang::coroutine::resume()
+{
+    if(m_done) {
+        throw std::runtime_error("coroutine: resumed after it has returned");
+    }
+
+    m_started = true;
+    m_resumer = std::exchange(running, this);
+
+    const char* resumer_limit = std::exchange(stack_limit, m_stack_limit);
+    m_context->switch_in();
+    m_stack_limit = std::exchange(stack_limit, resumer_limit);
+
+    running = m_resumer;
+
+    if(m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void andy::lang::coroutine::suspend()
+{
+    coroutine* self = running;
+
+    if(!self) {
+        throw std::runtime_error("coroutine: suspended outside of a coroutine");
+    }
+
+    self->m_context->switch_out(false);
+
+    if(self->m_cancelled) {
+        throw cancelled();
+    }
+}
+
+void andy::lang::coroutine::entry()
+{
+    coroutine* self = running;
+
+    self->m_context->switched_in();
+
+    try {
+        self->m_function();
+    } catch(const cancelled&) {
+    } catch(...) {
+        self->m_exception = std::current_exception();
+    }
+
+    self->m_done = true;
+
+    self->m_context->switch_out(true);
+}
+
+bool andy::lang::coroutine::stack_low(size_t __needed)
+{
+    const char* limit = current_stack_limit();
+
+    if(!limit) {
+        return false;
+    }
+
+    return (const char*)__builtin_frame_address(0) - limit < (std::ptrdiff_t)__needed;
+}
+
+void andy::lang::coroutine::on_new_stack(size_t __size, const std::function<void()>& __function)
+{
+    size_t size = __size;
+    void* stack = allocate_stack(size);
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+    segment current;
+    current.function = &__function;
+
+    getcontext(&current.self);
+    current.self.uc_stack.ss_sp = (char*)stack + page;
+    current.self.uc_stack.ss_size = size - page;
+    current.self.uc_link = nullptr;
+    makecontext(&current.self, segment_entry, 0);
+
+    const char* caller_limit = current_stack_limit();
+    stack_limit = (const char*)stack + page;
+    starting_segment = &current;
+
+#ifdef ANDY_ASAN_FIBERS
+    void* caller_fake_stack = nullptr;
+    __sanitizer_start_switch_fiber(&caller_fake_stack, (char*)stack + page, size - page);
+#endif
+#ifdef ANDY_TSAN_FIBERS
+    current.fiber = __tsan_create_fiber(0);
+    current.caller_fiber = __tsan_get_current_fiber();
+    __tsan_switch_to_fiber(current.fiber, 0);
+#endif
+    swapcontext(&current.caller, &current.self);
+#ifdef ANDY_ASAN_FIBERS
+    __sanitizer_finish_switch_fiber(caller_fake_stack, nullptr, nullptr);
+#endif
+#ifdef ANDY_TSAN_FIBERS
+    __tsan_destroy_fiber(current.fiber);
+#endif
+
+    stack_limit = caller_limit;
+    munmap(stack, size);
+
+    if(current.error) {
+        std::rethrow_exception(current.error);
+    }
+}
+
+#endif
+
+andy::lang::coroutine* andy::lang::coroutine::current()
+{
+    return running;
+}
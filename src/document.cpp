@@ -0,0 +1,399 @@
+#include <andy/lang/document.hpp>
+#include <andy/lang/preprocessor.hpp>
+
+namespace
+{
+    // How the positions after an edit move
+    struct edit_shift
+    {
+        std::string_view old_source;
+        std::string_view new_source;
+        // The end of the edit in the old source
+        andy::lang::lexer::token_position old_end;
+        ptrdiff_t delta;
+        ptrdiff_t line_delta;
+        ptrdiff_t column_delta;
+    };
+
+    andy::lang::lexer::token_position position_after(std::string_view __source, andy::lang::lexer::token_position __from, size_t __offset)
+    {
+        for(size_t i = __from.offset; i < __offset && i < __source.size(); i++) {
+            if(__source[i] == '\n') {
+                __from.line++;
+                __from.column = 0;
+            } else {
+                __from.column++;
+            }
+
+            __from.offset++;
+        }
+
+        return __from;
+    }
+
+    void shift(andy::lang::lexer::token_position& __position, const edit_shift& __shift)
+    {
+        if(__position.offset < __shift.old_end.offset) {
+            return;
+        }
+
+        if(__position.line == __shift.old_end.line) {
+            __position.column += __shift.column_delta;
+        }
+
+        __position.line   += __shift.line_delta;
+        __position.offset += __shift.delta;
+    }
+
+    void relocate(andy::lang::lexer::token& __token, const edit_shift& __shift)
+    {
+        __token.relocate(__shift.old_source, __shift.new_source, __shift.old_end.offset, __shift.delta);
+
+        shift(__token.start, __shift);
+        shift(__token.end, __shift);
+    }
+
+    void relocate(andy::lang::parser::ast_node& __node, const edit_shift& __shift)
+    {
+        // The tokens created by the parser are not in the source and have no position
+        if(__node.token().end.offset) {
+            relocate(__node.token(), __shift);
+        }
+
+        for(auto& child : __node.childrens()) {
+            relocate(child, __shift);
+        }
+    }
+
+    bool has_directive(std::vector<andy::lang::lexer::token>::const_iterator __begin, std::vector<andy::lang::lexer::token>::const_iterator __end)
+    {
+        for(auto it = __begin; it != __end; it++) {
+            if(it->type() == andy::lang::lexer::token_type::token_preprocessor) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+andy::lang::document::document(std::string __file_name, std::string __source)
+    : m_file_name(std::move(__file_name)), m_source(std::move(__source))
+{
+    // Keep the characters on the heap, see edit()
+    m_source.reserve(32);
+
+    reload();
+}
+
+void andy::lang::document::reload()
+{
+    m_stats = update_stats();
+    m_error.clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    m_lexer = andy::lang::lexer();
+    m_lexer_failed = false;
+
+    try {
+        m_lexer.tokenize(m_file_name, m_source);
+    } catch(const std::exception& e) {
+        // The tokens are incomplete, the next edit must lex everything again
+        m_lexer_failed = true;
+        m_error = e.what();
+    }
+
+    auto lexed = std::chrono::steady_clock::now();
+
+    m_stats.lex_time = lexed - start;
+    m_stats.lexed_tokens = m_lexer.tokens().size();
+
+    load_includes();
+
+    auto included = std::chrono::steady_clock::now();
+
+    m_declarations.clear();
+
+    if(!m_lexer_failed) {
+        m_declarations = parse(0, 0, {}, 0);
+    }
+
+    m_stats.parse_time = std::chrono::steady_clock::now() - included;
+    m_stats.parsed_declarations = m_declarations.size();
+}
+
+void andy::lang::document::load_includes()
+{
+    m_included = andy::lang::lexer();
+    m_included_root = andy::lang::parser::ast_node();
+    m_includes_error.clear();
+
+    if(!has_directive(m_lexer.tokens().begin(), m_lexer.tokens().end())) {
+        return;
+    }
+
+    m_stats.includes_reloaded = true;
+
+    try {
+        andy::lang::lexer processed(m_file_name, m_source);
+
+        andy::lang::preprocessor preprocessor;
+        preprocessor.process(m_file_name, processed);
+
+        std::vector<andy::lang::lexer::token> tokens;
+
+        for(const auto& token : processed.tokens()) {
+            if(token.m_file_name != m_file_name) {
+                tokens.push_back(token);
+            }
+        }
+
+        // The end of file of the root, the included files had theirs removed
+        tokens.push_back(processed.tokens().back());
+
+        // The tokens point into the sources owned by processed
+        m_included.include(processed);
+        m_included.insert(tokens);
+        m_included.reset();
+
+        andy::lang::parser p;
+        m_included_root = p.parse_all(m_included);
+    } catch(const std::exception& e) {
+        m_includes_error = e.what();
+    }
+}
+
+std::vector<andy::lang::document::declaration> andy::lang::document::parse(size_t __first_token, size_t __damage_end, std::vector<declaration> __reusable, ptrdiff_t __token_delta)
+{
+    std::vector<declaration> declarations;
+
+    andy::lang::parser p;
+    m_lexer.seek(__first_token);
+
+    size_t reusable = 0;
+
+    while(m_lexer.has_next_token()) {
+        const andy::lang::lexer::token& token = m_lexer.see_next();
+
+        if(token.is_eof()) {
+            break;
+        }
+
+        if(token.type() == andy::lang::lexer::token_type::token_comment) {
+            m_lexer.consume_token();
+            continue;
+        }
+
+        if(token.type() == andy::lang::lexer::token_type::token_preprocessor) {
+            // Resolved by load_includes, skip the directive and its argument
+            m_lexer.consume_token();
+
+            if(m_lexer.has_next_token() && m_lexer.see_next().type() == andy::lang::lexer::token_type::token_literal) {
+                m_lexer.consume_token();
+            }
+
+            continue;
+        }
+
+        size_t position = m_lexer.position();
+
+        if(position >= __damage_end) {
+            while(reusable < __reusable.size() && (ptrdiff_t)__reusable[reusable].first_token + __token_delta < (ptrdiff_t)position) {
+                reusable++;
+            }
+
+            if(reusable < __reusable.size() && (ptrdiff_t)__reusable[reusable].first_token + __token_delta == (ptrdiff_t)position) {
+                // The rest of the declarations did not change. Parsing goes on after them, the last parse may
+                // have stopped at a syntax error.
+                m_stats.reused_declarations = __reusable.size() - reusable;
+
+                for(size_t i = reusable; i < __reusable.size(); i++) {
+                    __reusable[i].first_token += __token_delta;
+                    declarations.push_back(std::move(__reusable[i]));
+                }
+
+                __reusable.clear();
+                m_lexer.seek(declarations.back().first_token + declarations.back().token_count);
+
+                continue;
+            }
+        }
+
+        try {
+            andy::lang::parser::ast_node node = p.parse_node(m_lexer);
+            declarations.push_back({ position, m_lexer.position() - position, std::move(node) });
+        } catch(const std::exception& e) {
+            m_error = e.what();
+            break;
+        }
+    }
+
+    return declarations;
+}
+
+const andy::lang::document::update_stats& andy::lang::document::edit(size_t __offset, size_t __removed, std::string_view __inserted)
+{
+    if(__offset > m_source.size() || __removed > m_source.size() - __offset) {
+        throw std::runtime_error("document: edit out of range");
+    }
+
+    // The tokens point into the source. The new source is built aside and always allocated on the heap, so
+    // moving it into m_source after the tokens are relocated does not move its characters.
+    std::string new_source;
+    new_source.reserve(std::max<size_t>(m_source.size() + __inserted.size() - __removed, 32));
+    new_source.append(m_source, 0, __offset);
+    new_source.append(__inserted);
+    new_source.append(m_source, __offset + __removed);
+
+    if(m_lexer_failed) {
+        m_source = std::move(new_source);
+        reload();
+        return m_stats;
+    }
+
+    m_stats = update_stats();
+    m_error.clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<andy::lang::lexer::token>& tokens = m_lexer.tokens();
+
+    // The first token which ends at or after the edit. The token before it is lexed again too, because the
+    // edit can join both (ab|c).
+    size_t first = 0;
+
+    while(first + 1 < tokens.size() && tokens[first].end.offset < __offset) {
+        first++;
+    }
+
+    if(first) {
+        first--;
+    }
+
+    // The lexer can only restart at the beginning of an interpolated string
+    while(first && tokens[first].interpolated()) {
+        first--;
+    }
+
+    andy::lang::lexer::token_position restart = tokens[first].start;
+
+    if(restart.offset > __offset) {
+        // The edit is before the first token
+        restart = andy::lang::lexer::token_position();
+    }
+
+    edit_shift shift;
+    shift.old_source = m_source;
+    shift.new_source = new_source;
+    shift.old_end    = position_after(m_source, restart, __offset + __removed);
+    shift.delta      = (ptrdiff_t)__inserted.size() - (ptrdiff_t)__removed;
+
+    andy::lang::lexer::token_position new_end = position_after(new_source, restart, __offset + __inserted.size());
+
+    shift.line_delta   = (ptrdiff_t)new_end.line - (ptrdiff_t)shift.old_end.line;
+    shift.column_delta = (ptrdiff_t)new_end.column - (ptrdiff_t)shift.old_end.column;
+
+    // Lex until a token starts where an old token after the edit started. Outside of interpolated strings the
+    // lexer only looks one character behind, so from there on the old tokens are the same.
+    size_t old_index = first;
+    size_t sync = tokens.size();
+
+    andy::lang::lexer relexer;
+
+    try {
+        relexer.tokenize(m_file_name, new_source, restart, [&](const andy::lang::lexer::token& token) {
+            if(token.start.offset <= new_end.offset) {
+                return false;
+            }
+
+            while(old_index < tokens.size() && (ptrdiff_t)tokens[old_index].start.offset + shift.delta < (ptrdiff_t)token.start.offset) {
+                old_index++;
+            }
+
+            if(old_index < tokens.size() && tokens[old_index].start.offset > shift.old_end.offset && !tokens[old_index].interpolated()
+                && (ptrdiff_t)tokens[old_index].start.offset + shift.delta == (ptrdiff_t)token.start.offset) {
+                sync = old_index;
+                return true;
+            }
+
+            return false;
+        });
+    } catch(const std::exception&) {
+        m_source = std::move(new_source);
+        reload();
+        return m_stats;
+    }
+
+    bool directives_changed = has_directive(tokens.begin() + first, tokens.begin() + sync) || has_directive(relexer.tokens().begin(), relexer.tokens().end());
+
+    for(size_t i = 0; i < first; i++) {
+        relocate(tokens[i], shift);
+    }
+
+    for(size_t i = sync; i < tokens.size(); i++) {
+        relocate(tokens[i], shift);
+    }
+
+    size_t lexed = relexer.tokens().size();
+    ptrdiff_t token_delta = (ptrdiff_t)lexed - (ptrdiff_t)(sync - first);
+
+    tokens.erase(tokens.begin() + first, tokens.begin() + sync);
+    tokens.insert(tokens.begin() + first, std::make_move_iterator(relexer.tokens().begin()), std::make_move_iterator(relexer.tokens().end()));
+
+    m_source = std::move(new_source);
+
+    auto relexed = std::chrono::steady_clock::now();
+
+    m_stats.lex_time = relexed - start;
+    m_stats.lexed_tokens = lexed;
+
+    // The position in the error of the preprocessor may have moved
+    if(directives_changed || !m_includes_error.empty()) {
+        load_includes();
+    }
+
+    auto included = std::chrono::steady_clock::now();
+
+    // Re-parse from the declaration which contains the token before the damage, parsing it can look ahead
+    size_t anchor = first ? first - 1 : 0;
+    size_t kept = 0;
+
+    while(kept < m_declarations.size() && m_declarations[kept].first_token + m_declarations[kept].token_count <= anchor) {
+        kept++;
+    }
+
+    // Where the parser was after the last kept declaration
+    size_t parse_from = kept ? m_declarations[kept - 1].first_token + m_declarations[kept - 1].token_count : 0;
+
+    std::vector<declaration> reusable;
+
+    for(size_t i = kept; i < m_declarations.size(); i++) {
+        if(m_declarations[i].first_token >= sync) {
+            reusable.push_back(std::move(m_declarations[i]));
+        }
+    }
+
+    m_declarations.resize(kept);
+
+    for(auto& declaration : m_declarations) {
+        relocate(declaration.node, shift);
+    }
+
+    for(auto& declaration : reusable) {
+        relocate(declaration.node, shift);
+    }
+
+    std::vector<declaration> parsed = parse(parse_from, first + lexed, std::move(reusable), token_delta);
+
+    m_stats.parsed_declarations = parsed.size() - m_stats.reused_declarations;
+    m_stats.reused_declarations += m_declarations.size();
+
+    for(auto& declaration : parsed) {
+        m_declarations.push_back(std::move(declaration));
+    }
+
+    m_stats.parse_time = std::chrono::steady_clock::now() - included;
+
+    return m_stats;
+}
@@ -0,0 +1,843 @@
+#include <andy/lang/event_loop.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace
+{
+    // Regular files are read and written by at most this many threads
+    constexpr size_t max_file_threads = 4;
+
+    std::string error_text(std::string_view __what, int __error = errno)
+    {
+        return std::string(__what) + ": " + std::strerror(__error);
+    }
+
+    bool would_block(int __error)
+    {
+        return __error == EAGAIN || __error == EWOULDBLOCK || __error == EINTR;
+    }
+
+    int exit_code(int __status)
+    {
+        if(WIFEXITED(__status)) {
+            return WEXITSTATUS(__status);
+        }
+
+        if(WIFSIGNALED(__status)) {
+            return 128 + WTERMSIG(__status);
+        }
+
+        return -1;
+    }
+
+    sockaddr_un unix_address(const std::filesystem::path& __path)
+    {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+
+        std::string path = __path.string();
+
+        if(path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("the socket path " + path + " is too long");
+        }
+
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+        return address;
+    }
+
+    sockaddr_in loopback_address(int __port)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)__port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        return address;
+    }
+};
+
+andy::lang::event_loop::socket::socket(int __fd, int __port, std::filesystem::path __unix_path)
+    : m_fd(__fd), m_port(__port), m_unix_path(std::move(__unix_path))
+{
+}
+
+andy::lang::event_loop::socket::~socket()
+{
+    ::close(m_fd);
+
+    if(!m_unix_path.empty()) {
+        std::error_code error;
+        std::filesystem::remove(m_unix_path, error);
+    }
+}
+
+void andy::lang::event_loop::socket::shutdown()
+{
+    ::shutdown(m_fd, SHUT_RDWR);
+}
+
+andy::lang::event_loop::event_loop()
+{
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    if(m_epoll < 0) {
+        throw std::runtime_error(error_text("event loop: epoll_create1 failed"));
+    }
+
+    m_wakeup = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if(m_wakeup < 0) {
+        ::close(m_epoll);
+        throw std::runtime_error(error_text("event loop: eventfd failed"));
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = m_wakeup;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wakeup, &event);
+}
+
+andy::lang::event_loop::~event_loop()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for(auto& thread : m_file_threads) {
+        thread.join();
+    }
+
+    // The descriptors of sockets are closed by their sockets, the ones of processes and connects are owned here
+    for(auto& [fd, watch] : m_watches) {
+        for(const handle& operation : { watch.reader, watch.writer }) {
+            if(operation && !operation->done) {
+                close_descriptors(*operation);
+            }
+        }
+    }
+
+    ::close(m_wakeup);
+    ::close(m_epoll);
+}
+
+void andy::lang::event_loop::close_descriptors(andy::lang::event_loop::operation& __operation)
+{
+    if(__operation.type != operation::kind::process && __operation.type != operation::kind::connect) {
+        return;
+    }
+
+    for(int* fd : { &__operation.m_fd, &__operation.m_input_fd, &__operation.m_exit_fd }) {
+        if(*fd >= 0) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+
+    if(__operation.m_pid > 0) {
+        // Reap the process if it already exited, it is not waited for
+        waitpid(__operation.m_pid, nullptr, WNOHANG);
+    }
+
+    __operation.done = true;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::read_file(std::filesystem::path __path)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::read_file);
+
+    submit(operation, [path = std::move(__path)](andy::lang::event_loop::operation& operation) {
+        std::ifstream file(path, std::ios::binary);
+
+        if(!file) {
+            operation.error = "could not open " + path.string();
+            return;
+        }
+
+        std::ostringstream content;
+        content << file.rdbuf();
+        operation.data = content.str();
+    });
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::write_file(std::filesystem::path __path, std::string __content)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::write_file);
+
+    submit(operation, [path = std::move(__path), content = std::move(__content)](andy::lang::event_loop::operation& operation) {
+        std::ofstream file(path, std::ios::binary);
+
+        if(!file || !file.write(content.data(), content.size()) || !file.flush()) {
+            operation.error = "could not write " + path.string();
+            return;
+        }
+
+        operation.value = (int64_t)content.size();
+    });
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::run_process(const std::string& __command, std::string __input, const std::filesystem::path& __working_directory)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::process);
+
+    int output[2];
+    int input[2];
+
+    if(pipe2(output, O_CLOEXEC) != 0) {
+        throw std::runtime_error(error_text("failed to run command"));
+    }
+
+    // A socket instead of a pipe, so writing to a process which exited fails instead of raising SIGPIPE
+    if(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, input) != 0) {
+        int error = errno;
+        ::close(output[0]);
+        ::close(output[1]);
+        throw std::runtime_error(error_text("failed to run command", error));
+    }
+
+    // Only async-signal-safe calls are made by the child, what it needs is prepared before the fork
+    std::string directory = __working_directory.string();
+
+    pid_t pid = fork();
+
+    if(pid == 0) {
+        dup2(input[1], STDIN_FILENO);
+        dup2(output[1], STDOUT_FILENO);
+
+        if(!directory.empty() && chdir(directory.c_str()) != 0) {
+            _exit(127);
+        }
+
+        execl("/bin/sh", "sh", "-c", __command.c_str(), (char*)nullptr);
+        _exit(127);
+    }
+
+    ::close(output[1]);
+    ::close(input[1]);
+
+    if(pid < 0) {
+        int error = errno;
+        ::close(output[0]);
+        ::close(input[0]);
+        throw std::runtime_error(error_text("failed to run command", error));
+    }
+
+    fcntl(output[0], F_SETFL, O_NONBLOCK);
+    fcntl(input[0], F_SETFL, O_NONBLOCK);
+
+    operation->m_pid = pid;
+    operation->m_fd = output[0];
+    operation->m_input_fd = input[0];
+    operation->m_pending = std::move(__input);
+    // Without pidfds (before Linux 5.3) the process is waited for when its output ends
+#ifdef SYS_pidfd_open
+    operation->m_exit_fd = (int)syscall(SYS_pidfd_open, pid, 0);
+#endif
+    operation->m_open_parts = operation->m_exit_fd >= 0 ? 3 : 2;
+
+    watch_reader(operation->m_fd, operation);
+
+    if(operation->m_exit_fd >= 0) {
+        watch_reader(operation->m_exit_fd, operation);
+    }
+
+    m_pending++;
+
+    if(operation->m_pending.empty()) {
+        ::close(operation->m_input_fd);
+        operation->m_input_fd = -1;
+        finish_part(operation);
+    } else {
+        watch_writer(operation->m_input_fd, operation);
+    }
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::timer(std::chrono::milliseconds __delay)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::timer);
+
+    m_timers.emplace(std::chrono::steady_clock::now() + __delay, operation);
+    m_pending++;
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::accept(std::shared_ptr<andy::lang::event_loop::socket> __listener)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::accept);
+    int fd = __listener->fd();
+    operation->m_socket = std::move(__listener);
+
+    watch_reader(fd, operation);
+    m_pending++;
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::connect_tcp(int __port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if(fd < 0) {
+        throw std::runtime_error(error_text("socket failed"));
+    }
+
+    sockaddr_in address = loopback_address(__port);
+
+    return start_connect(fd, &address, sizeof(address));
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::connect_unix(const std::filesystem::path& __path)
+{
+    sockaddr_un address = unix_address(__path);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if(fd < 0) {
+        throw std::runtime_error(error_text("socket failed"));
+    }
+
+    return start_connect(fd, &address, sizeof(address));
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::start_connect(int __fd, const void* __address, size_t __length)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::connect);
+    m_pending++;
+
+    if(::connect(__fd, (const sockaddr*)__address, (socklen_t)__length) == 0) {
+        operation->connection = std::make_shared<andy::lang::event_loop::socket>(__fd);
+        complete(operation);
+    } else if(errno == EINPROGRESS) {
+        operation->m_fd = __fd;
+        watch_writer(__fd, operation);
+    } else {
+        int error = errno;
+        ::close(__fd);
+        complete(operation, error_text("connect failed", error));
+    }
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::receive(std::shared_ptr<andy::lang::event_loop::socket> __socket)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::receive);
+    int fd = __socket->fd();
+    operation->m_socket = std::move(__socket);
+
+    watch_reader(fd, operation);
+    m_pending++;
+
+    return operation;
+}
+
+andy::lang::event_loop::handle andy::lang::event_loop::send(std::shared_ptr<andy::lang::event_loop::socket> __socket, std::string __data)
+{
+    auto operation = std::make_shared<andy::lang::event_loop::operation>(operation::kind::send);
+    int fd = __socket->fd();
+    operation->m_socket = std::move(__socket);
+    operation->m_pending = std::move(__data);
+
+    watch_writer(fd, operation);
+    m_pending++;
+
+    return operation;
+}
+
+std::shared_ptr<andy::lang::event_loop::socket> andy::lang::event_loop::listen_tcp(int __port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if(fd < 0) {
+        throw std::runtime_error(error_text("socket failed"));
+    }
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address = loopback_address(__port);
+    socklen_t length = sizeof(address);
+
+    if(bind(fd, (sockaddr*)&address, length) != 0 || listen(fd, SOMAXCONN) != 0 || getsockname(fd, (sockaddr*)&address, &length) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error(error_text("could not listen on port " + std::to_string(__port), error));
+    }
+
+    return std::make_shared<andy::lang::event_loop::socket>(fd, ntohs(address.sin_port));
+}
+
+std::shared_ptr<andy::lang::event_loop::socket> andy::lang::event_loop::listen_unix(const std::filesystem::path& __path)
+{
+    sockaddr_un address = unix_address(__path);
+
+    // A socket left by a process which did not remove it
+    if(std::filesystem::is_socket(__path)) {
+        std::filesystem::remove(__path);
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if(fd < 0) {
+        throw std::runtime_error(error_text("socket failed"));
+    }
+
+    if(bind(fd, (sockaddr*)&address, sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error(error_text("could not listen on " + __path.string(), error));
+    }
+
+    return std::make_shared<andy::lang::event_loop::socket>(fd, 0, __path);
+}
+
+void andy::lang::event_loop::wait(const handle& __operation)
+{
+    while(!__operation->done) {
+        if(!m_pending) {
+            throw std::runtime_error("event loop: the operation is not in flight");
+        }
+
+        run_once(true);
+    }
+}
+
+void andy::lang::event_loop::run()
+{
+    while(m_pending) {
+        run_once(true);
+    }
+}
+
+void andy::lang::event_loop::poll()
+{
+    if(m_pending) {
+        run_once(false);
+    }
+}
+
+void andy::lang::event_loop::run_once(bool __block)
+{
+    int timeout = __block ? -1 : 0;
+
+    if(__block && !m_timers.empty()) {
+        auto left = m_timers.begin()->first - std::chrono::steady_clock::now();
+        // Round up, waking before the deadline would only wait again
+        timeout = (int)std::max<int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(left).count());
+    }
+
+    epoll_event events[64];
+    int count = epoll_wait(m_epoll, events, 64, timeout);
+
+    if(count < 0 && errno != EINTR) {
+        throw std::runtime_error(error_text("event loop: epoll_wait failed"));
+    }
+
+    for(int i = 0; i < count; i++) {
+        int fd = events[i].data.fd;
+
+        if(fd == m_wakeup) {
+            uint64_t value;
+            while(read(m_wakeup, &value, sizeof(value)) > 0) {
+            }
+
+            std::vector<handle> finished;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                finished.swap(m_finished);
+            }
+
+            for(auto& operation : finished) {
+                complete(operation, operation->error);
+            }
+
+            continue;
+        }
+
+        auto it = m_watches.find(fd);
+
+        if(it == m_watches.end()) {
+            continue;
+        }
+
+        // The handlers change the watches, keep the operations
+        handle reader = it->second.reader;
+        handle writer = it->second.writer;
+
+        if(reader && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+            on_readable(fd, reader);
+        }
+
+        if(writer && (events[i].events & (EPOLLOUT | EPOLLHUP | EPOLLERR))) {
+            on_writable(fd, writer);
+        }
+    }
+
+    auto now = std::chrono::steady_clock::now();
+
+    while(!m_timers.empty() && m_timers.begin()->first <= now) {
+        handle operation = std::move(m_timers.begin()->second);
+        m_timers.erase(m_timers.begin());
+
+        complete(operation);
+    }
+}
+
+void andy::lang::event_loop::watch_reader(int __fd, handle __operation)
+{
+    watch& watch = m_watches[__fd];
+
+    if(watch.reader) {
+        throw std::runtime_error("a read is already in flight on this socket");
+    }
+
+    watch.reader = std::move(__operation);
+    update(__fd);
+}
+
+void andy::lang::event_loop::watch_writer(int __fd, handle __operation)
+{
+    watch& watch = m_watches[__fd];
+
+    if(watch.writer) {
+        throw std::runtime_error("a write is already in flight on this socket");
+    }
+
+    watch.writer = std::move(__operation);
+    update(__fd);
+}
+
+void andy::lang::event_loop::unwatch_reader(int __fd)
+{
+    m_watches[__fd].reader = nullptr;
+    update(__fd);
+}
+
+void andy::lang::event_loop::unwatch_writer(int __fd)
+{
+    m_watches[__fd].writer = nullptr;
+    update(__fd);
+}
+
+void andy::lang::event_loop::update(int __fd)
+{
+    auto it = m_watches.find(__fd);
+    watch& watch = it->second;
+
+    uint32_t events = (watch.reader ? uint32_t(EPOLLIN) : 0u) | (watch.writer ? uint32_t(EPOLLOUT) : 0u);
+
+    if(!events && !watch.events) {
+        m_watches.erase(it);
+        return;
+    }
+
+    if(events == watch.events) {
+        return;
+    }
+
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = __fd;
+
+    int result;
+
+    if(!events) {
+        result = epoll_ctl(m_epoll, EPOLL_CTL_DEL, __fd, nullptr);
+        m_watches.erase(it);
+    } else {
+        result = epoll_ctl(m_epoll, watch.events ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, __fd, &event);
+        watch.events = events;
+    }
+
+    if(result != 0 && events) {
+        int error = errno;
+        m_watches.erase(__fd);
+        throw std::runtime_error(error_text("event loop: cannot watch the descriptor", error));
+    }
+}
+
+void andy::lang::event_loop::on_readable(int __fd, handle __operation)
+{
+    switch(__operation->type) {
+        case operation::kind::accept: {
+            int fd = accept4(__fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+            if(fd < 0 && would_block(errno)) {
+                return;
+            }
+
+            int error = errno;
+            unwatch_reader(__fd);
+
+            if(fd < 0) {
+                complete(__operation, error_text("accept failed", error));
+            } else {
+                __operation->connection = std::make_shared<andy::lang::event_loop::socket>(fd);
+                complete(__operation);
+            }
+        }
+        break;
+        case operation::kind::receive: {
+            char buffer[65536];
+            ssize_t count = recv(__fd, buffer, sizeof(buffer), 0);
+
+            if(count < 0 && would_block(errno)) {
+                return;
+            }
+
+            int error = errno;
+            unwatch_reader(__fd);
+
+            if(count < 0) {
+                complete(__operation, error_text("receive failed", error));
+            } else {
+                __operation->data.assign(buffer, count);
+                complete(__operation);
+            }
+        }
+        break;
+        case operation::kind::process: {
+            if(__fd == __operation->m_exit_fd) {
+                int status = 0;
+
+                if(waitpid(__operation->m_pid, &status, WNOHANG) == 0) {
+                    return;
+                }
+
+                __operation->value = exit_code(status);
+
+                unwatch_reader(__fd);
+                ::close(__fd);
+                __operation->m_exit_fd = -1;
+                finish_part(__operation);
+                return;
+            }
+
+            char buffer[65536];
+
+            while(true) {
+                ssize_t count = read(__fd, buffer, sizeof(buffer));
+
+                if(count > 0) {
+                    __operation->data.append(buffer, count);
+                    continue;
+                }
+
+                if(count < 0 && would_block(errno)) {
+                    return;
+                }
+
+                break;
+            }
+
+            // The output ended
+            unwatch_reader(__fd);
+            ::close(__fd);
+            __operation->m_fd = -1;
+
+            if(__operation->m_exit_fd < 0) {
+                int status = 0;
+                waitpid(__operation->m_pid, &status, 0);
+                __operation->value = exit_code(status);
+            }
+
+            finish_part(__operation);
+        }
+        break;
+        default:
+        break;
+    }
+}
+
+void andy::lang::event_loop::on_writable(int __fd, handle __operation)
+{
+    switch(__operation->type) {
+        case operation::kind::connect: {
+            int error = 0;
+            socklen_t length = sizeof(error);
+            getsockopt(__fd, SOL_SOCKET, SO_ERROR, &error, &length);
+
+            unwatch_writer(__fd);
+            __operation->m_fd = -1;
+
+            if(error) {
+                ::close(__fd);
+                complete(__operation, error_text("connect failed", error));
+            } else {
+                __operation->connection = std::make_shared<andy::lang::event_loop::socket>(__fd);
+                complete(__operation);
+            }
+        }
+        break;
+        case operation::kind::send:
+        case operation::kind::process: {
+            std::string& data = __operation->m_pending;
+            int error = 0;
+
+            while(__operation->m_offset < data.size()) {
+                ssize_t count = ::send(__fd, data.data() + __operation->m_offset, data.size() - __operation->m_offset, MSG_NOSIGNAL);
+
+                if(count < 0) {
+                    if(would_block(errno)) {
+                        return;
+                    }
+
+                    error = errno;
+                    break;
+                }
+
+                __operation->m_offset += count;
+            }
+
+            unwatch_writer(__fd);
+
+            if(__operation->type == operation::kind::process) {
+                // A process which exits without reading all of its input is not an error
+                ::close(__fd);
+                __operation->m_input_fd = -1;
+                finish_part(__operation);
+            } else if(error) {
+                complete(__operation, error_text("send failed", error));
+            } else {
+                __operation->value = (int64_t)__operation->m_offset;
+                complete(__operation);
+            }
+        }
+        break;
+        default:
+        break;
+    }
+}
+
+void andy::lang::event_loop::finish_part(const handle& __operation)
+{
+    if(--__operation->m_open_parts == 0) {
+        complete(__operation);
+    }
+}
+
+void andy::lang::event_loop::complete(const handle& __operation, std::string __error)
+{
+    __operation->error = std::move(__error);
+    __operation->m_socket = nullptr;
+    __operation->m_pending.clear();
+    __operation->done = true;
+
+    m_pending--;
+
+    if(__operation->on_done) {
+        std::exchange(__operation->on_done, nullptr)();
+    }
+}
+
+void andy::lang::event_loop::submit(handle __operation, std::function<void(andy::lang::event_loop::operation&)> __job)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_jobs.emplace_back(std::move(__operation), std::move(__job));
+
+        if(m_busy_threads + m_jobs.size() > m_file_threads.size() && m_file_threads.size() < max_file_threads) {
+            m_file_threads.emplace_back(&andy::lang::event_loop::file_thread, this);
+        }
+    }
+
+    m_pending++;
+    m_condition.notify_one();
+}
+
+void andy::lang::event_loop::file_thread()
+{
+    while(true) {
+        std::pair<handle, std::function<void(andy::lang::event_loop::operation&)>> job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_condition.wait(lock, [this]() {
+                return m_stopping || !m_jobs.empty();
+            });
+
+            if(m_jobs.empty()) {
+                return;
+            }
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+            m_busy_threads++;
+        }
+
+        try {
+            job.second(*job.first);
+        } catch(const std::exception& e) {
+            job.first->error = e.what();
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_busy_threads--;
+            m_finished.push_back(std::move(job.first));
+        }
+
+        uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = write(m_wakeup, &one, sizeof(one));
+    }
+}
+#else
+// The loop needs epoll, eventfd and pidfds. Creating it fails elsewhere, so the rest is never called.
+namespace
+{
+    [[noreturn]] void unsupported()
+    {
+        throw std::runtime_error("the event loop is only available on Linux");
+    }
+};
+
+andy::lang::event_loop::socket::socket(int __fd, int __port, std::filesystem::path __unix_path) : m_fd(__fd), m_port(__port) { unsupported(); }
+andy::lang::event_loop::socket::~socket() {}
+void andy::lang::event_loop::socket::shutdown() { unsupported(); }
+andy::lang::event_loop::event_loop() { unsupported(); }
+andy::lang::event_loop::~event_loop() {}
+andy::lang::event_loop::handle andy::lang::event_loop::read_file(std::filesystem::path) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::write_file(std::filesystem::path, std::string) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::run_process(const std::string&, std::string, const std::filesystem::path&) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::timer(std::chrono::milliseconds) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::accept(std::shared_ptr<andy::lang::event_loop::socket>) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::connect_tcp(int) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::connect_unix(const std::filesystem::path&) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::receive(std::shared_ptr<andy::lang::event_loop::socket>) { unsupported(); }
+andy::lang::event_loop::handle andy::lang::event_loop::send(std::shared_ptr<andy::lang::event_loop::socket>, std::string) { unsupported(); }
+std::shared_ptr<andy::lang::event_loop::socket> andy::lang::event_loop::listen_tcp(int) { unsupported(); }
+std::shared_ptr<andy::lang::event_loop::socket> andy::lang::event_loop::listen_unix(const std::filesystem::path&) { unsupported(); }
+void andy::lang::event_loop::wait(const handle&) { unsupported(); }
+void andy::lang::event_loop::run() { unsupported(); }
+void andy::lang::event_loop::poll() { unsupported(); }
+void andy::lang::event_loop::run_once(bool) { unsupported(); }
+#endif
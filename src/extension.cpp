@@ -6,6 +6,7 @@
 #include <uva.hpp>
 
 #include <andy/lang/interpreter.hpp>
+#include <andy/lang/timings.hpp>
 
 #ifdef __linux__
 #   include <dlfcn.h>
@@ -62,6 +63,9 @@ void andy::lang::extension::import(andy::lang::interpreter* interpreter, std::st
     std::string module_path_str = module_path.string();
     const char* module_path_c_str = module_path_str.c_str();
 
+    // Loading the library, creating the extension and loading its classes
+    andy::lang::timings::scope import_phase(interpreter->timings, "import", module_path_str);
+
     andy::lang::extension* (*create_extension)();
 
 #ifdef __linux__
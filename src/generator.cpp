@@ -0,0 +1,69 @@
+#include <andy/lang/generator.hpp>
+
+std::shared_ptr<andy::lang::object> andy::lang::generator::create(andy::lang::interpreter* __interpreter, std::shared_ptr<andy::lang::object> __self, const andy::lang::method& __method, andy::lang::interpreter_context&& __context)
+{
+    auto generator = std::make_shared<andy::lang::generator>(__interpreter, std::move(__self), __method.block_ast->block(), std::move(__context));
+
+    return andy::lang::object::create(__interpreter, __interpreter->GeneratorClass(), std::move(generator));
+}
+
+andy::lang::generator::generator(andy::lang::interpreter* __interpreter, std::shared_ptr<andy::lang::object> __self, const andy::lang::parser::ast_node* __block, andy::lang::interpreter_context __context)
+    : m_interpreter(__interpreter), m_self(std::move(__self)), m_block(__block), m_context(std::move(__context)), m_coroutine([this]() {
+        m_interpreter->execute(*m_block, m_self);
+    })
+{
+}
+
+std::optional<std::shared_ptr<andy::lang::object>> andy::lang::generator::next()
+{
+    if(andy::lang::coroutine::current() == &m_coroutine) {
+        throw std::runtime_error("Generator: a generator cannot ask itself for a value");
+    }
+
+    if(!m_value && !m_coroutine.done()) {
+        swap_contexts();
+
+        try {
+            m_coroutine.resume();
+        } catch(...) {
+            swap_contexts();
+            throw;
+        }
+
+        swap_contexts();
+    }
+
+    return std::exchange(m_value, std::nullopt);
+}
+
+bool andy::lang::generator::done()
+{
+    if(!m_value) {
+        m_value = next();
+    }
+
+    return !m_value;
+}
+
+void andy::lang::generator::yield(std::shared_ptr<andy::lang::object> __value)
+{
+    if(!__value) {
+        __value = std::make_shared<andy::lang::object>(m_interpreter->NullClass);
+    }
+
+    m_value = std::move(__value);
+
+    andy::lang::coroutine::suspend();
+}
+
+void andy::lang::generator::swap_contexts()
+{
+    std::swap(m_interpreter->current_context, m_context);
+    std::swap(m_interpreter->stack, m_stack);
+
+    if(m_interpreter->generator == this) {
+        m_interpreter->generator = m_resumer;
+    } else {
+        m_resumer = std::exchange(m_interpreter->generator, this);
+    }
+}
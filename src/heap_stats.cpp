@@ -0,0 +1,239 @@
+#include <andy/lang/heap_stats.hpp>
+#include <andy/lang/object.hpp>
+#include <andy/lang/class.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iomanip>
+
+thread_local andy::lang::heap_stats* andy::lang::heap_stats::s_current = nullptr;
+
+namespace
+{
+    void sort_by(std::vector<andy::lang::heap_stats::entry>& entries, size_t andy::lang::heap_stats::entry::* field)
+    {
+        std::stable_sort(entries.begin(), entries.end(), [field](const auto& a, const auto& b) {
+            return a.*field > b.*field;
+        });
+    }
+
+    void write_entries(std::ostream& out, const std::vector<andy::lang::heap_stats::entry>& entries)
+    {
+        for(size_t i = 0; i < entries.size(); i++) {
+            const auto& e = entries[i];
+
+            // Class names are identifiers and sites are file names, none of them needs to be escaped
+            out << "\t\t{ \"class\": \"" << e.cls << "\", ";
+
+            if(!e.site.empty()) {
+                out << "\"site\": \"" << e.site << "\", ";
+            }
+
+            out << "\"objects\": " << e.objects << ", \"bytes\": " << e.bytes << ", ";
+            out << "\"allocated_objects\": " << e.allocated_objects << ", \"allocated_bytes\": " << e.allocated_bytes << " }";
+            out << (i + 1 < entries.size() ? ",\n" : "\n");
+        }
+    }
+};
+
+andy::lang::heap_stats::heap_stats()
+{
+    static std::atomic<uint32_t> generations = 0;
+
+    // 0 is the tag of the objects which are not counted
+    m_generation = (generations++ % 255) + 1;
+}
+
+andy::lang::heap_stats::~heap_stats()
+{
+    stop();
+}
+
+void andy::lang::heap_stats::start()
+{
+    if(m_running) {
+        return;
+    }
+
+    if(s_current) {
+        throw std::runtime_error("heap statistics are already counted on this thread");
+    }
+
+    s_current = this;
+    m_running = true;
+}
+
+void andy::lang::heap_stats::stop()
+{
+    if(!m_running) {
+        return;
+    }
+
+    s_current = nullptr;
+    m_running = false;
+    m_position = nullptr;
+    m_last_position = nullptr;
+}
+
+size_t andy::lang::heap_stats::site_of_tag(uint32_t __tag) const
+{
+    if((__tag >> 24) != m_generation) {
+        return (size_t)-1;
+    }
+
+    return __tag & 0xffffff;
+}
+
+uint32_t andy::lang::heap_stats::site_of(uint32_t __cls)
+{
+    auto it = m_site_ids.find({ m_position, __cls });
+
+    if(it != m_site_ids.end()) {
+        return it->second;
+    }
+
+    std::string site = "<native>";
+
+    if(m_position) {
+        site  = std::filesystem::path(m_position->m_file_name).filename().string();
+        site += ':';
+        site += std::to_string(m_position->start.line + 1);
+    }
+
+    auto [name_it, inserted] = m_site_names.try_emplace({ site, __cls }, (uint32_t)m_sites.size());
+
+    if(inserted) {
+        if(m_sites.size() > 0xffffff) {
+            throw std::runtime_error("too many allocation sites");
+        }
+
+        entry e;
+        e.cls  = m_classes[__cls].cls;
+        e.site = std::move(site);
+        m_sites.push_back(std::move(e));
+        m_site_classes.push_back(__cls);
+    }
+
+    m_site_ids.emplace(std::make_pair(m_position, __cls), name_it->second);
+
+    return name_it->second;
+}
+
+uint32_t andy::lang::heap_stats::allocated(const andy::lang::structure* __cls)
+{
+    if(__cls != m_last_cls || m_position != m_last_position || m_sites.empty()) {
+        auto [cls_it, inserted] = m_class_ids.try_emplace(__cls, (uint32_t)m_classes.size());
+
+        if(inserted) {
+            entry e;
+            e.cls = __cls ? __cls->name : std::string("<null>");
+            m_classes.push_back(std::move(e));
+        }
+
+        m_last_cls = __cls;
+        m_last_position = m_position;
+        m_last_site = site_of(cls_it->second);
+    }
+
+    size_t bytes = sizeof(andy::lang::object);
+
+    for(entry* e : { &m_classes[m_site_classes[m_last_site]], &m_sites[m_last_site] }) {
+        e->objects++;
+        e->bytes += bytes;
+        e->allocated_objects++;
+        e->allocated_bytes += bytes;
+    }
+
+    m_live_objects++;
+    m_live_bytes += bytes;
+    m_peak_bytes = std::max(m_peak_bytes, m_live_bytes);
+
+    return (m_generation << 24) | m_last_site;
+}
+
+void andy::lang::heap_stats::grew(uint32_t __tag, size_t __bytes)
+{
+    size_t site = site_of_tag(__tag);
+
+    if(site == (size_t)-1) {
+        return;
+    }
+
+    for(entry* e : { &m_classes[m_site_classes[site]], &m_sites[site] }) {
+        e->bytes += __bytes;
+        e->allocated_bytes += __bytes;
+    }
+
+    m_live_bytes += __bytes;
+    m_peak_bytes = std::max(m_peak_bytes, m_live_bytes);
+}
+
+void andy::lang::heap_stats::freed(uint32_t __tag, size_t __bytes)
+{
+    size_t site = site_of_tag(__tag);
+
+    if(site == (size_t)-1) {
+        return;
+    }
+
+    for(entry* e : { &m_classes[m_site_classes[site]], &m_sites[site] }) {
+        e->objects--;
+        e->bytes -= __bytes;
+    }
+
+    m_live_objects--;
+    m_live_bytes -= __bytes;
+}
+
+std::vector<andy::lang::heap_stats::entry> andy::lang::heap_stats::classes() const
+{
+    std::vector<entry> result = m_classes;
+    sort_by(result, &entry::bytes);
+    return result;
+}
+
+std::vector<andy::lang::heap_stats::entry> andy::lang::heap_stats::sites() const
+{
+    std::vector<entry> result = m_sites;
+    sort_by(result, &entry::allocated_bytes);
+    return result;
+}
+
+void andy::lang::heap_stats::write_report(std::ostream& __out) const
+{
+    __out << "live objects: " << m_live_objects << ", live bytes: " << m_live_bytes << ", peak bytes: " << m_peak_bytes << std::endl;
+    __out << std::endl;
+
+    __out << std::setw(12) << "objects" << std::setw(14) << "bytes" << std::setw(14) << "allocated" << std::setw(16) << "allocated bytes" << "  class" << std::endl;
+
+    for(const entry& e : classes()) {
+        __out << std::setw(12) << e.objects << std::setw(14) << e.bytes << std::setw(14) << e.allocated_objects << std::setw(16) << e.allocated_bytes << "  " << e.cls << std::endl;
+    }
+
+    __out << std::endl;
+    __out << std::setw(12) << "objects" << std::setw(14) << "bytes" << std::setw(14) << "allocated" << std::setw(16) << "allocated bytes" << "  site" << std::endl;
+
+    std::vector<entry> all = sites();
+
+    // The sites which allocate the least are noise
+    for(size_t i = 0; i < all.size() && i < 20; i++) {
+        const entry& e = all[i];
+        __out << std::setw(12) << e.objects << std::setw(14) << e.bytes << std::setw(14) << e.allocated_objects << std::setw(16) << e.allocated_bytes << "  " << e.cls << " at " << e.site << std::endl;
+    }
+}
+
+void andy::lang::heap_stats::write_snapshot(std::ostream& __out) const
+{
+    __out << "{\n";
+    __out << "\t\"live_objects\": " << m_live_objects << ",\n";
+    __out << "\t\"live_bytes\": " << m_live_bytes << ",\n";
+    __out << "\t\"peak_bytes\": " << m_peak_bytes << ",\n";
+    __out << "\t\"classes\": [\n";
+    write_entries(__out, classes());
+    __out << "\t],\n";
+    __out << "\t\"sites\": [\n";
+    write_entries(__out, sites());
+    __out << "\t]\n";
+    __out << "}\n";
+}
@@ -0,0 +1,429 @@
+#include <andy/lang/image.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/lang.hpp>
+#include <andy/lang/big_integer.hpp>
+
+#include <cstring>
+#include <deque>
+#include <set>
+#include <unordered_map>
+
+namespace
+{
+    // State: uint32 object_count | object[object_count] | uint32 global_count | (string name, uint32 object)[global_count]
+    // The objects are stored in the order they are found from the globals. An object references another by
+    // its index, so the objects are created first and filled after, which restores cycles.
+    enum object_kind : uint8_t
+    {
+        kind_null,
+        kind_true,
+        kind_false,
+        kind_integer,
+        kind_float,
+        kind_double,
+        kind_string,
+        kind_array,
+        kind_dictionary,
+        // A Class object, stored by the name of its class
+        kind_class,
+        // An instance of a class of the program: string class, uint32 base + 1, uint32 derived + 1, uint32 variable_count, (string name, uint32 object)[variable_count]
+        kind_instance,
+        // A BigInteger, stored by its decimal representation
+        kind_big_integer,
+    };
+
+    constexpr uint32_t no_object = 0;
+
+    class state_writer
+    {
+    public:
+        state_writer(andy::lang::interpreter& __interpreter, std::set<std::string_view> __classes)
+            : m_interpreter(__interpreter), m_classes(std::move(__classes))
+        {
+        }
+    public:
+        uint32_t id_of(const std::shared_ptr<andy::lang::object>& __object, std::string_view __global)
+        {
+            auto [it, inserted] = m_ids.try_emplace(__object.get(), (uint32_t)m_ids.size());
+
+            if(inserted) {
+                m_pending.push_back({ __object, __global });
+            }
+
+            return it->second;
+        }
+
+        // The objects are written in the order of their ids, the order they were found
+        std::string objects()
+        {
+            std::string result;
+
+            while(!m_pending.empty()) {
+                auto [object, global] = m_pending.front();
+                m_pending.pop_front();
+
+                write_object(result, *object, global);
+            }
+
+            return result;
+        }
+
+        size_t object_count() const { return m_ids.size(); }
+    public:
+        static void write_u32(std::string& __out, uint32_t __value)
+        {
+            __out.append((const char*)&__value, sizeof(__value));
+        }
+
+        static void write_string(std::string& __out, std::string_view __value)
+        {
+            write_u32(__out, (uint32_t)__value.size());
+            __out.append(__value);
+        }
+    protected:
+        // __global names the variable the object was found from, for the errors
+        void write_object(std::string& __out, const andy::lang::object& __object, std::string_view __global)
+        {
+            auto cls = __object.cls;
+
+            if(cls == m_interpreter.NullClass) {
+                __out.push_back(kind_null);
+            } else if(cls == m_interpreter.TrueClass) {
+                __out.push_back(kind_true);
+            } else if(cls == m_interpreter.FalseClass) {
+                __out.push_back(kind_false);
+            } else if(cls == m_interpreter.IntegerClass) {
+                __out.push_back(kind_integer);
+                int64_t value = __object.as<int64_t>();
+                __out.append((const char*)&value, sizeof(value));
+            } else if(cls == m_interpreter.BigIntegerClass) {
+                __out.push_back(kind_big_integer);
+                write_string(__out, __object.as<andy::lang::big_integer>().to_string());
+            } else if(cls == m_interpreter.FloatClass) {
+                __out.push_back(kind_float);
+                float value = __object.as<float>();
+                __out.append((const char*)&value, sizeof(value));
+            } else if(cls == m_interpreter.DoubleClass) {
+                __out.push_back(kind_double);
+                double value = __object.as<double>();
+                __out.append((const char*)&value, sizeof(value));
+            } else if(cls == m_interpreter.StringClass) {
+                __out.push_back(kind_string);
+                write_string(__out, __object.as<std::string>());
+            } else if(cls == m_interpreter.ArrayClass) {
+                const auto& items = __object.as<std::vector<std::shared_ptr<andy::lang::object>>>();
+
+                __out.push_back(kind_array);
+                write_u32(__out, (uint32_t)items.size());
+
+                for(const auto& item : items) {
+                    write_u32(__out, id_of(item, __global));
+                }
+            } else if(cls == m_interpreter.DictionaryClass) {
+                const auto& pairs = __object.as<andy::lang::dictionary>();
+
+                __out.push_back(kind_dictionary);
+                write_u32(__out, (uint32_t)pairs.size());
+
+                for(const auto& [key, value] : pairs) {
+                    write_u32(__out, id_of(key, __global));
+                    write_u32(__out, id_of(value, __global));
+                }
+            } else if(cls == m_interpreter.ClassClass) {
+                __out.push_back(kind_class);
+                write_string(__out, __object.as<std::shared_ptr<andy::lang::structure>>()->name);
+            } else if(cls && m_classes.contains(cls->name)) {
+                __out.push_back(kind_instance);
+                write_string(__out, cls->name);
+                write_u32(__out, __object.base_instance ? id_of(__object.base_instance, __global) + 1 : no_object);
+                write_u32(__out, __object.derived_instance ? id_of(__object.derived_instance, __global) + 1 : no_object);
+                write_u32(__out, (uint32_t)__object.instance_variables.size());
+
+                for(const auto& [name, value] : __object.instance_variables) {
+                    write_string(__out, name);
+                    write_u32(__out, id_of(value, __global));
+                }
+            } else {
+                throw std::runtime_error("image: the global " + std::string(__global) + " references a " + (cls ? cls->name : std::string("null")) + " object, which cannot be stored");
+            }
+        }
+    protected:
+        andy::lang::interpreter& m_interpreter;
+        std::set<std::string_view> m_classes;
+        std::unordered_map<const andy::lang::object*, uint32_t> m_ids;
+        std::deque<std::pair<std::shared_ptr<andy::lang::object>, std::string_view>> m_pending;
+    };
+
+    class state_reader
+    {
+    public:
+        state_reader(std::string_view __state)
+            : m_state(__state)
+        {
+        }
+    public:
+        uint8_t read_u8()
+        {
+            return (uint8_t)*take(1);
+        }
+
+        uint32_t read_u32()
+        {
+            uint32_t value;
+            memcpy(&value, take(sizeof(value)), sizeof(value));
+            return value;
+        }
+
+        template<typename T>
+        T read()
+        {
+            T value;
+            memcpy(&value, take(sizeof(value)), sizeof(value));
+            return value;
+        }
+
+        std::string_view read_string()
+        {
+            uint32_t size = read_u32();
+            return std::string_view(take(size), size);
+        }
+
+        bool at_end() const { return m_position == m_state.size(); }
+    protected:
+        const char* take(size_t __size)
+        {
+            if(m_state.size() - m_position < __size) {
+                throw std::runtime_error("image: the state is truncated");
+            }
+
+            const char* data = m_state.data() + m_position;
+            m_position += __size;
+
+            return data;
+        }
+    protected:
+        std::string_view m_state;
+        size_t m_position = 0;
+    };
+
+    // The classes declared at the top of a program, the only ones whose instances can be stored
+    std::set<std::string_view> declared_classes(const andy::lang::parser::ast_node& __root)
+    {
+        std::set<std::string_view> classes;
+
+        for(const auto& node : __root.childrens()) {
+            if(node.type() == andy::lang::parser::ast_node_type::ast_node_classdecl) {
+                classes.insert(node.decname());
+            }
+        }
+
+        return classes;
+    }
+};
+
+andy::lang::image::image(std::filesystem::path __path)
+    : m_cache(std::move(__path))
+{
+}
+
+void andy::lang::image::store(const andy::lang::parser::ast_node& __root, const std::vector<andy::lang::module_cache::dependency>& __dependencies, andy::lang::interpreter& __interpreter)
+{
+    state_writer writer(__interpreter, declared_classes(__root));
+    std::string globals;
+
+    auto& variables = __interpreter.variables();
+    state_writer::write_u32(globals, (uint32_t)variables.size());
+
+    for(const auto& [name, value] : variables) {
+        state_writer::write_string(globals, name);
+        state_writer::write_u32(globals, writer.id_of(value, name));
+    }
+
+    std::string objects = writer.objects();
+
+    std::string state;
+    state_writer::write_u32(state, (uint32_t)writer.object_count());
+    state += objects;
+    state += globals;
+
+    if(!m_cache.store(__root, __dependencies, state)) {
+        throw std::runtime_error("image: cannot write the image");
+    }
+}
+
+bool andy::lang::image::load()
+{
+    return m_cache.load(m_root);
+}
+
+void andy::lang::image::restore(andy::lang::interpreter& __interpreter) const
+{
+    // The declarations only create methods and classes, the rest of the program is what the state replaces
+    std::shared_ptr<andy::lang::object> self;
+
+    for(const auto& node : m_root.childrens()) {
+        if(node.type() == andy::lang::parser::ast_node_type::ast_node_fn_decl || node.type() == andy::lang::parser::ast_node_type::ast_node_classdecl) {
+            __interpreter.execute(node, self);
+        }
+    }
+
+    auto find_class = [&](std::string_view name) {
+        auto cls = __interpreter.find_class(name);
+
+        if(!cls) {
+            throw std::runtime_error("image: class " + std::string(name) + " not found");
+        }
+
+        return cls;
+    };
+
+    state_reader reader(m_cache.state());
+
+    std::vector<std::shared_ptr<andy::lang::object>> objects(reader.read_u32());
+    std::vector<uint8_t> kinds(objects.size());
+    // Where the references of each object start, they are read once every object exists
+    std::vector<state_reader> references;
+    references.reserve(objects.size());
+
+    for(size_t i = 0; i < objects.size(); i++) {
+        kinds[i] = reader.read_u8();
+        references.push_back(reader);
+
+        switch(kinds[i]) {
+            case kind_null:
+                objects[i] = std::make_shared<andy::lang::object>(__interpreter.NullClass);
+            break;
+            case kind_true:
+                objects[i] = std::make_shared<andy::lang::object>(__interpreter.TrueClass);
+            break;
+            case kind_false:
+                objects[i] = std::make_shared<andy::lang::object>(__interpreter.FalseClass);
+            break;
+            case kind_integer:
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.IntegerClass, reader.read<int64_t>());
+            break;
+            case kind_big_integer:
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.BigIntegerClass, andy::lang::big_integer::parse(reader.read_string()));
+            break;
+            case kind_float:
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.FloatClass, reader.read<float>());
+            break;
+            case kind_double:
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.DoubleClass, reader.read<double>());
+            break;
+            case kind_string:
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.StringClass, std::string(reader.read_string()));
+            break;
+            case kind_array: {
+                std::vector<std::shared_ptr<andy::lang::object>> items(reader.read_u32());
+
+                for(size_t j = 0; j < items.size(); j++) {
+                    reader.read_u32();
+                }
+
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.ArrayClass, std::move(items));
+            }
+            break;
+            case kind_dictionary: {
+                andy::lang::dictionary pairs(reader.read_u32());
+
+                for(size_t j = 0; j < pairs.size(); j++) {
+                    reader.read_u32();
+                    reader.read_u32();
+                }
+
+                objects[i] = andy::lang::object::instantiate(&__interpreter, __interpreter.DictionaryClass, std::move(pairs));
+            }
+            break;
+            case kind_class: {
+                // As the interpreter creates the object of a nested class
+                objects[i] = andy::lang::object::create(&__interpreter, __interpreter.ClassClass, find_class(reader.read_string()));
+                objects[i]->cls->instance_methods["new"].call(objects[i]);
+            }
+            break;
+            case kind_instance: {
+                // The constructor already ran in the program which stored the image
+                objects[i] = std::make_shared<andy::lang::object>(find_class(reader.read_string()));
+
+                reader.read_u32();
+                reader.read_u32();
+
+                uint32_t variable_count = reader.read_u32();
+
+                for(uint32_t j = 0; j < variable_count; j++) {
+                    reader.read_string();
+                    reader.read_u32();
+                }
+            }
+            break;
+            default:
+                throw std::runtime_error("image: unknown object kind");
+        }
+    }
+
+    auto object_at = [&](uint32_t index) {
+        if(index >= objects.size()) {
+            throw std::runtime_error("image: object out of range");
+        }
+
+        return objects[index];
+    };
+
+    for(size_t i = 0; i < objects.size(); i++) {
+        state_reader& object_reader = references[i];
+
+        switch(kinds[i]) {
+            case kind_array: {
+                auto& items = objects[i]->as<std::vector<std::shared_ptr<andy::lang::object>>>();
+                object_reader.read_u32();
+
+                for(auto& item : items) {
+                    item = object_at(object_reader.read_u32());
+                }
+            }
+            break;
+            case kind_dictionary: {
+                auto& pairs = objects[i]->as<andy::lang::dictionary>();
+                object_reader.read_u32();
+
+                for(auto& [key, value] : pairs) {
+                    key   = object_at(object_reader.read_u32());
+                    value = object_at(object_reader.read_u32());
+                }
+            }
+            break;
+            case kind_instance: {
+                object_reader.read_string();
+
+                if(uint32_t base = object_reader.read_u32()) {
+                    objects[i]->base_instance = object_at(base - 1);
+                }
+
+                if(uint32_t derived = object_reader.read_u32()) {
+                    objects[i]->derived_instance = object_at(derived - 1);
+                }
+
+                uint32_t variable_count = object_reader.read_u32();
+
+                for(uint32_t j = 0; j < variable_count; j++) {
+                    // The name points into the mapped image, which outlives the object
+                    std::string_view name = object_reader.read_string();
+                    objects[i]->instance_variables[name] = object_at(object_reader.read_u32());
+                }
+            }
+            break;
+        }
+    }
+
+    auto& variables = __interpreter.variables();
+    uint32_t global_count = reader.read_u32();
+
+    for(uint32_t i = 0; i < global_count; i++) {
+        std::string_view name = reader.read_string();
+        variables[name] = object_at(reader.read_u32());
+    }
+
+    if(!reader.at_end()) {
+        throw std::runtime_error("image: trailing state");
+    }
+}
@@ -1,17 +1,61 @@
 #include <andy/lang/interpreter.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
 #include <uva/file.hpp>
 
 #include <andy/lang/extension.hpp>
 #include <andy/lang/lang.hpp>
+#include <andy/lang/profiler.hpp>
+#include <andy/lang/big_integer.hpp>
+#include <andy/lang/call_stats.hpp>
+#include <andy/lang/coroutine.hpp>
+#include <andy/lang/heap_stats.hpp>
+#include <andy/lang/event_loop.hpp>
+#include <andy/lang/generator.hpp>
+#include <andy/lang/scheduler.hpp>
+
+namespace
+{
+    // Out of line, so that building the message takes no room in the frame of resolve_call, which every nested
+    // call keeps on the stack
+    [[noreturn]] void throw_no_method(std::string_view class_name, std::string_view function_name)
+    {
+        std::string message;
+        message.reserve(100);
+        message += "class ";
+        message += class_name;
+        message += " does not have a method called ";
+        message += function_name;
+        throw std::runtime_error(message);
+    }
+};
 
 andy::lang::interpreter::interpreter()
 {
     init();
 }
 
+andy::lang::event_loop& andy::lang::interpreter::loop()
+{
+    if(!m_event_loop) {
+        m_event_loop = std::make_shared<andy::lang::event_loop>();
+    }
+
+    return *m_event_loop;
+}
+
+andy::lang::scheduler& andy::lang::interpreter::fibers()
+{
+    if(!m_scheduler) {
+        m_scheduler = std::make_shared<andy::lang::scheduler>(this);
+    }
+
+    return *m_scheduler;
+}
+
 void andy::lang::interpreter::load(std::shared_ptr<andy::lang::structure> cls)
 {
     cls->class_methods["subclasses"] = andy::lang::method("subclasses", method_storage_type::instance_method, [cls,this](std::shared_ptr<andy::lang::object> object, std::vector<std::shared_ptr<andy::lang::object>> params) {
@@ -30,11 +74,22 @@ void andy::lang::interpreter::load(std::shared_ptr<andy::lang::structure> cls)
     classes.push_back(cls);
 }
 
-std::shared_ptr<andy::lang::structure> andy::lang::interpreter::execute_classdecl(andy::lang::parser::ast_node source_code)
+void andy::lang::interpreter::unload(const std::shared_ptr<andy::lang::structure>& cls)
+{
+    if(cls->base) {
+        auto& deriveds = cls->base->deriveds;
+        deriveds.erase(std::remove(deriveds.begin(), deriveds.end(), cls), deriveds.end());
+    }
+
+    classes.erase(std::remove(classes.begin(), classes.end(), cls), classes.end());
+}
+
+std::shared_ptr<andy::lang::structure> andy::lang::interpreter::execute_classdecl(const andy::lang::parser::ast_node& source_code)
 {
     std::string_view class_name = source_code.decname();
 
     auto cls = std::make_shared<andy::lang::structure>(std::string(class_name));
+    cls->declaration = &source_code;
 
     auto baseclass_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_classdecl_base);
 
@@ -78,7 +133,7 @@ std::shared_ptr<andy::lang::structure> andy::lang::interpreter::execute_classdec
 
             auto static_node = class_child.child_from_type(andy::lang::parser::ast_node_type::ast_node_declstatic);
 
-            auto method = andy::lang::method(std::string(method_name), method_storage_type::instance_method, params, class_child);
+            auto method = andy::lang::method(std::string(method_name), method_storage_type::instance_method, params, &class_child);
 
             if(static_node || source_code.decl_type() == "namespace") {
                 cls->class_methods[method_name] = std::move(method);
@@ -107,23 +162,20 @@ std::shared_ptr<andy::lang::structure> andy::lang::interpreter::execute_classdec
     return cls;
 }
 
-std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute(andy::lang::parser::ast_node source_code, std::shared_ptr<andy::lang::object>& object)
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
 {
-    switch (source_code.type())
-    {
-        case andy::lang::parser::ast_node_type::ast_node_fn_decl: {
-            
-            std::string_view method_name = source_code.decname();
-
-            std::vector<std::string> params;
-            params.reserve(source_code.childrens().size());
+    if(profiler) {
+        profiler->at(source_code.token());
+    }
 
-            for(auto& param : source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_params)->childrens()) {
-                params.push_back(std::string(param.token().content()));
-            }
+    if(heap_stats) {
+        heap_stats->at(source_code.token());
+    }
 
-            current_context.functions[method_name] = andy::lang::method(std::string(method_name), method_storage_type::instance_method, params, source_code);
-        }
+    switch (source_code.type())
+    {
+        case andy::lang::parser::ast_node_type::ast_node_fn_decl:
+            execute_fn_decl(source_code);
         break;
         case andy::lang::parser::ast_node_type::ast_node_classdecl: {
             auto cls = execute_classdecl(source_code);
@@ -134,413 +186,512 @@ std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute(andy::lang:
             return node_to_object(source_code);
         }
         break;
-        case andy::lang::parser::ast_node_fn_call: {
-            andy::lang::method* method_to_call = nullptr;
+        case andy::lang::parser::ast_node_fn_call:
+            return execute_call(source_code, object);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_vardecl:
+            return execute_vardecl(source_code, object);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_conditional:
+            return execute_conditional(source_code, object);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_while:
+            return execute_while(source_code, object);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_break: {
+            current_context.has_returned = true;
+            return nullptr;
+        }
+        case andy::lang::parser::ast_node_type::ast_node_context:
+            return execute_all(source_code, object);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_condition: {
+            return node_to_object(source_code.childrens().front());
+        }
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_fn_return: {
+            if(source_code.childrens().size()) {
+                const andy::lang::parser::ast_node& value = source_code.childrens().front();
 
-            // And we have a shared_ptr in case the object is created, os it still alive in the current context
-            std::shared_ptr<andy::lang::object> object_to_call = nullptr;
+                if(current_context.tail_calls && value.type() == andy::lang::parser::ast_node_type::ast_node_fn_call) {
+                    if(profiler) {
+                        profiler->at(value.token());
+                    }
 
-            std::shared_ptr<andy::lang::structure> class_to_call = nullptr;
+                    return execute_call(value, object, true);
+                }
 
-            if(auto it = current_context.functions.find(source_code.decname()); it != current_context.functions.end()) {
-                method_to_call = &it->second;
+                return node_to_object(value);
+            } else {
+                return std::make_shared<andy::lang::object>(NullClass);
             }
+        }
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_fn_yield:
+            execute_yield(source_code);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_foreach:
+            return execute_foreach(source_code, object);
+        break;
+        case andy::lang::parser::ast_node_type::ast_node_for:
+            return execute_for(source_code, object);
+        break;
+    default:
+        throw std::runtime_error(source_code.token().error_message_at_current_position("interpreter: Unexpected token"));
+        break;
+    }
 
-            andy::lang::parser::ast_node* object_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_object);
+    return nullptr;
+}
 
-            std::string_view function_name = source_code.decname();
-            bool is_super = function_name == "super";
-            bool is_assignment = function_name == "=";
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_vardecl(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
+{
+    std::string_view var_name = source_code.decname();
+    std::shared_ptr<andy::lang::structure> cls = nullptr;
+    if(object) {
+        cls = object->cls;
+    }
+    std::shared_ptr<andy::lang::object> value = node_to_object(source_code.childrens()[1], cls, object);
+    current_context.variables[var_name] = value;
+    return value;
+}
 
-            if(!method_to_call && object_node) {
-                // function call from a class/object/function return value
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_conditional(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
+{
+    std::shared_ptr<andy::lang::object> ret = execute(*source_code.condition(), object);
 
-                object_node = object_node->childrens().data();
+    if(ret && ret->is_present()) {
+        auto context = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context);
 
-                if(object_node->type() == andy::lang::parser::ast_node_type::ast_node_declname) {
-                    object_to_call = try_object_from_declname(*object_node);
+        ret = execute(*context, object);
+    } else {
+        auto e = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_else);
+        
+        if(e) {
+            auto else_context = e->child_from_type(andy::lang::parser::ast_node_type::ast_node_context);
 
-                    if(object_to_call) {
-                        if(is_assignment) {
-                            const auto& params_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_params);
+            ret = execute(*else_context, object);
+        }
+    }
 
-                            std::shared_ptr<andy::lang::object> new_object = node_to_object(params_node->childrens().front());
-                            *object_to_call = std::move(*new_object);
+    return ret;
+}
 
-                            return object;
-                        } else {
-                            std::map<std::string_view, andy::lang::method>::iterator method_it;
-                            
-                            if(function_name == "new") {
-                                if(object_to_call->cls == ClassClass) {
-                                    auto real_class = object_to_call->as<std::shared_ptr<andy::lang::structure>>();
-                                    method_it = real_class->class_methods.find(function_name);
-
-                                    if(method_it == real_class->class_methods.end()) {
-                                        // default constructor
-                                        return andy::lang::object::instantiate(this, real_class, nullptr);
-                                    }
-                                } else {
-                                    method_it = object_to_call->cls->instance_methods.find(function_name);
-                                    if(method_it == object_to_call->cls->instance_methods.end()) {
-                                        // default constructor
-                                        return andy::lang::object::instantiate(this, object_to_call->cls, nullptr);
-                                    }
-                                }
-                            } else {
-                                method_it = object_to_call->cls->instance_methods.find(function_name);
-
-                                if(method_it == object_to_call->cls->instance_methods.end()) {
-                                    auto throw_exception = [&]() {
-                                        std::string message;
-                                        message.reserve(100);
-                                        message += "class ";
-                                        message += object_to_call->cls->name;
-                                        message += " does not have a method called ";
-                                        message += std::string(function_name);
-                                        throw std::runtime_error(message);
-                                    };
-                                    if(object_to_call->cls == ClassClass) {
-                                        auto real_class = object_to_call->as<std::shared_ptr<andy::lang::structure>>();
-                                        method_it = real_class->class_methods.find(function_name);
-
-                                        if(method_it == real_class->class_methods.end()) {
-                                            throw_exception();
-                                        }
-
-                                        method_to_call = &method_it->second;
-                                        class_to_call = real_class;
-                                    } else {
-                                        if(object_to_call->cls->base) {
-                                            method_it = object_to_call->cls->base->instance_methods.find(function_name);
-
-                                            if(method_it != object_to_call->cls->base->instance_methods.end()) {
-                                                method_to_call = &method_it->second;
-                                                class_to_call = object_to_call->cls->base;
-                                                object_to_call = object_to_call->base_instance;
-                                            } else {
-                                                throw_exception();
-                                            }
-                                        } else {
-                                            throw_exception();
-                                        }
-                                    }
-                                } else {
-                                    method_to_call = &method_it->second;
-                                    class_to_call = object_to_call->cls;
-                                }
-                            }
-                        }
-                    } else {
-                        std::string_view class_or_object_name = object_node->token().content();
-                        for(auto& cls : classes) {
-                            if(cls->name == class_or_object_name) {
-                                if(function_name == "new") {
-                                    auto it = cls->instance_methods.find(function_name);
-                                    if(it == cls->instance_methods.end()) {
-                                        // default constructor
-                                        return andy::lang::object::instantiate(this, cls, nullptr);
-                                    } else {
-                                        method_to_call = &it->second;
-                                        class_to_call = cls;
-                                    }
-                                } else {
-                                    auto it = cls->class_methods.find(function_name);
-
-                                    if(it == cls->class_methods.end()) {
-                                        throw std::runtime_error("class " + std::string(class_or_object_name) + " does not have a method called " + std::string(function_name));
-                                    }
-
-                                    method_to_call = &it->second;
-                                    class_to_call = cls;
-                                }
-
-                                break;
-                            }
-                        }
-                    }
-                } else if (object_node->type() == andy::lang::parser::ast_node_type::ast_node_fn_call) {
-                    object_to_call = execute(*object_node, object);
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_while(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
+{
+    std::shared_ptr<andy::lang::object> ret = nullptr;
 
-                    if(!object_to_call) {
-                        throw std::runtime_error(object_node->token().error_message_at_current_position("undefined operator '.' for null"));
-                    }
+    while(execute(*source_code.condition(), object)->is_present()) {
+        ret = execute(*source_code.context(), object);
 
-                    auto it = object_to_call->cls->instance_methods.find(std::string(function_name));
+        if(current_context.has_returned) {
+            return current_context.return_value;
+        }
+    }
 
-                    if(it == object_to_call->cls->instance_methods.end()) {
-                        throw std::runtime_error("class " + object_to_call->cls->name + " does not have a method called " + std::string(function_name));
-                    }
+    return ret;
+}
 
-                    method_to_call = &it->second;
-                    class_to_call = object_to_call->cls;
-                } else if(object_node->type() == andy::lang::parser::ast_node_type::ast_node_valuedecl) {
-                    for(auto& cls : classes) {
-                        if(cls->name == object_node->token().content()) {
-                            class_to_call = cls;
-                            break;
-                        }
-                    }
+void andy::lang::interpreter::execute_yield(const andy::lang::parser::ast_node& source_code)
+{
+    if(!generator) {
+        throw std::runtime_error(source_code.token().error_message_at_current_position("yield outside of a function"));
+    }
 
-                    if(class_to_call) {
-                        auto it = class_to_call->instance_methods.find(std::string(function_name));
+    generator->yield(node_to_object(source_code.childrens().front()));
+}
 
-                        if(it == class_to_call->instance_methods.end()) {
-                            throw std::runtime_error("class " + class_to_call->name + " does not have a method called " + std::string(function_name));
-                        }
+void andy::lang::interpreter::execute_fn_decl(const andy::lang::parser::ast_node& source_code)
+{
+    std::string_view method_name = source_code.decname();
 
-                        method_to_call = &it->second;
-                    } else {
-                        std::shared_ptr<andy::lang::structure> object_class = nullptr;
+    std::vector<std::string> params;
+    params.reserve(source_code.childrens().size());
 
-                        if(object) {
-                            object_class = object->cls;
-                        }
+    for(auto& param : source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_params)->childrens()) {
+        params.push_back(std::string(param.token().content()));
+    }
 
-                        object_to_call = node_to_object(*object_node, object_class, object);
+    current_context.functions[method_name] = andy::lang::method(std::string(method_name), method_storage_type::instance_method, params, &source_code);
+}
 
-                        auto it = object_to_call->cls->instance_methods.find(std::string(function_name));
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_foreach(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
+{
+    auto* valuedecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_valuedecl);
 
-                        if(it == object_to_call->cls->instance_methods.end()) {
-                            throw std::runtime_error("class " + object_to_call->cls->name + " does not have a method called " + std::string(function_name));
-                        }
+    std::shared_ptr<andy::lang::object> array_or_dictionary = node_to_object(*valuedecl);
 
-                        method_to_call = &it->second;
-                        class_to_call = object_to_call->cls;
-                    }
-                }
-            } else {
-                if(is_super) {
-                    if(!object) {
-                        throw std::runtime_error("super can only be called from an instance object");
-                    }
+    auto* vardecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_vardecl);
 
-                    if(!object->cls->base) {
-                        throw std::runtime_error("class " + object->cls->name + " does not have a base class");
-                    }
+    // Returning from an array or a dictionary does not end the loop, the next iterations must not see a call
+    // returned as a tail call left for the function
+    bool tail_calls = std::exchange(current_context.tail_calls, false);
 
-                    auto it = object->cls->base->instance_methods.find("new");
+    if(array_or_dictionary->cls == ArrayClass) {
+        std::vector<std::shared_ptr<andy::lang::object>>& array_values = array_or_dictionary->as<std::vector<std::shared_ptr<andy::lang::object>>>();
+        for(auto& value : array_values) {
+            current_context.variables[vardecl->decname()] = value;
+            execute_all(*source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context), object);
+        }
+    } else if(array_or_dictionary->cls == DictionaryClass) {
+        andy::lang::dictionary& dictionary_values = array_or_dictionary->as<andy::lang::dictionary>();
+        for(auto& [key, value] : dictionary_values) {
+            std::vector<std::shared_ptr<andy::lang::object>> params = { key, value };
+            std::shared_ptr<andy::lang::object> params_object = andy::lang::object::instantiate(this, ArrayClass, params);
 
-                    if(it == object->cls->base->instance_methods.end()) {
-                        throw std::runtime_error("base class " + object->cls->base->name + " does not have a constructor");
-                    }
+            current_context.variables[vardecl->decname()] = params_object;
 
-                    method_to_call = &it->second;
-                    object_to_call = object;
-                    class_to_call = object->cls->base;
-                } else {
-                    if(object) {
-                        auto it = object->cls->instance_methods.find(function_name);
-
-                        if(it == object->cls->instance_methods.end()) {
-                            if(object->cls->base) {
-                                it = object->cls->base->instance_methods.find(function_name);
-
-                                if(it != object->cls->base->instance_methods.end()) {
-                                    if(!object->base_instance) {
-                                        throw std::runtime_error("object has no base instance");
-                                    }
-
-                                    method_to_call = &it->second;
-                                    class_to_call = object->cls->base;
-                                    object_to_call = object->base_instance;
-                                } else {
-                                    // ?????
-                                    // Why was it throwing exceptions?
-                                    //throw std::runtime_error("function '" + function_name + "' not found in class " + object->cls->name);
-                                }
-                            }
-                        } else {
-                            method_to_call = &it->second;
-                            object_to_call = object;
-                            class_to_call = object->cls;
-                        }
-                    } 
-                    
-                    if(!method_to_call) {
-                        auto it = StdClass->class_methods.find(function_name);
+            execute_all(*source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context), object);
+        }
+    } else if(array_or_dictionary->cls == m_generator_class) {
+        // The values are asked for one at a time, the generator runs between the iterations
+        auto values = array_or_dictionary->as<std::shared_ptr<andy::lang::generator>>();
 
-                        if(it == StdClass->class_methods.end()) {
-                            throw std::runtime_error("function '" + std::string(function_name) + "' not found");
-                        } else {
-                            method_to_call = &it->second;
-                            class_to_call = StdClass;
-                        }
-                    }
-                }
+        while(auto value = values->next()) {
+            current_context.variables[vardecl->decname()] = std::move(*value);
+            execute_all(*source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context), object);
+
+            if(current_context.has_returned) {
+                current_context.tail_calls = tail_calls;
+                return current_context.return_value;
             }
+        }
+    } else {
+        throw std::runtime_error("foreach should iterate over an array, a dictionary or a generator");
+    }
 
-            std::vector<std::shared_ptr<andy::lang::object>> positional_params;
-            std::map<std::string, std::shared_ptr<andy::lang::object>> named_params;
+    current_context.tail_calls = tail_calls;
 
-            andy::lang::parser::ast_node* params_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_params);
+    return nullptr;
+}
 
-            if(params_node) {
-                for(auto& param : params_node->childrens()) {
-                    andy::lang::parser::ast_node* value_node = &param;
-                    if(param.type() == andy::lang::parser::ast_node_type::ast_node_valuedecl && param.childrens().size()) {
-                        // Named parameter
-                        if(auto __value_node = param.child_from_type(andy::lang::parser::ast_node_type::ast_node_valuedecl)) {
-                            value_node = __value_node;
-                        }
-                    }
-                    std::shared_ptr<andy::lang::object> value = nullptr;
-                    
-                    value = node_to_object(*value_node);
-
-                    andy::lang::parser::ast_node* name = nullptr;
-                    
-                    if(param.type() == andy::lang::parser::ast_node_type::ast_node_valuedecl) {
-                        name = param.child_from_type(andy::lang::parser::ast_node_type::ast_node_declname);
-                    }
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_for(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
+{
+    auto* vardecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_vardecl);
+    auto* condition_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_condition);
+    auto* fn_call = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_call);
 
-                    if(name) {
-                        named_params[std::string(name->token().content())] = value;
-                    } else {
-                        positional_params.push_back(value);
-                    }
+    std::string var_name(vardecl->decname());
+
+    std::shared_ptr<andy::lang::object> start = execute(*vardecl, object);
+
+    while(true) {
+        std::shared_ptr<andy::lang::object> condition = execute(*condition_node, object);
+
+        if(!condition->is_present()) {
+            break;
+        }
+
+        push_context(true);
+        execute_all(*source_code.context(), object);
+        pop_context();
+
+        execute(*fn_call, object);
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_call(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object, bool tail)
+{
+    andy::lang::method* method_to_call = nullptr;
+
+    // And we have a shared_ptr in case the object is created, os it still alive in the current context
+    std::shared_ptr<andy::lang::object> object_to_call = nullptr;
+
+    std::shared_ptr<andy::lang::structure> class_to_call = nullptr;
+
+    std::shared_ptr<andy::lang::object> resolved = resolve_call(source_code, object, method_to_call, class_to_call, object_to_call);
+
+    if(!method_to_call) {
+        // Assignments and default constructors do not call a method
+        return resolved;
+    }
+
+    std::vector<std::shared_ptr<andy::lang::object>> positional_params;
+    std::map<std::string, std::shared_ptr<andy::lang::object>> named_params;
+
+    evaluate_params(source_code, positional_params, named_params);
+
+    // Native methods, generators, constructors and super need a call of their own
+    if(tail && method_to_call->block_ast && !method_to_call->is_generator && method_to_call->name != "new" && source_code.decname() != "super") {
+        tail_call.emplace(std::move(class_to_call), std::move(object_to_call), method_to_call, std::move(positional_params), std::move(named_params));
+        return nullptr;
+    }
+
+    std::shared_ptr<andy::lang::object> ret = call(std::move(class_to_call), object_to_call, *method_to_call, std::move(positional_params), std::move(named_params));
+
+    if(source_code.decname() == "super") {
+        object_to_call->base_instance = ret;
+        return nullptr;
+    }
+
+    return ret;
+}
+
+void andy::lang::interpreter::evaluate_params(const andy::lang::parser::ast_node& source_code, std::vector<std::shared_ptr<andy::lang::object>>& positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>>& named_params)
+{
+    const andy::lang::parser::ast_node* params_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_params);
+
+    if(params_node) {
+        for(auto& param : params_node->childrens()) {
+            const andy::lang::parser::ast_node* value_node = &param;
+            if(param.type() == andy::lang::parser::ast_node_type::ast_node_valuedecl && param.childrens().size()) {
+                // Named parameter
+                if(auto __value_node = param.child_from_type(andy::lang::parser::ast_node_type::ast_node_valuedecl)) {
+                    value_node = __value_node;
                 }
             }
+            std::shared_ptr<andy::lang::object> value = nullptr;
+            
+            value = node_to_object(*value_node);
 
-            std::shared_ptr<andy::lang::object> ret = call(class_to_call, object_to_call, *method_to_call, positional_params, named_params);
-
-            if(is_super) {
-                object_to_call->base_instance = ret;
-                return nullptr;
+            const andy::lang::parser::ast_node* name = nullptr;
+            
+            if(param.type() == andy::lang::parser::ast_node_type::ast_node_valuedecl) {
+                name = param.child_from_type(andy::lang::parser::ast_node_type::ast_node_declname);
             }
 
-            return ret;
-        }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_vardecl: {
-            std::string_view var_name = source_code.decname();
-            std::shared_ptr<andy::lang::structure> cls = nullptr;
-            if(object) {
-                cls = object->cls;
+            if(name) {
+                named_params[std::string(name->token().content())] = value;
+            } else {
+                positional_params.push_back(value);
             }
-            std::shared_ptr<andy::lang::object> value = node_to_object(source_code.childrens()[1], cls, object);
-            current_context.variables[var_name] = value;
-            return value;
         }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_conditional: {
-            std::shared_ptr<andy::lang::object> ret = execute(*source_code.condition(), object);
+    }
+}
 
-            if(ret && ret->is_present()) {
-                auto context = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context);
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::resolve_call(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object, andy::lang::method*& method_to_call, std::shared_ptr<andy::lang::structure>& class_to_call, std::shared_ptr<andy::lang::object>& object_to_call)
+{
+    if(auto it = current_context.functions.find(source_code.decname()); it != current_context.functions.end()) {
+        method_to_call = &it->second;
+    }
 
-                ret = execute(*context, object);
-            } else {
-                auto e = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_else);
-                
-                if(e) {
-                    auto else_context = e->child_from_type(andy::lang::parser::ast_node_type::ast_node_context);
+    const andy::lang::parser::ast_node* object_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_object);
 
-                    ret = execute(*else_context, object);
-                }
+    std::string_view function_name = source_code.decname();
+    bool is_super = function_name == "super";
+
+    if(!method_to_call && object_node) {
+        // function call from a class/object/function return value
+
+        object_node = object_node->childrens().data();
+
+        if(object_node->type() == andy::lang::parser::ast_node_type::ast_node_declname) {
+            return resolve_named_call(source_code, *object_node, object, method_to_call, class_to_call, object_to_call);
+        } else if (object_node->type() == andy::lang::parser::ast_node_type::ast_node_fn_call) {
+            object_to_call = execute(*object_node, object);
+
+            if(!object_to_call) {
+                throw std::runtime_error(object_node->token().error_message_at_current_position("undefined operator '.' for null"));
             }
 
-            return ret;
-        }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_while: {
-            std::shared_ptr<andy::lang::object> ret = nullptr;
+            auto it = object_to_call->cls->instance_methods.find(function_name);
+
+            if(it == object_to_call->cls->instance_methods.end()) {
+                throw_no_method(object_to_call->cls->name, function_name);
+            }
+
+            method_to_call = &it->second;
+            class_to_call = object_to_call->cls;
+        } else if(object_node->type() == andy::lang::parser::ast_node_type::ast_node_valuedecl) {
+            class_to_call = find_class(object_node->token().content());
 
-            while(execute(*source_code.condition(), object)->is_present()) {
-                ret = execute(*source_code.context(), object);
+            if(class_to_call) {
+                auto it = class_to_call->instance_methods.find(function_name);
 
-                if(current_context.has_returned) {
-                    return current_context.return_value;
+                if(it == class_to_call->instance_methods.end()) {
+                    throw_no_method(class_to_call->name, function_name);
                 }
-            }
 
-            return ret;
-        }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_break: {
-            current_context.has_returned = true;
-            return nullptr;
-        }
-        case andy::lang::parser::ast_node_type::ast_node_context:
-            return execute_all(source_code, object);
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_condition: {
-            return node_to_object(source_code.childrens().front());
-        }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_fn_return: {
-            if(source_code.childrens().size()) {
-                return node_to_object(source_code.childrens().front());
+                method_to_call = &it->second;
             } else {
-                return std::make_shared<andy::lang::object>(NullClass);
+                std::shared_ptr<andy::lang::structure> object_class = nullptr;
+
+                if(object) {
+                    object_class = object->cls;
+                }
+
+                object_to_call = node_to_object(*object_node, object_class, object);
+
+                auto it = object_to_call->cls->instance_methods.find(function_name);
+
+                if(it == object_to_call->cls->instance_methods.end()) {
+                    throw_no_method(object_to_call->cls->name, function_name);
+                }
+
+                method_to_call = &it->second;
+                class_to_call = object_to_call->cls;
             }
         }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_foreach: {
-            auto* valuedecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_valuedecl);
+    } else {
+        if(is_super) {
+            resolve_super(object, method_to_call, class_to_call, object_to_call);
+        } else {
+            if(object) {
+                auto it = object->cls->instance_methods.find(function_name);
 
-            std::shared_ptr<andy::lang::object> array_or_dictionary = node_to_object(*valuedecl);
+                if(it == object->cls->instance_methods.end()) {
+                    if(object->cls->base) {
+                        it = object->cls->base->instance_methods.find(function_name);
 
-            auto* vardecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_vardecl);
+                        if(it != object->cls->base->instance_methods.end()) {
+                            if(!object->base_instance) {
+                                throw std::runtime_error("object has no base instance");
+                            }
 
-            if(array_or_dictionary->cls == ArrayClass) {
-                std::vector<std::shared_ptr<andy::lang::object>>& array_values = array_or_dictionary->as<std::vector<std::shared_ptr<andy::lang::object>>>();
-                for(auto& value : array_values) {
-                    current_context.variables[vardecl->decname()] = value;
-                    execute_all(*source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context), object);
+                            method_to_call = &it->second;
+                            class_to_call = object->cls->base;
+                            object_to_call = object->base_instance;
+                        } else {
+                            // ?????
+                            // Why was it throwing exceptions?
+                            //throw std::runtime_error("function '" + function_name + "' not found in class " + object->cls->name);
+                        }
+                    }
+                } else {
+                    method_to_call = &it->second;
+                    object_to_call = object;
+                    class_to_call = object->cls;
                 }
-            } else if(array_or_dictionary->cls == DictionaryClass) {
-                andy::lang::dictionary& dictionary_values = array_or_dictionary->as<andy::lang::dictionary>();
-                for(auto& [key, value] : dictionary_values) {
-                    std::vector<std::shared_ptr<andy::lang::object>> params = { key, value };
-                    std::shared_ptr<andy::lang::object> params_object = andy::lang::object::instantiate(this, ArrayClass, params);
-
-                    current_context.variables[vardecl->decname()] = params_object;
+            } 
+            
+            if(!method_to_call) {
+                auto it = StdClass->class_methods.find(function_name);
 
-                    execute_all(*source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_context), object);
+                if(it == StdClass->class_methods.end()) {
+                    throw std::runtime_error("function '" + std::string(function_name) + "' not found");
+                } else {
+                    method_to_call = &it->second;
+                    class_to_call = StdClass;
                 }
-            } else {
-                throw std::runtime_error("foreach should iterate over an array or a dictionary");
             }
         }
-        break;
-        case andy::lang::parser::ast_node_type::ast_node_for: {
-            auto* vardecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_vardecl);
-            auto* valuedecl = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_valuedecl);
-            auto* condition_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_condition);
-            auto* fn_call = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_call);
+    }
 
-            std::string var_name(vardecl->decname());
+    return nullptr;
+}
 
-            std::shared_ptr<andy::lang::object> start = execute(*vardecl, object);
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::resolve_named_call(const andy::lang::parser::ast_node& source_code, const andy::lang::parser::ast_node& object_node, std::shared_ptr<andy::lang::object>& object, andy::lang::method*& method_to_call, std::shared_ptr<andy::lang::structure>& class_to_call, std::shared_ptr<andy::lang::object>& object_to_call)
+{
+    std::string_view function_name = source_code.decname();
+    bool is_assignment = function_name == "=";
 
-            while(true) {
-                std::shared_ptr<andy::lang::object> condition = execute(*condition_node, object);
+    object_to_call = try_object_from_declname(object_node);
 
-                if(!condition->is_present()) {
-                    break;
+    if(object_to_call) {
+        if(is_assignment) {
+            const auto& params_node = source_code.child_from_type(andy::lang::parser::ast_node_type::ast_node_fn_params);
+
+            std::shared_ptr<andy::lang::object> new_object = node_to_object(params_node->childrens().front());
+            *object_to_call = std::move(*new_object);
+
+            return object;
+        } else {
+            std::map<std::string_view, andy::lang::method>::iterator method_it;
+            
+            if(function_name == "new") {
+                if(object_to_call->cls == ClassClass) {
+                    auto real_class = object_to_call->as<std::shared_ptr<andy::lang::structure>>();
+                    method_it = real_class->class_methods.find(function_name);
+
+                    if(method_it == real_class->class_methods.end()) {
+                        // default constructor
+                        return andy::lang::object::instantiate(this, real_class, nullptr);
+                    }
+                } else {
+                    method_it = object_to_call->cls->instance_methods.find(function_name);
+                    if(method_it == object_to_call->cls->instance_methods.end()) {
+                        // default constructor
+                        return andy::lang::object::instantiate(this, object_to_call->cls, nullptr);
+                    }
+                }
+            } else {
+                method_it = object_to_call->cls->instance_methods.find(function_name);
+
+                if(method_it == object_to_call->cls->instance_methods.end()) {
+                    if(object_to_call->cls == ClassClass) {
+                        auto real_class = object_to_call->as<std::shared_ptr<andy::lang::structure>>();
+                        method_it = real_class->class_methods.find(function_name);
+
+                        if(method_it == real_class->class_methods.end()) {
+                            throw_no_method(object_to_call->cls->name, function_name);
+                        }
+
+                        method_to_call = &method_it->second;
+                        class_to_call = real_class;
+                    } else {
+                        if(object_to_call->cls->base) {
+                            method_it = object_to_call->cls->base->instance_methods.find(function_name);
+
+                            if(method_it != object_to_call->cls->base->instance_methods.end()) {
+                                method_to_call = &method_it->second;
+                                class_to_call = object_to_call->cls->base;
+                                object_to_call = object_to_call->base_instance;
+                            } else {
+                                throw_no_method(object_to_call->cls->name, function_name);
+                            }
+                        } else {
+                            throw_no_method(object_to_call->cls->name, function_name);
+                        }
+                    }
+                } else {
+                    method_to_call = &method_it->second;
+                    class_to_call = object_to_call->cls;
                 }
+            }
+        }
+    } else {
+        std::string_view class_or_object_name = object_node.token().content();
+        if(auto cls = find_class(class_or_object_name)) {
+            if(function_name == "new") {
+                auto it = cls->instance_methods.find(function_name);
+                if(it == cls->instance_methods.end()) {
+                    // default constructor
+                    return andy::lang::object::instantiate(this, cls, nullptr);
+                } else {
+                    method_to_call = &it->second;
+                    class_to_call = cls;
+                }
+            } else {
+                auto it = cls->class_methods.find(function_name);
 
-                push_context(true);
-                execute_all(*source_code.context(), object);
-                pop_context();
+                if(it == cls->class_methods.end()) {
+                    throw_no_method(class_or_object_name, function_name);
+                }
 
-                execute(*fn_call, object);
+                method_to_call = &it->second;
+                class_to_call = cls;
             }
         }
-        break;
-    default:
-        throw std::runtime_error(source_code.token().error_message_at_current_position("interpreter: Unexpected token"));
-        break;
     }
 
     return nullptr;
 }
 
-std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_all(std::vector<andy::lang::parser::ast_node>::const_iterator begin, std::vector<andy::lang::parser::ast_node>::const_iterator end, std::shared_ptr<andy::lang::object>& object)
+void andy::lang::interpreter::resolve_super(std::shared_ptr<andy::lang::object>& object, andy::lang::method*& method_to_call, std::shared_ptr<andy::lang::structure>& class_to_call, std::shared_ptr<andy::lang::object>& object_to_call)
 {
-    std::shared_ptr<andy::lang::object> result = nullptr;
+    if(!object) {
+        throw std::runtime_error("super can only be called from an instance object");
+    }
 
+    if(!object->cls->base) {
+        throw std::runtime_error("class " + object->cls->name + " does not have a base class");
+    }
+
+    auto it = object->cls->base->instance_methods.find("new");
+
+    if(it == object->cls->base->instance_methods.end()) {
+        throw std::runtime_error("base class " + object->cls->base->name + " does not have a constructor");
+    }
+
+    method_to_call = &it->second;
+    object_to_call = object;
+    class_to_call = object->cls->base;
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_all(std::vector<andy::lang::parser::ast_node>::const_iterator begin, std::vector<andy::lang::parser::ast_node>::const_iterator end, std::shared_ptr<andy::lang::object>& object)
+{
     for(auto it = begin; it != end; it++) {
         const andy::lang::parser::ast_node& node = *it;
 
@@ -548,7 +699,8 @@ std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_all(std::ve
             break;
         }
 
-        result = execute(*it, object);
+        // Not kept alive while the next statements execute, a recursion would keep one for every call in progress
+        std::shared_ptr<andy::lang::object> result = execute(*it, object);
 
         if(it->type() == andy::lang::parser::ast_node_type::ast_node_fn_return) {
             current_context.has_returned = true;
@@ -562,15 +714,78 @@ std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_all(std::ve
     return nullptr;
 }
 
-std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_all(andy::lang::parser::ast_node source_code, std::shared_ptr<andy::lang::object>& object)
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::execute_all(const andy::lang::parser::ast_node& source_code, std::shared_ptr<andy::lang::object>& object)
 {
     return execute_all(source_code.childrens().begin(), source_code.childrens().end(), object);
 }
 
 std::shared_ptr<andy::lang::object> andy::lang::interpreter::call(std::shared_ptr<andy::lang::structure> cls, std::shared_ptr<andy::lang::object> object, const andy::lang::method &method, std::vector<std::shared_ptr<andy::lang::object>> positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>> named_params)
 {
+    if(stack.size() >= max_depth) {
+        throw std::runtime_error("stack overflow: more than " + std::to_string(max_depth) + " nested calls");
+    }
+
+    // A deep recursion continues on a new stack segment instead of overflowing the one it runs on
+    if(andy::lang::coroutine::stack_low(stack_reserve)) {
+        std::shared_ptr<andy::lang::object> ret;
+
+        andy::lang::coroutine::on_new_stack(stack_segment_size, [&]() {
+            ret = call(std::move(cls), std::move(object), method, std::move(positional_params), std::move(named_params));
+        });
+
+        return ret;
+    }
+
     push_context();
 
+    // The method running in the context, which a tail call replaces
+    const andy::lang::method* running = &method;
+    // A function declared in the block which tail calls it goes away with the context, it is moved here. Held
+    // apart, a method would take room in the frame of every nested call.
+    std::unique_ptr<andy::lang::method> declared_callee;
+
+    std::shared_ptr<andy::lang::object> ret = nullptr;
+
+    while(true) {
+        {
+            andy::lang::profiler::scope profiler_scope(profiler, *running, cls.get());
+#ifdef ANDY_CALL_STATS
+            andy::lang::call_stats::scope call_stats_scope(call_stats, *running, cls.get());
+#endif
+            ret = invoke(cls, object, *running, positional_params, named_params);
+        }
+
+        if(!tail_call) {
+            break;
+        }
+
+        // The context is reused by the call, so a tail recursion runs in constant memory
+        running = tail_call->method;
+
+        for(auto& [name, function] : current_context.functions) {
+            if(&function == tail_call->method) {
+                declared_callee = std::make_unique<andy::lang::method>(std::move(function));
+                running = declared_callee.get();
+                break;
+            }
+        }
+
+        cls = std::move(tail_call->cls);
+        object = std::move(tail_call->object);
+        positional_params = std::move(tail_call->positional_params);
+        named_params = std::move(tail_call->named_params);
+        tail_call.reset();
+
+        current_context = interpreter_context();
+    }
+
+    pop_context();
+
+    return ret;
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::interpreter::invoke(std::shared_ptr<andy::lang::structure>& cls, std::shared_ptr<andy::lang::object>& object, const andy::lang::method& method, std::vector<std::shared_ptr<andy::lang::object>>& positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>>& named_params)
+{
     bool is_constructor = method.name == "new";
 
     if(is_constructor) {
@@ -584,23 +799,9 @@ std::shared_ptr<andy::lang::object> andy::lang::interpreter::call(std::shared_pt
 
     std::shared_ptr<andy::lang::object> ret = nullptr;
 
-    if(method.positional_params.size() != positional_params.size()) {
-        throw std::runtime_error("function " + method.name + " expects " + std::to_string(method.positional_params.size()) + " parameters, but " + std::to_string(positional_params.size()) + " were given");
-    }
-
-    for(const auto& param : method.named_params) {
-        auto it = named_params.find(param.name);
-
-        if(it == named_params.end()) {
-            if(param.has_default_value) {
-                named_params[param.name] = var_to_object(param.default_value);
-            } else {
-                throw std::runtime_error("function " + method.name + " called without parameter " + param.name);
-            }
-        }
-    }
+    check_params(method, positional_params, named_params);
 
-    if(method.block_ast.childrens().size()) {
+    if(method.block_ast && method.block_ast->childrens().size()) {
         for(size_t i = 0; i < method.positional_params.size(); i++) {
             current_context.variables[method.positional_params[i].name] = positional_params[i];
         }
@@ -609,7 +810,12 @@ std::shared_ptr<andy::lang::object> andy::lang::interpreter::call(std::shared_pt
             current_context.variables[name] = value;
         }
         
-        ret = execute(*method.block_ast.block(), object);
+        if(method.is_generator) {
+            ret = andy::lang::generator::create(this, object, method, std::move(current_context));
+        } else {
+            current_context.tail_calls = !is_constructor;
+            ret = execute_all(*method.block_ast->block(), object);
+        }
     } else if(method.function) {
         ret = method.function(object, positional_params, named_params);
     }
@@ -632,11 +838,28 @@ std::shared_ptr<andy::lang::object> andy::lang::interpreter::call(std::shared_pt
         }
     }
 
-    pop_context();
-
     return ret;
 }
 
+void andy::lang::interpreter::check_params(const andy::lang::method& method, const std::vector<std::shared_ptr<andy::lang::object>>& positional_params, std::map<std::string, std::shared_ptr<andy::lang::object>>& named_params)
+{
+    if(method.positional_params.size() != positional_params.size()) {
+        throw std::runtime_error("function " + method.name + " expects " + std::to_string(method.positional_params.size()) + " parameters, but " + std::to_string(positional_params.size()) + " were given");
+    }
+
+    for(const auto& param : method.named_params) {
+        auto it = named_params.find(param.name);
+
+        if(it == named_params.end()) {
+            if(param.has_default_value) {
+                named_params[param.name] = var_to_object(param.default_value);
+            } else {
+                throw std::runtime_error("function " + method.name + " called without parameter " + param.name);
+            }
+        }
+    }
+}
+
 void andy::lang::interpreter::init()
 {
     andy::lang::structure::create_structures(this);
@@ -645,6 +868,11 @@ void andy::lang::interpreter::init()
 const std::shared_ptr<andy::lang::object> andy::lang::interpreter::try_object_from_declname(const andy::lang::parser::ast_node& node, std::shared_ptr<andy::lang::structure> cls, std::shared_ptr<andy::lang::object> object)
 {
     if(object) {
+        // Not an instance variable, which would keep every object alive through a reference to itself
+        if(node.token().content() == "this") {
+            return object;
+        }
+
         auto it = object->instance_variables.find(node.token().content());
 
         if(it != object->instance_variables.end()) {
@@ -674,13 +902,11 @@ const std::shared_ptr<andy::lang::object> andy::lang::interpreter::try_object_fr
                 return try_object_from_declname(node, fn_object->cls, fn_object);
             }
 
-            for(auto& cls : classes) {
-                if(cls->name == class_name) {
-                    auto it = cls->class_variables.find(var_name);
-    
-                    if(it != cls->class_variables.end()) {
-                        return it->second;
-                    }
+            if(auto cls = find_class(class_name)) {
+                auto it = cls->class_variables.find(var_name);
+
+                if(it != cls->class_variables.end()) {
+                    return it->second;
                 }
             }
     
@@ -714,45 +940,19 @@ const std::shared_ptr<andy::lang::object> andy::lang::interpreter::try_object_fr
 
 const std::shared_ptr<andy::lang::object> andy::lang::interpreter::node_to_object(const andy::lang::parser::ast_node& node, std::shared_ptr<andy::lang::structure> cls, std::shared_ptr<andy::lang::object> object)
 {
+    if(heap_stats) {
+        heap_stats->at(node.token());
+    }
+
     if(node.token().type() == andy::lang::lexer::token_type::token_literal) {
-        switch(node.token().kind())
-        {
-            case lexer::token_kind::token_boolean: {
-                if(node.token().boolean_literal) {
-                    return std::make_shared<andy::lang::object>(TrueClass);
-                } else {
-                    return std::make_shared<andy::lang::object>(FalseClass);
-                }
-            }
-            break;
-            case lexer::token_kind::token_integer: {
-                std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, IntegerClass, node.token().integer_literal);
-                return obj;
-            }
-            case lexer::token_kind::token_float: {
-                std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, FloatClass, node.token().float_literal);
-                return obj;
-            }
-            break;
-            case lexer::token_kind::token_double: {
-                std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, DoubleClass, node.token().double_literal);
-                return obj;
-            }
-            break;
-            case lexer::token_kind::token_string: {
-                std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, StringClass, std::move(std::string(node.token().content())));
-                return obj;
-            }
-            break;
-            case lexer::token_kind::token_null:
-                return std::make_shared<andy::lang::object>(NullClass);
-            break;
-            default:    
-                throw std::runtime_error("interpreter: unknown node kind");
-            break;
-        }
+        return literal_to_object(node);
     } else if(node.type() == andy::lang::parser::ast_node_type::ast_node_fn_call) {
-        return execute(node, object);
+        // Without going through execute, which would add its frame to every level of a recursion
+        if(profiler) {
+            profiler->at(node.token());
+        }
+
+        return execute_call(node, object);
     } else if(node.type() == andy::lang::parser::ast_node_type::ast_node_declname || node.type() == andy::lang::parser::ast_node_type::ast_node_valuedecl) {
         std::shared_ptr<andy::lang::object> obj = try_object_from_declname(node, cls, object);
 
@@ -761,7 +961,65 @@ const std::shared_ptr<andy::lang::object> andy::lang::interpreter::node_to_objec
         }
 
         throw std::runtime_error("'" + std::string(node.token().content()) + "' is undefined");
-    } else if(node.type() == andy::lang::parser::ast_node_type::ast_node_arraydecl) {
+    }
+
+    return composite_to_object(node);
+}
+
+const std::shared_ptr<andy::lang::object> andy::lang::interpreter::literal_to_object(const andy::lang::parser::ast_node& node)
+{
+    switch(node.token().kind())
+    {
+        case lexer::token_kind::token_boolean: {
+            if(node.token().boolean_literal) {
+                return std::make_shared<andy::lang::object>(TrueClass);
+            } else {
+                return std::make_shared<andy::lang::object>(FalseClass);
+            }
+        }
+        break;
+        case lexer::token_kind::token_integer: {
+            // The lexer saturates the literals which do not fit in 64 bits
+            if(node.token().integer_literal == INT64_MAX) {
+                andy::lang::big_integer value = andy::lang::big_integer::parse(node.token().content());
+
+                if(!value.fits_int64()) {
+                    return andy::lang::object::instantiate(this, BigIntegerClass, std::move(value));
+                }
+            }
+
+            std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, IntegerClass, node.token().integer_literal);
+            return obj;
+        }
+        case lexer::token_kind::token_float: {
+            std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, FloatClass, node.token().float_literal);
+            return obj;
+        }
+        break;
+        case lexer::token_kind::token_double: {
+            std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, DoubleClass, node.token().double_literal);
+            return obj;
+        }
+        break;
+        case lexer::token_kind::token_string: {
+            std::shared_ptr<andy::lang::object> obj = andy::lang::object::instantiate(this, StringClass, std::move(std::string(node.token().content())));
+            return obj;
+        }
+        break;
+        case lexer::token_kind::token_null:
+            return std::make_shared<andy::lang::object>(NullClass);
+        break;
+        default:    
+            throw std::runtime_error("interpreter: unknown node kind");
+        break;
+    }
+
+    return nullptr;
+}
+
+const std::shared_ptr<andy::lang::object> andy::lang::interpreter::composite_to_object(const andy::lang::parser::ast_node& node)
+{
+    if(node.type() == andy::lang::parser::ast_node_type::ast_node_arraydecl) {
         std::vector<std::shared_ptr<andy::lang::object>> array;
 
         for(auto& child : node.childrens()) {
@@ -795,7 +1053,7 @@ const std::shared_ptr<andy::lang::object> andy::lang::interpreter::node_to_objec
                     str += node_child.token().content();
                     break;
                 case lexer::token_kind::token_integer:
-                    str += std::to_string(node_child.token().integer_literal);
+                    str += node_child.token().integer_literal == INT64_MAX ? andy::lang::big_integer::parse(node_child.token().content()).to_string() : std::to_string(node_child.token().integer_literal);
                     break;
                 case lexer::token_kind::token_float:
                     str += std::to_string(node_child.token().float_literal);
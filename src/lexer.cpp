@@ -2,12 +2,41 @@
 
 #include <algorithm>
 
+#include <andy/lang/perfect_hash.hpp>
+
 // Permitted delimiters: (){};:,
 const static uint64_t is_delimiter_lookup[] = { 0, 0, 0, 0, 0, 0x100000101, 0, 0x1010000, 0, 0, 0, 0, 0, 0, 0, 0x10001000000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
 const static uint64_t is_operator_lookup[] = { 0, 0, 0, 0, 0x1010000000100, 0x101010001010000, 0, 0x101010100000000, 0, 0, 0, 0x10001000000, 0, 0, 0, 0x100000000, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
-// Keep ordered as it is used in binary search
-const static std::vector<std::string_view> keywords_lookup = { "break", "class", "else", "for", "foreach", "function", "if", "namespace", "new", "return", "static", "var", "while" };
-const static std::map<std::string_view, andy::lang::lexer::operator_type> string_to_operator_lookup = {
+// The words which are not identifiers. Classified once per token, the parser dispatches on the enum.
+struct word_class
+{
+    andy::lang::lexer::token_type type;
+    andy::lang::lexer::token_kind kind;
+    andy::lang::lexer::keyword_type keyword;
+};
+
+constexpr andy::lang::perfect_hash_table<word_class, 32> words_lookup(std::array<std::pair<std::string_view, word_class>, 18> {{
+    { "break",     { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_break     } },
+    { "class",     { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_class     } },
+    { "else",      { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_else      } },
+    { "for",       { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_for       } },
+    { "foreach",   { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_foreach   } },
+    { "function",  { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_function  } },
+    { "if",        { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_if        } },
+    { "namespace", { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_namespace } },
+    { "new",       { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_new       } },
+    { "return",    { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_return    } },
+    { "static",    { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_static    } },
+    { "var",       { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_var       } },
+    { "while",     { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_while     } },
+    { "yield",     { andy::lang::lexer::token_type::token_keyword, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_yield     } },
+    { "extends",   { andy::lang::lexer::token_type::token_identifier, andy::lang::lexer::token_kind::token_null, andy::lang::lexer::keyword_type::keyword_extends   } },
+    { "null",      { andy::lang::lexer::token_type::token_literal, andy::lang::lexer::token_kind::token_null,    andy::lang::lexer::keyword_type::keyword_none      } },
+    { "false",     { andy::lang::lexer::token_type::token_literal, andy::lang::lexer::token_kind::token_boolean, andy::lang::lexer::keyword_type::keyword_none      } },
+    { "true",      { andy::lang::lexer::token_type::token_literal, andy::lang::lexer::token_kind::token_boolean, andy::lang::lexer::keyword_type::keyword_none      } },
+}}, { andy::lang::lexer::token_type::token_identifier, andy::lang::lexer::token_kind::token_null, andy::lang::lexer::keyword_type::keyword_none });
+
+constexpr andy::lang::perfect_hash_table<andy::lang::lexer::operator_type, 32> operators_lookup(std::array<std::pair<std::string_view, andy::lang::lexer::operator_type>, 19> {{
     { "+",  andy::lang::lexer::operator_type::operator_plus          },
     { "-",  andy::lang::lexer::operator_type::operator_minus         },
     { "*",  andy::lang::lexer::operator_type::operator_multiply      },
@@ -25,7 +54,13 @@ const static std::map<std::string_view, andy::lang::lexer::operator_type> string
     { ">=", andy::lang::lexer::operator_type::operator_greater_equal },
     { "++", andy::lang::lexer::operator_type::operator_increment     },
     { "--", andy::lang::lexer::operator_type::operator_decrement     },
-};
+    { "=",  andy::lang::lexer::operator_type::operator_assign        },
+    { "?",  andy::lang::lexer::operator_type::operator_question      },
+}}, andy::lang::lexer::operator_type::operator_null);
+
+static_assert(words_lookup.find("foreach").keyword == andy::lang::lexer::keyword_type::keyword_foreach);
+static_assert(words_lookup.find("fore").type == andy::lang::lexer::token_type::token_identifier);
+static_assert(operators_lookup.find(">=") == andy::lang::lexer::operator_type::operator_greater_equal);
 
 static bool is_delimiter(const char& c)
 {
@@ -36,10 +71,6 @@ bool is_operator(const char& c) {
     return ((bool*)is_operator_lookup)[(uint8_t)c];
 }
 
-bool is_keyword(std::string_view str) {
-    return std::binary_search(keywords_lookup.begin(), keywords_lookup.end(), str);
-}
-
 bool is_preprocessor(std::string_view str) {
     if(str.starts_with('#')) {
         return true;
@@ -49,14 +80,7 @@ bool is_preprocessor(std::string_view str) {
 }
 
 andy::lang::lexer::operator_type to_operator(std::string_view str) {
-
-    auto it = string_to_operator_lookup.find(str);
-
-    if(it == string_to_operator_lookup.end()) {
-        return andy::lang::lexer::operator_type::operator_null;
-    }
-
-    return it->second;
+    return operators_lookup.find(str);
 }
 
 andy::lang::lexer::lexer(std::string_view __file_name, std::string_view __source)
@@ -64,9 +88,14 @@ andy::lang::lexer::lexer(std::string_view __file_name, std::string_view __source
     tokenize(__file_name, __source);
 }
 
-void andy::lang::lexer::include(std::string __file_name, std::string __source)
+const std::pair<const std::string, std::string>& andy::lang::lexer::include(std::string __file_name, std::string __source)
 {
-    m_includes[std::move(__file_name)] = std::move(__source);
+    return *m_includes.emplace(std::move(__file_name), std::move(__source));
+}
+
+void andy::lang::lexer::include(andy::lang::lexer& __other)
+{
+    m_includes.merge(__other.m_includes);
 }
 
 std::string_view andy::lang::lexer::source(const andy::lang::lexer::token& token) const
@@ -138,6 +167,7 @@ void andy::lang::lexer::read()
 void andy::lang::lexer::push_token(token_position start, token_type type, token_kind kind, operator_type op)
 {
     token t(start, m_start, m_buffer, type, kind, m_file_name, m_source, op);
+    t.set_interpolated(m_interpolation_depth > 0);
 
     m_buffer = "";
 
@@ -145,7 +175,8 @@ void andy::lang::lexer::push_token(token_position start, token_type type, token_
         switch(t.kind())
         {
         case token_kind::token_integer:
-            t.integer_literal = atoi(t.content().data());
+            // Saturates at INT64_MAX, the interpreter makes a BigInteger of the larger literals
+            t.integer_literal = strtoll(t.content().data(), nullptr, 10);
             break;
         case token_kind::token_float:
             t.float_literal = atof(t.content().data());
@@ -348,27 +379,10 @@ void andy::lang::lexer::read_next_token()
         return;
     }
 
-    // Todo: map
-    if(m_buffer == "null") {
-        push_token(start, token_type::token_literal, token_kind::token_null);
-        return;
-    } else if(m_buffer == "false") {
-        push_token(start, token_type::token_literal, token_kind::token_boolean);
-        return;
-    } else if(m_buffer == "true") {
-        push_token(start, token_type::token_literal, token_kind::token_boolean);
-        return;
-    }
-
-    if(is_keyword(m_buffer)) {
-        push_token(start, token_type::token_keyword);
-        return;
-    } else {
-        push_token(start, token_type::token_identifier);
-        return;
-    }
+    word_class word = words_lookup.find(m_buffer);
 
-    throw std::runtime_error("lexer: unknown token");
+    push_token(start, word.type, word.kind);
+    m_tokens.back().set_keyword(word.keyword);
 }
 
 void andy::lang::lexer::tokenize(std::string_view __file_name, std::string_view __source)
@@ -382,6 +396,30 @@ void andy::lang::lexer::tokenize(std::string_view __file_name, std::string_view
     } while(!m_tokens.back().is_eof());
 }
 
+void andy::lang::lexer::tokenize(std::string_view __file_name, std::string_view __source, token_position __start, const std::function<bool(const andy::lang::lexer::token&)>& __stop)
+{
+    m_file_name = __file_name;
+    m_source    = __source;
+    m_current   = __source.substr(__start.offset);
+    m_start     = __start;
+
+    while(true) {
+        // An interpolated string is read at once, its first token is where the lexer can stop
+        size_t first = m_tokens.size();
+
+        read_next_token();
+
+        if(__stop(m_tokens[first])) {
+            m_tokens.erase(m_tokens.begin() + first, m_tokens.end());
+            break;
+        }
+
+        if(m_tokens.back().is_eof()) {
+            break;
+        }
+    }
+}
+
 void andy::lang::lexer::consume_token()
 {
     if(!has_next_token()) {
@@ -453,12 +491,12 @@ void andy::lang::lexer::insert(const std::vector<andy::lang::lexer::token> &toke
 }
 
 andy::lang::lexer::token::token(token_position start, token_position end, std::string_view content, token_type type, token_kind kind, std::string_view file_name, std::string_view source, operator_type op)
-    : start(start), end(end), m_content(content), m_type(type), m_kind(kind), m_file_name(std::move(file_name)), m_operator(op)
+    : start(start), end(end), m_content(content), m_type(type), m_kind(kind), integer_literal(0), m_file_name(std::move(file_name)), m_operator(op)
 {
 }
 
 andy::lang::lexer::token::token(token_position start, token_position end, std::string_view content, token_type type, token_kind kind)
-    : start(start), end(end), m_content(content), m_type(type), m_kind(kind)
+    : start(start), end(end), m_content(content), m_type(type), m_kind(kind), integer_literal(0)
 {
 
 }
@@ -479,7 +517,8 @@ std::string andy::lang::lexer::token::unexpected_eof_message() const
 
 std::string_view andy::lang::lexer::token::human_start_position() const
 {
-    static std::string result;
+    // Interpreters can run on many threads, each one formats its own messages
+    static thread_local std::string result;
     result.clear();
 
     result += m_file_name;
@@ -499,6 +538,22 @@ void andy::lang::lexer::token::merge(const token &other)
     end = other.end;
 }
 
+void andy::lang::lexer::token::relocate(std::string_view __old_source, std::string_view __new_source, size_t __edit_end, ptrdiff_t __delta)
+{
+    // Tokens created by the parser may not point into the source
+    if(m_content.data() < __old_source.data() || m_content.data() > __old_source.data() + __old_source.size()) {
+        return;
+    }
+
+    size_t offset = m_content.data() - __old_source.data();
+
+    if(offset >= __edit_end) {
+        offset += __delta;
+    }
+
+    m_content = std::string_view(__new_source.data() + offset, m_content.size());
+}
+
 std::string_view andy::lang::lexer::token::content() const
 {
     if(string_literal.size()) {
@@ -554,6 +609,8 @@ void andy::lang::lexer::extract_and_push_string(token_position start)
                     push_token(start, token_type::token_literal, token_kind::token_interpolated_string);
                     m_tokens.back().string_literal = std::move(output);
 
+                    m_interpolation_depth++;
+
                     // Read the variable or expression
                     while(m_current.size() && m_current.front() != '}') {
                         read_next_token();
@@ -566,6 +623,7 @@ void andy::lang::lexer::extract_and_push_string(token_position start)
                     // Check if the string is finished
                     if(m_current.size() && m_current.front() == '\"') {
                         discard(); // Remove the closing quote
+                        m_interpolation_depth--;
                         return;
                     }
 
@@ -574,6 +632,7 @@ void andy::lang::lexer::extract_and_push_string(token_position start)
 
                     // So the parser knows where the string ends
                     push_token(start, token_type::token_delimiter);
+                    m_interpolation_depth--;
                     return;
                 }
 
@@ -0,0 +1,138 @@
+#include <andy/lang/mapped_file.hpp>
+
+#ifdef _WIN32
+#   include <Windows.h>
+#elif defined(__wasm__)
+#   include <fstream>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+#ifdef __wasm__
+namespace
+{
+    bool read_file(const std::filesystem::path& __path, std::string& __content)
+    {
+        std::ifstream stream(__path, std::ios::binary);
+
+        if(!stream) {
+            return false;
+        }
+
+        stream.seekg(0, std::ios::end);
+        __content.resize((size_t)stream.tellg());
+        stream.seekg(0, std::ios::beg);
+        stream.read(__content.data(), __content.size());
+
+        return (bool)stream && __content.size();
+    }
+};
+#endif
+
+andy::lang::mapped_file::~mapped_file()
+{
+    close();
+}
+
+bool andy::lang::mapped_file::open(const std::filesystem::path &__path)
+{
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(__path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if(file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+
+    if(!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if(!mapping) {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_file    = file;
+    m_mapping = mapping;
+    m_data    = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    m_size    = (size_t)size.QuadPart;
+#elif defined(__wasm__)
+    if(!read_file(__path, m_buffer)) {
+        return false;
+    }
+
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#else
+    int fd = ::open(__path.c_str(), O_RDONLY);
+
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+
+    if(fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+
+    if(data == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = (const char*)data;
+    m_size = (size_t)st.st_size;
+#endif
+
+    if(!m_data) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void andy::lang::mapped_file::close()
+{
+#ifdef _WIN32
+    if(m_data) {
+        UnmapViewOfFile(m_data);
+    }
+
+    if(m_mapping) {
+        CloseHandle((HANDLE)m_mapping);
+    }
+
+    if(m_file) {
+        CloseHandle((HANDLE)m_file);
+    }
+
+    m_file    = nullptr;
+    m_mapping = nullptr;
+#elif defined(__wasm__)
+    m_buffer.clear();
+#else
+    if(m_data) {
+        munmap((void*)m_data, m_size);
+    }
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
@@ -18,3 +18,23 @@ void andy::lang::method::init_params(std::vector<std::string> __params)
         }
     }
 }
+
+bool andy::lang::method::yields(const andy::lang::parser::ast_node& __node)
+{
+    for(const auto& child : __node.childrens()) {
+        switch(child.type()) {
+            case andy::lang::parser::ast_node_type::ast_node_fn_yield:
+                return true;
+            case andy::lang::parser::ast_node_type::ast_node_fn_decl:
+            case andy::lang::parser::ast_node_type::ast_node_classdecl:
+                break;
+            default:
+                if(yields(child)) {
+                    return true;
+                }
+                break;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,374 @@
+#include <andy/lang/module_cache.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+
+
+namespace
+{
+    // Layout: header | dependency_record[dependency_count] | node_record[node_count] | strings | state
+    constexpr char cache_magic[8] = { 'A', 'N', 'D', 'Y', 'C', '\0', '\0', '\0' };
+    constexpr uint32_t cache_format_version = 4;
+
+    struct string_ref
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct header
+    {
+        char magic[8];
+        uint32_t format_version;
+        uint32_t record_size;
+        uint64_t version_hash;
+        uint64_t dependency_count;
+        uint64_t node_count;
+        uint64_t strings_size;
+        uint64_t state_size;
+    };
+
+    struct dependency_record
+    {
+        uint64_t hash;
+        string_ref file_name;
+    };
+
+    // The syntax tree in preorder. The children of a node are the child_count subtrees which follow it.
+    struct node_record
+    {
+        uint32_t type;
+        uint32_t child_count;
+        uint32_t token_type;
+        uint32_t token_kind;
+        uint32_t op;
+        uint32_t keyword;
+        uint32_t start_line;
+        uint32_t start_column;
+        uint32_t start_offset;
+        uint32_t end_line;
+        uint32_t end_column;
+        uint32_t end_offset;
+        string_ref content;
+        string_ref file_name;
+        uint64_t literal;
+    };
+
+    static_assert(sizeof(((andy::lang::lexer::token*)nullptr)->double_literal) == sizeof(uint64_t));
+
+    class string_table
+    {
+    public:
+        string_ref add(std::string_view __value)
+        {
+            auto it = m_offsets.find(__value);
+
+            if(it != m_offsets.end()) {
+                return { it->second, (uint32_t)__value.size() };
+            }
+
+            uint32_t offset = (uint32_t)m_data.size();
+            m_data.append(__value);
+            m_offsets.emplace(std::string(__value), offset);
+
+            return { offset, (uint32_t)__value.size() };
+        }
+
+        const std::string& data() const { return m_data; }
+    protected:
+        std::string m_data;
+        std::map<std::string, uint32_t, std::less<>> m_offsets;
+    };
+
+    void write_node(const andy::lang::parser::ast_node& __node, std::vector<node_record>& __nodes, string_table& __strings)
+    {
+        const andy::lang::lexer::token& token = __node.token();
+
+        node_record record;
+        memset(&record, 0, sizeof(record));
+
+        record.type         = (uint32_t)__node.type();
+        record.child_count  = (uint32_t)__node.childrens().size();
+        record.token_type   = (uint32_t)token.type();
+        record.token_kind   = (uint32_t)token.kind();
+        record.op           = (uint32_t)token.op();
+        record.keyword      = (uint32_t)token.keyword();
+        record.start_line   = (uint32_t)token.start.line;
+        record.start_column = (uint32_t)token.start.column;
+        record.start_offset = (uint32_t)token.start.offset;
+        record.end_line     = (uint32_t)token.end.line;
+        record.end_column   = (uint32_t)token.end.column;
+        record.end_offset   = (uint32_t)token.end.offset;
+        // content() already resolves escapes and merged tokens, so the loaded token needs no string_literal
+        record.content      = __strings.add(token.content());
+        record.file_name    = __strings.add(token.m_file_name);
+
+        memcpy(&record.literal, &token.double_literal, sizeof(record.literal));
+
+        __nodes.push_back(record);
+
+        for(const auto& child : __node.childrens()) {
+            write_node(child, __nodes, __strings);
+        }
+    }
+
+    uint64_t version_hash()
+    {
+        std::string version(ANDYLANG_VERSION);
+        version.push_back('/');
+        version += std::to_string(sizeof(node_record));
+        version.push_back('/');
+        version += std::to_string(andy::lang::parser::ast_node_type::ast_node_condition);
+        version.push_back('/');
+        version += std::to_string(andy::lang::lexer::operator_type::operator_max);
+        version.push_back('/');
+        version += std::to_string(andy::lang::lexer::keyword_type::keyword_max);
+
+        return andy::lang::module_cache::hash(version);
+    }
+
+    bool read_file(const std::string& __path, std::string& __content)
+    {
+        std::ifstream stream(__path, std::ios::binary);
+
+        if(!stream) {
+            return false;
+        }
+
+        stream.seekg(0, std::ios::end);
+        __content.resize((size_t)stream.tellg());
+        stream.seekg(0, std::ios::beg);
+        stream.read(__content.data(), __content.size());
+
+        return (bool)stream;
+    }
+};
+
+andy::lang::module_cache::module_cache(std::filesystem::path __cache_path)
+    : m_path(std::move(__cache_path))
+{
+}
+
+andy::lang::module_cache::~module_cache()
+{
+}
+
+std::filesystem::path andy::lang::module_cache::cache_path_for(const std::filesystem::path &__source_path, const std::filesystem::path &__cache_directory)
+{
+    if(__cache_directory.empty()) {
+        std::filesystem::path cache_path = __source_path;
+        cache_path.replace_extension(".andyc");
+
+        return cache_path;
+    }
+
+    // Different sources with the same name must not share a cache
+    char key[17];
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash(std::filesystem::absolute(__source_path).string()));
+
+    std::string file_name = __source_path.stem().string();
+    file_name.push_back('-');
+    file_name += key;
+    file_name += ".andyc";
+
+    return __cache_directory / file_name;
+}
+
+uint64_t andy::lang::module_cache::hash(std::string_view __data)
+{
+    uint64_t result = 14695981039346656037ull;
+
+    for(const char& c : __data) {
+        result ^= (uint8_t)c;
+        result *= 1099511628211ull;
+    }
+
+    return result;
+}
+
+bool andy::lang::module_cache::load(andy::lang::parser::ast_node &__root)
+{
+    if(!m_file.open(m_path)) {
+        return false;
+    }
+
+    const header* h = (const header*)m_file.data();
+
+    bool valid = m_file.size() >= sizeof(header)
+              && memcmp(h->magic, cache_magic, sizeof(cache_magic)) == 0
+              && h->format_version == cache_format_version
+              && h->record_size == sizeof(node_record)
+              && h->version_hash == version_hash()
+              && h->node_count
+              && sizeof(header) + h->dependency_count * sizeof(dependency_record) + h->node_count * sizeof(node_record) + h->strings_size + h->state_size == m_file.size();
+
+    if(!valid) {
+        m_file.close();
+        return false;
+    }
+
+    const dependency_record* dependencies = (const dependency_record*)(m_file.data() + sizeof(header));
+    const char* strings = m_file.data() + m_file.size() - h->state_size - h->strings_size;
+
+    std::string source;
+
+    for(size_t i = 0; i < h->dependency_count; i++) {
+        const dependency_record& dependency = dependencies[i];
+
+        if((uint64_t)dependency.file_name.offset + dependency.file_name.size > h->strings_size) {
+            m_file.close();
+            return false;
+        }
+
+        std::string file_name(strings + dependency.file_name.offset, dependency.file_name.size);
+
+        if(!read_file(file_name, source) || hash(source) != dependency.hash) {
+            m_file.close();
+            return false;
+        }
+    }
+
+    try {
+        size_t index = 0;
+        andy::lang::parser::ast_node root;
+
+        read_node(root, index);
+
+        if(index != h->node_count) {
+            throw std::runtime_error("module cache: trailing nodes");
+        }
+
+        __root = std::move(root);
+    } catch(const std::exception&) {
+        m_file.close();
+        return false;
+    }
+
+    return true;
+}
+
+void andy::lang::module_cache::read_node(andy::lang::parser::ast_node &__node, size_t &__index) const
+{
+    const header* h = (const header*)m_file.data();
+
+    if(__index >= h->node_count) {
+        throw std::runtime_error("module cache: node out of range");
+    }
+
+    const node_record* nodes = (const node_record*)(m_file.data() + sizeof(header) + h->dependency_count * sizeof(dependency_record));
+    const node_record& record = nodes[__index++];
+
+    const char* strings = m_file.data() + m_file.size() - h->state_size - h->strings_size;
+
+    auto view = [&](const string_ref& ref) {
+        if((uint64_t)ref.offset + ref.size > h->strings_size) {
+            throw std::runtime_error("module cache: string out of range");
+        }
+
+        return std::string_view(strings + ref.offset, ref.size);
+    };
+
+    andy::lang::lexer::token_position start;
+    start.line   = record.start_line;
+    start.column = record.start_column;
+    start.offset = record.start_offset;
+
+    andy::lang::lexer::token_position end;
+    end.line   = record.end_line;
+    end.column = record.end_column;
+    end.offset = record.end_offset;
+
+    andy::lang::lexer::token token(start, end, view(record.content), (andy::lang::lexer::token_type)record.token_type, (andy::lang::lexer::token_kind)record.token_kind, view(record.file_name), {}, (andy::lang::lexer::operator_type)record.op);
+    memcpy(&token.double_literal, &record.literal, sizeof(record.literal));
+    token.set_keyword((andy::lang::lexer::keyword_type)record.keyword);
+
+    __node.set_type((andy::lang::parser::ast_node_type)record.type);
+    __node.set_token(std::move(token));
+    __node.childrens().resize(record.child_count);
+
+    for(auto& child : __node.childrens()) {
+        read_node(child, __index);
+    }
+
+    __node.reindex();
+}
+
+std::string_view andy::lang::module_cache::state() const
+{
+    if(!m_file.is_open()) {
+        return {};
+    }
+
+    const header* h = (const header*)m_file.data();
+
+    return std::string_view(m_file.data() + m_file.size() - h->state_size, h->state_size);
+}
+
+bool andy::lang::module_cache::store(const andy::lang::parser::ast_node &__root, const std::vector<andy::lang::module_cache::dependency> &__dependencies, std::string_view __state)
+{
+    string_table strings;
+    std::vector<dependency_record> dependencies;
+    std::vector<node_record> nodes;
+
+    for(const auto& dependency : __dependencies) {
+        dependency_record record;
+        record.hash      = hash(dependency.source);
+        record.file_name = strings.add(dependency.file_name);
+
+        dependencies.push_back(record);
+    }
+
+    write_node(__root, nodes, strings);
+
+    header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, cache_magic, sizeof(cache_magic));
+    h.format_version   = cache_format_version;
+    h.record_size      = sizeof(node_record);
+    h.version_hash     = version_hash();
+    h.dependency_count = dependencies.size();
+    h.node_count       = nodes.size();
+    h.strings_size     = strings.data().size();
+    h.state_size       = __state.size();
+
+    std::random_device random;
+    std::filesystem::path temporary_path = m_path;
+    temporary_path += "." + std::to_string(random()) + ".tmp";
+
+    std::error_code ec;
+
+    if(m_path.has_parent_path()) {
+        std::filesystem::create_directories(m_path.parent_path(), ec);
+    }
+
+    {
+        std::ofstream stream(temporary_path, std::ios::binary);
+
+        if(!stream) {
+            return false;
+        }
+
+        stream.write((const char*)&h, sizeof(h));
+        stream.write((const char*)dependencies.data(), dependencies.size() * sizeof(dependency_record));
+        stream.write((const char*)nodes.data(), nodes.size() * sizeof(node_record));
+        stream.write(strings.data().data(), strings.data().size());
+        stream.write(__state.data(), __state.size());
+
+        if(!stream) {
+            stream.close();
+            std::filesystem::remove(temporary_path, ec);
+            return false;
+        }
+    }
+
+    std::filesystem::rename(temporary_path, m_path, ec);
+
+    if(ec) {
+        std::filesystem::remove(temporary_path, ec);
+        return false;
+    }
+
+    return true;
+}
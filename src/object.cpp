@@ -3,6 +3,7 @@
 #include <andy/lang/class.hpp>
 #include <andy/lang/method.hpp>
 #include <andy/lang/interpreter.hpp>
+#include <andy/lang/heap_stats.hpp>
 
 #include <uva/console.hpp>
 
@@ -11,6 +12,11 @@ andy::lang::object::object(std::shared_ptr<andy::lang::structure> c)
 {
     if(cls) {
         uva::console::log_debug("{}#{} created", cls->name, (void*)this);
+
+        if(andy::lang::heap_stats* stats = andy::lang::heap_stats::current()) {
+            heap_tag = stats->allocated(cls.get());
+            heap_bytes = sizeof(andy::lang::object);
+        }
     }
 }
 
@@ -22,6 +28,12 @@ andy::lang::object::~object()
         }
 
         uva::console::log_debug("{}#{} destroyed", cls->name, (void*)this);
+
+        if(heap_tag) {
+            if(andy::lang::heap_stats* stats = andy::lang::heap_stats::current()) {
+                stats->freed(heap_tag, heap_bytes);
+            }
+        }
     }
 }
 
@@ -31,7 +43,7 @@ void andy::lang::object::initialize(andy::lang::interpreter *interpreter, std::v
         instance_variables[instance_variable.first] = andy::lang::object::instantiate(interpreter, instance_variable.second, nullptr);
     }
 
-    instance_variables["this"] = shared_from_this();
+    count_native_bytes(instance_variables.size() * andy::lang::heap_stats::instance_variable_bytes);
 
     if(cls->base) {
         //base_instance = andy::lang::object::instantiate(interpreter, cls->base, nullptr);
@@ -56,6 +68,16 @@ void andy::lang::object::log_native_destructor()
     uva::console::log_debug("{}#{} native destructor", cls->name, (void*)this);
 }
 
+void andy::lang::object::count_native_bytes(size_t bytes)
+{
+    if(heap_tag) {
+        if(andy::lang::heap_stats* stats = andy::lang::heap_stats::current()) {
+            stats->grew(heap_tag, bytes);
+            heap_bytes += (uint32_t)bytes;
+        }
+    }
+}
+
 bool andy::lang::object::is_present() const
 {
     if(!cls) {
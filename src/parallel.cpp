@@ -0,0 +1,224 @@
+#include <andy/lang/parallel.hpp>
+#include <andy/lang/interpreter.hpp>
+#include <andy/lang/thread_pool.hpp>
+#include <andy/lang/worker.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace
+{
+    // Set while a chunk runs on this thread. A parallel call made by the function then runs sequentially,
+    // the clone of the thread is busy.
+    thread_local bool in_chunk = false;
+
+    // The clone of the thread, emptied for the chunk. It gets the global functions and the classes of the program,
+    // so the function can use what it could in the calling interpreter. The calling thread waits for the chunks,
+    // every thread can read its functions and classes meanwhile.
+    andy::lang::interpreter& clone_for(andy::lang::interpreter* __interpreter, const andy::lang::method& __function, std::ostream* __output)
+    {
+        thread_local std::unique_ptr<andy::lang::interpreter> clone;
+        // Declared by an earlier chunk, possibly of another program
+        thread_local std::vector<std::shared_ptr<andy::lang::structure>> declared;
+        // The classes of the caller they were declared from. Weak, a class of a program which ended is not kept alive
+        // and cannot be mistaken for a new one.
+        thread_local std::vector<std::weak_ptr<andy::lang::structure>> declared_from;
+
+        if(!clone) {
+            clone = std::make_unique<andy::lang::interpreter>();
+        }
+
+        clone->reset_globals();
+
+        const auto& classes = __interpreter->loaded_classes();
+
+        // A declared class does not change, the classes are declared again only when the program has other classes
+        bool same = true;
+        size_t count = 0;
+
+        for(const auto& cls : classes) {
+            if(!cls->declaration) {
+                continue;
+            }
+
+            if(count == declared_from.size() || declared_from[count].lock() != cls) {
+                same = false;
+                break;
+            }
+
+            count++;
+        }
+
+        if(!same || count != declared_from.size()) {
+            for(const auto& cls : declared) {
+                clone->unload(cls);
+            }
+
+            declared.clear();
+            declared_from.clear();
+
+            // In the order they were loaded, a base class is declared before the classes deriving from it. The
+            // method bodies point into the syntax tree of the program, which is only read.
+            for(const auto& cls : classes) {
+                if(cls->declaration) {
+                    declared.push_back(clone->execute_classdecl(*cls->declaration));
+                    declared_from.push_back(cls);
+                    clone->load(declared.back());
+                }
+            }
+        }
+
+        clone->functions() = __interpreter->caller_functions();
+        clone->functions().emplace(__function.name, __function);
+        clone->working_directory = __interpreter->working_directory;
+        clone->input_file_path = __interpreter->input_file_path;
+        clone->output = __output;
+
+        return *clone;
+    }
+
+    // Run fn(clone, begin, end, chunk) for every chunk on the pool, then write what the chunks printed in order
+    template<typename Fn>
+    void run_chunks(andy::lang::interpreter* __interpreter, size_t __items, size_t __chunks, const andy::lang::method& __function, Fn&& __fn)
+    {
+        std::vector<std::ostringstream> outputs(__chunks);
+
+        andy::lang::parallel::pool().parallel_for(__chunks, [&](size_t chunk) {
+            andy::lang::interpreter& clone = clone_for(__interpreter, __function, &outputs[chunk]);
+
+            in_chunk = true;
+
+            try {
+                __fn(clone, __items * chunk / __chunks, __items * (chunk + 1) / __chunks, chunk);
+            } catch(...) {
+                in_chunk = false;
+                clone.reset_globals();
+                throw;
+            }
+
+            in_chunk = false;
+            // Do not keep the results of the chunk alive until the next one
+            clone.reset_globals();
+        });
+
+        for(auto& output : outputs) {
+            if(output.tellp() > 0) {
+                *__interpreter->output << output.str();
+            }
+        }
+    }
+
+    // Copy an item of the calling interpreter into a clone. The items are only read, by every thread at once.
+    std::shared_ptr<andy::lang::object> copy_item(andy::lang::interpreter& __clone, andy::lang::interpreter* __interpreter, const std::shared_ptr<andy::lang::object>& __item)
+    {
+        return andy::lang::message::from(__interpreter, __item).to_object(&__clone);
+    }
+
+    size_t chunks_for(size_t __items)
+    {
+        if(in_chunk) {
+            return 1;
+        }
+
+        return andy::lang::parallel::chunk_count(__items, andy::lang::parallel::pool().size());
+    }
+};
+
+andy::lang::thread_pool& andy::lang::parallel::pool()
+{
+    static andy::lang::thread_pool pool;
+
+    return pool;
+}
+
+size_t andy::lang::parallel::chunk_count(size_t __items, size_t __threads)
+{
+    if(__threads <= 1 || __items < min_chunk * 2) {
+        return 1;
+    }
+
+    size_t chunks = __threads * 4;
+
+    return std::min(chunks, __items / min_chunk);
+}
+
+std::vector<std::shared_ptr<andy::lang::object>> andy::lang::parallel::map(andy::lang::interpreter* __interpreter, const std::vector<std::shared_ptr<andy::lang::object>>& __items, const andy::lang::method& __function)
+{
+    std::vector<std::shared_ptr<andy::lang::object>> results;
+    results.reserve(__items.size());
+
+    size_t chunks = chunks_for(__items.size());
+
+    if(chunks == 1) {
+        for(const auto& item : __items) {
+            results.push_back(__interpreter->call(nullptr, nullptr, __function, { item }));
+        }
+
+        return results;
+    }
+
+    std::vector<andy::lang::message> messages(__items.size());
+
+    run_chunks(__interpreter, __items.size(), chunks, __function, [&](andy::lang::interpreter& clone, size_t begin, size_t end, size_t) {
+        for(size_t i = begin; i < end; i++) {
+            auto result = clone.call(nullptr, nullptr, __function, { copy_item(clone, __interpreter, __items[i]) });
+            messages[i] = andy::lang::message::from(&clone, result);
+        }
+    });
+
+    for(auto& message : messages) {
+        results.push_back(std::move(message).to_object(__interpreter));
+    }
+
+    return results;
+}
+
+void andy::lang::parallel::each(andy::lang::interpreter* __interpreter, const std::vector<std::shared_ptr<andy::lang::object>>& __items, const andy::lang::method& __function)
+{
+    size_t chunks = chunks_for(__items.size());
+
+    if(chunks == 1) {
+        for(const auto& item : __items) {
+            __interpreter->call(nullptr, nullptr, __function, { item });
+        }
+
+        return;
+    }
+
+    run_chunks(__interpreter, __items.size(), chunks, __function, [&](andy::lang::interpreter& clone, size_t begin, size_t end, size_t) {
+        for(size_t i = begin; i < end; i++) {
+            clone.call(nullptr, nullptr, __function, { copy_item(clone, __interpreter, __items[i]) });
+        }
+    });
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::parallel::reduce(andy::lang::interpreter* __interpreter, const std::vector<std::shared_ptr<andy::lang::object>>& __items, const andy::lang::method& __function, std::shared_ptr<andy::lang::object> __initial)
+{
+    size_t chunks = chunks_for(__items.size());
+
+    if(chunks == 1) {
+        for(const auto& item : __items) {
+            __initial = __interpreter->call(nullptr, nullptr, __function, { __initial, item });
+        }
+
+        return __initial;
+    }
+
+    std::vector<andy::lang::message> partials(chunks);
+
+    run_chunks(__interpreter, __items.size(), chunks, __function, [&](andy::lang::interpreter& clone, size_t begin, size_t end, size_t chunk) {
+        std::shared_ptr<andy::lang::object> accumulator = copy_item(clone, __interpreter, __items[begin]);
+
+        for(size_t i = begin + 1; i < end; i++) {
+            accumulator = clone.call(nullptr, nullptr, __function, { accumulator, copy_item(clone, __interpreter, __items[i]) });
+        }
+
+        partials[chunk] = andy::lang::message::from(&clone, accumulator);
+    });
+
+    for(auto& partial : partials) {
+        __initial = __interpreter->call(nullptr, nullptr, __function, { __initial, std::move(partial).to_object(__interpreter) });
+    }
+
+    return __initial;
+}
@@ -64,7 +64,7 @@ andy::lang::parser::ast_node parser::parse_node(andy::lang::lexer &lexer)
     throw std::runtime_error(token.error_message_at_current_position("Unexpected token"));
 }
 
-andy::lang::parser::ast_node andy::lang::parser::parse_all(andy::lang::lexer &lexer)
+andy::lang::parser::ast_node andy::lang::parser::parse_all(andy::lang::lexer &lexer, std::vector<size_t>* __starts)
 {
     ast_node root_node(ast_node_type::ast_node_unit);
 
@@ -73,6 +73,9 @@ andy::lang::parser::ast_node andy::lang::parser::parse_all(andy::lang::lexer &le
         if(token.is_eof()) {
             break;
         }
+        if(__starts) {
+            __starts->push_back(lexer.position());
+        }
         ast_node child = parse_node(lexer);
         root_node.add_child(std::move(child));
     } while(lexer.has_next_token());
@@ -124,6 +127,7 @@ after_extracted_param:
                 key_node.set_type(ast_node_type::ast_node_declname);
                 named_param.add_child(std::move(key_node));
                 params_node.childrens().pop_back();
+                params_node.reindex();
 
                 ast_node value_node = parse_identifier_or_literal(lexer);
                 named_param.add_child(std::move(value_node));
@@ -244,7 +248,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_identifier_or_literal(and
                 }
 
                 return array_node;
-            } else if (token.content() == "!") {
+            } else if (token.op() == andy::lang::lexer::operator_type::operator_not) {
                 identifier_or_literal = std::move(lexer.next_token());
 
                 ast_node unary_op(ast_node_type::ast_node_fn_call);
@@ -326,7 +330,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_identifier_or_literal(and
         }
         break;
         case andy::lang::lexer::token_type::token_keyword:
-            if(token.content() == "new") {
+            if(token.keyword() == andy::lang::lexer::keyword_type::keyword_new) {
                 lexer.consume_token(); // Consume the 'new' token
 
                 ast_node fn_call = parse_identifier_or_literal(lexer);
@@ -359,6 +363,8 @@ andy::lang::parser::ast_node andy::lang::parser::parse_identifier_or_literal(and
                     new_node.add_child(std::move(*params_it));
                     fn_call.childrens().erase(params_it);
                 }
+
+                fn_call.reindex();
                 
                 ast_node obj_node(ast_node_type::ast_node_fn_object);
                 obj_node.add_child(std::move(fn_call));
@@ -380,7 +386,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_identifier_or_literal(and
 
     if(const auto& next_token = lexer.see_next();
         (next_token.type() == andy::lang::lexer::token_type::token_delimiter && next_token.content() == "(")
-        || (next_token.type() == andy::lang::lexer::token_type::token_operator && (next_token.content() == "!" || next_token.content() == "?"))) {
+        || (next_token.type() == andy::lang::lexer::token_type::token_operator && (next_token.op() == andy::lang::lexer::operator_type::operator_not || next_token.op() == andy::lang::lexer::operator_type::operator_question))) {
         
         // Function call
 
@@ -476,7 +482,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_identifier_or_literal(and
                 }
 
                 // ++ and -- are unary operators
-                if(operator_token.content() != "++" && operator_token.content() != "--") {
+                if(operator_token.op() != andy::lang::lexer::operator_type::operator_increment && operator_token.op() != andy::lang::lexer::operator_type::operator_decrement) {
                     ast_node right_node = parse_identifier_or_literal(lexer);
 
                     ast_node params_node(ast_node_type::ast_node_fn_params);
@@ -530,27 +536,36 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword(andy::lang::lexer
 {
     const andy::lang::lexer::token& token = lexer.see_next();
 
-    const std::map<std::string_view, andy::lang::parser::ast_node(andy::lang::parser::*)(andy::lang::lexer&)> keyword_parsers = {
-        { "class",     &andy::lang::parser::parse_keyword_class     },
-        { "var",       &andy::lang::parser::parse_keyword_var       },
-        { "function",  &andy::lang::parser::parse_keyword_function  },
-        { "return",    &andy::lang::parser::parse_keyword_return    },
-        { "if",        &andy::lang::parser::parse_keyword_if        },
-        { "namespace", &andy::lang::parser::parse_keyword_namespace },
-        { "for",       &andy::lang::parser::parse_keyword_for       },
-        { "foreach",   &andy::lang::parser::parse_keyword_foreach   },
-        { "while",     &andy::lang::parser::parse_keyword_while     },
-        { "break",     &andy::lang::parser::parse_keyword_break     },
-        { "static",   &andy::lang::parser::parse_keyword_static   },
-    };
-
-    auto keyword_parser = keyword_parsers.find(token.content());
-
-    if(keyword_parser == keyword_parsers.end()) {
-        throw std::runtime_error(token.error_message_at_current_position("Unexpected keyword"));
+    switch(token.keyword()) {
+        case andy::lang::lexer::keyword_type::keyword_class:
+            return parse_keyword_class(lexer);
+        case andy::lang::lexer::keyword_type::keyword_var:
+            return parse_keyword_var(lexer);
+        case andy::lang::lexer::keyword_type::keyword_function:
+            return parse_keyword_function(lexer);
+        case andy::lang::lexer::keyword_type::keyword_return:
+            return parse_keyword_return(lexer);
+        case andy::lang::lexer::keyword_type::keyword_yield:
+            return parse_keyword_yield(lexer);
+        case andy::lang::lexer::keyword_type::keyword_if:
+            return parse_keyword_if(lexer);
+        case andy::lang::lexer::keyword_type::keyword_namespace:
+            return parse_keyword_namespace(lexer);
+        case andy::lang::lexer::keyword_type::keyword_for:
+            return parse_keyword_for(lexer);
+        case andy::lang::lexer::keyword_type::keyword_foreach:
+            return parse_keyword_foreach(lexer);
+        case andy::lang::lexer::keyword_type::keyword_while:
+            return parse_keyword_while(lexer);
+        case andy::lang::lexer::keyword_type::keyword_break:
+            return parse_keyword_break(lexer);
+        case andy::lang::lexer::keyword_type::keyword_static:
+            return parse_keyword_static(lexer);
+        default:
+            break;
     }
 
-    return (this->*keyword_parser->second)(lexer);
+    throw std::runtime_error(token.error_message_at_current_position("Unexpected keyword"));
 }
 
 andy::lang::parser::ast_node andy::lang::parser::parse_keyword_class(andy::lang::lexer &lexer) {
@@ -568,7 +583,9 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_class(andy::lang:
 
     const andy::lang::lexer::token& extends_or_context_token = lexer.see_next();
 
-    if(extends_or_context_token.content() == "extends" || extends_or_context_token.content() == ":" || extends_or_context_token.content() == "<") {
+    if(extends_or_context_token.keyword() == andy::lang::lexer::keyword_type::keyword_extends
+        || extends_or_context_token.op() == andy::lang::lexer::operator_type::operator_less
+        || (extends_or_context_token.type() == andy::lang::lexer::token_type::token_delimiter && extends_or_context_token.content() == ":")) {
         lexer.next_token(); // Consume the extends token
 
         const andy::lang::lexer::token& baseclass_token = lexer.see_next();
@@ -617,7 +634,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_var(andy::lang::l
 
     const andy::lang::lexer::token& equal_token = lexer.next_token();
 
-    if(equal_token.type() != lexer::token_type::token_operator || equal_token.content() != "=") {
+    if(equal_token.type() != lexer::token_type::token_operator || equal_token.op() != lexer::operator_type::operator_assign) {
         throw std::runtime_error(equal_token.error_message_at_current_position("Expected '=' after variable name"));
     }
 
@@ -640,7 +657,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_function(andy::la
             // Simply use it as the function name
             break;
         case lexer::token_type::token_keyword:
-            if(identifier_token.content() == "new") {
+            if(identifier_token.keyword() == andy::lang::lexer::keyword_type::keyword_new) {
                 // This is a constructor
                 // Use it as the function name
             } else {
@@ -720,6 +737,14 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_return(andy::lang
     return return_node;
 }
 
+andy::lang::parser::ast_node andy::lang::parser::parse_keyword_yield(andy::lang::lexer &lexer) {
+    ast_node yield_node(std::move(lexer.next_token()), ast_node_type::ast_node_fn_yield);
+
+    yield_node.add_child(std::move(parse_identifier_or_literal(lexer)));
+
+    return yield_node;
+}
+
 andy::lang::parser::ast_node andy::lang::parser::parse_keyword_if(andy::lang::lexer &lexer){
     ast_node if_node(ast_node_type::ast_node_conditional);
     if_node.add_child(ast_node(std::move(lexer.next_token()), ast_node_type::ast_node_decltype));
@@ -753,7 +778,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_if(andy::lang::le
 
     const andy::lang::lexer::token& token = lexer.see_next();
 
-    if(token.type() == andy::lang::lexer::token_type::token_keyword && token.content() == "else") {
+    if(token.keyword() == andy::lang::lexer::keyword_type::keyword_else) {
         lexer.next_token(); // Consume the else token
 
         ast_node else_node(ast_node_type::ast_node_else);
@@ -808,7 +833,7 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_for(andy::lang::l
 
     const andy::lang::lexer::token& var_token = lexer.see_next();
 
-    if(var_token.type() != lexer::token_type::token_keyword || var_token.content() != "var") {
+    if(var_token.keyword() != lexer::keyword_type::keyword_var) {
         throw std::runtime_error(var_token.error_message_at_current_position("Expected 'var' after '('"));
     }
 
@@ -1016,12 +1041,12 @@ andy::lang::parser::ast_node andy::lang::parser::parse_keyword_static(andy::lang
     const andy::lang::lexer::token& next_token = lexer.see_next();
 
     if(next_token.type() == andy::lang::lexer::token_type::token_keyword) {
-        if(next_token.content() == "function") {
+        if(next_token.keyword() == andy::lang::lexer::keyword_type::keyword_function) {
             ast_node node = parse_keyword_function(lexer);
             node.add_child(ast_node(std::move(static_token), ast_node_type::ast_node_declstatic));
 
             return node;
-        } else if(next_token.content() == "var") {
+        } else if(next_token.keyword() == andy::lang::lexer::keyword_type::keyword_var) {
             ast_node node = parse_keyword_var(lexer);
             node.add_child(ast_node(std::move(static_token), ast_node_type::ast_node_declstatic));
 
@@ -1,6 +1,9 @@
 #include <filesystem>
+#include <algorithm>
 
 #include <andy/lang/preprocessor.hpp>
+#include <andy/lang/thread_pool.hpp>
+#include <andy/lang/timings.hpp>
 
 #include <uva.hpp>
 
@@ -8,33 +11,39 @@
 
 // TODO: move to uva::file
 
-std::string wildcard_to_regex(const std::string& wildcard) {
-    std::string regex_pattern = "^";
-    for (char ch : wildcard) {
-        switch (ch) {
-            case '*':
-                regex_pattern += ".*"; // '*' corresponde a qualquer sequência de caracteres
-                break;
-            case '?':
-                regex_pattern += ".";  // '?' corresponde a um único caractere
-                break;
-            case '.':
-                regex_pattern += "\\."; // Escape do ponto, pois em regex, '.' é um caractere especial
-                break;
-            default:
-                regex_pattern += ch;    // Adiciona o caractere literal
-                break;
-        }
-    }
-    regex_pattern += "$"; // Final da expressão regular
-    return regex_pattern;
+// Whether text matches a wildcard, where '*' matches any sequence of characters and '?' any single one.
+// std::regex is not used, compiling one races on the locale of the process when several threads include files.
+bool wildcard_match(std::string_view wildcard, std::string_view text) {
+    size_t w = 0, t = 0;
+    // Where the last '*' was, and the text it was matched against, to backtrack to
+    size_t star = std::string_view::npos, star_text = 0;
+
+    while (t < text.size()) {
+        if (w < wildcard.size() && (wildcard[w] == '?' || wildcard[w] == text[t])) {
+            w++;
+            t++;
+        } else if (w < wildcard.size() && wildcard[w] == '*') {
+            star = w++;
+            star_text = t;
+        } else if (star != std::string_view::npos) {
+            w = star + 1;
+            t = ++star_text;
+        } else {
+            return false;
+        }
+    }
+
+    while (w < wildcard.size() && wildcard[w] == '*') {
+        w++;
+    }
+
+    return w == wildcard.size();
 }
 
 // Função para listar arquivos com base em um wildcard
 std::vector<std::string> list_files_with_wildcard(const std::filesystem::path& base_path, std::string pattern) {
     std::vector<std::string> files;
     pattern = "*/" + pattern; // Adiciona um coringa para buscar em subdiretórios
-    std::regex regex_pattern(wildcard_to_regex(pattern));  // Converte o padrão para regex
 
     for (const auto& entry : std::filesystem::recursive_directory_iterator(base_path)) {
         if (std::filesystem::is_regular_file(entry.path())) {
@@ -43,7 +52,7 @@ std::vector<std::string> list_files_with_wildcard(const std::filesystem::path& b
             std::replace(filename.begin(), filename.end(), '\\', '/');
 #endif
             // Verifica se o arquivo corresponde ao padrão
-            if (std::regex_match(filename, regex_pattern)) {
+            if (wildcard_match(pattern, filename)) {
                 files.push_back(filename);
             }
         }
@@ -52,7 +61,8 @@ std::vector<std::string> list_files_with_wildcard(const std::filesystem::path& b
     return files;
 }
 
-std::map<std::string, void(andy::lang::preprocessor::*)(const std::filesystem::path&, andy::lang::lexer&), std::less<>> preprocessor_directives = {
+// Only read after it is initialized, so preprocessors on different threads can share it
+static const std::map<std::string, void(andy::lang::preprocessor::*)(const std::filesystem::path&, andy::lang::lexer&), std::less<>> preprocessor_directives = {
     { "#include", &andy::lang::preprocessor::process_include },
     { "#compile", &andy::lang::preprocessor::process_compile }
 };
@@ -114,16 +124,342 @@ void andy::lang::preprocessor::process_include(const std::filesystem::path &__fi
     // After this the iterator is at the position of the next token
     
     for(std::string& file : files) {
+        andy::lang::timings::scope read_phase(timings, "read", file);
         std::string file_content = uva::file::read_all_text<char>(file);
-        andy::lang::lexer l(file, file_content);
+        read_phase.end();
 
-        process(file, l);
+        // Stored before it is lexed, the tokens point to the name and the source
+        const auto& [file_name, source] = __lexer.include(std::move(file), std::move(file_content));
+
+        andy::lang::timings::scope lex_phase(timings, "lex", file_name);
+        andy::lang::lexer l(file_name, source);
+        lex_phase.end();
+
+        process(file_name, l);
 
         l.erase_eof();
 
         __lexer.insert(l.tokens());
-        __lexer.include(std::move(file), std::move(file_content));
+        // Nested includes are owned by l, which is about to be destroyed
+        __lexer.include(l);
+    }
+}
+
+void andy::lang::preprocessor::extract_includes(unit &__unit, andy::lang::lexer &__lexer)
+{
+    __lexer.reset();
+
+    while(__lexer.has_next_token()) {
+        const andy::lang::lexer::token& token = __lexer.next_token();
+
+        if(token.is_eof()) {
+            break;
+        }
+
+        if(token.type() != andy::lang::lexer::token_type::token_preprocessor) {
+            continue;
+        }
+
+        if(token.content() != "#include") {
+            if(auto it = preprocessor_directives.find(token.content()); it != preprocessor_directives.end()) {
+                (this->*it->second)(__unit.file_name, __lexer);
+            } else {
+                throw std::runtime_error(token.error_message_at_current_position("unknown preprocessor directive"));
+            }
+
+            continue;
+        }
+
+        andy::lang::lexer::token directive       = token;
+        andy::lang::lexer::token file_name_token = __lexer.see_next();
+
+        if(file_name_token.type() != lexer::token_type::token_literal || file_name_token.kind() != lexer::token_kind::token_string) {
+            throw std::runtime_error(file_name_token.error_message_at_current_position("Expected string literal after include directive"));
+        }
+
+        std::filesystem::path file_path = __lexer.path();
+
+        auto files = m_cache ? m_cache->match(file_path.parent_path(), file_name_token.content())
+                             : list_files_with_wildcard(file_path.parent_path(), std::string(file_name_token.content()));
+
+        __lexer.erase_tokens(2); // Remove the directive and the file name token
+
+        for(std::string& file : files) {
+            __unit.include_files.push_back(std::move(file));
+            __unit.include_tokens.push_back(directive);
+            __unit.include_positions.push_back(__lexer.position());
+        }
+    }
+
+    __lexer.reset();
+}
+
+void andy::lang::preprocessor::parse_unit(unit &__unit, andy::lang::lexer &__lexer)
+{
+    try {
+        std::vector<size_t> starts;
+
+        andy::lang::parser p;
+        __unit.root = p.parse_all(__lexer, &starts);
+
+        const auto& tokens = __lexer.tokens();
+
+        // process() splices an included file where its directive was, so it is merged before the node which
+        // followed the directive. A node starts with the comments and the ';' the parser skips before it, the
+        // directive may be among them.
+        for(size_t i = 0; i < __unit.include_positions.size(); i++) {
+            size_t position = __unit.include_positions[i];
+            size_t node = std::lower_bound(starts.begin(), starts.end(), position) - starts.begin();
+
+            if(node && (node == starts.size() ? position < __lexer.position() : position < starts[node])) {
+                bool inside = false;
+
+                for(size_t t = starts[node - 1]; t < position; t++) {
+                    if(tokens[t].type() != andy::lang::lexer::token_type::token_comment && tokens[t].content() != ";") {
+                        inside = true;
+                        break;
+                    }
+                }
+
+                if(inside) {
+                    throw std::runtime_error(__unit.include_tokens[i].error_message_at_current_position("#include inside a statement cannot be loaded in parallel"));
+                }
+
+                node--;
+            }
+
+            __unit.include_nodes.push_back(node);
+        }
+    } catch(...) {
+        // Rethrown in merge order, so the reported error does not depend on scheduling
+        __unit.error = std::current_exception();
+    }
+}
+
+andy::lang::parser::ast_node andy::lang::preprocessor::process_parallel(const std::filesystem::path &__file_name, andy::lang::lexer &__lexer, size_t __jobs, include_cache* __cache)
+{
+    m_units.clear();
+    m_graph.clear();
+    m_cache = __cache;
+
+    andy::lang::thread_pool pool(__jobs);
+
+    // The root unit is lexed by the caller. Its own lexer is left empty.
+    m_units.push_back(std::make_shared<unit>());
+    m_units[0]->file_name = std::string(__lexer.path());
+    m_graph.emplace_back();
+
+    std::vector<andy::lang::lexer*> lexers = { &__lexer };
+    std::vector<std::string> keys = { std::filesystem::weakly_canonical(__file_name).string() };
+    std::map<std::string, size_t, std::less<>> unit_from_path = {
+        { keys[0], 0 }
+    };
+
+    // Breadth first: the directives of a level are resolved on this thread, in order, because #compile has side
+    // effects. Then every file found is read and lexed in parallel, which gives the next level. The units of a
+    // cache are loaded whole, their directives were resolved by whoever loaded them first.
+    std::vector<size_t> level = { 0 };
+
+    while(level.size()) {
+        std::vector<size_t> discovered;
+
+        for(size_t index : level) {
+            unit& u = *m_units[index];
+
+            if(!m_cache || index == 0) {
+                extract_includes(u, *lexers[index]);
+            }
+
+            for(const std::string& file : u.include_files) {
+                std::string key = std::filesystem::weakly_canonical(file).string();
+                size_t included;
+
+                if(auto it = unit_from_path.find(key); it != unit_from_path.end()) {
+                    included = it->second;
+                } else {
+                    included = m_units.size();
+                    unit_from_path[key] = included;
+
+                    m_units.push_back(std::make_shared<unit>());
+                    m_units.back()->file_name = file;
+                    m_graph.emplace_back();
+                    lexers.push_back(&m_units.back()->lexer);
+                    keys.push_back(std::move(key));
+
+                    discovered.push_back(included);
+                }
+
+                m_graph[index].push_back(included);
+            }
+        }
+
+        pool.parallel_for(discovered.size(), [&](size_t i) {
+            size_t index = discovered[i];
+
+            if(m_cache) {
+                m_units[index] = m_cache->load(keys[index], m_units[index]->file_name, [this](unit& u) {
+                    load_unit(u);
+                });
+            } else {
+                unit& u = *m_units[index];
+
+                andy::lang::timings::scope read_phase(timings, "read", u.file_name);
+                u.source = uva::file::read_all_text<char>(u.file_name);
+                read_phase.end();
+
+                andy::lang::timings::scope lex_phase(timings, "lex", u.file_name);
+                u.lexer.tokenize(u.file_name, u.source);
+            }
+        });
+
+        level = std::move(discovered);
+    }
+
+    pool.parallel_for(m_units.size(), [&](size_t i) {
+        if(m_cache && i) {
+            // Parsed by load_unit
+            return;
+        }
+
+        andy::lang::timings::scope parse_phase(timings, "parse", m_units[i]->file_name);
+        parse_unit(*m_units[i], *lexers[i]);
+    });
+
+    std::vector<size_t> uses(m_units.size(), 0);
+    uses[0] = 1;
+
+    for(const auto& includes : m_graph) {
+        for(size_t included : includes) {
+            uses[included]++;
+        }
+    }
+
+    andy::lang::parser::ast_node root(andy::lang::parser::ast_node_type::ast_node_unit);
+    std::vector<bool> visiting(m_units.size(), false);
+
+    merge_unit(0, root, visiting, uses);
+
+    return root;
+}
+
+void andy::lang::preprocessor::load_unit(unit &__unit)
+{
+    try {
+        __unit.source = uva::file::read_all_text<char>(__unit.file_name);
+        __unit.lexer.tokenize(__unit.file_name, __unit.source);
+
+        extract_includes(__unit, __unit.lexer);
+    } catch(...) {
+        __unit.error = std::current_exception();
+        return;
+    }
+
+    parse_unit(__unit, __unit.lexer);
+}
+
+void andy::lang::preprocessor::merge_unit(size_t index, andy::lang::parser::ast_node &root, std::vector<bool> &visiting, std::vector<size_t> &uses)
+{
+    unit& u = *m_units[index];
+
+    // The last use can take the nodes, the others need a copy. The units of a cache are used by other files too.
+    bool take = --uses[index] == 0 && (!m_cache || index == 0);
+
+    auto& nodes = u.root.childrens();
+    size_t include = 0;
+
+    visiting[index] = true;
+
+    // Each include goes before the node which followed its directive. A unit which did not parse has no nodes, its
+    // includes are still merged first, so a circular include or an error in an included file is reported before its own.
+    for(size_t node = 0; node <= nodes.size(); node++) {
+        for(; include < m_graph[index].size() && (u.error || u.include_nodes[include] <= node); include++) {
+            size_t included = m_graph[index][include];
+
+            if(visiting[included]) {
+                throw std::runtime_error(u.include_tokens[include].error_message_at_current_position("circular include of '" + m_units[included]->file_name + "'"));
+            }
+
+            merge_unit(included, root, visiting, uses);
+        }
+
+        if(u.error) {
+            std::rethrow_exception(u.error);
+        }
+
+        if(node == nodes.size()) {
+            break;
+        }
+
+        // process() erases the end of an included file, the end node of an include must not stop the program
+        if(index && nodes[node].type() == andy::lang::parser::ast_node_type::ast_node_undefined && nodes[node].token().is_eof()) {
+            continue;
+        }
+
+        if(take) {
+            root.add_child(std::move(nodes[node]));
+        } else {
+            root.add_child(nodes[node]);
+        }
+    }
+
+    visiting[index] = false;
+}
+
+std::shared_ptr<andy::lang::preprocessor::unit> andy::lang::include_cache::load(std::string_view __key, std::string __file_name, const std::function<void(preprocessor::unit&)>& __loader)
+{
+    std::promise<std::shared_ptr<preprocessor::unit>> promise;
+    std::shared_future<std::shared_ptr<preprocessor::unit>> future;
+    bool owner = false;
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if(auto it = m_units.find(__key); it != m_units.end()) {
+            future = it->second;
+        } else {
+            future = promise.get_future().share();
+            m_units.emplace(std::string(__key), future);
+            owner = true;
+        }
+    }
+
+    if(owner) {
+        auto u = std::make_shared<preprocessor::unit>();
+        u->file_name = std::move(__file_name);
+
+        __loader(*u);
+
+        promise.set_value(std::move(u));
     }
+
+    return future.get();
+}
+
+std::vector<std::string> andy::lang::include_cache::match(const std::filesystem::path &__directory, std::string_view __pattern)
+{
+    std::pair<std::string, std::string> key = { __directory.string(), std::string(__pattern) };
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if(auto it = m_matches.find(key); it != m_matches.end()) {
+            return it->second;
+        }
+    }
+
+    // Listed without the lock, two threads may list the same directory once
+    std::vector<std::string> files = list_files_with_wildcard(__directory, key.second);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_matches.emplace(std::move(key), files);
+
+    return files;
+}
+
+size_t andy::lang::include_cache::size() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    return m_units.size();
 }
 
 void andy::lang::preprocessor::process_compile(const std::filesystem::path &__file_name, andy::lang::lexer &__lexer)
@@ -158,19 +494,23 @@ void andy::lang::preprocessor::process_compile(const std::filesystem::path &__fi
         throw std::runtime_error(file_name_token.error_message_at_current_position("Compile: Directory does not contain a CMakelists.txt file"));
     }
 
-    std::filesystem::path current_path = std::filesystem::current_path();
+    // Two programs can compile the same directory, its build directory is shared. The directories are given
+    // to cmake, the working directory of the process is never changed.
+    static std::mutex compile_mutex;
+    std::unique_lock<std::mutex> lock(compile_mutex);
 
-    std::filesystem::current_path(file_path.parent_path());
+    std::filesystem::path source_directory = std::filesystem::absolute(file_path.parent_path());
+    std::filesystem::path build_directory  = source_directory / "build";
 
     std::filesystem::path temp_file = std::filesystem::temp_directory_path() / "andy_temp_compile.txt";
 
-    if(system(("cmake -B build . > " + temp_file.string()).c_str())) {
+    if(system(("cmake -S \"" + source_directory.string() + "\" -B \"" + build_directory.string() + "\" > \"" + temp_file.string() + "\"").c_str())) {
         throw std::runtime_error(file_name_token.error_message_at_current_position("Compile: CMake failed."));
     }
 
-    if(system(("cmake --build build --config Debug > " + temp_file.string()).c_str())) {
+    if(system(("cmake --build \"" + build_directory.string() + "\" --config Debug > \"" + temp_file.string() + "\"").c_str())) {
         throw std::runtime_error(file_name_token.error_message_at_current_position("Compile: Build failed."));
     }
 
-    std::filesystem::current_path(current_path);
+    m_compiled.push_back(std::move(source_directory));
 }
\ No newline at end of file
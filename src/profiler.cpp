@@ -0,0 +1,283 @@
+#include <andy/lang/profiler.hpp>
+#include <andy/lang/method.hpp>
+#include <andy/lang/class.hpp>
+
+#include <filesystem>
+
+#if !defined(__wasm__) && !defined(__UVA_WIN__)
+    #include <signal.h>
+    #include <sys/time.h>
+#endif
+
+namespace
+{
+    // The ticks of the running profiler, counted by the signal handler
+    std::atomic<std::atomic<size_t>*> running_ticks = nullptr;
+
+#if !defined(__wasm__) && !defined(__UVA_WIN__)
+    struct sigaction previous_action;
+
+    void count_tick(int)
+    {
+        if(std::atomic<size_t>* ticks = running_ticks.load(std::memory_order_relaxed)) {
+            ticks->fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+#endif
+
+    void write_json_string(std::ostream& out, std::string_view value)
+    {
+        out << '"';
+
+        for(char c : value) {
+            switch(c) {
+                case '"':
+                case '\\':
+                    out << '\\' << c;
+                break;
+                case '\n':
+                    out << "\\n";
+                break;
+                default:
+                    out << c;
+                break;
+            }
+        }
+
+        out << '"';
+    }
+};
+
+andy::lang::profiler::profiler(std::chrono::microseconds __interval)
+    : m_interval(__interval)
+{
+    if(m_interval.count() <= 0) {
+        throw std::runtime_error("the profiler interval must be positive");
+    }
+}
+
+andy::lang::profiler::~profiler()
+{
+    stop();
+}
+
+void andy::lang::profiler::start(std::string __name)
+{
+    if(m_running) {
+        return;
+    }
+
+    std::atomic<size_t>* expected = nullptr;
+
+    if(!running_ticks.compare_exchange_strong(expected, &m_ticks)) {
+        throw std::runtime_error("another profiler is running");
+    }
+
+    m_name = std::move(__name);
+    m_stack.clear();
+    m_stack.push_back({ nullptr, nullptr, nullptr });
+    m_start = std::chrono::steady_clock::now();
+    m_ticks = 0;
+    m_running = true;
+
+#if defined(__wasm__)
+    m_last_poll = m_start;
+#elif defined(__UVA_WIN__)
+    m_timer_running = true;
+    m_timer = std::thread(&andy::lang::profiler::timer_loop, this);
+#else
+    struct sigaction action = {};
+    action.sa_handler = count_tick;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGPROF, &action, &previous_action);
+
+    struct itimerval timer = {};
+    timer.it_interval.tv_sec  = m_interval.count() / 1000000;
+    timer.it_interval.tv_usec = m_interval.count() % 1000000;
+    timer.it_value = timer.it_interval;
+    setitimer(ITIMER_PROF, &timer, nullptr);
+#endif
+}
+
+void andy::lang::profiler::stop()
+{
+    if(!m_running) {
+        return;
+    }
+
+    m_running = false;
+
+#if defined(__UVA_WIN__)
+    m_timer_running = false;
+    m_timer.join();
+#elif !defined(__wasm__)
+    struct itimerval timer = {};
+    setitimer(ITIMER_PROF, &timer, nullptr);
+    sigaction(SIGPROF, &previous_action, nullptr);
+#endif
+
+    running_ticks = nullptr;
+}
+
+#ifdef __UVA_WIN__
+void andy::lang::profiler::timer_loop()
+{
+    auto next = std::chrono::steady_clock::now() + m_interval;
+
+    while(m_timer_running) {
+        std::this_thread::sleep_until(next);
+        next += m_interval;
+
+        m_ticks.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+#endif
+
+void andy::lang::profiler::poll()
+{
+#ifdef __wasm__
+    auto now = std::chrono::steady_clock::now();
+    size_t ticks = (now - m_last_poll) / m_interval;
+
+    if(ticks && m_running) {
+        m_last_poll += ticks * m_interval;
+        m_ticks += ticks;
+    }
+#endif
+}
+
+uint32_t andy::lang::profiler::intern(std::string __name)
+{
+    auto it = m_ids.find(__name);
+
+    if(it != m_ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = (uint32_t)m_names.size();
+    m_names.push_back(__name);
+    m_ids.emplace(std::move(__name), id);
+
+    return id;
+}
+
+void andy::lang::profiler::take_sample()
+{
+    sample s;
+    s.weight = m_ticks.exchange(0, std::memory_order_relaxed);
+    s.time   = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start);
+    s.frames.reserve(m_stack.size());
+
+    std::string name;
+
+    for(const frame& f : m_stack) {
+        name.clear();
+
+        if(f.method) {
+            if(f.cls) {
+                name += f.cls->name;
+                name += '.';
+            }
+
+            name += f.method->name;
+        } else {
+            name += m_name;
+        }
+
+        const andy::lang::lexer::token* position = f.position;
+
+        // A method written in andy which has not reached its first statement is at its declaration
+        if(!position && f.method && f.method->block_ast) {
+            position = &f.method->block_ast->token();
+        }
+
+        if(position && !position->m_file_name.empty()) {
+            name += " (";
+            name += std::filesystem::path(position->m_file_name).filename().string();
+            name += ':';
+            name += std::to_string(position->start.line + 1);
+            name += ')';
+        }
+
+        s.frames.push_back(intern(name));
+    }
+
+    m_samples.push_back(std::move(s));
+}
+
+void andy::lang::profiler::write_folded(std::ostream& __out) const
+{
+    std::map<std::vector<uint32_t>, size_t> stacks;
+
+    for(const sample& s : m_samples) {
+        stacks[s.frames] += s.weight;
+    }
+
+    for(const auto& [frames, weight] : stacks) {
+        for(size_t i = 0; i < frames.size(); i++) {
+            if(i) {
+                __out << ';';
+            }
+
+            // The separators of the format cannot be part of a name
+            for(char c : m_names[frames[i]]) {
+                __out << (c == ';' || c == '\n' ? '_' : c);
+            }
+        }
+
+        __out << ' ' << weight << '\n';
+    }
+}
+
+void andy::lang::profiler::write_chrome_trace(std::ostream& __out) const
+{
+    // A sample stands for the ticks before it. Consecutive samples which share the bottom of their stacks
+    // extend the same events, so each call becomes one "complete" event spanning its samples.
+    struct open_frame
+    {
+        uint32_t name;
+        long long start;
+    };
+
+    std::vector<open_frame> open;
+    long long last_end = 0;
+
+    __out << "{\n\"traceEvents\": [\n";
+    __out << "{ \"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": { \"name\": \"andy\" } }";
+
+    auto close = [&](size_t depth, long long end) {
+        while(open.size() > depth) {
+            const open_frame& f = open.back();
+
+            __out << ",\n{ \"name\": ";
+            write_json_string(__out, m_names[f.name]);
+            __out << ", \"cat\": \"andy\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << f.start << ", \"dur\": " << std::max(end - f.start, 1LL) << " }";
+
+            open.pop_back();
+        }
+    };
+
+    for(const sample& s : m_samples) {
+        long long end = s.time.count();
+        long long start = std::max(end - (long long)(s.weight * m_interval.count()), last_end);
+
+        size_t common = 0;
+
+        while(common < open.size() && common < s.frames.size() && open[common].name == s.frames[common]) {
+            common++;
+        }
+
+        close(common, start);
+
+        for(size_t i = common; i < s.frames.size(); i++) {
+            open.push_back({ s.frames[i], start });
+        }
+
+        last_end = end;
+    }
+
+    close(0, last_end);
+
+    __out << "\n],\n\"displayTimeUnit\": \"ms\"\n}\n";
+}
@@ -0,0 +1,236 @@
+#include <andy/lang/scheduler.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+andy::lang::fiber::fiber(andy::lang::interpreter* __interpreter, andy::lang::method __method, std::vector<std::shared_ptr<andy::lang::object>> __params, size_t __stack_size)
+    : m_interpreter(__interpreter), m_method(std::move(__method)), m_params(std::move(__params)), m_coroutine([this]() {
+        m_result = m_interpreter->call(nullptr, nullptr, m_method, std::move(m_params));
+    }, __stack_size)
+{
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::fiber::result() const
+{
+    if(m_error) {
+        std::rethrow_exception(m_error);
+    }
+
+    if(!m_result) {
+        return std::make_shared<andy::lang::object>(m_interpreter->NullClass);
+    }
+
+    return m_result;
+}
+
+void andy::lang::fiber::resume()
+{
+    auto swap_contexts = [this]() {
+        std::swap(m_interpreter->current_context, m_context);
+        std::swap(m_interpreter->stack, m_stack);
+        std::swap(m_interpreter->generator, m_generator);
+    };
+
+    swap_contexts();
+
+    try {
+        m_coroutine.resume();
+    } catch(...) {
+        m_error = std::current_exception();
+    }
+
+    swap_contexts();
+}
+
+andy::lang::scheduler::scheduler(andy::lang::interpreter* __interpreter)
+    : m_interpreter(__interpreter)
+{
+}
+
+std::shared_ptr<andy::lang::fiber> andy::lang::scheduler::spawn(andy::lang::method __method, std::vector<std::shared_ptr<andy::lang::object>> __params)
+{
+    auto fiber = std::make_shared<andy::lang::fiber>(m_interpreter, std::move(__method), std::move(__params), stack_size);
+
+    m_fibers.emplace(fiber.get(), fiber);
+    wake(fiber);
+
+    return fiber;
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::scheduler::join(const std::shared_ptr<andy::lang::fiber>& __fiber)
+{
+    if(__fiber.get() == m_running && !__fiber->done()) {
+        throw std::runtime_error("Fiber: a fiber cannot join itself");
+    }
+
+    block([&]() { return __fiber->done(); }, [&](std::shared_ptr<andy::lang::fiber> self) {
+        __fiber->m_joiners.push_back(std::move(self));
+    });
+
+    return __fiber->result();
+}
+
+void andy::lang::scheduler::yield()
+{
+    if(andy::lang::fiber* self = running()) {
+        wake(self->weak_from_this());
+        andy::lang::coroutine::suspend();
+    } else {
+        run_ready();
+    }
+}
+
+void andy::lang::scheduler::wait(const andy::lang::event_loop::handle& __operation)
+{
+    if(__operation->done) {
+        return;
+    }
+
+    m_loop = &m_interpreter->loop();
+
+    block([&]() { return __operation->done; }, [&](std::shared_ptr<andy::lang::fiber> self) {
+        // Several fibers can wait for the same operation
+        __operation->on_done = [this, self = std::weak_ptr<andy::lang::fiber>(self), previous = std::move(__operation->on_done)]() {
+            if(previous) {
+                previous();
+            }
+
+            wake(self);
+        };
+    });
+}
+
+void andy::lang::scheduler::run()
+{
+    run_until([this]() { return m_fibers.empty(); });
+}
+
+andy::lang::fiber* andy::lang::scheduler::running() const
+{
+    if(m_running && andy::lang::coroutine::current() == &m_running->m_coroutine) {
+        return m_running;
+    }
+
+    return nullptr;
+}
+
+void andy::lang::scheduler::block(const std::function<bool()>& __ready, const std::function<void(std::shared_ptr<andy::lang::fiber>)>& __enqueue)
+{
+    andy::lang::fiber* self = running();
+
+    if(!self) {
+        run_until(__ready);
+        return;
+    }
+
+    while(!__ready()) {
+        __enqueue(self->shared_from_this());
+        andy::lang::coroutine::suspend();
+    }
+}
+
+void andy::lang::scheduler::run_until(const std::function<bool()>& __ready)
+{
+    while(!__ready()) {
+        if(!m_ready.empty()) {
+            run_ready();
+        } else if(m_loop && m_loop->pending()) {
+            m_loop->run_once(true);
+        } else {
+            throw std::runtime_error("Fiber: every fiber is waiting and nothing can wake them up");
+        }
+    }
+}
+
+void andy::lang::scheduler::run_ready()
+{
+    // The fibers which become ready meanwhile run on the next round
+    for(size_t count = m_ready.size(); count > 0 && !m_ready.empty(); count--) {
+        std::shared_ptr<andy::lang::fiber> fiber = std::move(m_ready.front());
+        m_ready.pop_front();
+        fiber->m_ready = false;
+
+        andy::lang::fiber* previous = std::exchange(m_running, fiber.get());
+        fiber->resume();
+        m_running = previous;
+
+        if(fiber->done()) {
+            for(auto& joiner : fiber->m_joiners) {
+                wake(joiner);
+            }
+
+            fiber->m_joiners.clear();
+            m_fibers.erase(fiber.get());
+        }
+    }
+}
+
+void andy::lang::scheduler::wake(const std::weak_ptr<andy::lang::fiber>& __fiber)
+{
+    std::shared_ptr<andy::lang::fiber> fiber = __fiber.lock();
+
+    if(fiber && !fiber->m_ready && !fiber->done()) {
+        fiber->m_ready = true;
+        m_ready.push_back(std::move(fiber));
+    }
+}
+
+andy::lang::scheduler::channel::channel(andy::lang::scheduler* __scheduler, size_t __capacity)
+    : m_scheduler(__scheduler), m_capacity(std::max<size_t>(__capacity, 1))
+{
+}
+
+bool andy::lang::scheduler::channel::send(std::shared_ptr<andy::lang::object> __value)
+{
+    m_scheduler->block([this]() { return m_closed || m_values.size() < m_capacity; }, [this](std::shared_ptr<andy::lang::fiber> self) {
+        m_senders.push_back(std::move(self));
+    });
+
+    if(m_closed) {
+        return false;
+    }
+
+    m_values.push_back(std::move(__value));
+
+    if(!m_receivers.empty()) {
+        m_scheduler->wake(m_receivers.front());
+        m_receivers.pop_front();
+    }
+
+    return true;
+}
+
+std::optional<std::shared_ptr<andy::lang::object>> andy::lang::scheduler::channel::receive()
+{
+    m_scheduler->block([this]() { return m_closed || !m_values.empty(); }, [this](std::shared_ptr<andy::lang::fiber> self) {
+        m_receivers.push_back(std::move(self));
+    });
+
+    if(m_values.empty()) {
+        return std::nullopt;
+    }
+
+    std::shared_ptr<andy::lang::object> value = std::move(m_values.front());
+    m_values.pop_front();
+
+    if(!m_senders.empty()) {
+        m_scheduler->wake(m_senders.front());
+        m_senders.pop_front();
+    }
+
+    return value;
+}
+
+void andy::lang::scheduler::channel::close()
+{
+    m_closed = true;
+
+    for(auto* waiters : { &m_senders, &m_receivers }) {
+        for(auto& fiber : *waiters) {
+            m_scheduler->wake(fiber);
+        }
+
+        waiters->clear();
+    }
+}
@@ -0,0 +1,773 @@
+#include <andy/lang/symbol_index.hpp>
+#include <andy/lang/module_cache.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <set>
+
+#include <uva/file.hpp>
+
+namespace
+{
+    // Layout: header | file_record[file_count] | name_record[name_count] | symbol_record[symbol_count]
+    //       | reference_record[reference_count] | strings
+    // The names are sorted and own contiguous ranges of the symbols and references.
+    constexpr char index_magic[8] = { 'A', 'N', 'D', 'Y', 'S', 'Y', 'M', '\0' };
+    constexpr uint32_t index_format_version = 1;
+
+    struct string_ref
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct header
+    {
+        char magic[8];
+        uint32_t format_version;
+        uint32_t record_size;
+        uint64_t file_count;
+        uint64_t name_count;
+        uint64_t symbol_count;
+        uint64_t reference_count;
+        uint64_t strings_size;
+    };
+
+    struct file_record
+    {
+        uint64_t hash;
+        string_ref file_name;
+    };
+
+    struct name_record
+    {
+        string_ref name;
+        uint32_t first_symbol;
+        uint32_t symbol_count;
+        uint32_t first_reference;
+        uint32_t reference_count;
+    };
+
+    struct symbol_record
+    {
+        uint32_t file;
+        uint32_t kind;
+        uint32_t line;
+        uint32_t column;
+        uint32_t offset;
+        uint32_t length;
+        string_ref container;
+    };
+
+    struct reference_record
+    {
+        uint32_t file;
+        uint32_t line;
+        uint32_t column;
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    constexpr uint32_t record_size = sizeof(file_record) + sizeof(name_record) + sizeof(symbol_record) + sizeof(reference_record);
+
+    // The sections of a mapped index
+    struct stored_index
+    {
+        const header* h = nullptr;
+        const file_record* files = nullptr;
+        const name_record* names = nullptr;
+        const symbol_record* symbols = nullptr;
+        const reference_record* references = nullptr;
+        const char* strings = nullptr;
+
+        stored_index(const andy::lang::mapped_file& __file)
+        {
+            if(!__file.is_open()) {
+                return;
+            }
+
+            h          = (const header*)__file.data();
+            files      = (const file_record*)(h + 1);
+            names      = (const name_record*)(files + h->file_count);
+            symbols    = (const symbol_record*)(names + h->name_count);
+            references = (const reference_record*)(symbols + h->symbol_count);
+            strings    = (const char*)(references + h->reference_count);
+        }
+
+        uint64_t count(uint64_t header::* __count) const
+        {
+            return h ? h->*__count : 0;
+        }
+
+        std::string_view view(const string_ref& __ref) const
+        {
+            if((uint64_t)__ref.offset + __ref.size > h->strings_size) {
+                return {};
+            }
+
+            return std::string_view(strings + __ref.offset, __ref.size);
+        }
+
+        const name_record* find(std::string_view __name) const
+        {
+            const name_record* begin = names;
+            const name_record* end = names + count(&header::name_count);
+
+            const name_record* it = std::lower_bound(begin, end, __name, [this](const name_record& record, std::string_view name) {
+                return view(record.name) < name;
+            });
+
+            if(it == end || view(it->name) != __name) {
+                return nullptr;
+            }
+
+            return it;
+        }
+    };
+
+    // The methods the interpreter calls without an identifier in the source
+    bool is_implicit(std::string_view __name)
+    {
+        return __name == "new" || __name == "to_string" || __name.starts_with("operator");
+    }
+
+    void extract_node(const andy::lang::parser::ast_node& __node, std::string_view __file_name, std::string_view __container, bool __in_class, std::vector<andy::lang::symbol_index::symbol>& __symbols)
+    {
+        using ast_node_type = andy::lang::parser::ast_node_type;
+
+        auto add = [&](const andy::lang::parser::ast_node* name_node, andy::lang::symbol_index::symbol_kind kind, std::string_view container) {
+            if(!name_node) {
+                return;
+            }
+
+            const andy::lang::lexer::token& token = name_node->token();
+
+            if(token.m_file_name != __file_name || token.end.offset == token.start.offset) {
+                return;
+            }
+
+            andy::lang::symbol_index::symbol symbol;
+            symbol.name            = std::string(token.content());
+            symbol.kind            = kind;
+            symbol.container       = std::string(container);
+            symbol.where.file_name = std::string(__file_name);
+            symbol.where.line      = token.start.line;
+            symbol.where.column    = token.start.column;
+            symbol.where.offset    = token.start.offset;
+            symbol.where.length    = token.end.offset - token.start.offset;
+
+            __symbols.push_back(std::move(symbol));
+        };
+
+        switch(__node.type()) {
+            case ast_node_type::ast_node_classdecl: {
+                add(__node.child_from_type(ast_node_type::ast_node_declname), andy::lang::symbol_index::symbol_class, __container);
+
+                for(const auto& child : __node.childrens()) {
+                    extract_node(child, __file_name, __node.decname(), true, __symbols);
+                }
+            }
+            break;
+            case ast_node_type::ast_node_fn_decl: {
+                add(__node.child_from_type(ast_node_type::ast_node_declname), __in_class ? andy::lang::symbol_index::symbol_method : andy::lang::symbol_index::symbol_function, __container);
+
+                if(const auto* params = __node.child_from_type(ast_node_type::ast_node_fn_params)) {
+                    for(const auto& param : params->childrens()) {
+                        if(param.type() == ast_node_type::ast_node_declname) {
+                            add(&param, andy::lang::symbol_index::symbol_parameter, __node.decname());
+                        }
+                    }
+                }
+
+                if(const auto* block = __node.block()) {
+                    extract_node(*block, __file_name, __node.decname(), false, __symbols);
+                }
+            }
+            break;
+            case ast_node_type::ast_node_vardecl: {
+                add(__node.child_from_type(ast_node_type::ast_node_declname), andy::lang::symbol_index::symbol_variable, __container);
+
+                for(const auto& child : __node.childrens()) {
+                    extract_node(child, __file_name, __container, __in_class, __symbols);
+                }
+            }
+            break;
+            case ast_node_type::ast_node_declname:
+            break;
+            default:
+                for(const auto& child : __node.childrens()) {
+                    extract_node(child, __file_name, __container, __in_class, __symbols);
+                }
+            break;
+        }
+    }
+
+    bool location_less(const andy::lang::symbol_index::location& __a, const andy::lang::symbol_index::location& __b)
+    {
+        if(__a.file_name != __b.file_name) {
+            return __a.file_name < __b.file_name;
+        }
+
+        return __a.offset < __b.offset;
+    }
+};
+
+andy::lang::symbol_index::symbol_index(std::filesystem::path __index_path)
+    : m_path(std::move(__index_path))
+{
+}
+
+bool andy::lang::symbol_index::load()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_stored_files.clear();
+    m_hidden.clear();
+
+    if(!m_file.open(m_path)) {
+        return false;
+    }
+
+    const header* h = (const header*)m_file.data();
+
+    bool valid = m_file.size() >= sizeof(header)
+              && memcmp(h->magic, index_magic, sizeof(index_magic)) == 0
+              && h->format_version == index_format_version
+              && h->record_size == record_size
+              && sizeof(header) + h->file_count * sizeof(file_record) + h->name_count * sizeof(name_record)
+                 + h->symbol_count * sizeof(symbol_record) + h->reference_count * sizeof(reference_record) + h->strings_size == m_file.size();
+
+    if(!valid) {
+        m_file.close();
+        return false;
+    }
+
+    stored_index stored(m_file);
+
+    for(uint32_t i = 0; i < h->file_count; i++) {
+        std::string_view file_name = stored.view(stored.files[i].file_name);
+
+        m_stored_files.emplace(std::string(file_name), i);
+        m_hidden.push_back(m_files.find(file_name) != m_files.end());
+    }
+
+    // The records must point inside their sections, so the queries do not need to check them
+    for(uint64_t i = 0; i < h->name_count; i++) {
+        const name_record& name = stored.names[i];
+
+        if((uint64_t)name.first_symbol + name.symbol_count > h->symbol_count || (uint64_t)name.first_reference + name.reference_count > h->reference_count) {
+            m_stored_files.clear();
+            m_hidden.clear();
+            m_file.close();
+            return false;
+        }
+    }
+
+    for(uint64_t i = 0; i < h->symbol_count; i++) {
+        if(stored.symbols[i].file >= h->file_count) {
+            m_stored_files.clear();
+            m_hidden.clear();
+            m_file.close();
+            return false;
+        }
+    }
+
+    for(uint64_t i = 0; i < h->reference_count; i++) {
+        if(stored.references[i].file >= h->file_count) {
+            m_stored_files.clear();
+            m_hidden.clear();
+            m_file.close();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool andy::lang::symbol_index::store()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    stored_index stored(m_file);
+
+    // Every visible file, with its records grouped by name
+    std::map<std::string, uint32_t> files;
+    std::vector<uint64_t> hashes;
+    std::map<std::string, std::pair<std::vector<symbol_record>, std::vector<reference_record>>, std::less<>> names;
+    std::map<std::string, uint32_t, std::less<>> containers;
+    std::string strings;
+
+    auto add_string = [&](std::string_view value) -> string_ref {
+        string_ref ref = { (uint32_t)strings.size(), (uint32_t)value.size() };
+        strings.append(value);
+        return ref;
+    };
+
+    auto add_file = [&](std::string_view file_name, uint64_t hash) {
+        uint32_t index = (uint32_t)files.size();
+        files.emplace(std::string(file_name), index);
+        hashes.push_back(hash);
+        return index;
+    };
+
+    auto container_ref = [&](std::string_view container) -> string_ref {
+        if(container.empty()) {
+            return { 0, 0 };
+        }
+
+        auto it = containers.find(container);
+
+        if(it == containers.end()) {
+            it = containers.emplace(std::string(container), add_string(container).offset).first;
+        }
+
+        return { it->second, (uint32_t)container.size() };
+    };
+
+    std::vector<uint32_t> stored_to_new(stored.count(&header::file_count), UINT32_MAX);
+
+    for(uint32_t i = 0; i < stored.count(&header::file_count); i++) {
+        if(!m_hidden[i]) {
+            stored_to_new[i] = add_file(stored.view(stored.files[i].file_name), stored.files[i].hash);
+        }
+    }
+
+    for(uint64_t i = 0; i < stored.count(&header::name_count); i++) {
+        const name_record& name = stored.names[i];
+        auto* records = &names[std::string(stored.view(name.name))];
+
+        for(uint32_t j = name.first_symbol; j < name.first_symbol + name.symbol_count; j++) {
+            symbol_record record = stored.symbols[j];
+
+            if(stored_to_new[record.file] != UINT32_MAX) {
+                record.file = stored_to_new[record.file];
+                record.container = container_ref(stored.view(record.container));
+                records->first.push_back(record);
+            }
+        }
+
+        for(uint32_t j = name.first_reference; j < name.first_reference + name.reference_count; j++) {
+            reference_record record = stored.references[j];
+
+            if(stored_to_new[record.file] != UINT32_MAX) {
+                record.file = stored_to_new[record.file];
+                records->second.push_back(record);
+            }
+        }
+    }
+
+    for(const auto& [file_name, entry] : m_files) {
+        if(entry.removed) {
+            continue;
+        }
+
+        uint32_t file = add_file(file_name, entry.hash);
+
+        for(const auto& symbol : entry.symbols) {
+            symbol_record record = { file, (uint32_t)symbol.kind, (uint32_t)symbol.where.line, (uint32_t)symbol.where.column, (uint32_t)symbol.where.offset, (uint32_t)symbol.where.length, container_ref(symbol.container) };
+            names[symbol.name].first.push_back(record);
+        }
+
+        for(const auto& reference : entry.references) {
+            reference_record record = { file, (uint32_t)reference.where.line, (uint32_t)reference.where.column, (uint32_t)reference.where.offset, (uint32_t)reference.where.length };
+            names[reference.name].second.push_back(record);
+        }
+    }
+
+    std::vector<file_record> file_records(files.size());
+
+    for(const auto& [file_name, index] : files) {
+        file_records[index] = { hashes[index], add_string(file_name) };
+    }
+
+    std::vector<name_record> name_records;
+    std::vector<symbol_record> symbol_records;
+    std::vector<reference_record> reference_records;
+
+    for(const auto& [name, records] : names) {
+        if(records.first.empty() && records.second.empty()) {
+            continue;
+        }
+
+        name_record record;
+        record.name            = add_string(name);
+        record.first_symbol    = (uint32_t)symbol_records.size();
+        record.symbol_count    = (uint32_t)records.first.size();
+        record.first_reference = (uint32_t)reference_records.size();
+        record.reference_count = (uint32_t)records.second.size();
+
+        symbol_records.insert(symbol_records.end(), records.first.begin(), records.first.end());
+        reference_records.insert(reference_records.end(), records.second.begin(), records.second.end());
+        name_records.push_back(record);
+    }
+
+    header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, index_magic, sizeof(index_magic));
+    h.format_version  = index_format_version;
+    h.record_size     = record_size;
+    h.file_count      = file_records.size();
+    h.name_count      = name_records.size();
+    h.symbol_count    = symbol_records.size();
+    h.reference_count = reference_records.size();
+    h.strings_size    = strings.size();
+
+    std::random_device random;
+    std::filesystem::path temporary_path = m_path;
+    temporary_path += "." + std::to_string(random()) + ".tmp";
+
+    std::error_code ec;
+
+    if(m_path.has_parent_path()) {
+        std::filesystem::create_directories(m_path.parent_path(), ec);
+    }
+
+    {
+        std::ofstream stream(temporary_path, std::ios::binary);
+
+        if(!stream) {
+            return false;
+        }
+
+        stream.write((const char*)&h, sizeof(h));
+        stream.write((const char*)file_records.data(), file_records.size() * sizeof(file_record));
+        stream.write((const char*)name_records.data(), name_records.size() * sizeof(name_record));
+        stream.write((const char*)symbol_records.data(), symbol_records.size() * sizeof(symbol_record));
+        stream.write((const char*)reference_records.data(), reference_records.size() * sizeof(reference_record));
+        stream.write(strings.data(), strings.size());
+
+        if(!stream) {
+            stream.close();
+            std::filesystem::remove(temporary_path, ec);
+            return false;
+        }
+    }
+
+    m_file.close();
+
+    std::filesystem::rename(temporary_path, m_path, ec);
+
+    if(ec) {
+        std::filesystem::remove(temporary_path, ec);
+        return false;
+    }
+
+    // Everything is stored now, map the new file
+    m_files.clear();
+    lock.unlock();
+
+    return load();
+}
+
+bool andy::lang::symbol_index::is_current(std::string_view __file_name, uint64_t __hash) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    if(auto it = m_files.find(__file_name); it != m_files.end()) {
+        return !it->second.removed && it->second.hash == __hash;
+    }
+
+    if(auto it = m_stored_files.find(__file_name); it != m_stored_files.end()) {
+        return stored_index(m_file).files[it->second].hash == __hash;
+    }
+
+    return false;
+}
+
+andy::lang::symbol_index::file_entry andy::lang::symbol_index::extract(std::string_view __file_name, const std::vector<andy::lang::lexer::token>& __tokens, const std::vector<const andy::lang::parser::ast_node*>& __declarations)
+{
+    file_entry entry;
+
+    for(const auto* declaration : __declarations) {
+        extract_node(*declaration, __file_name, {}, false, entry.symbols);
+    }
+
+    std::set<size_t> declared;
+
+    for(const auto& symbol : entry.symbols) {
+        declared.insert(symbol.where.offset);
+    }
+
+    for(const auto& token : __tokens) {
+        if(token.type() != andy::lang::lexer::token_type::token_identifier || token.m_file_name != __file_name) {
+            continue;
+        }
+
+        if(declared.count(token.start.offset)) {
+            continue;
+        }
+
+        reference reference;
+        reference.name            = std::string(token.content());
+        reference.where.file_name = std::string(__file_name);
+        reference.where.line      = token.start.line;
+        reference.where.column    = token.start.column;
+        reference.where.offset    = token.start.offset;
+        reference.where.length    = token.end.offset - token.start.offset;
+
+        entry.references.push_back(std::move(reference));
+    }
+
+    return entry;
+}
+
+void andy::lang::symbol_index::replace(std::string_view __file_name, file_entry __entry)
+{
+    if(auto it = m_stored_files.find(__file_name); it != m_stored_files.end()) {
+        m_hidden[it->second] = true;
+    }
+
+    m_files[std::string(__file_name)] = std::move(__entry);
+}
+
+void andy::lang::symbol_index::update(std::string_view __file_name, uint64_t __hash, const std::vector<andy::lang::lexer::token>& __tokens, const std::vector<const andy::lang::parser::ast_node*>& __declarations)
+{
+    // Extracted without the lock, so many files can be indexed at once
+    file_entry entry = extract(__file_name, __tokens, __declarations);
+    entry.hash = __hash;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    replace(__file_name, std::move(entry));
+}
+
+bool andy::lang::symbol_index::update(const std::filesystem::path& __file_name)
+{
+    std::string file_name = __file_name.string();
+    std::string source = uva::file::read_all_text<char>(__file_name);
+    uint64_t hash = andy::lang::module_cache::hash(source);
+
+    if(is_current(file_name, hash)) {
+        return false;
+    }
+
+    andy::lang::lexer l;
+    andy::lang::parser::ast_node root;
+
+    try {
+        l.tokenize(file_name, source);
+
+        andy::lang::parser p;
+        root = p.parse_all(l);
+    } catch(const std::exception&) {
+        // The references of the tokens lexed so far are still useful
+    }
+
+    std::vector<const andy::lang::parser::ast_node*> declarations;
+
+    for(const auto& child : root.childrens()) {
+        declarations.push_back(&child);
+    }
+
+    update(file_name, hash, l.tokens(), declarations);
+
+    return true;
+}
+
+void andy::lang::symbol_index::remove(std::string_view __file_name)
+{
+    file_entry entry;
+    entry.removed = true;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    replace(__file_name, std::move(entry));
+}
+
+std::vector<andy::lang::symbol_index::symbol> andy::lang::symbol_index::definitions(std::string_view __name) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    std::vector<symbol> result;
+    stored_index stored(m_file);
+
+    if(const name_record* name = stored.find(__name)) {
+        for(uint32_t i = name->first_symbol; i < name->first_symbol + name->symbol_count; i++) {
+            const symbol_record& record = stored.symbols[i];
+
+            if(m_hidden[record.file]) {
+                continue;
+            }
+
+            symbol symbol;
+            symbol.name            = std::string(__name);
+            symbol.kind            = (symbol_kind)record.kind;
+            symbol.container       = std::string(stored.view(record.container));
+            symbol.where.file_name = std::string(stored.view(stored.files[record.file].file_name));
+            symbol.where.line      = record.line;
+            symbol.where.column    = record.column;
+            symbol.where.offset    = record.offset;
+            symbol.where.length    = record.length;
+
+            result.push_back(std::move(symbol));
+        }
+    }
+
+    // The files updated in memory are few, they are scanned
+    for(const auto& [file_name, entry] : m_files) {
+        for(const auto& symbol : entry.symbols) {
+            if(symbol.name == __name) {
+                result.push_back(symbol);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const symbol& a, const symbol& b) {
+        return location_less(a.where, b.where);
+    });
+
+    return result;
+}
+
+std::vector<andy::lang::symbol_index::reference> andy::lang::symbol_index::references(std::string_view __name) const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    std::vector<reference> result;
+    stored_index stored(m_file);
+
+    if(const name_record* name = stored.find(__name)) {
+        for(uint32_t i = name->first_reference; i < name->first_reference + name->reference_count; i++) {
+            const reference_record& record = stored.references[i];
+
+            if(m_hidden[record.file]) {
+                continue;
+            }
+
+            reference reference;
+            reference.name            = std::string(__name);
+            reference.where.file_name = std::string(stored.view(stored.files[record.file].file_name));
+            reference.where.line      = record.line;
+            reference.where.column    = record.column;
+            reference.where.offset    = record.offset;
+            reference.where.length    = record.length;
+
+            result.push_back(std::move(reference));
+        }
+    }
+
+    for(const auto& [file_name, entry] : m_files) {
+        for(const auto& reference : entry.references) {
+            if(reference.name == __name) {
+                result.push_back(reference);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const reference& a, const reference& b) {
+        return location_less(a.where, b.where);
+    });
+
+    return result;
+}
+
+size_t andy::lang::symbol_index::stored_reference_count(std::string_view __name) const
+{
+    stored_index stored(m_file);
+    const name_record* name = stored.find(__name);
+
+    if(!name) {
+        return 0;
+    }
+
+    size_t count = 0;
+
+    for(uint32_t i = name->first_reference; i < name->first_reference + name->reference_count; i++) {
+        count += !m_hidden[stored.references[i].file];
+    }
+
+    return count;
+}
+
+std::vector<andy::lang::symbol_index::symbol> andy::lang::symbol_index::unused() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    std::map<std::string_view, size_t> updated_references;
+
+    for(const auto& [file_name, entry] : m_files) {
+        for(const auto& reference : entry.references) {
+            updated_references[reference.name]++;
+        }
+    }
+
+    auto is_unused = [&](std::string_view name, symbol_kind kind, size_t stored_references) {
+        if(kind == symbol_parameter || (kind == symbol_method && is_implicit(name))) {
+            return false;
+        }
+
+        auto it = updated_references.find(name);
+
+        return stored_references == 0 && (it == updated_references.end() || it->second == 0);
+    };
+
+    std::vector<symbol> result;
+    stored_index stored(m_file);
+
+    for(uint64_t i = 0; i < stored.count(&header::name_count); i++) {
+        const name_record& name = stored.names[i];
+        std::string_view name_view = stored.view(name.name);
+        size_t stored_references = 0;
+
+        for(uint32_t j = name.first_reference; j < name.first_reference + name.reference_count; j++) {
+            stored_references += !m_hidden[stored.references[j].file];
+        }
+
+        for(uint32_t j = name.first_symbol; j < name.first_symbol + name.symbol_count; j++) {
+            const symbol_record& record = stored.symbols[j];
+
+            if(m_hidden[record.file] || !is_unused(name_view, (symbol_kind)record.kind, stored_references)) {
+                continue;
+            }
+
+            symbol symbol;
+            symbol.name            = std::string(name_view);
+            symbol.kind            = (symbol_kind)record.kind;
+            symbol.container       = std::string(stored.view(record.container));
+            symbol.where.file_name = std::string(stored.view(stored.files[record.file].file_name));
+            symbol.where.line      = record.line;
+            symbol.where.column    = record.column;
+            symbol.where.offset    = record.offset;
+            symbol.where.length    = record.length;
+
+            result.push_back(std::move(symbol));
+        }
+    }
+
+    for(const auto& [file_name, entry] : m_files) {
+        for(const auto& symbol : entry.symbols) {
+            if(is_unused(symbol.name, symbol.kind, stored_reference_count(symbol.name))) {
+                result.push_back(symbol);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(), [](const symbol& a, const symbol& b) {
+        return location_less(a.where, b.where);
+    });
+
+    return result;
+}
+
+std::vector<std::string> andy::lang::symbol_index::files() const
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    std::vector<std::string> result;
+
+    for(const auto& [file_name, index] : m_stored_files) {
+        if(!m_hidden[index]) {
+            result.push_back(file_name);
+        }
+    }
+
+    for(const auto& [file_name, entry] : m_files) {
+        if(!entry.removed) {
+            result.push_back(file_name);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
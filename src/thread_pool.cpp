@@ -0,0 +1,190 @@
+#include <andy/lang/thread_pool.hpp>
+
+#include <exception>
+
+namespace
+{
+    // The pool and queue of the worker running on this thread
+    thread_local const andy::lang::thread_pool* current_pool = nullptr;
+    thread_local size_t current_index = 0;
+};
+
+andy::lang::thread_pool::thread_pool(size_t __threads)
+{
+#ifndef __wasm__
+    if(__threads == 0) {
+        __threads = std::thread::hardware_concurrency();
+    }
+#else
+    __threads = 1;
+#endif
+
+    if(__threads == 0) {
+        __threads = 1;
+    }
+
+    for(size_t i = 0; i < __threads; i++) {
+        m_queues.push_back(std::make_unique<queue>());
+    }
+
+    // The calling thread also executes work, it uses the first queue
+    for(size_t i = 1; i < __threads; i++) {
+        m_workers.emplace_back(&andy::lang::thread_pool::worker_loop, this, i);
+    }
+}
+
+andy::lang::thread_pool::~thread_pool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+
+    m_condition.notify_all();
+
+    for(auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+size_t andy::lang::thread_pool::current_queue() const
+{
+    return current_pool == this ? current_index : 0;
+}
+
+void andy::lang::thread_pool::worker_loop(size_t __index)
+{
+    current_pool  = this;
+    current_index = __index;
+
+    while(true) {
+        if(run_one(__index)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        m_condition.wait(lock, [this]() {
+            return m_stopping || m_pending;
+        });
+
+        if(m_stopping && !m_pending) {
+            // Stopping and there is nothing left to do
+            return;
+        }
+    }
+}
+
+bool andy::lang::thread_pool::run_one(size_t __index)
+{
+    for(size_t i = 0; i < m_queues.size(); i++) {
+        queue& q = *m_queues[(__index + i) % m_queues.size()];
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(q.mutex);
+
+            if(q.tasks.empty()) {
+                continue;
+            }
+
+            // The owner works through its slice in order, a thief takes the far end of it
+            if(i == 0) {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+            } else {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+            }
+
+            m_pending--;
+        }
+
+        task();
+
+        return true;
+    }
+
+    return false;
+}
+
+void andy::lang::thread_pool::parallel_for(size_t count, const std::function<void(size_t)>& fn)
+{
+    if(count == 0) {
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(count);
+
+    if(m_workers.empty() || count == 1) {
+        for(size_t i = 0; i < count; i++) {
+            try {
+                fn(i);
+            } catch(...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    } else {
+        std::atomic<size_t> remaining = count;
+        std::condition_variable done;
+
+        size_t self = current_queue();
+        size_t queues = m_queues.size();
+
+        // One contiguous slice per queue, the first one to the calling thread
+        for(size_t slice = 0; slice < queues; slice++) {
+            size_t begin = count * slice / queues;
+            size_t end = count * (slice + 1) / queues;
+
+            if(begin == end) {
+                continue;
+            }
+
+            queue& q = *m_queues[(self + slice) % queues];
+            std::unique_lock<std::mutex> lock(q.mutex);
+
+            for(size_t i = begin; i < end; i++) {
+                q.tasks.push_back([&, i]() {
+                    try {
+                        fn(i);
+                    } catch(...) {
+                        errors[i] = std::current_exception();
+                    }
+
+                    // Under the lock, so the caller cannot see the batch done and destroy its state before the
+                    // notification, nor miss it between its check and its wait
+                    std::unique_lock<std::mutex> lock(m_mutex);
+
+                    if(--remaining == 0) {
+                        done.notify_all();
+                    }
+                });
+            }
+
+            m_pending += end - begin;
+        }
+
+        {
+            // A worker which saw no pending task is either waiting or will see the new ones
+            std::unique_lock<std::mutex> lock(m_mutex);
+        }
+
+        m_condition.notify_all();
+
+        // Help with the batch, and with any other work, instead of sleeping
+        while(remaining && run_one(self)) {
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        done.wait(lock, [&]() {
+            return remaining == 0;
+        });
+    }
+
+    for(auto& error : errors) {
+        if(error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
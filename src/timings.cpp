@@ -0,0 +1,184 @@
+#include <andy/lang/timings.hpp>
+
+#include <ctime>
+#include <iomanip>
+#include <map>
+
+#if defined(__UVA_WIN__)
+    #include <windows.h>
+#endif
+
+namespace
+{
+    // The processor time of the calling thread, or of the whole process
+    std::chrono::nanoseconds cpu_time(bool thread)
+    {
+#if defined(__UVA_WIN__)
+        FILETIME creation, exit, kernel, user;
+
+        if(thread) {
+            GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+        } else {
+            GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+        }
+
+        auto ticks = [](const FILETIME& t) {
+            return ((unsigned long long)t.dwHighDateTime << 32) | t.dwLowDateTime;
+        };
+
+        // FILETIME counts 100 nanoseconds
+        return std::chrono::nanoseconds((ticks(kernel) + ticks(user)) * 100);
+#elif defined(__wasm__)
+        return std::chrono::nanoseconds((long long)((double)std::clock() / CLOCKS_PER_SEC * 1e9));
+#else
+        timespec t;
+        clock_gettime(thread ? CLOCK_THREAD_CPUTIME_ID : CLOCK_PROCESS_CPUTIME_ID, &t);
+
+        return std::chrono::seconds(t.tv_sec) + std::chrono::nanoseconds(t.tv_nsec);
+#endif
+    }
+
+    double to_milliseconds(std::chrono::nanoseconds duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void write_phase(std::ostream& out, const andy::lang::timings::phase& p, std::string_view name)
+    {
+        out << std::setw(12) << to_milliseconds(p.wall) << std::setw(12) << to_milliseconds(p.cpu);
+        out << std::setw(14) << p.allocations << std::setw(16) << p.allocated_bytes << "  " << name << std::endl;
+    }
+
+    void write_json_string(std::ostream& out, std::string_view value)
+    {
+        out << '"';
+
+        for(char c : value) {
+            if(c == '"' || c == '\\') {
+                out << '\\';
+            }
+
+            out << c;
+        }
+
+        out << '"';
+    }
+};
+
+andy::lang::timings::timings()
+{
+    s_counting++;
+}
+
+andy::lang::timings::~timings()
+{
+    s_counting--;
+}
+
+void andy::lang::timings::record(phase __phase)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_phases.push_back(std::move(__phase));
+}
+
+std::vector<andy::lang::timings::phase> andy::lang::timings::phases() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_phases;
+}
+
+void andy::lang::timings::write_report(std::ostream& __out) const
+{
+    std::vector<phase> all = phases();
+
+    phase total;
+    std::map<std::string, std::vector<const phase*>> files;
+
+    __out << std::fixed << std::setprecision(3);
+    __out << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms" << std::setw(14) << "allocations" << std::setw(16) << "bytes" << "  phase" << std::endl;
+
+    for(const phase& p : all) {
+        if(!p.file.empty()) {
+            files[p.file].push_back(&p);
+            continue;
+        }
+
+        write_phase(__out, p, p.name);
+
+        total.wall += p.wall;
+        total.cpu += p.cpu;
+        total.allocations += p.allocations;
+        total.allocated_bytes += p.allocated_bytes;
+    }
+
+    write_phase(__out, total, "total");
+
+    if(files.empty()) {
+        return;
+    }
+
+    __out << std::endl;
+    __out << std::setw(12) << "wall ms" << std::setw(12) << "cpu ms" << std::setw(14) << "allocations" << std::setw(16) << "bytes" << "  file" << std::endl;
+
+    for(const auto& [file, file_phases] : files) {
+        for(const phase* p : file_phases) {
+            write_phase(__out, *p, p->name + " " + file);
+        }
+    }
+}
+
+void andy::lang::timings::write_json(std::ostream& __out) const
+{
+    std::vector<phase> all = phases();
+
+    __out << "[\n";
+
+    for(size_t i = 0; i < all.size(); i++) {
+        const phase& p = all[i];
+
+        __out << "\t{ \"phase\": ";
+        write_json_string(__out, p.name);
+
+        if(!p.file.empty()) {
+            __out << ", \"file\": ";
+            write_json_string(__out, p.file);
+        }
+
+        __out << ", \"wall_ns\": " << p.wall.count() << ", \"cpu_ns\": " << p.cpu.count();
+        __out << ", \"allocations\": " << p.allocations << ", \"allocated_bytes\": " << p.allocated_bytes << " }";
+        __out << (i + 1 < all.size() ? ",\n" : "\n");
+    }
+
+    __out << "]\n";
+}
+
+andy::lang::timings::scope::scope(andy::lang::timings* __timings, std::string __name, std::string __file)
+    : m_timings(__timings)
+{
+    if(!m_timings) {
+        return;
+    }
+
+    m_phase.name = std::move(__name);
+    m_phase.file = std::move(__file);
+
+    m_allocations     = t_allocations;
+    m_allocated_bytes = t_allocated_bytes;
+    m_cpu  = cpu_time(!m_phase.file.empty());
+    m_wall = std::chrono::steady_clock::now();
+}
+
+void andy::lang::timings::scope::end()
+{
+    if(!m_timings) {
+        return;
+    }
+
+    m_phase.wall = std::chrono::steady_clock::now() - m_wall;
+    m_phase.cpu  = cpu_time(!m_phase.file.empty()) - m_cpu;
+    m_phase.allocations     = t_allocations - m_allocations;
+    m_phase.allocated_bytes = t_allocated_bytes - m_allocated_bytes;
+
+    m_timings->record(std::move(m_phase));
+    m_timings = nullptr;
+}
@@ -0,0 +1,211 @@
+#include <andy/lang/worker.hpp>
+#include <andy/lang/api.hpp>
+
+namespace
+{
+    // Arrays and dictionaries can reference themselves, the copy stops there instead of recursing forever
+    constexpr size_t max_message_depth = 256;
+
+    andy::lang::message copy_message(andy::lang::interpreter* __interpreter, const std::shared_ptr<andy::lang::object>& __object, bool __transfer, size_t __depth)
+    {
+        if(__depth > max_message_depth) {
+            throw std::runtime_error("Worker: the value is nested too deep to be sent, it may reference itself");
+        }
+
+        andy::lang::message message;
+
+        if(!__object) {
+            return message;
+        }
+
+        auto cls = __object->cls;
+
+        if(cls == __interpreter->NullClass) {
+        } else if(cls == __interpreter->TrueClass) {
+            message.value = true;
+        } else if(cls == __interpreter->FalseClass) {
+            message.value = false;
+        } else if(cls == __interpreter->IntegerClass) {
+            message.value = __object->as<int64_t>();
+        } else if(cls == __interpreter->BigIntegerClass) {
+            message.value = __object->as<andy::lang::big_integer>();
+        } else if(cls == __interpreter->FloatClass) {
+            message.value = __object->as<float>();
+        } else if(cls == __interpreter->DoubleClass) {
+            message.value = __object->as<double>();
+        } else if(cls == __interpreter->StringClass) {
+            std::string& value = __object->as<std::string>();
+
+            if(__transfer) {
+                message.value = std::move(value);
+                value.clear();
+            } else {
+                message.value = value;
+            }
+        } else if(cls == __interpreter->ArrayClass) {
+            auto& items = __object->as<std::vector<std::shared_ptr<andy::lang::object>>>();
+
+            andy::lang::message::array array;
+            array.reserve(items.size());
+
+            for(const auto& item : items) {
+                array.push_back(copy_message(__interpreter, item, __transfer, __depth + 1));
+            }
+
+            if(__transfer) {
+                items.clear();
+            }
+
+            message.value = std::move(array);
+        } else if(cls == __interpreter->DictionaryClass) {
+            auto& pairs = __object->as<andy::lang::dictionary>();
+
+            andy::lang::message::dictionary dictionary;
+            dictionary.reserve(pairs.size());
+
+            for(const auto& [key, value] : pairs) {
+                dictionary.emplace_back(copy_message(__interpreter, key, __transfer, __depth + 1), copy_message(__interpreter, value, __transfer, __depth + 1));
+            }
+
+            if(__transfer) {
+                pairs.clear();
+            }
+
+            message.value = std::move(dictionary);
+        } else {
+            throw std::runtime_error("Worker: a " + (cls ? cls->name : std::string("native")) + " object cannot be sent to another interpreter");
+        }
+
+        return message;
+    }
+};
+
+andy::lang::message andy::lang::message::from(andy::lang::interpreter* __interpreter, const std::shared_ptr<andy::lang::object>& __object, bool __transfer)
+{
+    return copy_message(__interpreter, __object, __transfer, 0);
+}
+
+std::shared_ptr<andy::lang::object> andy::lang::message::to_object(andy::lang::interpreter* __interpreter) &&
+{
+    return std::visit([__interpreter](auto&& value) -> std::shared_ptr<andy::lang::object> {
+        using T = std::decay_t<decltype(value)>;
+
+        if constexpr(std::is_same_v<T, std::monostate>) {
+            return std::make_shared<andy::lang::object>(__interpreter->NullClass);
+        } else if constexpr(std::is_same_v<T, bool>) {
+            return std::make_shared<andy::lang::object>(value ? __interpreter->TrueClass : __interpreter->FalseClass);
+        } else if constexpr(std::is_same_v<T, int64_t>) {
+            return andy::lang::object::create(__interpreter, __interpreter->IntegerClass, value);
+        } else if constexpr(std::is_same_v<T, andy::lang::big_integer>) {
+            return andy::lang::object::create(__interpreter, __interpreter->BigIntegerClass, std::move(value));
+        } else if constexpr(std::is_same_v<T, float>) {
+            return andy::lang::object::create(__interpreter, __interpreter->FloatClass, value);
+        } else if constexpr(std::is_same_v<T, double>) {
+            return andy::lang::object::create(__interpreter, __interpreter->DoubleClass, value);
+        } else if constexpr(std::is_same_v<T, std::string>) {
+            return andy::lang::object::create(__interpreter, __interpreter->StringClass, std::move(value));
+        } else if constexpr(std::is_same_v<T, andy::lang::message::array>) {
+            std::vector<std::shared_ptr<andy::lang::object>> items;
+            items.reserve(value.size());
+
+            for(auto& item : value) {
+                items.push_back(std::move(item).to_object(__interpreter));
+            }
+
+            return andy::lang::object::create(__interpreter, __interpreter->ArrayClass, std::move(items));
+        } else {
+            andy::lang::dictionary pairs;
+            pairs.reserve(value.size());
+
+            for(auto& [key, item] : value) {
+                pairs.emplace_back(std::move(key).to_object(__interpreter), std::move(item).to_object(__interpreter));
+            }
+
+            return andy::lang::object::create(__interpreter, __interpreter->DictionaryClass, std::move(pairs));
+        }
+    }, std::move(value));
+}
+
+andy::lang::worker::worker(std::filesystem::path __path, andy::lang::interpreter* __creator)
+    : m_path(__creator->resolve(__path)), m_inbox(channel_capacity), m_outbox(channel_capacity), m_creator_output(__creator->output)
+{
+    m_thread = std::thread(&andy::lang::worker::run, this, __creator->working_directory);
+}
+
+andy::lang::worker::~worker()
+{
+    // A worker waiting on a channel sees it closed and ends
+    m_inbox.close();
+    m_outbox.close();
+
+    if(m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void andy::lang::worker::run(std::filesystem::path __working_directory)
+{
+    try {
+        andy::lang::api::engine engine;
+        andy::lang::interpreter& interpreter = engine.interpreter();
+
+        interpreter.worker = this;
+        interpreter.working_directory = std::move(__working_directory);
+        interpreter.input_file_path = m_path;
+
+        // std::cout can be written by many threads, any other stream is only written by the creator
+        if(m_creator_output != &std::cout) {
+            interpreter.output = &m_output;
+        }
+
+        auto result = engine.run(engine.compile(m_path));
+
+        if(result) {
+            m_result = andy::lang::message::from(&interpreter, result, true);
+        }
+    } catch(const std::exception& e) {
+        m_error = e.what();
+
+        if(m_error.empty()) {
+            m_error = "unknown error";
+        }
+    }
+
+    // Publishes the result and the error to the creator
+    m_inbox.close();
+    m_outbox.close();
+}
+
+bool andy::lang::worker::send(andy::lang::message __message)
+{
+    return m_inbox.push(std::move(__message));
+}
+
+std::optional<andy::lang::message> andy::lang::worker::receive()
+{
+    std::optional<andy::lang::message> message = m_outbox.pop();
+
+    if(!message && !m_error.empty()) {
+        throw std::runtime_error("worker " + m_path.string() + ": " + m_error);
+    }
+
+    return message;
+}
+
+andy::lang::message andy::lang::worker::join()
+{
+    if(m_thread.joinable()) {
+        m_thread.join();
+
+        if(m_output.tellp() > 0) {
+            *m_creator_output << m_output.str();
+            m_output.str({});
+        }
+    }
+
+    if(!m_error.empty()) {
+        throw std::runtime_error("worker " + m_path.string() + ": " + m_error);
+    }
+
+    return std::move(m_result);
+}
@@ -0,0 +1,77 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/call_stats.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+describe of("call_stats", []() {
+  std::filesystem::path path = std::filesystem::temp_directory_path() / "andy_call_stats_spec" / "main.andy";
+  write_file(path, "function work(n)\n{\n    var x = n * 3;\n    return x % 7;\n}\nfor(var i = 0; i < 15; i++) {\n    work(i);\n}\n");
+
+  andy::lang::call_stats stats;
+
+  andy::lang::api::options options;
+  options.call_stats = &stats;
+  andy::lang::api::evaluate(path, options);
+
+  std::vector<andy::lang::call_stats::entry> entries = stats.entries();
+
+  auto find = [&](std::string_view cls, std::string_view method) -> const andy::lang::call_stats::entry* {
+    for(const auto& entry : entries) {
+      if(entry.cls == cls && entry.method == method) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  };
+
+  describe("entries", [&]() {
+    it("should count the calls of andy and native methods", [&]() {
+      expect(find("", "work") != nullptr).to<eq>(true);
+      expect(find("", "work")->calls).to<eq>(15);
+      expect(find("", "work")->native).to<eq>(false);
+      expect(find("Integer", "*")->calls).to<eq>(15);
+      expect(find("Integer", "*")->native).to<eq>(true);
+    });
+    it("should not count the methods called in the exclusive time", [&]() {
+      const auto* work = find("", "work");
+      expect(work->inclusive > work->exclusive).to<eq>(true);
+    });
+    it("should count the time of a recursion once", [&]() {
+      andy::lang::method method("down", andy::lang::method_storage_type::instance_method, std::vector<std::string>{}, nullptr);
+      andy::lang::call_stats recursion;
+
+      recursion.enter(method, nullptr);
+      recursion.enter(method, nullptr);
+      recursion.leave();
+      recursion.leave();
+
+      auto down = recursion.entries().at(0);
+      expect(down.calls).to<eq>(2);
+      expect(down.inclusive).to<eq>(down.exclusive);
+    });
+    it("should sort by exclusive time", [&]() {
+      bool sorted = true;
+      for(size_t i = 1; i < entries.size(); i++) {
+        sorted = sorted && entries[i - 1].exclusive >= entries[i].exclusive;
+      }
+      expect(sorted).to<eq>(true);
+    });
+  });
+  describe("write_json", [&]() {
+    it("should write one object per method", [&]() {
+      std::ostringstream json;
+      stats.write_json(json);
+      expect(json.str().find("\"method\": \"work\", \"native\": false, \"calls\": 15") != std::string::npos).to<eq>(true);
+    });
+  });
+});
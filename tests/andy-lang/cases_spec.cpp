@@ -0,0 +1,194 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/thread_pool.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+// Runs tests/andy/cases in this process. Every case gets its own interpreter and output stream, so the
+// cases run on a thread pool. The time of each case is written to andy_cases_timings.json in the build
+// directory. If ANDY_CASES_BASELINE names such a file, the cases run one at a time, so that they do not slow
+// each other down, and a case which got slower than ANDY_CASES_THRESHOLD percent (50 by default) fails.
+
+struct case_result
+{
+  int code = 0;
+  std::string output;
+  double milliseconds = 0;
+};
+
+static std::string read_file(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// The same exit code and output as running the andy executable with its output redirected
+static case_result run_case(const std::filesystem::path& path)
+{
+  case_result result;
+  std::ostringstream output;
+
+  andy::lang::api::options options;
+  options.output = &output;
+
+  auto start = std::chrono::steady_clock::now();
+
+  try {
+    std::shared_ptr<andy::lang::object> ret = andy::lang::api::evaluate(path, options);
+
+    if(ret) {
+      result.code = ret->as<int64_t>() & 0xff;
+    }
+  } catch(const std::exception& e) {
+    output << e.what() << std::endl;
+    result.code = 1;
+  }
+
+  auto end = std::chrono::steady_clock::now();
+
+  result.output = output.str();
+  result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+  return result;
+}
+
+// The timings of a previous run, one case per line
+static std::map<std::string, double> read_timings(const std::filesystem::path& path)
+{
+  std::map<std::string, double> timings;
+  std::ifstream file(path);
+  std::string line;
+
+  while(std::getline(file, line)) {
+    size_t name_start = line.find("\"case\": \"");
+    size_t time_start = line.find("\"milliseconds\": ");
+
+    if(name_start == std::string::npos || time_start == std::string::npos) {
+      continue;
+    }
+
+    name_start += 9;
+    std::string name = line.substr(name_start, line.find('"', name_start) - name_start);
+
+    timings[name] = std::stod(line.substr(time_start + 16));
+  }
+
+  return timings;
+}
+
+static std::string escape(std::string_view text)
+{
+  std::string escaped;
+  escaped.reserve(text.size() * 2);
+  for(char c : text) {
+    if(c == '\n') {
+      escaped += "\\n";
+    } else if(c == '\r') {
+      escaped += "\\r";
+    } else if(c == '\t') {
+      escaped += "\\t";
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+
+static std::string format_milliseconds(double milliseconds)
+{
+  std::ostringstream out;
+  out.precision(2);
+  out << std::fixed << milliseconds << "ms";
+  return out.str();
+}
+
+describe of("cases", []() {
+  std::filesystem::path cases_path = std::filesystem::path(ANDYLANG_PROJECT_DIR) / "tests" / "andy" / "cases";
+
+  std::vector<std::filesystem::path> cases;
+
+  for(const auto& entry : std::filesystem::recursive_directory_iterator(cases_path)) {
+    if(entry.is_regular_file() && entry.path().extension() == ".andy") {
+      cases.push_back(entry.path());
+    }
+  }
+
+  std::sort(cases.begin(), cases.end());
+
+  std::map<std::string, double> baseline;
+  double threshold = 50;
+  const char* baseline_path = std::getenv("ANDY_CASES_BASELINE");
+
+  if(baseline_path) {
+    baseline = read_timings(baseline_path);
+  }
+
+  if(const char* threshold_value = std::getenv("ANDY_CASES_THRESHOLD")) {
+    threshold = std::stod(threshold_value);
+  }
+
+  std::vector<case_result> results(cases.size());
+
+  auto start = std::chrono::steady_clock::now();
+
+  // A pool of one thread runs the cases in order on this thread
+  andy::lang::thread_pool pool(baseline_path ? 1 : 0);
+  pool.parallel_for(cases.size(), [&](size_t i) {
+    results[i] = run_case(cases[i]);
+  });
+
+  auto end = std::chrono::steady_clock::now();
+
+  std::ofstream timings(std::filesystem::path(ANDYLANG_BUILD_DIR) / "andy_cases_timings.json");
+  timings << "{\n\t\"threads\": " << pool.size() << ",\n";
+  timings << "\t\"milliseconds\": " << std::chrono::duration<double, std::milli>(end - start).count() << ",\n";
+  timings << "\t\"cases\": [\n";
+
+  for(size_t i = 0; i < cases.size(); i++) {
+    std::string name = std::filesystem::relative(cases[i], cases_path).generic_string();
+    const case_result& result = results[i];
+
+    timings << "\t\t{ \"case\": \"" << name << "\", \"milliseconds\": " << result.milliseconds << " }" << (i + 1 < cases.size() ? ",\n" : "\n");
+
+    context(name, [&]() {
+      std::string stem = cases[i].stem().string();
+
+      if(isdigit(stem[0])) {
+        int expected = std::stoi(stem);
+
+        it("should return " + std::to_string(expected), [&]() {
+          expect(result.code).to<eq>(expected);
+        });
+      } else {
+        std::filesystem::path expected_path = cases[i];
+        expected_path.replace_extension(".cout");
+        std::string expected = read_file(expected_path);
+
+        it("should print '" + escape(expected) + "'", [&]() {
+          expect(result.output).to<eq>(expected);
+        });
+      }
+
+      auto previous = baseline.find(name);
+
+      if(previous != baseline.end()) {
+        // Cases which take less than a millisecond are within the noise of the machine
+        double allowed = std::max(previous->second * (1 + threshold / 100), previous->second + 1);
+
+        it("should not take longer than " + format_milliseconds(allowed), [&]() {
+          expect(result.milliseconds <= allowed).to<eq>(true);
+        });
+      }
+    });
+  }
+
+  timings << "\t]\n}\n";
+});
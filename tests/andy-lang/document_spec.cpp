@@ -0,0 +1,112 @@
+#include <andy/tests.hpp>
+#include <andy/lang/document.hpp>
+
+#include <random>
+
+static std::string dump(const andy::lang::lexer::token& token)
+{
+  // The type of the tokens created by the parser is not initialized
+  std::string result(token.content());
+  result += '@';
+  result += std::to_string(token.start.line);
+  result += ':';
+  result += std::to_string(token.start.column);
+  result += ':';
+  result += std::to_string(token.start.offset);
+  result += '-';
+  result += std::to_string(token.end.offset);
+  return result;
+}
+
+static std::string dump(const andy::lang::parser::ast_node& node)
+{
+  std::string result = std::to_string((int)node.type());
+  result += '[';
+  result += dump(node.token());
+  result += '(';
+  for(const auto& child : node.childrens()) {
+    result += dump(child);
+  }
+  result += ")]";
+  return result;
+}
+
+static std::string dump(const andy::lang::document& document)
+{
+  std::string result;
+  for(const auto& token : document.lexer().tokens()) {
+    result += dump(token);
+    result += '\n';
+  }
+  for(const auto& declaration : document.declarations()) {
+    result += std::to_string(declaration.first_token);
+    result += '+';
+    result += std::to_string(declaration.token_count);
+    result += dump(declaration.node);
+    result += '\n';
+  }
+  result += document.error();
+  return result;
+}
+
+describe of("document", []() {
+  std::string source =
+    "class Point {\n"
+    "  var x = 0;\n"
+    "  var y = 0;\n"
+    "  function length() {\n"
+    "    return x * x + y * y;\n"
+    "  }\n"
+    "};\n"
+    "\n"
+    "function greet(name) {\n"
+    "  puts(\"hello ${name}\\n\");\n"
+    "}\n"
+    "\n"
+    "var p = new Point();\n"
+    "greet('world');\n";
+
+  describe("edit", [&]() {
+    it("should match a fresh document after an edit inside a declaration", [&]() {
+      andy::lang::document document("document_spec.andy", source);
+      size_t offset = source.find("x * x");
+      document.edit(offset, 1, "width");
+
+      std::string edited = source;
+      edited.replace(offset, 1, "width");
+      andy::lang::document fresh("document_spec.andy", edited);
+
+      expect(dump(document)).to<eq>(dump(fresh));
+    });
+    it("should reuse the declarations after the damage", [&]() {
+      andy::lang::document document("document_spec.andy", source);
+      const auto& stats = document.edit(source.find("0;"), 1, "42");
+
+      expect(stats.parsed_declarations).to<eq>(1);
+      expect(stats.reused_declarations).to<eq>(document.declarations().size() - 1);
+      expect(stats.lexed_tokens < document.lexer().tokens().size()).to<eq>(true);
+      expect(document.error()).to<eq>("");
+    });
+    it("should match a fresh document after random edits", [&]() {
+      std::mt19937 random(1234);
+      std::vector<std::string_view> insertions = { "", "a", " ", "\n", "1", "var z = 3;\n", "(", ")", "\"", "}", "'s'", "# " };
+
+      andy::lang::document document("document_spec.andy", source);
+      std::string current = source;
+
+      for(int i = 0; i < 200; i++) {
+        size_t offset = random() % (current.size() + 1);
+        size_t removed = std::min<size_t>(random() % 4, current.size() - offset);
+        std::string_view inserted = insertions[random() % insertions.size()];
+
+        document.edit(offset, removed, inserted);
+        current.replace(offset, removed, inserted);
+
+        andy::lang::document fresh("document_spec.andy", current);
+
+        expect(std::string(document.source())).to<eq>(current);
+        expect(dump(document)).to<eq>(dump(fresh));
+      }
+    });
+  });
+});
@@ -0,0 +1,130 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+
+#include <sstream>
+
+describe of("engine", []() {
+  describe("run", []() {
+    it("should run a program many times with its bindings", []() {
+      andy::lang::api::engine engine;
+      auto program = engine.compile_source("return limit * 2;\n");
+
+      expect(engine.run(program, { { "limit", engine.make(3) } })->as<int64_t>()).to<eq>(6);
+      expect(engine.run(program, { { "limit", engine.make(21) } })->as<int64_t>()).to<eq>(42);
+    });
+    it("should start every run from empty globals", []() {
+      andy::lang::api::engine engine;
+      auto first  = engine.compile_source("var seen = 1;\n");
+      auto second = engine.compile_source("return seen;\n");
+
+      engine.run(first);
+
+      std::string message;
+      try {
+        engine.run(second);
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("'seen' is undefined");
+    });
+    it("should declare the classes of a program once", []() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+
+      auto program = engine.compile_source("class Rule\n{\n    function name()\n    {\n        return \"rule\";\n    }\n}\nvar rule = new Rule();\nputs(rule.name());\n");
+
+      for(int i = 0; i < 3; i++) {
+        engine.run(program);
+      }
+
+      expect(output.str()).to<eq>("rule\nrule\nrule\n");
+      expect(engine.interpreter().find_class("Rule") != nullptr).to<eq>(true);
+    });
+  });
+  describe("unload", []() {
+    it("should reject a class declared by another loaded program until that program is unloaded", []() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+
+      auto first  = engine.compile_source("class Rule\n{\n    function name()\n    {\n        return \"first\";\n    }\n}\nvar rule = new Rule();\nputs(rule.name());\n");
+      auto second = engine.compile_source("class Rule\n{\n    function name()\n    {\n        return \"second\";\n    }\n}\nvar rule = new Rule();\nputs(rule.name());\n");
+
+      engine.run(first);
+
+      std::string message;
+      try {
+        engine.run(second);
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message.find("class Rule is already declared") != std::string::npos).to<eq>(true);
+
+      engine.unload(first);
+      expect(engine.interpreter().find_class("Rule") == nullptr).to<eq>(true);
+
+      engine.run(second);
+      expect(output.str()).to<eq>("first\nsecond\n");
+    });
+    it("should release the program", []() {
+      andy::lang::api::engine engine;
+      auto program = engine.compile_source("class Rule\n{\n}\nfunction check()\n{\n    return 1;\n}\n");
+      std::weak_ptr<andy::lang::api::program> weak = program;
+
+      engine.run(program);
+      engine.unload(program);
+      program.reset();
+
+      expect(weak.expired()).to<eq>(true);
+
+      std::string message;
+      try {
+        engine.call("check");
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("function check not found");
+    });
+  });
+  describe("interpreter", []() {
+    it("should create a lazy builtin class the first time C++ uses it, as a script would", []() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+
+      auto path = andy::lang::object::create(&engine.interpreter(), engine.interpreter().PathClass(), std::filesystem::path("rules"));
+
+      expect(path->cls == engine.interpreter().find_class("Path")).to<eq>(true);
+
+      engine.run(engine.compile_source("puts(path.to_string());\n"), { { "path", path } });
+
+      expect(output.str()).to<eq>("rules\n");
+    });
+  });
+  describe("call", []() {
+    it("should call a function of the last run with typed arguments", []() {
+      andy::lang::api::engine engine;
+      engine.run(engine.compile_source("function scale(value, factor)\n{\n    return value * factor;\n}\nfunction greet(name)\n{\n    return \"hello \" + name;\n}\n"));
+
+      expect(engine.call("scale", 4, 5)->as<int64_t>()).to<eq>(20);
+      expect(engine.call("greet", std::string("andy"))->as<std::string>()).to<eq>("hello andy");
+    });
+    it("should fail for an unknown function", []() {
+      andy::lang::api::engine engine;
+      engine.run(engine.compile_source("var x = 1;\n"));
+
+      std::string message;
+      try {
+        engine.call("missing");
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("function missing not found");
+    });
+  });
+});
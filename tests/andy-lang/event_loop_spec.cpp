@@ -0,0 +1,91 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/event_loop.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+
+describe of("event_loop", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_event_loop_spec";
+  std::filesystem::remove_all(root);
+  std::filesystem::create_directories(root);
+
+  describe("operations", [&]() {
+    it("should overlap many operations", [&]() {
+      andy::lang::event_loop loop;
+      std::vector<andy::lang::event_loop::handle> operations;
+
+      auto start = std::chrono::steady_clock::now();
+
+      for(int i = 0; i < 200; i++) {
+        operations.push_back(loop.timer(std::chrono::milliseconds(100)));
+      }
+      for(int i = 0; i < 20; i++) {
+        operations.push_back(loop.run_process("sleep 0.1; echo " + std::to_string(i), {}, root));
+      }
+
+      loop.run();
+
+      auto elapsed = std::chrono::steady_clock::now() - start;
+
+      expect(loop.pending()).to<eq>((size_t)0);
+      expect(operations.back()->data).to<eq>("19\n");
+      // One after the other they take 22 seconds. Far less means they overlapped, however loaded the machine is
+      auto serial = std::chrono::milliseconds(100) * operations.size();
+
+      expect(elapsed < serial / 4).to<eq>(true);
+    });
+    it("should read and write files on its threads", [&]() {
+      andy::lang::event_loop loop;
+
+      auto write = loop.write_file(root / "data.txt", "contents");
+      loop.wait(write);
+      auto read = loop.read_file(root / "data.txt");
+      auto missing = loop.read_file(root / "missing.txt");
+      loop.run();
+
+      expect(write->value).to<eq>((int64_t)8);
+      expect(read->data).to<eq>("contents");
+      expect(missing->error).to<eq>("could not open " + (root / "missing.txt").string());
+    });
+    it("should write the input of a process and read its output", [&]() {
+      andy::lang::event_loop loop;
+
+      auto process = loop.run_process("tr a-z A-Z; exit 2", "loud", root);
+      loop.wait(process);
+
+      expect(process->data).to<eq>("LOUD");
+      expect(process->value).to<eq>((int64_t)2);
+    });
+  });
+  describe("Async", [&]() {
+    it("should talk over loopback TCP and UNIX sockets", [&]() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+      engine.interpreter().working_directory = root;
+
+      engine.run(engine.compile_source(
+        "var server = Async.listen(0);\nvar accepting = server.accept();\nvar client = Async.connect(server.port()).wait();\nvar connection = accepting.wait();\n"
+        "client.write(\"ping\").wait();\nputs(connection.read().wait());\nconnection.write(\"pong\").wait();\nputs(client.read().wait());\n"
+        "client.close();\nputs(connection.read().wait().size().to_string());\n"
+        "var unix_server = Async.listen_unix(\"andy.sock\");\nvar unix_accepting = unix_server.accept();\nvar unix_client = Async.connect_unix(\"andy.sock\").wait();\n"
+        "unix_client.write(\"over unix\").wait();\nputs(unix_accepting.wait().read().wait());\n"));
+
+      expect(output.str()).to<eq>("ping\npong\n0\nover unix\n");
+    });
+    it("should wait for files, processes and timers started together", [&]() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+      engine.interpreter().working_directory = root;
+
+      engine.run(engine.compile_source(
+        "var write = Async.write(\"async.txt\", \"written\");\nvar timer = Async.sleep(50);\nvar process = Async.system(\"echo run\");\n"
+        "puts(write.wait().to_string());\nputs(Async.read(\"async.txt\").wait());\nputs(process.wait());\ntimer.wait();\nif(timer.done?()) {\n    puts(\"done\");\n}\n"));
+
+      expect(output.str()).to<eq>("7\nwritten\nrun\n\ndone\n");
+    });
+  });
+});
@@ -0,0 +1,71 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+
+#include <chrono>
+#include <sstream>
+
+static std::string run_fiber_source(const std::string& source)
+{
+  andy::lang::api::engine engine;
+  std::ostringstream output;
+  engine.interpreter().output = &output;
+
+  engine.run(engine.compile_source(source));
+
+  return output.str();
+}
+
+describe of("fiber", []() {
+  describe("spawn", []() {
+    it("should run fibers while the program waits and join their results", []() {
+      expect(run_fiber_source(
+        "function count(name) {\n    puts(name + \" 1\");\n    Fiber.pass();\n    puts(name + \" 2\");\n    return name;\n}\n"
+        "var a = spawn(\"count\", \"a\");\nvar b = spawn(\"count\", \"b\");\nputs(\"spawned\");\nputs(join(b));\nputs(a.join());\n"))
+        .to<eq>("spawned\na 1\nb 1\na 2\nb 2\nb\na\n");
+    });
+    it("should rethrow the error of a fiber when it is joined", []() {
+      std::string error;
+
+      try {
+        run_fiber_source("function fail(argument) {\n    missing();\n}\nvar fiber = spawn(\"fail\", null);\njoin(fiber);\n");
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error.empty()).to<eq>(false);
+    });
+  });
+  describe("Channel", []() {
+    it("should pass values between fibers, waiting while it is full or empty", []() {
+      expect(run_fiber_source(
+        "function produce(channel) {\n    var i = 0;\n    while(i < 5) {\n        channel.send(i + 1);\n        i = i + 1;\n    }\n}\n"
+        "function consume(channel) {\n    var total = 0;\n    var count = 0;\n    while(count < 5) {\n        total = total + channel.receive();\n        count = count + 1;\n    }\n    return total;\n}\n"
+        "var channel = new Channel(2);\nvar consumer = spawn(\"consume\", channel);\nspawn(\"produce\", channel);\nputs(consumer.join().to_string());\n"))
+        .to<eq>("15\n");
+    });
+    it("should report when every fiber waits forever", []() {
+      std::string error;
+
+      try {
+        run_fiber_source("function wait(channel) {\n    channel.receive();\n}\nvar fiber = spawn(\"wait\", new Channel(1));\nfiber.join();\n");
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error).to<eq>("Fiber: every fiber is waiting and nothing can wake them up");
+    });
+  });
+  describe("Async", []() {
+    it("should run ten thousand fibers waiting for timers at once", []() {
+      auto start = std::chrono::steady_clock::now();
+
+      expect(run_fiber_source(
+        "function task(channel) {\n    Async.sleep(50).wait();\n    channel.send(1);\n}\n"
+        "var channel = new Channel(16);\nvar i = 0;\nwhile(i < 10000) {\n    spawn(\"task\", channel);\n    i = i + 1;\n}\n"
+        "var received = 0;\nwhile(received < 10000) {\n    channel.receive();\n    received = received + 1;\n}\nputs(Fiber.count().to_string());\nFiber.run();\nputs(Fiber.count().to_string());\n"))
+        .to<eq>("0\n0\n");
+
+      expect(std::chrono::steady_clock::now() - start < std::chrono::seconds(10)).to<eq>(true);
+    });
+  });
+});
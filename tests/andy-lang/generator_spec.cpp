@@ -0,0 +1,87 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/coroutine.hpp>
+
+#include <sstream>
+
+static std::string run_generator_source(const std::string& source)
+{
+  andy::lang::api::engine engine;
+  std::ostringstream output;
+  engine.interpreter().output = &output;
+
+  engine.run(engine.compile_source(source));
+
+  return output.str();
+}
+
+describe of("generator", []() {
+  describe("coroutine", []() {
+    it("should resume where it suspended", []() {
+      std::vector<int> steps;
+
+      andy::lang::coroutine coroutine([&]() {
+        steps.push_back(1);
+        andy::lang::coroutine::suspend();
+        steps.push_back(2);
+      });
+
+      coroutine.resume();
+      steps.push_back(0);
+      coroutine.resume();
+
+      expect(steps).to<eq>(std::vector<int>{ 1, 0, 2 });
+      expect(coroutine.done()).to<eq>(true);
+    });
+    it("should rethrow what it throws and unwind when destroyed suspended", []() {
+      auto alive = std::make_shared<int>(0);
+
+      {
+        andy::lang::coroutine coroutine([alive]() {
+          auto held = alive;
+          andy::lang::coroutine::suspend();
+        });
+
+        coroutine.resume();
+        expect(alive.use_count()).to<eq>((long)3);
+      }
+
+      expect(alive.use_count()).to<eq>((long)1);
+
+      andy::lang::coroutine failing([]() {
+        throw std::runtime_error("failed");
+      });
+
+      std::string error;
+
+      try {
+        failing.resume();
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error).to<eq>("failed");
+    });
+  });
+  describe("yield", []() {
+    it("should run the function only when a value is asked for", []() {
+      expect(run_generator_source(
+        "function numbers(count) {\n    puts(\"start\");\n    var i = 0;\n    while(i < count) {\n        yield i;\n        i = i + 1;\n    }\n}\n"
+        "var values = numbers(3);\nputs(\"created\");\nputs(values.next().to_string());\nputs(values.next().to_string());\nputs(values.next().to_string());\n"
+        "if(values.done?()) {\n    puts(\"done\");\n}\n"))
+        .to<eq>("created\nstart\n0\n1\n2\ndone\n");
+    });
+    it("should be consumed lazily by foreach", []() {
+      expect(run_generator_source(
+        "function naturals() {\n    var i = 0;\n    while(true) {\n        yield i;\n        i = i + 1;\n    }\n}\n"
+        "var numbers = naturals();\nforeach(var n : numbers) {\n    if(n == 3) {\n        break;\n    }\n    puts(n.to_string());\n}\n"))
+        .to<eq>("0\n1\n2\n");
+    });
+    it("should keep the generators of a function apart", []() {
+      expect(run_generator_source(
+        "function letters(prefix) {\n    yield prefix + \"a\";\n    yield prefix + \"b\";\n}\n"
+        "var x = letters(\"x\");\nvar y = letters(\"y\");\nputs(x.next());\nputs(y.next());\nputs(y.next());\nputs(x.next());\nputs(x.to_array().size().to_string());\n"))
+        .to<eq>("xa\nya\nyb\nxb\n0\n");
+    });
+  });
+});
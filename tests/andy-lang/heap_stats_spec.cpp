@@ -0,0 +1,72 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/heap_stats.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+static std::string read_file(const std::filesystem::path& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+describe of("heap_stats", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_heap_stats_spec";
+  std::filesystem::path snapshot_path = root / "snapshot.json";
+  std::filesystem::remove_all(root);
+
+  write_file(root / "main.andy", "class Node\n{\n    function new()\n    {\n    }\n}\nfor(var i = 0; i < 10; i++) {\n    var node = new Node();\n}\nheap_snapshot(\"" + snapshot_path.generic_string() + "\");\n");
+
+  andy::lang::heap_stats stats;
+
+  andy::lang::api::options options;
+  options.heap_stats = &stats;
+  andy::lang::api::evaluate(root / "main.andy", options);
+
+  auto find = [](const std::vector<andy::lang::heap_stats::entry>& entries, std::string_view cls) -> andy::lang::heap_stats::entry {
+    for(const auto& entry : entries) {
+      if(entry.cls == cls) {
+        return entry;
+      }
+    }
+    return {};
+  };
+
+  describe("classes", [&]() {
+    it("should count the objects allocated per class", [&]() {
+      auto node = find(stats.classes(), "Node");
+      expect(node.allocated_objects).to<eq>(10);
+      expect(node.allocated_bytes >= 10 * sizeof(andy::lang::object)).to<eq>(true);
+    });
+    it("should not count the objects of the interpreter", [&]() {
+      expect(find(stats.classes(), "Class").allocated_objects).to<eq>(0);
+    });
+    it("should keep the peak", [&]() {
+      expect(stats.peak_bytes() >= stats.live_bytes()).to<eq>(true);
+      expect(stats.peak_bytes() > 0).to<eq>(true);
+    });
+  });
+  describe("sites", [&]() {
+    it("should attribute the objects to their source line", [&]() {
+      auto node = find(stats.sites(), "Node");
+      expect(node.site).to<eq>("main.andy:8");
+    });
+  });
+  describe("heap_snapshot", [&]() {
+    it("should write a snapshot while the program runs", [&]() {
+      std::string snapshot = read_file(snapshot_path);
+      expect(snapshot.find("\"class\": \"Node\", \"site\": \"main.andy:8\"") != std::string::npos).to<eq>(true);
+    });
+  });
+});
@@ -0,0 +1,84 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+describe of("image", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_image_spec";
+  std::filesystem::remove_all(root);
+
+  write_file(root / "boot.andy",
+    "class Greeter\n{\n    function greet()\n    {\n        return \"hello\";\n    }\n}\n"
+    "function twice(n)\n{\n    return n * 2;\n}\n"
+    "var count = 0;\nwhile(count < 100) {\n    count = count + 1;\n}\n"
+    "var names = [\"a\", \"b\"];\nvar same = names;\nvar settings = { \"mode\": \"fast\" };\nvar greeter = new Greeter();\n"
+    "puts(\"boot\");\n");
+  write_file(root / "main.andy",
+    "puts(count.to_string());\nputs(same[1]);\nputs(settings[\"mode\"]);\nputs(greeter.greet());\n"
+    "var doubled = twice(4);\nputs(doubled.to_string());\n");
+  write_file(root / "path.andy", "var temp = new Path(\"/tmp\");\n");
+
+  describe("store_image", [&]() {
+    it("should restore the globals, functions and classes without running the boot program", [&]() {
+      std::ostringstream boot_output;
+      andy::lang::api::options boot_options;
+      boot_options.output = &boot_output;
+      boot_options.store_image = root / "boot.image";
+      andy::lang::api::evaluate(root / "boot.andy", boot_options);
+
+      std::ostringstream output;
+      andy::lang::api::options options;
+      options.output = &output;
+      options.image = root / "boot.image";
+      andy::lang::api::evaluate(root / "main.andy", options);
+
+      expect(boot_output.str()).to<eq>("boot\n");
+      expect(output.str()).to<eq>("100\nb\nfast\nhello\n8\n");
+    });
+    it("should refuse a global it cannot store", [&]() {
+      andy::lang::api::options options;
+      options.store_image = root / "path.image";
+
+      std::string message;
+      try {
+        andy::lang::api::evaluate(root / "path.andy", options);
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("image: the global temp references a Path object, which cannot be stored");
+    });
+  });
+  describe("image", [&]() {
+    it("should be out of date once the boot program changes", [&]() {
+      andy::lang::api::options boot_options;
+      std::ostringstream boot_output;
+      boot_options.output = &boot_output;
+      boot_options.store_image = root / "changed.image";
+      andy::lang::api::evaluate(root / "boot.andy", boot_options);
+
+      write_file(root / "boot.andy", "var count = 1;\n");
+
+      andy::lang::api::options options;
+      options.image = root / "changed.image";
+
+      bool thrown = false;
+      try {
+        andy::lang::api::evaluate(root / "main.andy", options);
+      } catch(const std::exception&) {
+        thrown = true;
+      }
+
+      expect(thrown).to<eq>(true);
+    });
+  });
+});
@@ -0,0 +1,72 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/big_integer.hpp>
+
+#include <sstream>
+
+static std::string run_integer_source(const std::string& source)
+{
+  andy::lang::api::engine engine;
+  std::ostringstream output;
+  engine.interpreter().output = &output;
+
+  engine.run(engine.compile_source(source));
+
+  return output.str();
+}
+
+describe of("integer", []() {
+  describe("Integer", []() {
+    it("should hold 64 bits", []() {
+      expect(run_integer_source("var a = 3000000000;\nvar b = a * 2;\nputs(b.to_string());\n"))
+        .to<eq>("6000000000\n");
+    });
+    it("should become a BigInteger when a result overflows, and an Integer again when it fits", []() {
+      expect(run_integer_source(
+        "var a = 9223372036854775807;\nvar b = a + 1;\nputs(b.to_string());\nvar c = b - 1;\nputs(c.to_string());\n"
+        "var n = 0 - a;\nvar d = n - 2;\nputs(d.to_string());\nvar e = 9223372036854775807;\ne++;\nputs(e.to_string());\n"))
+        .to<eq>("9223372036854775808\n9223372036854775807\n-9223372036854775809\n9223372036854775808\n");
+    });
+    it("should multiply past 64 bits", []() {
+      expect(run_integer_source(
+        "var f = 1;\nfor(var i = 1; i < 31; i++) {\n    f = f * i;\n}\nputs(f.to_string());\n"
+        "var p = 1;\nfor(var i = 0; i < 200; i++) {\n    p *= 2;\n}\nputs(p.to_string());\nvar q = p / f;\nputs(q.to_string());\n"))
+        .to<eq>("265252859812191058636308480000000\n1606938044258990275541962092341162602522202993782792835301376\n6058136547130019586198394050\n");
+    });
+    it("should read the literals and the strings which do not fit in 64 bits", []() {
+      expect(run_integer_source(
+        "var x = 123456789012345678901234567890;\nvar y = x + 1;\nputs(y.to_string());\n"
+        "var z = \"99999999999999999999\".to_integer();\nvar w = z + 1;\nputs(w.to_string());\n"))
+        .to<eq>("123456789012345678901234567891\n100000000000000000000\n");
+    });
+    it("should throw on a division by zero", []() {
+      std::string error;
+
+      try {
+        run_integer_source("var a = 1;\nvar b = a / 0;\n");
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error.find("division by zero") != std::string::npos).to<eq>(true);
+    });
+  });
+  describe("big_integer", []() {
+    it("should multiply operands above the Karatsuba threshold like the schoolbook method", []() {
+      andy::lang::big_integer a = andy::lang::big_integer::parse(std::string(700, '7'));
+      andy::lang::big_integer b = andy::lang::big_integer::parse("-" + std::string(500, '3'));
+      andy::lang::big_integer product = a * b;
+
+      expect(product / b == a).to<eq>(true);
+      expect((product % a).is_zero()).to<eq>(true);
+      expect((a * a - a * (a - 1)) == a).to<eq>(true);
+    });
+    it("should divide truncating toward zero", []() {
+      andy::lang::big_integer a = andy::lang::big_integer::parse("-18446744073709551617");
+      andy::lang::big_integer b(3);
+
+      expect((a / b).to_string()).to<eq>(std::string("-6148914691236517205"));
+      expect((a % b).to_string()).to<eq>(std::string("-2"));
+    });
+  });
+});
@@ -123,6 +123,23 @@ describe of("lexer", []() {
           }
         });
       });
+      describe("operator types", []() {
+        it("should be set from the operator table", [&]() {
+          andy::lang::lexer l("", "a = !b; a++; a--; a == b;");
+          std::vector<andy::lang::lexer::operator_type> types;
+
+          for(const auto& token : l.tokens()) {
+            if(token.type() == andy::lang::lexer::token_type::token_operator) {
+              types.push_back(token.op());
+            }
+          }
+
+          expect(types == std::vector<andy::lang::lexer::operator_type>{
+            andy::lang::lexer::operator_assign, andy::lang::lexer::operator_not, andy::lang::lexer::operator_increment,
+            andy::lang::lexer::operator_decrement, andy::lang::lexer::operator_equal
+          }).to<eq>(true);
+        });
+      });
     });
   });
-});
\ No newline at end of file
+});
@@ -0,0 +1,103 @@
+#include <andy/tests.hpp>
+#include <andy/lang/module_cache.hpp>
+#include <andy/lang/parser.hpp>
+#include <andy/lang/api.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+static std::string dump(const andy::lang::parser::ast_node& node)
+{
+  std::string result = std::to_string((int)node.type());
+  result += ':';
+  result += node.token().content();
+  result += '@';
+  result += node.token().m_file_name;
+  result += ':';
+  result += std::to_string(node.token().start.line);
+  result += ':';
+  result += std::to_string(node.token().integer_literal);
+  result += '(';
+  for(const auto& child : node.childrens()) {
+    result += dump(child);
+  }
+  result += ')';
+  return result;
+}
+
+describe of("module_cache", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_module_cache_spec";
+  std::filesystem::remove_all(root);
+
+  std::string source_path = (root / "main.andy").string();
+  std::string source = "var a = 10;\nputs(\"a is ${a}\\n\");\nreturn a;\n";
+  write_file(source_path, source);
+
+  andy::lang::lexer l(source_path, source);
+  andy::lang::parser p;
+  andy::lang::parser::ast_node program = p.parse_all(l);
+
+  std::filesystem::path cache_path = andy::lang::module_cache::cache_path_for(source_path, root / "cache");
+
+  describe("load", [&]() {
+    it("should rebuild the stored program", [&]() {
+      andy::lang::module_cache writer(cache_path);
+      expect(writer.store(program, { { source_path, source } })).to<eq>(true);
+
+      andy::lang::module_cache reader(cache_path);
+      andy::lang::parser::ast_node loaded;
+
+      expect(reader.load(loaded)).to<eq>(true);
+      expect(dump(loaded)).to<eq>(dump(program));
+    });
+    it("should reject a cache of a modified source", [&]() {
+      andy::lang::module_cache writer(cache_path);
+      writer.store(program, { { source_path, source } });
+
+      write_file(source_path, "return 1;\n");
+
+      andy::lang::module_cache reader(cache_path);
+      andy::lang::parser::ast_node loaded;
+
+      expect(reader.load(loaded)).to<eq>(false);
+      expect(loaded.is_undefined()).to<eq>(true);
+
+      write_file(source_path, source);
+    });
+    it("should reject a corrupted cache", [&]() {
+      write_file(cache_path, "ANDYC");
+
+      andy::lang::module_cache reader(cache_path);
+      andy::lang::parser::ast_node loaded;
+
+      expect(reader.load(loaded)).to<eq>(false);
+    });
+  });
+  describe("evaluate", [&]() {
+    it("should not cache a program which uses #compile, so the extension is built on every run", [&]() {
+      std::filesystem::path compile_path = root / "compile" / "main.andy";
+      write_file(root / "compile" / "extension" / "CMakeLists.txt", "cmake_minimum_required(VERSION 3.10)\nproject(extension NONE)\n");
+      write_file(compile_path, "#compile \"extension\"\nvar ran = 1;\n");
+
+      andy::lang::api::options options;
+      options.cache = true;
+      options.cache_directory = root / "cache";
+
+      for(int run = 0; run < 2; run++) {
+        std::filesystem::remove_all(root / "compile" / "extension" / "build");
+        andy::lang::api::evaluate(compile_path, options);
+
+        expect(std::filesystem::exists(root / "compile" / "extension" / "build")).to<eq>(true);
+      }
+
+      expect(std::filesystem::exists(andy::lang::module_cache::cache_path_for(compile_path, root / "cache"))).to<eq>(false);
+    });
+  });
+});
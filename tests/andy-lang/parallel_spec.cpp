@@ -0,0 +1,104 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/parallel.hpp>
+
+#include <sstream>
+
+// Arrays can only be built from a literal
+static std::string array_literal(size_t count)
+{
+  std::string literal = "[";
+
+  for(size_t i = 0; i < count; i++) {
+    literal += (i ? ", " : "") + std::to_string(i);
+  }
+
+  return literal + "]";
+}
+
+describe of("parallel", []() {
+  describe("chunk_count", []() {
+    it("should not split small arrays", []() {
+      expect(andy::lang::parallel::chunk_count(100, 8)).to<eq>((size_t)1);
+      expect(andy::lang::parallel::chunk_count(100000, 1)).to<eq>((size_t)1);
+    });
+    it("should split in a few chunks per thread of at least min_chunk items", []() {
+      expect(andy::lang::parallel::chunk_count(1000000, 8)).to<eq>((size_t)32);
+      expect(andy::lang::parallel::chunk_count(andy::lang::parallel::min_chunk * 3, 8)).to<eq>((size_t)3);
+    });
+  });
+  describe("Array", []() {
+    std::string numbers = "var numbers = " + array_literal(5000) + ";\n";
+
+    it("should map in the order of the items", [=]() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+
+      engine.run(engine.compile_source("function describe(n)\n{\n    return \"item \" + n.to_string();\n}\n" + numbers +
+        "var described = numbers.parallel_map(\"describe\");\nputs(described.size().to_string());\nputs(described[0]);\nputs(described[4999]);\nputs(described[2500]);\n"));
+
+      expect(output.str()).to<eq>("5000\nitem 0\nitem 4999\nitem 2500\n");
+    });
+    it("should reduce with an associative function", [=]() {
+      andy::lang::api::engine engine;
+
+      auto sum = engine.run(engine.compile_source("function add(a, b)\n{\n    return a + b;\n}\n" + numbers + "return numbers.parallel_reduce(\"add\", 10);\n"));
+
+      expect(sum->as<int64_t>()).to<eq>(12497510);
+    });
+    it("should write what each call prints in the order of the items", [=]() {
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+
+      engine.run(engine.compile_source("function show(n)\n{\n    puts(n.to_string());\n}\n" + numbers + "numbers.parallel_each(\"show\");\n"));
+
+      std::string expected;
+      for(int i = 0; i < 5000; i++) {
+        expected += std::to_string(i) + "\n";
+      }
+
+      expect(output.str()).to<eq>(expected);
+    });
+    it("should let the function use the classes of the program, however many items there are", [=]() {
+      for(size_t count : { (size_t)10, (size_t)5000 }) {
+        andy::lang::api::engine engine;
+
+        auto sum = engine.run(engine.compile_source(
+          "class Scale\n{\n    static function triple(n)\n    {\n        return n * 3;\n    }\n}\n"
+          "class Step extends Scale\n{\n}\n"
+          "function scale(n)\n{\n    return Scale.triple(n) + 1;\n}\n"
+          "function add(a, b)\n{\n    return a + b;\n}\n"
+          "var numbers = " + array_literal(count) + ";\nvar scaled = numbers.parallel_map(\"scale\");\nreturn scaled.parallel_reduce(\"add\", 0);\n"));
+
+        expect(sum->as<int64_t>()).to<eq>((int64_t)(3 * count * (count - 1) / 2 + count));
+      }
+    });
+    it("should use the classes of the program which calls it, not the ones of an earlier program", [=]() {
+      for(int64_t factor : { 3, 5, 5 }) {
+        andy::lang::api::engine engine;
+
+        auto sum = engine.run(engine.compile_source(
+          "class Scale\n{\n    static function apply(n)\n    {\n        return n * " + std::to_string(factor) + ";\n    }\n}\n"
+          "function scale(n)\n{\n    return Scale.apply(n);\n}\n"
+          "function add(a, b)\n{\n    return a + b;\n}\n" + numbers +
+          "var scaled = numbers.parallel_map(\"scale\");\nreturn scaled.parallel_reduce(\"add\", 0);\n"));
+
+        expect(sum->as<int64_t>()).to<eq>(factor * 5000 * 4999 / 2);
+      }
+    });
+    it("should fail for an unknown function", []() {
+      andy::lang::api::engine engine;
+
+      std::string message;
+      try {
+        engine.run(engine.compile_source("var numbers = [1, 2];\nnumbers.parallel_map(\"missing\");\n"));
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("Array.parallel_map: function missing not found");
+    });
+  });
+});
@@ -0,0 +1,44 @@
+#include <andy/tests.hpp>
+#include <andy/lang/parser.hpp>
+
+using ast_node = andy::lang::parser::ast_node;
+using ast_node_type = andy::lang::parser::ast_node_type;
+
+describe of("parser", []() {
+  describe("ast_node", []() {
+    it("should find the first child of a slotted type", []() {
+      ast_node node(ast_node_type::ast_node_fn_call);
+      node.add_child(ast_node(ast_node_type::ast_node_fn_params));
+      node.add_child(ast_node(ast_node_type::ast_node_declname));
+      node.add_child(ast_node(ast_node_type::ast_node_declname));
+
+      expect(node.child_from_type(ast_node_type::ast_node_declname) == &node.childrens()[1]).to<eq>(true);
+      expect(node.child_from_type(ast_node_type::ast_node_fn_params) == &node.childrens()[0]).to<eq>(true);
+      expect(node.child_from_type(ast_node_type::ast_node_fn_object) == nullptr).to<eq>(true);
+    });
+    it("should find children after reindex", []() {
+      ast_node node(ast_node_type::ast_node_fn_call);
+      node.add_child(ast_node(ast_node_type::ast_node_fn_params));
+      node.add_child(ast_node(ast_node_type::ast_node_declname));
+
+      node.childrens().erase(node.childrens().begin());
+      node.reindex();
+
+      expect(node.child_from_type(ast_node_type::ast_node_declname) == &node.childrens()[0]).to<eq>(true);
+      expect(node.child_from_type(ast_node_type::ast_node_fn_params) == nullptr).to<eq>(true);
+    });
+    it("should keep the slots of a parsed program", []() {
+      std::string source = "function f(a) { if(a) { return 1; } else { return 2; } }\n";
+      andy::lang::lexer l("parser_spec.andy", source);
+      andy::lang::parser p;
+      ast_node root = p.parse_all(l);
+
+      const ast_node& fn = root.childrens().front();
+      const ast_node* conditional = &fn.block()->childrens().front();
+
+      expect(fn.decname()).to<eq>("f");
+      expect(conditional->condition() != nullptr).to<eq>(true);
+      expect(conditional->child_from_type(ast_node_type::ast_node_else) != nullptr).to<eq>(true);
+    });
+  });
+});
@@ -0,0 +1,159 @@
+#include <andy/tests.hpp>
+#include <andy/lang/preprocessor.hpp>
+
+#include <uva/file.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path);
+  file << content;
+}
+
+static std::string dump(const andy::lang::parser::ast_node& node)
+{
+  std::string result = std::to_string((int)node.type());
+  result += ':';
+  result += node.token().content();
+  result += '@';
+  result += node.token().m_file_name;
+  result += '(';
+  for(const auto& child : node.childrens()) {
+    result += dump(child);
+  }
+  result += ')';
+  return result;
+}
+
+describe of("preprocessor", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_preprocessor_spec";
+  std::filesystem::remove_all(root);
+
+  write_file(root / "main.andy", "#include \"lib/*.andy\"\n#include \"shared.andy\"\nputs(a());\n");
+  write_file(root / "lib" / "a.andy", "#include \"b.andy\"\nfunction a() { return 1; }\n");
+  write_file(root / "lib" / "b.andy", "function b2() { return 2; }\n");
+  write_file(root / "shared.andy", "function b() { return 1; }\n");
+  write_file(root / "cycle" / "main.andy", "#include \"x.andy\"\n");
+  write_file(root / "cycle" / "x.andy", "#include \"y.andy\"\n");
+  write_file(root / "cycle" / "y.andy", "#include \"x.andy\"\n");
+  write_file(root / "error" / "main.andy", "#include \"bad.andy\"\n");
+  write_file(root / "error" / "bad.andy", "\nclass {\n");
+  write_file(root / "order" / "main.andy", "puts(\"first\");\n#include \"second.andy\"\n// a comment\n#include \"third.andy\"\nputs(\"last\");\n");
+  write_file(root / "order" / "second.andy", "puts(\"second\");\n");
+  write_file(root / "order" / "third.andy", "puts(\"third\");\n");
+  write_file(root / "inside" / "main.andy", "class A {\n#include \"method.andy\"\n}\n");
+  write_file(root / "inside" / "method.andy", "function m() { return 1; }\n");
+
+  describe("process_parallel", [&]() {
+    it("should produce the same program as process", [&]() {
+      std::string main_path = (root / "main.andy").string();
+      std::string source = uva::file::read_all_text<char>(main_path);
+
+      andy::lang::lexer sequential_lexer(main_path, source);
+      andy::lang::preprocessor sequential;
+      sequential.process(main_path, sequential_lexer);
+      andy::lang::parser p;
+      std::string expected = dump(p.parse_all(sequential_lexer));
+
+      for(size_t jobs : { 1, 2, 8 }) {
+        andy::lang::lexer parallel_lexer(main_path, source);
+        andy::lang::preprocessor parallel;
+        std::string result = dump(parallel.process_parallel(main_path, parallel_lexer, jobs));
+
+        expect(result).to<eq>(expected);
+      }
+    });
+    it("should merge an include where its directive is", [&]() {
+      std::string main_path = (root / "order" / "main.andy").string();
+      std::string source = uva::file::read_all_text<char>(main_path);
+
+      andy::lang::lexer sequential_lexer(main_path, source);
+      andy::lang::preprocessor sequential;
+      sequential.process(main_path, sequential_lexer);
+      andy::lang::parser p;
+      std::string expected = dump(p.parse_all(sequential_lexer));
+
+      andy::lang::lexer parallel_lexer(main_path, source);
+      andy::lang::preprocessor parallel;
+      std::string result = dump(parallel.process_parallel(main_path, parallel_lexer, 2));
+
+      expect(result).to<eq>(expected);
+      expect(result.find("first@") < result.find("second@")).to<eq>(true);
+      expect(result.find("third@") < result.find("last@")).to<eq>(true);
+    });
+    it("should report an include inside a statement", [&]() {
+      std::string main_path = (root / "inside" / "main.andy").string();
+      std::string source = uva::file::read_all_text<char>(main_path);
+
+      andy::lang::lexer l(main_path, source);
+      andy::lang::preprocessor preprocessor;
+
+      std::string error;
+
+      try {
+        preprocessor.process_parallel(main_path, l);
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error.find("#include inside a statement") != std::string::npos).to<eq>(true);
+    });
+    it("should share the included files of a cache", [&]() {
+      std::string main_path = (root / "main.andy").string();
+      std::string source = uva::file::read_all_text<char>(main_path);
+
+      andy::lang::lexer uncached_lexer(main_path, source);
+      andy::lang::preprocessor uncached;
+      std::string expected = dump(uncached.process_parallel(main_path, uncached_lexer, 1));
+
+      andy::lang::include_cache cache;
+      andy::lang::preprocessor first;
+      andy::lang::preprocessor second;
+
+      for(andy::lang::preprocessor* preprocessor : { &first, &second }) {
+        andy::lang::lexer l(main_path, source);
+        expect(dump(preprocessor->process_parallel(main_path, l, 2, &cache))).to<eq>(expected);
+      }
+
+      expect(cache.size()).to<eq>(3);
+      expect(first.units()[1] == second.units()[1]).to<eq>(true);
+    });
+    it("should report circular includes", [&]() {
+      std::string main_path = (root / "cycle" / "main.andy").string();
+      std::string source = uva::file::read_all_text<char>(main_path);
+
+      andy::lang::lexer l(main_path, source);
+      andy::lang::preprocessor preprocessor;
+
+      std::string error;
+
+      try {
+        preprocessor.process_parallel(main_path, l);
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error.find("circular include") != std::string::npos).to<eq>(true);
+    });
+    it("should report errors at the included file position", [&]() {
+      std::string main_path = (root / "error" / "main.andy").string();
+      std::string source = uva::file::read_all_text<char>(main_path);
+
+      andy::lang::lexer l(main_path, source);
+      andy::lang::preprocessor preprocessor;
+
+      std::string error;
+
+      try {
+        preprocessor.process_parallel(main_path, l);
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error.find("bad.andy:2:7") != std::string::npos).to<eq>(true);
+    });
+  });
+});
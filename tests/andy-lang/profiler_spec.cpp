@@ -0,0 +1,63 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/profiler.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+describe of("profiler", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_profiler_spec";
+  std::filesystem::remove_all(root);
+
+  write_file(root / "work.andy", "function work(i)\n{\n    var x = i * 3;\n    return x % 7;\n}\n");
+  write_file(root / "main.andy", "#include \"work.andy\"\n\nvar total = 0;\nfor(var i = 0; i < 50000; i++) {\n    total += work(i);\n}\n");
+
+  andy::lang::profiler profiler(std::chrono::microseconds(100));
+
+  andy::lang::api::options options;
+  options.profiler = &profiler;
+  andy::lang::api::evaluate(root / "main.andy", options);
+
+  describe("write_folded", [&]() {
+    it("should name the frames after the methods and their files", [&]() {
+      std::ostringstream folded;
+      profiler.write_folded(folded);
+
+      expect(profiler.samples() > 0).to<eq>(true);
+      expect(folded.str().find("main.andy (main.andy:4);work (work.andy:") != std::string::npos).to<eq>(true);
+    });
+  });
+  describe("write_chrome_trace", [&]() {
+    it("should write complete events", [&]() {
+      std::ostringstream trace;
+      profiler.write_chrome_trace(trace);
+
+      expect(trace.str().find("\"ph\": \"X\"") != std::string::npos).to<eq>(true);
+    });
+  });
+  describe("start", [&]() {
+    it("should not run two profilers at once", [&]() {
+      andy::lang::profiler first;
+      andy::lang::profiler second;
+      first.start("first");
+
+      bool thrown = false;
+      try {
+        second.start("second");
+      } catch(const std::runtime_error&) {
+        thrown = true;
+      }
+
+      first.stop();
+      expect(thrown).to<eq>(true);
+    });
+  });
+});
@@ -0,0 +1,63 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+
+#include <sstream>
+
+static const std::string counter_source =
+  "class Counter {\n    static function depth(n) {\n        if(n == 0) {\n            return 0;\n        }\n        return Counter.depth(n - 1) + 1;\n    }\n}\n";
+
+static std::string run_recursion_source(const std::string& source, size_t max_depth = 0)
+{
+  andy::lang::api::engine engine;
+  std::ostringstream output;
+  engine.interpreter().output = &output;
+
+  if(max_depth) {
+    engine.interpreter().max_depth = max_depth;
+  }
+
+  engine.run(engine.compile_source(counter_source + source));
+
+  return output.str();
+}
+
+describe of("recursion", []() {
+  describe("depth", []() {
+    it("should recurse far deeper than the stack of the thread", []() {
+      expect(run_recursion_source("puts(Counter.depth(100000).to_string());\n")).to<eq>("100000\n");
+    });
+    it("should recurse inside a fiber, whose stack is smaller", []() {
+      expect(run_recursion_source("function deep(n) {\n    return Counter.depth(n);\n}\nvar fiber = spawn(\"deep\", 20000);\nputs(fiber.join().to_string());\n"))
+        .to<eq>("20000\n");
+    });
+  });
+  describe("tail calls", []() {
+    it("should run ten million tail calls in the frame of the first one", []() {
+      // With only 100 frames allowed, any call which nested would throw
+      expect(run_recursion_source(
+        "class Sum {\n    static function to(n, total) {\n        if(n == 0) {\n            return total;\n        }\n        return Sum.to(n - 1, total + 1);\n    }\n}\n"
+        "puts(Sum.to(10000000, 0).to_string());\n", 100))
+        .to<eq>("10000000\n");
+    });
+    it("should reuse the frame for a call to another method", []() {
+      expect(run_recursion_source(
+        "class Parity {\n    static function even(n) {\n        if(n == 0) {\n            return \"even\";\n        }\n        return Parity.odd(n - 1);\n    }\n"
+        "    static function odd(n) {\n        if(n == 0) {\n            return \"odd\";\n        }\n        return Parity.even(n - 1);\n    }\n}\n"
+        "puts(Parity.even(100001));\n", 100))
+        .to<eq>("odd\n");
+    });
+  });
+  describe("max_depth", []() {
+    it("should throw when the calls nest deeper", []() {
+      std::string error;
+
+      try {
+        run_recursion_source("Counter.depth(5000);\n", 1000);
+      } catch(const std::exception& e) {
+        error = e.what();
+      }
+
+      expect(error).to<eq>("stack overflow: more than 1000 nested calls");
+    });
+  });
+});
@@ -0,0 +1,88 @@
+#include <andy/tests.hpp>
+#include <andy/lang/symbol_index.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+static std::string dump(const std::vector<andy::lang::symbol_index::symbol>& symbols)
+{
+  std::string result;
+  for(const auto& symbol : symbols) {
+    result += symbol.container.empty() ? symbol.name : symbol.container + "." + symbol.name;
+    result += '@';
+    result += std::filesystem::path(symbol.where.file_name).filename().string();
+    result += ':';
+    result += std::to_string(symbol.where.line);
+    result += ' ';
+  }
+  return result;
+}
+
+describe of("symbol_index", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_symbol_index_spec";
+  std::filesystem::remove_all(root);
+
+  std::filesystem::path a_path = root / "a.andy";
+  std::filesystem::path b_path = root / "b.andy";
+  std::filesystem::path index_path = root / "index" / "symbols.andyi";
+
+  write_file(a_path, "class Point\n{\n    function length(scale)\n    {\n        return scale;\n    }\n};\nfunction unused_function()\n{\n}\n");
+  write_file(b_path, "var p = new Point();\nputs(p.length(2));\n");
+
+  describe("update", [&]() {
+    it("should find definitions and references", [&]() {
+      andy::lang::symbol_index index(index_path);
+      index.update(a_path);
+      index.update(b_path);
+
+      expect(dump(index.definitions("length"))).to<eq>("Point.length@a.andy:2 ");
+      expect(index.references("Point").size()).to<eq>(1);
+      expect(index.references("p").size()).to<eq>(1);
+      expect(dump(index.unused())).to<eq>("unused_function@a.andy:7 ");
+    });
+  });
+  describe("store", [&]() {
+    it("should answer from the stored index", [&]() {
+      andy::lang::symbol_index writer(index_path);
+      writer.update(a_path);
+      writer.update(b_path);
+      expect(writer.store()).to<eq>(true);
+
+      andy::lang::symbol_index reader(index_path);
+      expect(reader.load()).to<eq>(true);
+      expect(reader.files().size()).to<eq>(2);
+      expect(dump(reader.definitions("length"))).to<eq>("Point.length@a.andy:2 ");
+      expect(reader.references("Point").size()).to<eq>(1);
+      expect(dump(reader.unused())).to<eq>("unused_function@a.andy:7 ");
+      expect(reader.update(a_path)).to<eq>(false);
+    });
+    it("should hide the stored records of an updated file", [&]() {
+      andy::lang::symbol_index index(index_path);
+      index.load();
+
+      write_file(b_path, "puts(\"no points\");\n");
+      expect(index.update(b_path)).to<eq>(true);
+
+      expect(index.references("Point").size()).to<eq>(0);
+      expect(dump(index.unused())).to<eq>("Point@a.andy:0 Point.length@a.andy:2 unused_function@a.andy:7 ");
+
+      expect(index.store()).to<eq>(true);
+      expect(index.references("Point").size()).to<eq>(0);
+      expect(index.files().size()).to<eq>(2);
+    });
+    it("should reject a corrupted index", [&]() {
+      write_file(index_path, "ANDYSYM");
+
+      andy::lang::symbol_index reader(index_path);
+      expect(reader.load()).to<eq>(false);
+      expect(reader.files().size()).to<eq>(0);
+    });
+  });
+});
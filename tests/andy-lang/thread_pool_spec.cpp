@@ -0,0 +1,53 @@
+#include <andy/tests.hpp>
+#include <andy/lang/thread_pool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+describe of("thread_pool", []() {
+  describe("parallel_for", []() {
+    it("should call every index once", []() {
+      andy::lang::thread_pool pool(4);
+      std::vector<std::atomic<int>> calls(1000);
+
+      pool.parallel_for(calls.size(), [&](size_t i) {
+        calls[i]++;
+      });
+
+      size_t once = 0;
+      for(auto& c : calls) {
+        once += c == 1;
+      }
+
+      expect(once).to<eq>(calls.size());
+    });
+    it("should rethrow the exception of the lowest index", []() {
+      andy::lang::thread_pool pool(4);
+      std::string message;
+
+      try {
+        pool.parallel_for(100, [&](size_t i) {
+          if(i % 10 == 7) {
+            throw std::runtime_error(std::to_string(i));
+          }
+        });
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("7");
+    });
+    it("should run nested batches", []() {
+      andy::lang::thread_pool pool(4);
+      std::atomic<size_t> sum = 0;
+
+      pool.parallel_for(16, [&](size_t i) {
+        pool.parallel_for(16, [&](size_t j) {
+          sum += i * 16 + j;
+        });
+      });
+
+      expect((size_t)sum).to<eq>(256 * 255 / 2);
+    });
+  });
+});
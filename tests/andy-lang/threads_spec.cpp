@@ -0,0 +1,81 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+describe of("threads", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_threads_spec";
+  std::filesystem::remove_all(root);
+
+  size_t thread_count = std::max<size_t>(4, std::thread::hardware_concurrency());
+
+  write_file(root / "count.andy", "function count(n)\n{\n    var total = 0;\n    for(var i = 0; i < n; i++) {\n        total = total + i;\n    }\n    return total;\n}\n");
+  write_file(root / "main.andy", "#include \"count.andy\"\n\nvar total = count(1000);\nputs(total.to_string());\nPath.set_current(directory);\nputs(File.read(\"name.txt\"));\n");
+
+  describe("interpreters", [&]() {
+    it("should run one interpreter per thread", [&]() {
+      std::vector<std::string> outputs(thread_count);
+      std::vector<std::string> errors(thread_count);
+      std::vector<std::thread> threads;
+
+      for(size_t t = 0; t < thread_count; t++) {
+        // Each thread changes the working directory of its program to its own directory
+        write_file(root / std::to_string(t) / "name.txt", "thread " + std::to_string(t));
+
+        threads.emplace_back([&, t]() {
+          try {
+            andy::lang::api::engine engine;
+            std::ostringstream output;
+            engine.interpreter().output = &output;
+
+            auto program = engine.compile(root / "main.andy");
+
+            for(int run = 0; run < 20; run++) {
+              engine.run(program, { { "directory", engine.make((root / std::to_string(t)).string()) } });
+            }
+
+            outputs[t] = output.str();
+          } catch(const std::exception& e) {
+            errors[t] = e.what();
+          }
+        });
+      }
+
+      for(auto& thread : threads) {
+        thread.join();
+      }
+
+      for(size_t t = 0; t < thread_count; t++) {
+        std::string expected;
+        for(int run = 0; run < 20; run++) {
+          expected += "499500\nthread " + std::to_string(t) + "\n";
+        }
+
+        expect(errors[t]).to<eq>("");
+        expect(outputs[t]).to<eq>(expected);
+      }
+    });
+    it("should not change the working directory of the process", [&]() {
+      std::filesystem::path before = std::filesystem::current_path();
+
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+      engine.run(engine.compile(root / "main.andy"), { { "directory", engine.make((root / "0").string()) } });
+
+      expect(std::filesystem::current_path().string()).to<eq>(before.string());
+      expect(engine.interpreter().working_directory.string()).to<eq>((root / "0").string());
+    });
+  });
+});
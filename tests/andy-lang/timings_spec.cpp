@@ -0,0 +1,72 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/timings.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+static std::string names(const andy::lang::timings& timings)
+{
+  std::string result;
+  for(const auto& phase : timings.phases()) {
+    result += phase.name;
+    if(!phase.file.empty()) {
+      result += " " + std::filesystem::path(phase.file).filename().string();
+    }
+    result += ", ";
+  }
+  return result;
+}
+
+describe of("timings", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_timings_spec";
+  std::filesystem::remove_all(root);
+
+  write_file(root / "work.andy", "function work(i)\n{\n    return i * 3;\n}\n");
+  write_file(root / "main.andy", "#include \"work.andy\"\n\nreturn work(2);\n");
+
+  describe("evaluate", [&]() {
+    it("should measure every phase and the included files", [&]() {
+      andy::lang::timings timings;
+
+      andy::lang::api::options options;
+      options.timings = &timings;
+      andy::lang::api::evaluate(root / "main.andy", options);
+
+      expect(names(timings)).to<eq>("read, lex, read work.andy, lex work.andy, preprocess, parse, create structures, execute, start extensions, ");
+    });
+    it("should parse each file with parallel includes", [&]() {
+      andy::lang::timings timings;
+
+      andy::lang::api::options options;
+      options.timings = &timings;
+      options.parallel_includes = true;
+      andy::lang::api::evaluate(root / "main.andy", options);
+
+      std::string phases = names(timings);
+      expect(phases.find("parse main.andy, ") != std::string::npos).to<eq>(true);
+      expect(phases.find("parse work.andy, ") != std::string::npos).to<eq>(true);
+      expect(phases.find("preprocess and parse, create structures") != std::string::npos).to<eq>(true);
+    });
+  });
+  describe("write_json", [&]() {
+    it("should write one object per phase", [&]() {
+      andy::lang::timings timings;
+      {
+        andy::lang::timings::scope phase(&timings, "phase", "file.andy");
+      }
+
+      std::ostringstream json;
+      timings.write_json(json);
+      expect(json.str().find("{ \"phase\": \"phase\", \"file\": \"file.andy\", \"wall_ns\": ") != std::string::npos).to<eq>(true);
+    });
+  });
+});
@@ -0,0 +1,102 @@
+#include <andy/tests.hpp>
+#include <andy/lang/api.hpp>
+#include <andy/lang/channel.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+static void write_file(const std::filesystem::path& path, std::string_view content)
+{
+  std::filesystem::create_directories(path.parent_path());
+  std::ofstream file(path, std::ios::binary);
+  file << content;
+}
+
+describe of("worker", []() {
+  std::filesystem::path root = std::filesystem::temp_directory_path() / "andy_worker_spec";
+  std::filesystem::remove_all(root);
+
+  // Echoes as many messages as the first one says
+  write_file(root / "echo.andy", "var count = Worker.receive();\nfor(var i = 0; i < count; i++) {\n    Worker.send(Worker.receive());\n}\nputs(\"echoed\");\nreturn \"done\";\n");
+  write_file(root / "fail.andy", "Worker.send(1);\nvar x = missing;\n");
+
+  describe("channel", []() {
+    it("should keep the order of the values across threads", []() {
+      andy::lang::channel<int> channel(4);
+      long long sum = 0;
+      bool ordered = true;
+
+      std::thread consumer([&]() {
+        int expected = 0;
+        while(std::optional<int> value = channel.pop()) {
+          ordered = ordered && *value == expected++;
+          sum += *value;
+        }
+      });
+
+      for(int i = 0; i < 10000; i++) {
+        channel.push(i);
+      }
+
+      channel.close();
+      consumer.join();
+
+      expect(ordered).to<eq>(true);
+      expect(sum).to<eq>(49995000LL);
+      expect(channel.push(1)).to<eq>(false);
+    });
+  });
+  describe("Worker", [&]() {
+    it("should exchange copies of values with a script on its own thread", [&]() {
+      write_file(root / "main.andy",
+        "var worker = new Worker(\"echo.andy\");\nworker.send(102);\n"
+        "var total = 0;\nfor(var i = 1; i < 101; i++) {\n    worker.send(i);\n}\nfor(var i = 1; i < 101; i++) {\n    total = total + worker.receive();\n}\nputs(total.to_string());\n"
+        "var words = [\"a\", \"b\"];\nworker.transfer(words);\nputs(words.size().to_string());\nputs(worker.receive().join(\",\"));\n"
+        "worker.send({ \"mode\": \"fast\" });\nvar settings = worker.receive();\nputs(settings[\"mode\"]);\n"
+        "puts(worker.join());\n");
+
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+      engine.interpreter().working_directory = root;
+      engine.run(engine.compile(root / "main.andy"));
+
+      expect(output.str()).to<eq>("5050\n0\na,b\nfast\nechoed\ndone\n");
+    });
+    it("should rethrow the error of the script on join", [&]() {
+      write_file(root / "join.andy", "var worker = new Worker(\"fail.andy\");\nputs(worker.receive().to_string());\nworker.join();\n");
+
+      andy::lang::api::engine engine;
+      std::ostringstream output;
+      engine.interpreter().output = &output;
+      engine.interpreter().working_directory = root;
+
+      std::string message;
+      try {
+        engine.run(engine.compile(root / "join.andy"));
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(output.str()).to<eq>("1\n");
+      expect(message).to<eq>("worker " + (root / "fail.andy").string() + ": 'missing' is undefined");
+    });
+    it("should refuse to send objects of other classes", [&]() {
+      write_file(root / "path.andy", "var worker = new Worker(\"echo.andy\");\nworker.send(new Path(\"/tmp\"));\n");
+
+      andy::lang::api::engine engine;
+      engine.interpreter().working_directory = root;
+
+      std::string message;
+      try {
+        engine.run(engine.compile(root / "path.andy"));
+      } catch(const std::exception& e) {
+        message = e.what();
+      }
+
+      expect(message).to<eq>("Worker: a Path object cannot be sent to another interpreter");
+    });
+  });
+});